@@ -0,0 +1,658 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* neardal-bench: drive NEARDAL against neard-mock and report throughput,
+ * latency and memory figures as JSON, e.g.:
+ *   mock/mock-run.sh -- bench/neardal-bench -o results.json */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+
+#ifndef VERSION
+#define VERSION "unknown"
+#endif
+
+/* A storm is 'sustained' if every tag is reported within this delay */
+#define BENCH_MAX_LAG_NS	(50ULL * 1000000ULL)
+
+BenchOpts bench_opts = {
+	.count		= 1000,
+	.rate		= 200,
+	.records	= 1,
+	.dwell		= 50,
+	.duration	= 1000,
+	.sizes		= NULL,
+	.rates		= NULL,
+	.adapters	= NULL,
+	.startupTags	= 4,
+	.runs		= 5,
+	.soakTags	= 1000000,
+	.soakBatch	= 1000,
+	.soakSlack	= 512,
+	.timeout	= 10000,
+};
+
+BenchEvents bench_events;
+
+static gchar *sScenarios;
+static gchar *sOutput;
+
+static GOptionEntry sOptions[] = {
+	{ "scenario", 's', 0, G_OPTION_ARG_STRING, &sScenarios,
+	  "Scenarios to run, comma separated (default: all but soak)",
+	  "LIST" },
+	{ "output", 'o', 0, G_OPTION_ARG_FILENAME, &sOutput,
+	  "JSON output file (default: stdout)", "FILE" },
+	{ "count", 'c', 0, G_OPTION_ARG_INT, &bench_opts.count,
+	  "Tags per latency/memory run (default: 1000)", "N" },
+	{ "rate", 'R', 0, G_OPTION_ARG_DOUBLE, &bench_opts.rate,
+	  "Tags per second of latency run (default: 200)", "N" },
+	{ "records", 'r', 0, G_OPTION_ARG_INT, &bench_opts.records,
+	  "Records per tag (default: 1)", "N" },
+	{ "dwell", 'd', 0, G_OPTION_ARG_INT, &bench_opts.dwell,
+	  "Tag presence during storms in ms (default: 50)", "MS" },
+	{ "duration", 'D', 0, G_OPTION_ARG_INT, &bench_opts.duration,
+	  "Measurement window in ms (default: 1000)", "MS" },
+	{ "sizes", 'S', 0, G_OPTION_ARG_STRING, &bench_opts.sizes,
+	  "Topology sizes of lookup run (default: 10,100,1000,4000)",
+	  "LIST" },
+	{ "rates", 0, 0, G_OPTION_ARG_STRING, &bench_opts.rates,
+	  "Rate steps of sustained run (default: 100,...,20000)", "LIST" },
+	{ "adapters", 'A', 0, G_OPTION_ARG_STRING, &bench_opts.adapters,
+	  "Adapter counts of startup run (default: 1,8,64,256)", "LIST" },
+	{ "startup-tags", 0, 0, G_OPTION_ARG_INT, &bench_opts.startupTags,
+	  "Tags per adapter present at startup (default: 4)", "N" },
+	{ "runs", 0, 0, G_OPTION_ARG_INT, &bench_opts.runs,
+	  "Constructions per startup step (default: 5)", "N" },
+	{ "soak-tags", 0, 0, G_OPTION_ARG_INT, &bench_opts.soakTags,
+	  "Tags cycled by the soak run (default: 1000000)", "N" },
+	{ "soak-batch", 0, 0, G_OPTION_ARG_INT, &bench_opts.soakBatch,
+	  "Tags present at once during the soak run (default: 1000)", "N" },
+	{ "soak-slack", 0, 0, G_OPTION_ARG_INT, &bench_opts.soakSlack,
+	  "Heap growth allowed after soak warm-up in KiB (default: 512)",
+	  "KIB" },
+	{ "timeout", 't', 0, G_OPTION_ARG_INT, &bench_opts.timeout,
+	  "Max wait for NEARDAL events in ms (default: 10000)", "MS" },
+	{ NULL, 0, 0, 0, NULL, NULL, NULL }
+};
+
+static void bench_prv_mock(const gchar *method, GVariant *params)
+{
+	GVariant *ret = bench_mock_call(method, params);
+
+	if (ret != NULL)
+		g_variant_unref(ret);
+}
+
+static gboolean bench_prv_found(gpointer data)
+{
+	return bench_events.tagsFound >= GPOINTER_TO_UINT(data);
+}
+
+static gboolean bench_prv_records_found(gpointer data)
+{
+	return bench_events.recordsFound >= GPOINTER_TO_UINT(data);
+}
+
+/* Run a storm of 'count' tags at 'rate' tags/s, wait for all 'tag found' */
+static gboolean bench_prv_storm(gdouble rate, guint count, guint64 *elapsed)
+{
+	guint64		start;
+	gboolean	ok;
+	gint		timeout;
+
+	if (!bench_clear_tags())
+		return FALSE;
+	bench_events_reset();
+	neardal_reset_stats();
+
+	bench_prv_mock("SetRecords", g_variant_new("(i)", bench_opts.records));
+	bench_prv_mock("SetDwell", g_variant_new("(i)", bench_opts.dwell));
+
+	timeout = bench_opts.timeout + (gint) (count * 1000.0 / rate);
+	start = bench_now();
+	bench_prv_mock("StartStorm", g_variant_new("(di)", rate, count));
+	ok = bench_wait(bench_prv_found, GUINT_TO_POINTER(count), timeout);
+	*elapsed = bench_events.lastFoundNs > start ?
+		   bench_events.lastFoundNs - start : 0;
+
+	return ok;
+}
+
+/*****************************************************************************
+ * latency: injection -> 'tag found' callback latency at a fixed rate
+ ****************************************************************************/
+static gboolean bench_latency(void)
+{
+	guint64		elapsed;
+	gboolean	ok;
+
+	ok = bench_prv_storm(bench_opts.rate, bench_opts.count, &elapsed);
+
+	bench_json_uint("tags", bench_opts.count);
+	bench_json_uint("records", bench_opts.records);
+	bench_json_double("rate", bench_opts.rate);
+	bench_json_uint("received", bench_events.tagsFound);
+	bench_json_uint("recordsReceived", bench_events.recordsFound);
+	bench_json_uint("elapsedNs", elapsed);
+	bench_json_double("eventsPerSec", elapsed ?
+			  bench_events.tagsFound * 1e9 / elapsed : 0);
+	bench_json_samples("tagFound", bench_events.latencies);
+	bench_json_stats();
+
+	return ok;
+}
+
+/*****************************************************************************
+ * sustained: highest storm rate whose tags are all reported in time
+ ****************************************************************************/
+static gboolean bench_sustained(void)
+{
+	gint		*rates, nbRates, i;
+	gdouble		best = 0;
+	guint64		elapsed, p99;
+	guint		count;
+	gboolean	ok;
+
+	rates = bench_parse_list(bench_opts.rates ? bench_opts.rates :
+				 "100,200,500,1000,2000,5000,10000,20000",
+				 &nbRates);
+
+	bench_json_uint("records", bench_opts.records);
+	bench_json_begin_array("steps");
+	for (i = 0; i < nbRates; i++) {
+		count = MAX(1, rates[i] * bench_opts.duration / 1000);
+		ok = bench_prv_storm(rates[i], count, &elapsed);
+		bench_samples_sort(bench_events.latencies);
+		p99 = bench_samples_pct(bench_events.latencies, 99);
+		ok = ok && p99 <= BENCH_MAX_LAG_NS;
+
+		bench_json_begin(NULL);
+		bench_json_uint("rate", rates[i]);
+		bench_json_uint("tags", count);
+		bench_json_uint("received", bench_events.tagsFound);
+		bench_json_double("eventsPerSec", elapsed ?
+				  bench_events.tagsFound * 1e9 / elapsed : 0);
+		bench_json_samples("tagFound", bench_events.latencies);
+		bench_json_string("sustained", ok ? "yes" : "no");
+		bench_json_end();
+
+		if (!ok)
+			break;
+		best = rates[i];
+	}
+	bench_json_end_array();
+	bench_json_double("maxSustainedRate", best);
+	bench_json_uint("maxLagNs", BENCH_MAX_LAG_NS);
+
+	g_free(rates);
+
+	return bench_clear_tags();
+}
+
+/* Call 'fn' on every tag, round robin, during the measurement window */
+static gdouble bench_prv_calls_per_sec(gchar **tags, guint nbTags,
+				       gboolean (*fn)(gchar *tagName))
+{
+	guint64	start = bench_now(), deadline, now;
+	guint64	calls = 0;
+
+	deadline = start + bench_opts.duration * 1000000ULL;
+	do {
+		if (!fn(tags[calls % nbTags]))
+			return -1;
+		calls++;
+		now = (calls & 0xFF) ? start : bench_now();
+	} while ((calls & 0xFF) || now < deadline);
+
+	return calls * 1e9 / (now - start);
+}
+
+static gboolean bench_prv_get_tag_properties(gchar *tagName)
+{
+	neardal_tag *tag;
+
+	if (neardal_get_tag_properties(tagName, &tag) != NEARDAL_SUCCESS)
+		return FALSE;
+	neardal_free_tag(tag);
+
+	return TRUE;
+}
+
+static gboolean bench_prv_get_records(gchar *tagName)
+{
+	char	**records;
+	int	len;
+
+	if (neardal_get_records(tagName, &records, &len) != NEARDAL_SUCCESS)
+		return FALSE;
+	neardal_free_array(&records);
+
+	return TRUE;
+}
+
+/* Present tags (release with g_free(), names are owned by bench_events) */
+static gchar **bench_prv_tags(guint *len)
+{
+	GHashTableIter	iter;
+	gpointer	tagName;
+	gchar		**tags;
+
+	*len = 0;
+	tags = g_new(gchar *, g_hash_table_size(bench_events.tags) + 1);
+	g_hash_table_iter_init(&iter, bench_events.tags);
+	while (g_hash_table_iter_next(&iter, &tagName, NULL))
+		tags[(*len)++] = tagName;
+	tags[*len] = NULL;
+
+	return tags;
+}
+
+/*****************************************************************************
+ * lookup: get_tag_properties / get_records calls per second vs topology
+ ****************************************************************************/
+static gboolean bench_lookup(void)
+{
+	gint		*sizes, nbSizes, i;
+	gchar		**tags;
+	guint		present, nbTags;
+	gboolean	ok = bench_clear_tags();
+
+	sizes = bench_parse_list(bench_opts.sizes ? bench_opts.sizes :
+				 "10,100,1000,4000", &nbSizes);
+
+	bench_events_reset();
+	bench_prv_mock("SetRecords", g_variant_new("(i)", bench_opts.records));
+	bench_prv_mock("SetDwell", g_variant_new("(i)", 0));
+
+	bench_json_uint("records", bench_opts.records);
+	bench_json_begin_array("steps");
+	for (i = 0; ok && i < nbSizes; i++) {
+		if (sizes[i] <= 0)
+			continue;
+		present = g_hash_table_size(bench_events.tags);
+		if ((guint) sizes[i] > present)
+			bench_prv_mock("InjectTags", g_variant_new("(u)",
+						sizes[i] - present));
+		ok = bench_wait_tags(sizes[i], bench_opts.timeout) &&
+		     bench_wait(bench_prv_records_found,
+				GUINT_TO_POINTER(sizes[i] *
+						 bench_opts.records),
+				bench_opts.timeout);
+		if (!ok)
+			break;
+
+		tags = bench_prv_tags(&nbTags);
+
+		bench_json_begin(NULL);
+		bench_json_uint("tags", nbTags);
+		bench_json_uint("records", bench_events.recordsFound);
+		bench_json_double("getTagPropertiesPerSec",
+				  bench_prv_calls_per_sec(tags, nbTags,
+					bench_prv_get_tag_properties));
+		bench_json_double("getRecordsPerSec",
+				  bench_prv_calls_per_sec(tags, nbTags,
+					bench_prv_get_records));
+		bench_json_end();
+
+		g_free(tags);
+	}
+	bench_json_end_array();
+
+	g_free(sizes);
+
+	return ok && bench_clear_tags();
+}
+
+/*****************************************************************************
+ * write: neardal_tag_write() throughput on a single tag
+ ****************************************************************************/
+static gboolean bench_write(void)
+{
+	neardal_record	rcd;
+	GArray		*samples = g_array_new(FALSE, FALSE, sizeof(guint64));
+	GHashTableIter	iter;
+	gpointer	tagName = NULL;
+	guint64		start, deadline, t, errors = 0;
+	gboolean	ok = bench_clear_tags();
+
+	bench_prv_mock("SetRecords", g_variant_new("(i)", 1));
+	bench_prv_mock("SetDwell", g_variant_new("(i)", 0));
+	bench_prv_mock("InjectTags", g_variant_new("(u)", 1));
+	ok = ok && bench_wait_tags(1, bench_opts.timeout);
+
+	g_hash_table_iter_init(&iter, bench_events.tags);
+	if (ok && g_hash_table_iter_next(&iter, &tagName, NULL)) {
+		neardal_reset_stats();
+		memset(&rcd, 0, sizeof(rcd));
+		rcd.name = tagName;
+		rcd.type = "Text";
+		rcd.encoding = "UTF-8";
+		rcd.language = "en";
+		rcd.representation = "NEARDAL write benchmark";
+
+		start = bench_now();
+		deadline = start + bench_opts.duration * 1000000ULL;
+		do {
+			t = bench_now();
+			if (neardal_tag_write(&rcd) != NEARDAL_SUCCESS)
+				errors++;
+			t = bench_now() - t;
+			g_array_append_val(samples, t);
+			/* Let NEARDAL process the rewritten records */
+			bench_iterate();
+		} while (bench_now() < deadline);
+
+		bench_json_uint("writes", samples->len);
+		bench_json_uint("errors", errors);
+		bench_json_double("writesPerSec",
+				  samples->len * 1e9 / (bench_now() - start));
+		bench_json_samples("write", samples);
+	}
+
+	g_array_free(samples, TRUE);
+
+	return ok && bench_clear_tags();
+}
+
+/*****************************************************************************
+ * memory: resident memory per tag and per record
+ ****************************************************************************/
+static gboolean bench_memory(void)
+{
+	guint		n = bench_opts.count;
+	guint		r = MAX(1, bench_opts.records);
+	gssize		rss0, rss1, rss2, perTag;
+	gboolean	ok = bench_clear_tags();
+
+	bench_events_reset();
+	bench_prv_mock("SetDwell", g_variant_new("(i)", 0));
+
+	/* Tags without records, then as many tags with 'r' records each */
+	bench_prv_mock("SetRecords", g_variant_new("(i)", 0));
+	bench_iterate();
+	rss0 = bench_rss();
+	bench_prv_mock("InjectTags", g_variant_new("(u)", n));
+	ok = ok && bench_wait_tags(n, bench_opts.timeout);
+	rss1 = bench_rss();
+
+	bench_prv_mock("SetRecords", g_variant_new("(i)", r));
+	bench_prv_mock("InjectTags", g_variant_new("(u)", n));
+	ok = ok && bench_wait_tags(2 * n, bench_opts.timeout) &&
+	     bench_wait(bench_prv_records_found, GUINT_TO_POINTER(n * r),
+			bench_opts.timeout);
+	rss2 = bench_rss();
+
+	perTag = (rss1 - rss0) / (gssize) n;
+	bench_json_uint("tags", n);
+	bench_json_uint("recordsPerTag", r);
+	bench_json_int("rssBase", rss0);
+	bench_json_int("rssBytesPerTag", perTag);
+	bench_json_int("rssBytesPerRecord",
+		       ((rss2 - rss1) / (gssize) n - perTag) / (gssize) r);
+
+	return ok && bench_clear_tags();
+}
+
+/*****************************************************************************
+ * startup: NEARDAL construction time, per step, vs number of adapters (and
+ * tags already present)
+ ****************************************************************************/
+static gboolean bench_startup(void)
+{
+	gint		*counts, nbCounts, i, run;
+	guint		adapters = 1;
+	GVariant	*ret;
+	GArray		*samples;
+	guint64		start, t;
+	gboolean	ok = bench_clear_tags();
+
+	counts = bench_parse_list(bench_opts.adapters ? bench_opts.adapters :
+				  "1,8,64,256", &nbCounts);
+
+	/* Topology to restore */
+	ret = bench_mock_call("GetStats", NULL);
+	if (ret != NULL) {
+		GVariant *stats = g_variant_get_child_value(ret, 0);
+
+		g_variant_lookup(stats, "Adapters", "u", &adapters);
+		g_variant_unref(stats);
+		g_variant_unref(ret);
+	}
+
+	bench_prv_mock("SetRecords", g_variant_new("(i)", bench_opts.records));
+	bench_prv_mock("SetDwell", g_variant_new("(i)", 0));
+
+	bench_json_uint("tagsPerAdapter", bench_opts.startupTags);
+	bench_json_uint("records", bench_opts.records);
+	bench_json_begin_array("steps");
+	samples = g_array_new(FALSE, FALSE, sizeof(guint64));
+	for (i = 0; ok && i < nbCounts; i++) {
+		if (counts[i] <= 0)
+			continue;
+
+		/* Change the topology while NEARDAL does not listen */
+		neardal_destroy();
+		bench_prv_mock("RemoveTags", NULL);
+		bench_prv_mock("SetAdapters", g_variant_new("(u)", counts[i]));
+		bench_prv_mock("InjectTags", g_variant_new("(u)",
+				counts[i] * bench_opts.startupTags));
+
+		neardal_reset_stats();
+		g_array_set_size(samples, 0);
+		for (run = 0; ok && run < bench_opts.runs; run++) {
+			neardal_destroy();
+			bench_iterate();
+			start = bench_now();
+			ok = bench_mock_connect();
+			t = bench_now() - start;
+			g_array_append_val(samples, t);
+		}
+
+		bench_json_begin(NULL);
+		bench_json_uint("adapters", counts[i]);
+		bench_json_uint("tags", counts[i] * bench_opts.startupTags);
+		bench_samples_sort(samples);
+		bench_json_samples("constructNs", samples);
+		bench_json_stats();
+		bench_json_end();
+	}
+	bench_json_end_array();
+	g_array_free(samples, TRUE);
+	g_free(counts);
+
+	neardal_destroy();
+	bench_prv_mock("RemoveTags", NULL);
+	bench_prv_mock("SetAdapters", g_variant_new("(u)", adapters));
+	bench_iterate();
+
+	return bench_mock_connect() && ok;
+}
+
+/* Heap in use, or RSS when the C library can't tell */
+static gsize bench_prv_mem(void)
+{
+	gsize heap = bench_heap();
+
+	return heap ? heap : bench_rss();
+}
+
+/*****************************************************************************
+ * soak: cycle tag (and record) arrivals and removals, fail if memory still
+ * grows once warmed up (10% of the cycles)
+ ****************************************************************************/
+static gboolean bench_soak(void)
+{
+	guint		batch = MAX(1, bench_opts.soakBatch);
+	guint		cycles = MAX(1, bench_opts.soakTags / (gint) batch);
+	guint		warmup = MAX(1, cycles / 10);
+	guint		r = MAX(0, bench_opts.records);
+	gsize		slack = (gsize) MAX(0, bench_opts.soakSlack) * 1024;
+	gsize		peak, idle, peakBase = 0, idleBase = 0;
+	gsize		peakMax = 0, idleMax = 0;
+	guint		cycle;
+	guint64		start;
+	gboolean	ok = bench_clear_tags(), flat;
+
+	bench_prv_mock("SetRecords", g_variant_new("(i)", r));
+	bench_prv_mock("SetDwell", g_variant_new("(i)", 0));
+
+	start = bench_now();
+	for (cycle = 0; ok && cycle < cycles; cycle++) {
+		bench_events_reset();
+		bench_prv_mock("InjectTags", g_variant_new("(u)", batch));
+		ok = bench_wait_tags(batch, bench_opts.timeout) &&
+		     bench_wait(bench_prv_records_found,
+				GUINT_TO_POINTER(batch * r),
+				bench_opts.timeout);
+		peak = bench_prv_mem();
+
+		bench_prv_mock("RemoveTags", NULL);
+		ok = ok && bench_wait_tags(0, bench_opts.timeout);
+		bench_iterate();
+		idle = bench_prv_mem();
+
+		if (cycle + 1 == warmup) {
+			peakBase = peak;
+			idleBase = idle;
+		} else if (cycle >= warmup) {
+			peakMax = MAX(peakMax, peak);
+			idleMax = MAX(idleMax, idle);
+		}
+		if ((cycle + 1) % MAX(1, cycles / 10) == 0)
+			g_printerr("  %u/%u tags, heap %" G_GSIZE_FORMAT
+				   " bytes\n", (cycle + 1) * batch,
+				   cycles * batch, idle);
+	}
+
+	flat = peakMax <= peakBase + slack && idleMax <= idleBase + slack;
+
+	bench_json_uint("tags", (guint64) cycle * batch);
+	bench_json_uint("batch", batch);
+	bench_json_uint("recordsPerTag", r);
+	bench_json_string("memory", bench_heap() ? "heap" : "rss");
+	bench_json_uint("warmupTags", (guint64) warmup * batch);
+	bench_json_uint("peakBase", peakBase);
+	bench_json_uint("peakMax", peakMax);
+	bench_json_uint("idleBase", idleBase);
+	bench_json_uint("idleMax", idleMax);
+	bench_json_uint("slack", slack);
+	bench_json_double("tagsPerSec", (guint64) cycle * batch * 1e9 /
+			  MAX(1, bench_now() - start));
+	bench_json_string("steadyState", flat ? "flat" : "growing");
+	if (!flat)
+		g_printerr("soak: memory grew after warm-up (peak %"
+			   G_GSIZE_FORMAT " -> %" G_GSIZE_FORMAT ", idle %"
+			   G_GSIZE_FORMAT " -> %" G_GSIZE_FORMAT ")\n",
+			   peakBase, peakMax, idleBase, idleMax);
+
+	return ok && flat;
+}
+
+static const BenchScenario sScenariosList[] = {
+	{ "latency", "tag found callback latency", bench_latency },
+	{ "sustained", "max tag rate before callbacks fall behind",
+	  bench_sustained },
+	{ "lookup", "lookup calls per second vs topology size",
+	  bench_lookup },
+	{ "write", "tag write throughput", bench_write },
+	{ "memory", "resident memory per tag and record", bench_memory },
+	{ "startup", "construction time vs adapters", bench_startup },
+	{ "soak", "steady-state memory over tag churn", bench_soak, TRUE },
+};
+
+static gboolean bench_prv_selected(const BenchScenario *scenario)
+{
+	gchar		**names;
+	gboolean	selected = FALSE;
+	guint		i;
+
+	if (sScenarios == NULL)
+		return !scenario->onDemand;
+
+	names = g_strsplit(sScenarios, ",", -1);
+	for (i = 0; names[i] != NULL && !selected; i++)
+		selected = !strcmp(names[i], scenario->name);
+	g_strfreev(names);
+
+	return selected;
+}
+
+int main(int argc, char *argv[])
+{
+	GOptionContext	*context;
+	GError		*error = NULL;
+	FILE		*fp = stdout;
+	guint		i;
+	int		ret = EXIT_SUCCESS;
+
+	context = g_option_context_new("- NEARDAL benchmarks (neard-mock)");
+	g_option_context_add_main_entries(context, sOptions, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error) ||
+	    !bench_mock_init(&error)) {
+		g_printerr("%s\n", error->message);
+		g_error_free(error);
+		g_option_context_free(context);
+		return EXIT_FAILURE;
+	}
+	g_option_context_free(context);
+
+	bench_json_begin(NULL);
+	bench_json_string("benchmark", "neardal");
+	bench_json_string("version", VERSION);
+	bench_json_begin("results");
+	for (i = 0; i < G_N_ELEMENTS(sScenariosList); i++) {
+		if (!bench_prv_selected(&sScenariosList[i]))
+			continue;
+
+		g_printerr("%s: %s...\n", sScenariosList[i].name,
+			   sScenariosList[i].description);
+		bench_json_begin(sScenariosList[i].name);
+		if (!sScenariosList[i].run()) {
+			bench_json_string("error", "failed");
+			ret = EXIT_FAILURE;
+		}
+		bench_json_end();
+	}
+	bench_json_end();
+	bench_json_end();
+
+	if (sOutput != NULL) {
+		fp = fopen(sOutput, "w");
+		if (fp == NULL) {
+			g_printerr("Can't open %s\n", sOutput);
+			return EXIT_FAILURE;
+		}
+	}
+	bench_json_output(fp);
+	if (fp != stdout)
+		fclose(fp);
+
+	neardal_destroy();
+
+	return ret;
+}
@@ -0,0 +1,108 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stdio.h>
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "neardal.h"
+
+#define BENCH_MOCK_SERVICE	"org.neard"
+#define BENCH_MOCK_PATH		"/org/neardal/mock"
+#define BENCH_MOCK_IFACE	"org.neardal.Mock"
+
+/* Benchmark options */
+typedef struct {
+	gint		count;		/* tags per latency run */
+	gdouble		rate;		/* tags per second (latency run) */
+	gint		records;	/* records per tag */
+	gint		dwell;		/* tag presence (ms) during storms */
+	gint		duration;	/* measurement window (ms) */
+	gchar		*sizes;		/* topology sizes, comma separated */
+	gchar		*rates;		/* sustained rate steps, comma sep. */
+	gchar		*adapters;	/* startup adapter counts, comma sep. */
+	gint		startupTags;	/* tags per adapter at startup */
+	gint		runs;		/* constructions per startup step */
+	gint		soakTags;	/* tags cycled by the soak run */
+	gint		soakBatch;	/* tags present at once during soak */
+	gint		soakSlack;	/* heap growth allowed after warm-up, KiB */
+	gint		timeout;	/* max wait for events (ms) */
+} BenchOpts;
+
+/* Events seen through NEARDAL callbacks */
+typedef struct {
+	GHashTable	*injected;	/* tag path -> mock timestamp (ns) */
+	GHashTable	*tags;		/* present tag paths (as set) */
+	GArray		*latencies;	/* guint64 injected -> 'tag found' ns */
+	guint64		tagsFound;
+	guint64		tagsLost;
+	guint64		recordsFound;
+	guint64		lastFoundNs;	/* last 'tag found' timestamp */
+} BenchEvents;
+
+/* Benchmark scenario */
+typedef struct {
+	const gchar	*name;
+	const gchar	*description;
+	gboolean	(*run)(void);
+	gboolean	onDemand;	/* only run when selected by name */
+} BenchScenario;
+
+extern BenchOpts	bench_opts;
+extern BenchEvents	bench_events;
+
+/* bench_util.c */
+guint64 bench_now(void);
+gsize bench_rss(void);
+gsize bench_heap(void);
+void bench_samples_sort(GArray *samples);
+guint64 bench_samples_pct(GArray *samples, gdouble pct);
+gint *bench_parse_list(const gchar *list, gint *len);
+
+void bench_json_begin(const gchar *name);
+void bench_json_end(void);
+void bench_json_begin_array(const gchar *name);
+void bench_json_end_array(void);
+void bench_json_int(const gchar *name, gint64 value);
+void bench_json_uint(const gchar *name, guint64 value);
+void bench_json_double(const gchar *name, gdouble value);
+void bench_json_string(const gchar *name, const gchar *value);
+void bench_json_samples(const gchar *name, GArray *samples);
+void bench_json_latency(const neardal_latency *lat);
+void bench_json_stats(void);
+void bench_json_output(FILE *fp);
+
+void bench_iterate(void);
+gboolean bench_wait(gboolean (*cond)(gpointer), gpointer data,
+		    gint timeout);
+
+/* bench_mock.c (neard-mock benchmarks, use bench_opts and bench_events) */
+gboolean bench_mock_init(GError **error);
+gboolean bench_mock_connect(void);
+GVariant *bench_mock_call(const gchar *method, GVariant *params);
+void bench_events_reset(void);
+gboolean bench_wait_tags(guint present, gint timeout);
+gboolean bench_clear_tags(void);
+
+#endif /* BENCH_H */
@@ -0,0 +1,196 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "bench.h"
+
+/* Connection to neard-mock control interface */
+static GDBusConnection *sConn;
+
+/*---------------------------------------------------------------------------
+ * neard-mock control and NEARDAL events
+ ---------------------------------------------------------------------------*/
+static void bench_prv_tag_injected(GDBusConnection *conn,
+				   const gchar *sender, const gchar *path,
+				   const gchar *iface, const gchar *signal,
+				   GVariant *params, gpointer user_data)
+{
+	const gchar	*tagName;
+	guint64		*ts = g_new(guint64, 1);
+
+	(void) conn;
+	(void) sender;
+	(void) path;
+	(void) iface;
+	(void) signal;
+	(void) user_data;
+
+	g_variant_get(params, "(&ot)", &tagName, ts);
+	g_hash_table_replace(bench_events.injected, g_strdup(tagName), ts);
+}
+
+static void bench_prv_tag_found(const char *tagName, void *user_data)
+{
+	guint64	now = bench_now(), *ts, latency;
+	gchar	*name;
+
+	(void) user_data;
+
+	ts = g_hash_table_lookup(bench_events.injected, tagName);
+	if (ts != NULL) {
+		latency = now - *ts;
+		g_array_append_val(bench_events.latencies, latency);
+		g_hash_table_remove(bench_events.injected, tagName);
+	}
+	name = g_strdup(tagName);
+	g_hash_table_replace(bench_events.tags, name, name);
+	bench_events.tagsFound++;
+	bench_events.lastFoundNs = now;
+}
+
+static void bench_prv_tag_lost(const char *tagName, void *user_data)
+{
+	(void) user_data;
+
+	g_hash_table_remove(bench_events.tags, tagName);
+	bench_events.tagsLost++;
+}
+
+static void bench_prv_record_found(const char *rcdName, void *user_data)
+{
+	(void) rcdName;
+	(void) user_data;
+
+	bench_events.recordsFound++;
+}
+
+/*****************************************************************************
+ * bench_mock_init: connect to neard-mock and register NEARDAL callbacks
+ ****************************************************************************/
+gboolean bench_mock_init(GError **error)
+{
+	/* Same (shared) connection as NEARDAL */
+	sConn = g_bus_get_sync(G_BUS_TYPE_SYSTEM, NULL, error);
+	if (sConn == NULL)
+		return FALSE;
+
+	bench_events.injected = g_hash_table_new_full(g_str_hash, g_str_equal,
+						      g_free, g_free);
+	bench_events.tags = g_hash_table_new_full(g_str_hash, g_str_equal,
+						  g_free, NULL);
+	bench_events.latencies = g_array_new(FALSE, FALSE, sizeof(guint64));
+
+	g_dbus_connection_signal_subscribe(sConn, BENCH_MOCK_SERVICE,
+					   BENCH_MOCK_IFACE, "TagInjected",
+					   BENCH_MOCK_PATH, NULL,
+					   G_DBUS_SIGNAL_FLAGS_NONE,
+					   bench_prv_tag_injected, NULL, NULL);
+
+	if (!bench_mock_connect()) {
+		g_set_error(error, G_IO_ERROR, G_IO_ERROR_FAILED,
+			    "NEARDAL initialization failed (is neard-mock "
+			    "running?)");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/*****************************************************************************
+ * bench_mock_connect: register NEARDAL callbacks, constructing NEARDAL
+ * (again, after neardal_destroy())
+ ****************************************************************************/
+gboolean bench_mock_connect(void)
+{
+	return neardal_set_cb_tag_found(bench_prv_tag_found, NULL) ==
+	       NEARDAL_SUCCESS &&
+	       neardal_set_cb_tag_lost(bench_prv_tag_lost, NULL) ==
+	       NEARDAL_SUCCESS &&
+	       neardal_set_cb_record_found(bench_prv_record_found, NULL) ==
+	       NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * bench_mock_call: synchronous call to neard-mock control interface
+ ****************************************************************************/
+GVariant *bench_mock_call(const gchar *method, GVariant *params)
+{
+	GVariant	*ret;
+	GError		*error = NULL;
+
+	ret = g_dbus_connection_call_sync(sConn, BENCH_MOCK_SERVICE,
+					  BENCH_MOCK_PATH, BENCH_MOCK_IFACE,
+					  method, params, NULL,
+					  G_DBUS_CALL_FLAGS_NONE, -1, NULL,
+					  &error);
+	if (ret == NULL) {
+		g_printerr("neard-mock %s() failed: %s\n", method,
+			   error->message);
+		g_error_free(error);
+	}
+
+	return ret;
+}
+
+/*****************************************************************************
+ * bench_events_reset: forget latencies and counters (present tags are kept)
+ ****************************************************************************/
+void bench_events_reset(void)
+{
+	g_hash_table_remove_all(bench_events.injected);
+	g_array_set_size(bench_events.latencies, 0);
+	bench_events.tagsFound = 0;
+	bench_events.tagsLost = 0;
+	bench_events.recordsFound = 0;
+	bench_events.lastFoundNs = 0;
+}
+
+static gboolean bench_prv_tags_present(gpointer data)
+{
+	return g_hash_table_size(bench_events.tags) == GPOINTER_TO_UINT(data);
+}
+
+/*****************************************************************************
+ * bench_wait_tags: wait until NEARDAL reported exactly 'present' tags
+ ****************************************************************************/
+gboolean bench_wait_tags(guint present, gint timeout)
+{
+	return bench_wait(bench_prv_tags_present, GUINT_TO_POINTER(present),
+			  timeout);
+}
+
+/*****************************************************************************
+ * bench_clear_tags: stop storm, remove all mock tags and wait 'tag lost'
+ ****************************************************************************/
+gboolean bench_clear_tags(void)
+{
+	GVariant *ret;
+
+	ret = bench_mock_call("StopStorm", NULL);
+	if (ret != NULL)
+		g_variant_unref(ret);
+	ret = bench_mock_call("RemoveTags", NULL);
+	if (ret != NULL)
+		g_variant_unref(ret);
+
+	return bench_wait_tags(0, bench_opts.timeout);
+}
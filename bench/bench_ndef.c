@@ -0,0 +1,415 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* neardal-bench-ndef: NDEF parser throughput (neardal_ndef.h), on messages
+ * built in memory, and encoding of NDEF bytes into neard requests, e.g.:
+ *   bench/neardal-bench-ndef -o ndef.json */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "neardal_ndef.h"
+
+#ifndef VERSION
+#define VERSION "unknown"
+#endif
+
+static gchar	*sScenarios;
+static gchar	*sOutput;
+static gint	sDuration	= 1000;
+static gint	sRecords	= 1000;
+static gint	sLargeSize	= 1024 * 1024;
+static gint	sChunkSize	= 4096;
+static gchar	*sByteSizes;
+
+static GOptionEntry sOptions[] = {
+	{ "scenario", 's', 0, G_OPTION_ARG_STRING, &sScenarios,
+	  "Scenarios to run, comma separated (default: all)", "LIST" },
+	{ "output", 'o', 0, G_OPTION_ARG_FILENAME, &sOutput,
+	  "JSON output file (default: stdout)", "FILE" },
+	{ "duration", 'D', 0, G_OPTION_ARG_INT, &sDuration,
+	  "Measurement window in ms (default: 1000)", "MS" },
+	{ "records", 'r', 0, G_OPTION_ARG_INT, &sRecords,
+	  "Records of the 'many' message (default: 1000)", "N" },
+	{ "large-size", 'L', 0, G_OPTION_ARG_INT, &sLargeSize,
+	  "Payload bytes of the large messages (default: 1048576)", "BYTES" },
+	{ "chunk-size", 'C', 0, G_OPTION_ARG_INT, &sChunkSize,
+	  "Chunk payload bytes of the chunked message (default: 4096)",
+	  "BYTES" },
+	{ "byte-sizes", 'B', 0, G_OPTION_ARG_STRING, &sByteSizes,
+	  "Payload bytes of the 'bytes' steps, comma separated "
+	  "(default: 1024,4096,16384,65536)", "LIST" },
+	{ NULL, 0, 0, 0, NULL, NULL, NULL }
+};
+
+/* Append one record (or chunk) to 'msg' */
+static void bench_ndef_prv_record(GByteArray *msg, guint8 flags,
+				  const gchar *type, const guint8 *payload,
+				  guint len)
+{
+	guint8	hdr[6];
+	guint	n = 0;
+	guint	typeLen = type != NULL ? strlen(type) : 0;
+
+	if (len < 256)
+		flags |= NEARDAL_NDEF_FLAG_SR;
+	hdr[n++] = flags;
+	hdr[n++] = typeLen;
+	if (flags & NEARDAL_NDEF_FLAG_SR)
+		hdr[n++] = len;
+	else {
+		hdr[n++] = len >> 24;
+		hdr[n++] = len >> 16;
+		hdr[n++] = len >> 8;
+		hdr[n++] = len;
+	}
+	g_byte_array_append(msg, hdr, n);
+	g_byte_array_append(msg, (const guint8 *) type, typeLen);
+	g_byte_array_append(msg, payload, len);
+}
+
+/* Smart Poster: URI and title */
+static GByteArray *bench_ndef_prv_small(void)
+{
+	static const guint8	uri[] = "\x01neardal.example.com/ndef";
+	static const guint8	title[] = "\x02" "enNEARDAL";
+	GByteArray		*sp = g_byte_array_new();
+	GByteArray		*msg = g_byte_array_new();
+
+	bench_ndef_prv_record(sp, NEARDAL_NDEF_FLAG_MB | 1, "U", uri,
+			      sizeof(uri) - 1);
+	bench_ndef_prv_record(sp, NEARDAL_NDEF_FLAG_ME | 1, "T", title,
+			      sizeof(title) - 1);
+	bench_ndef_prv_record(msg, NEARDAL_NDEF_FLAG_MB | NEARDAL_NDEF_FLAG_ME |
+			      1, "Sp", sp->data, sp->len);
+	g_byte_array_free(sp, TRUE);
+
+	return msg;
+}
+
+/* 'sRecords' short URI records */
+static GByteArray *bench_ndef_prv_many(void)
+{
+	static const guint8	uri[] = "\x03neardal.example.com/";
+	GByteArray		*msg = g_byte_array_new();
+	guint8			flags;
+	gint			i;
+
+	for (i = 0; i < sRecords; i++) {
+		flags = 1;
+		if (i == 0)
+			flags |= NEARDAL_NDEF_FLAG_MB;
+		if (i == sRecords - 1)
+			flags |= NEARDAL_NDEF_FLAG_ME;
+		bench_ndef_prv_record(msg, flags, "U", uri, sizeof(uri) - 1);
+	}
+
+	return msg;
+}
+
+/* One 'sLargeSize' MIME record, in one piece or in 'chunk' chunks */
+static GByteArray *bench_ndef_prv_large(guint chunk)
+{
+	GByteArray	*msg = g_byte_array_new();
+	guint8		*payload = g_malloc(sLargeSize);
+	guint		offset, len;
+	guint8		flags;
+
+	memset(payload, 0xA5, sLargeSize);
+	if (chunk == 0)
+		chunk = sLargeSize;
+
+	for (offset = 0; offset < (guint) sLargeSize; offset += len) {
+		len = MIN(chunk, sLargeSize - offset);
+		flags = offset == 0 ? NEARDAL_NDEF_FLAG_MB |
+				      NEARDAL_NDEF_TNF_MIME :
+				      NEARDAL_NDEF_TNF_UNCHANGED;
+		if (offset + len < (guint) sLargeSize)
+			flags |= NEARDAL_NDEF_FLAG_CF;
+		else
+			flags |= NEARDAL_NDEF_FLAG_ME;
+		bench_ndef_prv_record(msg, flags,
+				      offset == 0 ? "application/octet-stream" :
+				      NULL, payload + offset, len);
+	}
+	g_free(payload);
+
+	return msg;
+}
+
+/* Walk a whole message: records, nested messages and chunks */
+static gboolean bench_ndef_prv_walk(neardal_ndef_iter *iter,
+				    guint64 *records, guint64 *bytes)
+{
+	neardal_ndef_iter	nested;
+	neardal_ndef_record	rcd;
+	const unsigned char	*chunk;
+	unsigned int		offset, chunkLen;
+	errorCode_t		err;
+
+	while ((err = neardal_ndef_iter_next(iter, &rcd)) == NEARDAL_SUCCESS) {
+		(*records)++;
+		if (neardal_ndef_iter_nested(&nested, &rcd) == NEARDAL_SUCCESS &&
+		    !bench_ndef_prv_walk(&nested, records, bytes))
+			return FALSE;
+
+		offset = 0;
+		while (neardal_ndef_chunk_next(&rcd, &offset, &chunk,
+					       &chunkLen) == NEARDAL_SUCCESS)
+			*bytes += chunkLen;
+	}
+
+	return err == NEARDAL_ERROR_NO_RECORD;
+}
+
+/* Parse 'msg' over and over during the measurement window */
+static gboolean bench_ndef_prv_run(GByteArray *msg)
+{
+	neardal_ndef_iter	iter;
+	guint64			start, deadline, now, parses = 0;
+	guint64			records = 0, bytes = 0;
+	gsize			heap;
+	gboolean		ok = TRUE;
+
+	heap = bench_heap();
+	start = bench_now();
+	deadline = start + sDuration * 1000000ULL;
+	do {
+		neardal_ndef_iter_init(&iter, msg->data, msg->len);
+		ok = bench_ndef_prv_walk(&iter, &records, &bytes);
+		parses++;
+		now = (parses & 0xF) ? start : bench_now();
+	} while (ok && ((parses & 0xF) || now < deadline));
+	if (!ok)
+		now = bench_now();
+
+	bench_json_uint("messageBytes", msg->len);
+	bench_json_uint("recordsPerMessage", parses ? records / parses : 0);
+	bench_json_double("messagesPerSec", parses * 1e9 / (now - start));
+	bench_json_double("recordsPerSec", records * 1e9 / (now - start));
+	bench_json_double("MBPerSec", (gdouble) parses * msg->len * 1e3 /
+			  (now - start));
+	bench_json_double("payloadMBPerSec", bytes * 1e3 / (now - start));
+	bench_json_int("heapDelta", (gint64) bench_heap() - (gint64) heap);
+	g_byte_array_free(msg, TRUE);
+
+	return ok;
+}
+
+static gboolean bench_ndef_small(void)
+{
+	return bench_ndef_prv_run(bench_ndef_prv_small());
+}
+
+static gboolean bench_ndef_many(void)
+{
+	return bench_ndef_prv_run(bench_ndef_prv_many());
+}
+
+static gboolean bench_ndef_large(void)
+{
+	return bench_ndef_prv_run(bench_ndef_prv_large(0));
+}
+
+static gboolean bench_ndef_chunked(void)
+{
+	return bench_ndef_prv_run(bench_ndef_prv_large(sChunkSize));
+}
+
+/* 'ay' built one byte at a time (former neardal_tools_prv_add_dict_entry) */
+static GVariant *bench_ndef_prv_bytes_per_byte(const guint8 *data, gsize len)
+{
+	GVariantBuilder	builder;
+	gsize		i;
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE_BYTESTRING);
+	for (i = 0; i < len; i++)
+		g_variant_builder_add(&builder, "y", data[i]);
+
+	return g_variant_builder_end(&builder);
+}
+
+/* 'ay' built in one go (neardal_tools_prv_bytes) */
+static GVariant *bench_ndef_prv_bytes_bulk(const guint8 *data, gsize len)
+{
+#if GLIB_CHECK_VERSION(2, 32, 0)
+	return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, data, len,
+					 sizeof(guint8));
+#else
+	gpointer copy = g_memdup(data, len);
+
+	return g_variant_new_from_data(G_VARIANT_TYPE_BYTESTRING, copy, len,
+				       TRUE, g_free, copy);
+#endif
+}
+
+/* Encode {'NDEF': <ay>} requests from 'data' during the measurement
+ * window, returns the encoded MB per second */
+static gdouble bench_ndef_prv_encode(GVariant *(*bytes)(const guint8 *,
+							 gsize),
+				     const guint8 *data, gsize len)
+{
+	GVariantBuilder	builder;
+	GVariant	*request;
+	guint64		start, deadline, now, encodes = 0;
+
+	start = bench_now();
+	deadline = start + sDuration * 1000000ULL;
+	do {
+		g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+		g_variant_builder_add(&builder, "{sv}", "NDEF",
+				      bytes(data, len));
+		request = g_variant_ref_sink(g_variant_builder_end(&builder));
+		/* Serialized, as when sent over DBus */
+		g_variant_get_data(request);
+		g_variant_unref(request);
+		encodes++;
+		now = (encodes & 0xF) ? start : bench_now();
+	} while ((encodes & 0xF) || now < deadline);
+
+	return (gdouble) encodes * len * 1e3 / (now - start);
+}
+
+static gboolean bench_ndef_bytes(void)
+{
+	gint		*sizes, nbSizes, i;
+	guint8		*data;
+	gdouble		perByte, bulk;
+
+	sizes = bench_parse_list(sByteSizes ? sByteSizes :
+				 "1024,4096,16384,65536", &nbSizes);
+
+	bench_json_begin_array("steps");
+	for (i = 0; i < nbSizes; i++) {
+		if (sizes[i] <= 0)
+			continue;
+		data = g_malloc(sizes[i]);
+		memset(data, 0xA5, sizes[i]);
+
+		perByte = bench_ndef_prv_encode(bench_ndef_prv_bytes_per_byte,
+						data, sizes[i]);
+		bulk = bench_ndef_prv_encode(bench_ndef_prv_bytes_bulk, data,
+					     sizes[i]);
+		bench_json_begin(NULL);
+		bench_json_uint("payloadBytes", sizes[i]);
+		bench_json_double("perByteMBPerSec", perByte);
+		bench_json_double("bulkMBPerSec", bulk);
+		bench_json_double("speedup", perByte > 0 ? bulk / perByte : 0);
+		bench_json_end();
+		g_free(data);
+	}
+	bench_json_end_array();
+	g_free(sizes);
+
+	return TRUE;
+}
+
+static const BenchScenario sScenariosList[] = {
+	{ "small", "Smart Poster (URI and title) messages per second",
+	  bench_ndef_small },
+	{ "many", "messages of many short records per second",
+	  bench_ndef_many },
+	{ "large", "large single record messages per second",
+	  bench_ndef_large },
+	{ "chunked", "large chunked record messages per second",
+	  bench_ndef_chunked },
+	{ "bytes", "NDEF bytes encoded in neard requests, per byte and in bulk",
+	  bench_ndef_bytes },
+};
+
+static gboolean bench_ndef_prv_selected(const gchar *name)
+{
+	gchar		**names;
+	gboolean	selected = FALSE;
+	guint		i;
+
+	if (sScenarios == NULL)
+		return TRUE;
+
+	names = g_strsplit(sScenarios, ",", -1);
+	for (i = 0; names[i] != NULL && !selected; i++)
+		selected = !strcmp(names[i], name);
+	g_strfreev(names);
+
+	return selected;
+}
+
+int main(int argc, char *argv[])
+{
+	GOptionContext	*context;
+	GError		*error = NULL;
+	FILE		*fp = stdout;
+	guint		i;
+	int		ret = EXIT_SUCCESS;
+
+	context = g_option_context_new("- NEARDAL NDEF parser benchmarks");
+	g_option_context_add_main_entries(context, sOptions, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error)) {
+		g_printerr("%s\n", error->message);
+		g_error_free(error);
+		g_option_context_free(context);
+		return EXIT_FAILURE;
+	}
+	g_option_context_free(context);
+
+	if (sRecords < 1 || sLargeSize < 1 || sChunkSize < 1) {
+		g_printerr("Invalid message sizes\n");
+		return EXIT_FAILURE;
+	}
+
+	bench_json_begin(NULL);
+	bench_json_string("benchmark", "neardal-ndef");
+	bench_json_string("version", VERSION);
+	bench_json_begin("results");
+	for (i = 0; i < G_N_ELEMENTS(sScenariosList); i++) {
+		if (!bench_ndef_prv_selected(sScenariosList[i].name))
+			continue;
+
+		g_printerr("%s: %s...\n", sScenariosList[i].name,
+			   sScenariosList[i].description);
+		bench_json_begin(sScenariosList[i].name);
+		if (!sScenariosList[i].run()) {
+			bench_json_string("error", "failed");
+			ret = EXIT_FAILURE;
+		}
+		bench_json_end();
+	}
+	bench_json_end();
+	bench_json_end();
+
+	if (sOutput != NULL) {
+		fp = fopen(sOutput, "w");
+		if (fp == NULL) {
+			g_printerr("Can't open %s\n", sOutput);
+			return EXIT_FAILURE;
+		}
+	}
+	bench_json_output(fp);
+	if (fp != stdout)
+		fclose(fp);
+
+	return ret;
+}
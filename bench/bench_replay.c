@@ -0,0 +1,166 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* neardal-replay: replay a NEARDAL traffic capture on the in-process
+ * simulator and measure how fast the library goes through it, e.g.:
+ *   NEARDAL_CAPTURE=spike.cap ncl ...
+ *   bench/neardal-replay -o replay.json spike.cap */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "neardal_capture.h"
+#include "neardal_sim.h"
+
+#ifndef VERSION
+#define VERSION "unknown"
+#endif
+
+static gchar	*sOutput;
+static gboolean	sRealTime;
+static gint	sRuns = 5;
+
+static guint64	sTagsFound;
+static guint64	sTagsLost;
+static guint64	sRecordsFound;
+
+static GOptionEntry sOptions[] = {
+	{ "output", 'o', 0, G_OPTION_ARG_FILENAME, &sOutput,
+	  "JSON output file (default: stdout)", "FILE" },
+	{ "realtime", 'T', 0, G_OPTION_ARG_NONE, &sRealTime,
+	  "Respect captured event times (default: as fast as possible)",
+	  NULL },
+	{ "runs", 0, 0, G_OPTION_ARG_INT, &sRuns,
+	  "Replays of the capture (default: 5)", "N" },
+	{ NULL, 0, 0, 0, NULL, NULL, NULL }
+};
+
+static void bench_replay_prv_tag_found(const char *tagName, void *user_data)
+{
+	(void) tagName;
+	(void) user_data;
+	sTagsFound++;
+}
+
+static void bench_replay_prv_tag_lost(const char *tagName, void *user_data)
+{
+	(void) tagName;
+	(void) user_data;
+	sTagsLost++;
+}
+
+static void bench_replay_prv_record_found(const char *rcdName,
+					  void *user_data)
+{
+	(void) rcdName;
+	(void) user_data;
+	sRecordsFound++;
+}
+
+int main(int argc, char *argv[])
+{
+	GOptionContext	*context;
+	GError		*error = NULL;
+	FILE		*fp = stdout;
+	GArray		*samples;
+	guint64		start, t;
+	guint		events = 0;
+	gint		run;
+	errorCode_t	err = NEARDAL_SUCCESS;
+
+	context = g_option_context_new("CAPTURE - replay a NEARDAL capture");
+	g_option_context_add_main_entries(context, sOptions, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error)) {
+		g_printerr("%s\n", error->message);
+		g_error_free(error);
+		g_option_context_free(context);
+		return EXIT_FAILURE;
+	}
+	g_option_context_free(context);
+	if (argc != 2) {
+		g_printerr("Usage: %s [OPTION...] CAPTURE\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+
+	if (neardal_sim_enable(TRUE) != NEARDAL_SUCCESS ||
+	    neardal_set_cb_tag_found(bench_replay_prv_tag_found, NULL) !=
+	    NEARDAL_SUCCESS ||
+	    neardal_set_cb_tag_lost(bench_replay_prv_tag_lost, NULL) !=
+	    NEARDAL_SUCCESS ||
+	    neardal_set_cb_record_found(bench_replay_prv_record_found,
+					NULL) != NEARDAL_SUCCESS) {
+		g_printerr("NEARDAL simulator initialization failed\n");
+		return EXIT_FAILURE;
+	}
+
+	/* Every run starts from an empty topology */
+	samples = g_array_new(FALSE, FALSE, sizeof(guint64));
+	neardal_reset_stats();
+	for (run = 0; err == NEARDAL_SUCCESS && run < MAX(1, sRuns); run++) {
+		neardal_destroy();
+		start = bench_now();
+		err = neardal_replay(argv[1], sRealTime, &events);
+		t = bench_now() - start;
+		g_array_append_val(samples, t);
+	}
+
+	bench_json_begin(NULL);
+	bench_json_string("benchmark", "neardal-replay");
+	bench_json_string("version", VERSION);
+	bench_json_string("capture", argv[1]);
+	bench_json_begin("results");
+	bench_json_uint("events", events);
+	bench_json_uint("runs", samples->len);
+	bench_json_string("pace", sRealTime ? "realtime" : "max");
+	bench_json_uint("tagsFound", sTagsFound);
+	bench_json_uint("tagsLost", sTagsLost);
+	bench_json_uint("recordsFound", sRecordsFound);
+	bench_samples_sort(samples);
+	bench_json_samples("replayNs", samples);
+	bench_json_double("eventsPerSec", events * 1e9 /
+			  MAX(1, bench_samples_pct(samples, 50)));
+	bench_json_stats();
+	if (err != NEARDAL_SUCCESS)
+		bench_json_string("error", neardal_error_get_text(err));
+	bench_json_end();
+	bench_json_end();
+	g_array_free(samples, TRUE);
+
+	if (sOutput != NULL) {
+		fp = fopen(sOutput, "w");
+		if (fp == NULL) {
+			g_printerr("Can't open %s\n", sOutput);
+			return EXIT_FAILURE;
+		}
+	}
+	bench_json_output(fp);
+	if (fp != stdout)
+		fclose(fp);
+
+	neardal_destroy();
+
+	return err == NEARDAL_SUCCESS ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,578 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* neardal-bench-sim: NEARDAL benchmarks on the in-process simulator (no
+ * DBus, no neard): measures the library alone, deterministically, e.g.:
+ *   bench/neardal-bench-sim -o results.json */
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "neardal_sim.h"
+
+#ifndef VERSION
+#define VERSION "unknown"
+#endif
+
+#define BENCH_SIM_ADAPTER	"/org/neard/nfc0"
+
+static gchar	*sScenarios;
+static gchar	*sOutput;
+static gint	sCount		= 10000;
+static gint	sRecords	= 1;
+static gint	sDuration	= 1000;
+static gchar	*sSizes;
+static gchar	*sFieldSizes;
+
+static guint64	sTagsFound;
+static guint64	sTagsLost;
+static guint64	sRecordsFound;
+
+static GOptionEntry sOptions[] = {
+	{ "scenario", 's', 0, G_OPTION_ARG_STRING, &sScenarios,
+	  "Scenarios to run, comma separated (default: all)", "LIST" },
+	{ "output", 'o', 0, G_OPTION_ARG_FILENAME, &sOutput,
+	  "JSON output file (default: stdout)", "FILE" },
+	{ "count", 'c', 0, G_OPTION_ARG_INT, &sCount,
+	  "Tags per churn run (default: 10000)", "N" },
+	{ "records", 'r', 0, G_OPTION_ARG_INT, &sRecords,
+	  "Records per tag (default: 1)", "N" },
+	{ "duration", 'D', 0, G_OPTION_ARG_INT, &sDuration,
+	  "Measurement window in ms (default: 1000)", "MS" },
+	{ "sizes", 'S', 0, G_OPTION_ARG_STRING, &sSizes,
+	  "Topology sizes of lookup run (default: 10,100,1000,4000)",
+	  "LIST" },
+	{ "field-sizes", 0, 0, G_OPTION_ARG_STRING, &sFieldSizes,
+	  "Tags in the field of field run (default: 100,250,500,1000)",
+	  "LIST" },
+	{ NULL, 0, 0, 0, NULL, NULL, NULL }
+};
+
+static void bench_sim_prv_tag_found(const char *tagName, void *user_data)
+{
+	(void) tagName;
+	(void) user_data;
+	sTagsFound++;
+}
+
+static void bench_sim_prv_tag_lost(const char *tagName, void *user_data)
+{
+	(void) tagName;
+	(void) user_data;
+	sTagsLost++;
+}
+
+static void bench_sim_prv_record_found(const char *rcdName, void *user_data)
+{
+	(void) rcdName;
+	(void) user_data;
+	sRecordsFound++;
+}
+
+static gchar *bench_sim_prv_tag_name(guint i)
+{
+	return g_strdup_printf("%s/tag%u", BENCH_SIM_ADAPTER, i);
+}
+
+/* Make tag 'i' appear with its records */
+static gboolean bench_sim_prv_add_tag(guint i)
+{
+	neardal_record	rcd;
+	gchar		*tagName = bench_sim_prv_tag_name(i);
+	gboolean	ok;
+	gint		r;
+
+	ok = neardal_sim_add_tag(tagName, "Type 2", FALSE) == NEARDAL_SUCCESS;
+
+	memset(&rcd, 0, sizeof(rcd));
+	rcd.type = "URI";
+	rcd.uri = "http://www.example.com/neardal";
+	rcd.uriObjSize = strlen(rcd.uri);
+	for (r = 0; ok && r < sRecords; r++) {
+		rcd.name = g_strdup_printf("%s/record%d", tagName, r);
+		ok = neardal_sim_add_record(&rcd) == NEARDAL_SUCCESS;
+		g_free(rcd.name);
+	}
+	g_free(tagName);
+
+	return ok;
+}
+
+static gboolean bench_sim_prv_remove_tag(guint i)
+{
+	gchar		*tagName = bench_sim_prv_tag_name(i);
+	gboolean	ok;
+
+	ok = neardal_sim_remove_tag(tagName) == NEARDAL_SUCCESS;
+	g_free(tagName);
+
+	return ok;
+}
+
+/*****************************************************************************
+ * churn: tag + records found / tag lost events per second
+ ****************************************************************************/
+static gboolean bench_sim_churn(void)
+{
+	guint64		start, elapsed;
+	gboolean	ok = TRUE;
+	gint		i;
+
+	sTagsFound = sTagsLost = sRecordsFound = 0;
+
+	start = bench_now();
+	for (i = 0; ok && i < sCount; i++)
+		ok = bench_sim_prv_add_tag(i) && bench_sim_prv_remove_tag(i);
+	elapsed = bench_now() - start;
+
+	bench_json_uint("tags", sCount);
+	bench_json_uint("records", sRecords);
+	bench_json_uint("tagsFound", sTagsFound);
+	bench_json_uint("tagsLost", sTagsLost);
+	bench_json_uint("recordsFound", sRecordsFound);
+	bench_json_double("eventsPerSec",
+			  (sTagsFound + sTagsLost + sRecordsFound) * 1e9 /
+			  (elapsed ? elapsed : 1));
+
+	return ok && sTagsFound == (guint64) sCount &&
+	       sRecordsFound == (guint64) sCount * sRecords;
+}
+
+/* Call 'fn' on every tag, round robin, during the measurement window */
+static gdouble bench_sim_prv_calls_per_sec(guint nbTags,
+					   gboolean (*fn)(gchar *tagName))
+{
+	gchar	**tags = g_new0(gchar *, nbTags + 1);
+	guint64	start, deadline, now, calls = 0;
+	guint	i;
+
+	for (i = 0; i < nbTags; i++)
+		tags[i] = bench_sim_prv_tag_name(i);
+
+	start = bench_now();
+	deadline = start + sDuration * 1000000ULL;
+	do {
+		if (!fn(tags[calls % nbTags])) {
+			g_strfreev(tags);
+			return -1;
+		}
+		calls++;
+		now = (calls & 0xFF) ? start : bench_now();
+	} while ((calls & 0xFF) || now < deadline);
+	g_strfreev(tags);
+
+	return calls * 1e9 / (now - start);
+}
+
+static gboolean bench_sim_prv_get_tag_properties(gchar *tagName)
+{
+	neardal_tag *tag;
+
+	if (neardal_get_tag_properties(tagName, &tag) != NEARDAL_SUCCESS)
+		return FALSE;
+	neardal_free_tag(tag);
+
+	return TRUE;
+}
+
+static gboolean bench_sim_prv_get_records(gchar *tagName)
+{
+	char	**records;
+	int	len;
+
+	if (neardal_get_records(tagName, &records, &len) != NEARDAL_SUCCESS)
+		return FALSE;
+	neardal_free_array(&records);
+
+	return TRUE;
+}
+
+/*****************************************************************************
+ * lookup: get_tag_properties / get_records calls per second vs topology
+ ****************************************************************************/
+static gboolean bench_sim_lookup(void)
+{
+	gint		*sizes, nbSizes, i;
+	gint		present = 0;
+	gboolean	ok = TRUE;
+
+	sizes = bench_parse_list(sSizes ? sSizes : "10,100,1000,4000",
+				 &nbSizes);
+
+	bench_json_uint("records", sRecords);
+	bench_json_begin_array("steps");
+	for (i = 0; ok && i < nbSizes; i++) {
+		while (ok && present < sizes[i])
+			ok = bench_sim_prv_add_tag(present++);
+		if (!ok || sizes[i] <= 0)
+			continue;
+
+		bench_json_begin(NULL);
+		bench_json_uint("tags", sizes[i]);
+		bench_json_double("getTagPropertiesPerSec",
+				  bench_sim_prv_calls_per_sec(sizes[i],
+					bench_sim_prv_get_tag_properties));
+		bench_json_double("getRecordsPerSec",
+				  bench_sim_prv_calls_per_sec(sizes[i],
+					bench_sim_prv_get_records));
+		bench_json_end();
+	}
+	bench_json_end_array();
+
+	while (present > 0)
+		ok = bench_sim_prv_remove_tag(--present) && ok;
+	g_free(sizes);
+
+	return ok;
+}
+
+/*****************************************************************************
+ * write: neardal_tag_write() calls per second (record replaced in place)
+ ****************************************************************************/
+static gboolean bench_sim_write(void)
+{
+	neardal_record	rcd;
+	guint64		start, deadline, now, calls = 0;
+	gboolean	ok;
+
+	ok = bench_sim_prv_add_tag(0);
+
+	memset(&rcd, 0, sizeof(rcd));
+	rcd.name = bench_sim_prv_tag_name(0);
+	rcd.type = "Text";
+	rcd.encoding = "UTF-8";
+	rcd.language = "en";
+	rcd.representation = "neardal";
+
+	start = bench_now();
+	deadline = start + sDuration * 1000000ULL;
+	do {
+		ok = ok && neardal_tag_write(&rcd) == NEARDAL_SUCCESS;
+		calls++;
+		now = (calls & 0xFF) ? start : bench_now();
+	} while (ok && ((calls & 0xFF) || now < deadline));
+
+	bench_json_double("writesPerSec", calls * 1e9 / (now - start));
+
+	ok = bench_sim_prv_remove_tag(0) && ok;
+	g_free(rcd.name);
+
+	return ok;
+}
+
+/*****************************************************************************
+ * template: URI writes with a changing serial, rebuilt from a neardal_record
+ * for each write vs compiled once (neardal_record_template)
+ ****************************************************************************/
+static gboolean bench_sim_template(void)
+{
+	neardal_record		rcd;
+	neardal_record_template	*tmpl = NULL;
+	gchar			*tagName = bench_sim_prv_tag_name(0);
+	gchar			serial[16];
+	guint64			start, deadline, now, calls;
+	gboolean		ok;
+
+	ok = bench_sim_prv_add_tag(0);
+
+	memset(&rcd, 0, sizeof(rcd));
+	rcd.name = tagName;
+	rcd.type = "URI";
+
+	/* Record rebuilt for each write */
+	calls = 0;
+	start = bench_now();
+	deadline = start + sDuration * 1000000ULL;
+	do {
+		rcd.uri = g_strdup_printf("https://www.example.com/t/%08"
+					  G_GINT64_MODIFIER "x", calls);
+		ok = ok && neardal_tag_write(&rcd) == NEARDAL_SUCCESS;
+		g_free(rcd.uri);
+		calls++;
+		now = (calls & 0xFF) ? start : bench_now();
+	} while (ok && ((calls & 0xFF) || now < deadline));
+	bench_json_double("recordWritesPerSec", calls * 1e9 / (now - start));
+
+	/* Compiled record, serial appended to the URI */
+	rcd.uri = "https://www.example.com/t/";
+	ok = ok && neardal_record_template_new(&rcd, "URI", &tmpl) ==
+		   NEARDAL_SUCCESS;
+	calls = 0;
+	start = bench_now();
+	deadline = start + sDuration * 1000000ULL;
+	do {
+		g_snprintf(serial, sizeof(serial), "%08" G_GINT64_MODIFIER "x",
+			   calls);
+		ok = ok && neardal_tag_write_template(tagName, tmpl, serial) ==
+			   NEARDAL_SUCCESS;
+		calls++;
+		now = (calls & 0xFF) ? start : bench_now();
+	} while (ok && ((calls & 0xFF) || now < deadline));
+	bench_json_double("templateWritesPerSec",
+			  calls * 1e9 / (now - start));
+	neardal_record_template_free(tmpl);
+
+	ok = bench_sim_prv_remove_tag(0) && ok;
+	g_free(tagName);
+
+	return ok;
+}
+
+/* Set the adapter tags to 'nbTags' tags of 'pool' from 'first' (ring) */
+static gboolean bench_sim_prv_set_field(gchar **pool, guint poolLen,
+					const gchar **tags, guint first,
+					guint nbTags)
+{
+	guint	i;
+
+	for (i = 0; i < nbTags; i++)
+		tags[i] = pool[(first + i) % poolLen];
+	tags[nbTags] = NULL;
+
+	return neardal_sim_set_tags(BENCH_SIM_ADAPTER, tags) ==
+	       NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * alloc: tag + records found / tag lost cycle latency, with the allocations
+ * NEARDAL made (run once with NEARDAL_POOL=0 to compare with the heap)
+ ****************************************************************************/
+static gboolean bench_sim_alloc(void)
+{
+	neardal_stats	*before, *after;
+	GArray		*samples;
+	guint64		start, t;
+	const gchar	*pool = g_getenv("NEARDAL_POOL");
+	gboolean	ok = TRUE;
+	gint		i;
+
+	if (neardal_get_stats(&before) != NEARDAL_SUCCESS)
+		return FALSE;
+
+	sTagsFound = sTagsLost = sRecordsFound = 0;
+	samples = g_array_sized_new(FALSE, FALSE, sizeof(guint64), sCount);
+	for (i = 0; ok && i < sCount; i++) {
+		start = bench_now();
+		ok = bench_sim_prv_add_tag(i) && bench_sim_prv_remove_tag(i);
+		t = bench_now() - start;
+		g_array_append_val(samples, t);
+	}
+
+	if (neardal_get_stats(&after) != NEARDAL_SUCCESS) {
+		neardal_free_stats(before);
+		g_array_free(samples, TRUE);
+		return FALSE;
+	}
+
+	bench_json_string("pool", pool != NULL && !strcmp(pool, "0") ?
+			  "off" : "on");
+	bench_json_uint("tags", sCount);
+	bench_json_uint("records", sRecords);
+	bench_json_uint("allocs", after->poolAllocs - before->poolAllocs);
+	bench_json_uint("sysAllocs",
+			after->poolSysAllocs - before->poolSysAllocs);
+	bench_json_samples("cycle", samples);
+
+	neardal_free_stats(after);
+	neardal_free_stats(before);
+	g_array_free(samples, TRUE);
+
+	return ok && sTagsFound == (guint64) sCount &&
+	       sTagsLost == (guint64) sCount;
+}
+
+/*****************************************************************************
+ * field: adapter 'Tags' property updates per second with hundreds of tags
+ * in the field, a tenth of them replaced at each update (or none)
+ ****************************************************************************/
+static gboolean bench_sim_field(void)
+{
+	gint		*sizes, nbSizes, i;
+	gchar		**pool;
+	const gchar	**tags;
+	guint		n, shift, first, poolLen, j;
+	guint64		start, deadline, now, updates, found;
+	gboolean	ok = TRUE;
+
+	sizes = bench_parse_list(sFieldSizes ? sFieldSizes :
+				 "100,250,500,1000", &nbSizes);
+
+	bench_json_begin_array("steps");
+	for (i = 0; ok && i < nbSizes; i++) {
+		if (sizes[i] <= 0)
+			continue;
+		n = sizes[i];
+		shift = MAX(n / 10, 1);
+		poolLen = 2 * n;
+		pool = g_new0(gchar *, poolLen + 1);
+		for (j = 0; j < poolLen; j++)
+			pool[j] = bench_sim_prv_tag_name(j);
+		tags = g_new0(const gchar *, n + 1);
+
+		sTagsFound = sTagsLost = 0;
+		ok = bench_sim_prv_set_field(pool, poolLen, tags, 0, n);
+		bench_json_begin(NULL);
+		bench_json_uint("tags", n);
+		bench_json_uint("replaced", shift);
+
+		/* A tenth of the field replaced at each update */
+		first = updates = 0;
+		start = bench_now();
+		deadline = start + sDuration * 1000000ULL;
+		do {
+			first += shift;
+			ok = bench_sim_prv_set_field(pool, poolLen, tags,
+						     first, n);
+			updates++;
+			now = (updates & 0xF) ? start : bench_now();
+		} while (ok && ((updates & 0xF) || now < deadline));
+		bench_json_double("updatesPerSec",
+				  updates * 1e9 / (now - start));
+		found = n + updates * shift;
+
+		/* Same field: nothing found nor lost */
+		updates = 0;
+		start = bench_now();
+		deadline = start + sDuration * 1000000ULL;
+		do {
+			ok = ok && bench_sim_prv_set_field(pool, poolLen, tags,
+							   first, n);
+			updates++;
+			now = (updates & 0xF) ? start : bench_now();
+		} while (ok && ((updates & 0xF) || now < deadline));
+		bench_json_double("unchangedPerSec",
+				  updates * 1e9 / (now - start));
+
+		ok = ok && neardal_sim_set_tags(BENCH_SIM_ADAPTER, NULL) ==
+			   NEARDAL_SUCCESS;
+		bench_json_uint("tagsFound", sTagsFound);
+		bench_json_uint("tagsLost", sTagsLost);
+		bench_json_end();
+		ok = ok && sTagsFound == found && sTagsLost == found;
+
+		g_free(tags);
+		g_strfreev(pool);
+	}
+	bench_json_end_array();
+	g_free(sizes);
+
+	return ok;
+}
+
+static const BenchScenario sScenariosList[] = {
+	{ "churn", "tag and record events per second", bench_sim_churn },
+	{ "lookup", "lookup calls per second vs topology size",
+	  bench_sim_lookup },
+	{ "write", "tag write calls per second", bench_sim_write },
+	{ "template", "URI writes per second, record vs compiled template",
+	  bench_sim_template },
+	{ "field", "adapter 'Tags' updates per second vs tags in the field",
+	  bench_sim_field },
+	{ "alloc", "tag cycle latency and allocator calls", bench_sim_alloc },
+};
+
+static gboolean bench_sim_prv_selected(const gchar *name)
+{
+	gchar		**names;
+	gboolean	selected = FALSE;
+	guint		i;
+
+	if (sScenarios == NULL)
+		return TRUE;
+
+	names = g_strsplit(sScenarios, ",", -1);
+	for (i = 0; names[i] != NULL && !selected; i++)
+		selected = !strcmp(names[i], name);
+	g_strfreev(names);
+
+	return selected;
+}
+
+int main(int argc, char *argv[])
+{
+	GOptionContext	*context;
+	GError		*error = NULL;
+	FILE		*fp = stdout;
+	guint		i;
+	int		ret = EXIT_SUCCESS;
+
+	context = g_option_context_new("- NEARDAL benchmarks (simulator)");
+	g_option_context_add_main_entries(context, sOptions, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error)) {
+		g_printerr("%s\n", error->message);
+		g_error_free(error);
+		g_option_context_free(context);
+		return EXIT_FAILURE;
+	}
+	g_option_context_free(context);
+
+	if (neardal_sim_enable(TRUE) != NEARDAL_SUCCESS ||
+	    neardal_set_cb_tag_found(bench_sim_prv_tag_found, NULL) !=
+	    NEARDAL_SUCCESS ||
+	    neardal_set_cb_tag_lost(bench_sim_prv_tag_lost, NULL) !=
+	    NEARDAL_SUCCESS ||
+	    neardal_set_cb_record_found(bench_sim_prv_record_found, NULL) !=
+	    NEARDAL_SUCCESS ||
+	    neardal_sim_add_adapter(BENCH_SIM_ADAPTER) != NEARDAL_SUCCESS) {
+		g_printerr("NEARDAL simulator initialization failed\n");
+		return EXIT_FAILURE;
+	}
+
+	bench_json_begin(NULL);
+	bench_json_string("benchmark", "neardal-sim");
+	bench_json_string("version", VERSION);
+	bench_json_begin("results");
+	for (i = 0; i < G_N_ELEMENTS(sScenariosList); i++) {
+		if (!bench_sim_prv_selected(sScenariosList[i].name))
+			continue;
+
+		g_printerr("%s: %s...\n", sScenariosList[i].name,
+			   sScenariosList[i].description);
+		bench_json_begin(sScenariosList[i].name);
+		if (!sScenariosList[i].run()) {
+			bench_json_string("error", "failed");
+			ret = EXIT_FAILURE;
+		}
+		bench_json_end();
+	}
+	bench_json_end();
+	bench_json_end();
+
+	if (sOutput != NULL) {
+		fp = fopen(sOutput, "w");
+		if (fp == NULL) {
+			g_printerr("Can't open %s\n", sOutput);
+			return EXIT_FAILURE;
+		}
+	}
+	bench_json_output(fp);
+	if (fp != stdout)
+		fclose(fp);
+
+	neardal_destroy();
+
+	return ret;
+}
@@ -0,0 +1,374 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#ifdef HAVE_CONFIG_H
+#include <config.h>
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(HAVE_MALLINFO2) || defined(HAVE_MALLINFO)
+#include <malloc.h>
+#endif
+
+#include "bench.h"
+
+/* JSON document being built, and 'first member' flag of each open scope */
+static GString	*sJson;
+static gboolean	sFirst[32];
+static gint	sDepth;
+
+/*****************************************************************************
+ * bench_now: monotonic clock, in nanoseconds (same clock as neard-mock)
+ ****************************************************************************/
+guint64 bench_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (guint64) ts.tv_sec * 1000000000ULL + (guint64) ts.tv_nsec;
+}
+
+/*****************************************************************************
+ * bench_rss: resident set size of the process, in bytes
+ ****************************************************************************/
+gsize bench_rss(void)
+{
+	FILE		*fp;
+	unsigned long	size, resident = 0;
+
+	fp = fopen("/proc/self/statm", "r");
+	if (fp == NULL)
+		return 0;
+	if (fscanf(fp, "%lu %lu", &size, &resident) != 2)
+		resident = 0;
+	fclose(fp);
+
+	return (gsize) resident * (gsize) sysconf(_SC_PAGESIZE);
+}
+
+/*****************************************************************************
+ * bench_heap: bytes allocated from the heap (malloc arenas and mmap()ed
+ * chunks), 0 when the C library can't tell
+ ****************************************************************************/
+gsize bench_heap(void)
+{
+#if defined(HAVE_MALLINFO2)
+	struct mallinfo2 mi = mallinfo2();
+
+	return mi.uordblks + mi.hblkhd;
+#elif defined(HAVE_MALLINFO)
+	struct mallinfo mi = mallinfo();
+
+	/* int fields: wrap around past 2 GiB */
+	return (gsize) (unsigned int) mi.uordblks +
+	       (gsize) (unsigned int) mi.hblkhd;
+#else
+	return 0;
+#endif
+}
+
+static gint bench_prv_cmp_u64(gconstpointer a, gconstpointer b)
+{
+	guint64 x = *(const guint64 *) a, y = *(const guint64 *) b;
+
+	return x < y ? -1 : x > y;
+}
+
+/*****************************************************************************
+ * bench_samples_sort: sort guint64 samples (before bench_samples_pct())
+ ****************************************************************************/
+void bench_samples_sort(GArray *samples)
+{
+	g_array_sort(samples, bench_prv_cmp_u64);
+}
+
+/*****************************************************************************
+ * bench_samples_pct: 'pct' percentile of sorted samples (nearest rank)
+ ****************************************************************************/
+guint64 bench_samples_pct(GArray *samples, gdouble pct)
+{
+	guint rank;
+
+	if (samples->len == 0)
+		return 0;
+
+	rank = (guint) (pct / 100.0 * samples->len + 0.5);
+	if (rank > 0)
+		rank--;
+	if (rank >= samples->len)
+		rank = samples->len - 1;
+
+	return g_array_index(samples, guint64, rank);
+}
+
+/*****************************************************************************
+ * bench_parse_list: parse comma separated integers (release with g_free())
+ ****************************************************************************/
+gint *bench_parse_list(const gchar *list, gint *len)
+{
+	gchar	**items = g_strsplit(list, ",", -1);
+	gint	*values, i;
+
+	*len = g_strv_length(items);
+	values = g_new0(gint, *len);
+	for (i = 0; i < *len; i++)
+		values[i] = atoi(items[i]);
+	g_strfreev(items);
+
+	return values;
+}
+
+/*---------------------------------------------------------------------------
+ * JSON output
+ ---------------------------------------------------------------------------*/
+static void bench_json_prv_member(const gchar *name)
+{
+	gint i;
+
+	if (sJson == NULL)
+		sJson = g_string_new(NULL);
+
+	if (sDepth > 0) {
+		if (!sFirst[sDepth])
+			g_string_append_c(sJson, ',');
+		g_string_append_c(sJson, '\n');
+	}
+	sFirst[sDepth] = FALSE;
+
+	for (i = 0; i < sDepth; i++)
+		g_string_append(sJson, "  ");
+	if (name != NULL)
+		g_string_append_printf(sJson, "\"%s\": ", name);
+}
+
+static void bench_json_prv_open(const gchar *name, gchar c)
+{
+	bench_json_prv_member(name);
+	g_string_append_c(sJson, c);
+	sFirst[++sDepth] = TRUE;
+}
+
+static void bench_json_prv_close(gchar c)
+{
+	gint i;
+
+	g_string_append_c(sJson, '\n');
+	for (i = 1; i < sDepth; i++)
+		g_string_append(sJson, "  ");
+	g_string_append_c(sJson, c);
+	sDepth--;
+}
+
+/*****************************************************************************
+ * bench_json_begin: open an object ('name' NULL at top level or in arrays)
+ ****************************************************************************/
+void bench_json_begin(const gchar *name)
+{
+	bench_json_prv_open(name, '{');
+}
+
+/*****************************************************************************
+ * bench_json_end: close current object
+ ****************************************************************************/
+void bench_json_end(void)
+{
+	bench_json_prv_close('}');
+}
+
+/*****************************************************************************
+ * bench_json_begin_array: open an array
+ ****************************************************************************/
+void bench_json_begin_array(const gchar *name)
+{
+	bench_json_prv_open(name, '[');
+}
+
+/*****************************************************************************
+ * bench_json_end_array: close current array
+ ****************************************************************************/
+void bench_json_end_array(void)
+{
+	bench_json_prv_close(']');
+}
+
+/*****************************************************************************
+ * bench_json_int/uint/double/string: add a member to current object
+ ****************************************************************************/
+void bench_json_int(const gchar *name, gint64 value)
+{
+	bench_json_prv_member(name);
+	g_string_append_printf(sJson, "%" G_GINT64_FORMAT, value);
+}
+
+void bench_json_uint(const gchar *name, guint64 value)
+{
+	bench_json_prv_member(name);
+	g_string_append_printf(sJson, "%" G_GUINT64_FORMAT, value);
+}
+
+void bench_json_double(const gchar *name, gdouble value)
+{
+	bench_json_prv_member(name);
+	g_string_append_printf(sJson, "%.3f", value);
+}
+
+void bench_json_string(const gchar *name, const gchar *value)
+{
+	gchar *escaped;
+
+	bench_json_prv_member(name);
+	if (value == NULL) {
+		g_string_append(sJson, "null");
+		return;
+	}
+	escaped = g_strescape(value, NULL);
+	g_string_append_printf(sJson, "\"%s\"", escaped);
+	g_free(escaped);
+}
+
+/*****************************************************************************
+ * bench_json_samples: add latency summary of guint64 ns samples (sorted)
+ ****************************************************************************/
+void bench_json_samples(const gchar *name, GArray *samples)
+{
+	guint64	sum = 0;
+	guint	i;
+
+	bench_samples_sort(samples);
+	for (i = 0; i < samples->len; i++)
+		sum += g_array_index(samples, guint64, i);
+
+	bench_json_begin(name);
+	bench_json_uint("count", samples->len);
+	bench_json_uint("minNs", bench_samples_pct(samples, 0));
+	bench_json_uint("meanNs", samples->len ? sum / samples->len : 0);
+	bench_json_uint("p50Ns", bench_samples_pct(samples, 50));
+	bench_json_uint("p90Ns", bench_samples_pct(samples, 90));
+	bench_json_uint("p99Ns", bench_samples_pct(samples, 99));
+	bench_json_uint("p999Ns", bench_samples_pct(samples, 99.9));
+	bench_json_uint("maxNs", bench_samples_pct(samples, 100));
+	bench_json_end();
+}
+
+/*****************************************************************************
+ * bench_json_latency: add a NEARDAL latency summary
+ ****************************************************************************/
+void bench_json_latency(const neardal_latency *lat)
+{
+	bench_json_begin(lat->name);
+	bench_json_uint("count", lat->count);
+	bench_json_uint("errors", lat->errors);
+	bench_json_uint("minNs", lat->minNs);
+	bench_json_uint("meanNs", lat->count ? lat->sumNs / lat->count : 0);
+	bench_json_uint("p50Ns", lat->p50Ns);
+	bench_json_uint("p90Ns", lat->p90Ns);
+	bench_json_uint("p99Ns", lat->p99Ns);
+	bench_json_uint("p999Ns", lat->p999Ns);
+	bench_json_uint("maxNs", lat->maxNs);
+	bench_json_end();
+}
+
+/*****************************************************************************
+ * bench_json_stats: add NEARDAL own counters and latencies (neardal_stats)
+ ****************************************************************************/
+void bench_json_stats(void)
+{
+	neardal_stats	*stats;
+	int		i;
+
+	if (neardal_get_stats(&stats) != NEARDAL_SUCCESS)
+		return;
+
+	bench_json_begin("neardal");
+	bench_json_uint("tagsFound", stats->tagsFound);
+	bench_json_uint("tagsLost", stats->tagsLost);
+	bench_json_uint("recordsFound", stats->recordsFound);
+	bench_json_uint("recordsLost", stats->recordsLost);
+	bench_json_uint("poolAllocs", stats->poolAllocs);
+	bench_json_uint("poolSysAllocs", stats->poolSysAllocs);
+	bench_json_begin("stages");
+	for (i = 0; i < NEARDAL_STATS_STAGE_COUNT; i++)
+		if (stats->stages[i].count > 0)
+			bench_json_latency(&stats->stages[i]);
+	bench_json_end();
+	bench_json_begin("ops");
+	for (i = 0; i < NEARDAL_STATS_OP_COUNT; i++)
+		if (stats->ops[i].count > 0)
+			bench_json_latency(&stats->ops[i]);
+	bench_json_end();
+	bench_json_begin("startup");
+	for (i = 0; i < NEARDAL_STATS_STARTUP_COUNT; i++)
+		if (stats->startup[i].count > 0)
+			bench_json_latency(&stats->startup[i]);
+	bench_json_end();
+	bench_json_end();
+
+	neardal_free_stats(stats);
+}
+
+/*****************************************************************************
+ * bench_json_output: write JSON document
+ ****************************************************************************/
+void bench_json_output(FILE *fp)
+{
+	if (sJson == NULL)
+		return;
+	fprintf(fp, "%s\n", sJson->str);
+	fflush(fp);
+}
+
+/*****************************************************************************
+ * bench_iterate: dispatch all pending events without blocking
+ ****************************************************************************/
+void bench_iterate(void)
+{
+	while (g_main_context_iteration(NULL, FALSE))
+		;
+}
+
+static gboolean bench_prv_expired(gpointer user_data)
+{
+	*(gboolean *) user_data = TRUE;
+
+	return FALSE;
+}
+
+/*****************************************************************************
+ * bench_wait: run main loop until 'cond' is true or 'timeout' (ms) expires
+ ****************************************************************************/
+gboolean bench_wait(gboolean (*cond)(gpointer), gpointer data, gint timeout)
+{
+	gboolean	expired = FALSE;
+	guint		id;
+
+	id = g_timeout_add(timeout, bench_prv_expired, &expired);
+	while (!cond(data) && !expired)
+		g_main_context_iteration(NULL, TRUE);
+	if (!expired)
+		g_source_remove(id);
+
+	return cond(data);
+}
@@ -20,6 +20,8 @@
  */
 
 #include <stdio.h>
+#include <stddef.h>
+#include <stdlib.h>
 #include <unistd.h>
 #include <string.h>
 
@@ -29,13 +31,10 @@
 #include "neard_adapter_proxy.h"
 
 #include "neardal.h"
+#include "neardal_capture.h"
 #include "neardal_prv.h"
 
-#define	ADP_MODE_INITIATOR		"Initiator"
-#define	ADP_MODE_TARGET			"Target"
-#define	ADP_MODE_DUAL			"Dual"
-
-neardalCtx neardalMgr = {.proxy = NULL};
+neardalCtx neardalMgr = {.backend = NULL};
 
 /*---------------------------------------------------------------------------
  * Context Management
@@ -47,39 +46,28 @@ neardalCtx neardalMgr = {.proxy = NULL};
 void neardal_prv_construct(errorCode_t *ec)
 {
 	errorCode_t	err = NEARDAL_SUCCESS;
+	guint64		start;
 
-	if (neardalMgr.proxy != NULL)
+	if (neardalMgr.constructed)
 		goto exit;
 
 	NEARDAL_TRACEIN();
-	memset(&neardalMgr.conn, 0, sizeof(neardalCtx) - sizeof(neardalCb));
-
-	/* Create DBUS connection */
-	neardalMgr.conn = g_bus_get_sync(NEARDAL_DBUS_TYPE, NULL,
-					   &neardalMgr.gerror);
-	if (neardalMgr.conn != NULL) {
-		err = neardal_agent_acquire_dbus_name();
-		if (err != NEARDAL_SUCCESS)
-			NEARDAL_TRACE_ERR("Agent not managed!\n");
-
-		/* We have a DBUS connection, create proxy on Neard Manager */
-		err =  neardal_mgr_create();
-		if (err != NEARDAL_SUCCESS) {
-			NEARDAL_TRACEF(
-				"neardal_mgr_create() exit (err %d: %s)\n",
-				err, neardal_error_get_text(err));
-
-		}
-		/* No Neard daemon, destroying neardal object... */
-		if (err != NEARDAL_SUCCESS)
-			goto exit;
-
-	} else {
-		NEARDAL_TRACE_ERR("Unable to connect to dbus: %s\n",
-				 neardalMgr.gerror->message);
-		neardal_tools_prv_free_gerror(&neardalMgr.gerror);
-		err = NEARDAL_ERROR_DBUS;
-	}
+	/* Callbacks and backend selection survive a reconstruction */
+	memset((gchar *) &neardalMgr + offsetof(neardalCtx, conn), 0,
+	       sizeof(neardalCtx) - offsetof(neardalCtx, conn));
+
+	/* Capture requested from the environment */
+	if (neardal_capture_fp == NULL && getenv("NEARDAL_CAPTURE") != NULL)
+		neardal_capture_start(getenv("NEARDAL_CAPTURE"));
+
+	/* Connect to Neard (DBus) or start the simulator */
+	start = neardal_metrics_prv_now();
+	err =  neardal_mgr_create();
+	neardal_metrics_prv_startup(NEARDAL_STATS_STARTUP_TOTAL, start,
+				    err != NEARDAL_SUCCESS);
+	if (err != NEARDAL_SUCCESS)
+		NEARDAL_TRACEF("neardal_mgr_create() exit (err %d: %s)\n",
+			       err, neardal_error_get_text(err));
 
 exit:
 	if (ec != NULL)
@@ -99,9 +87,11 @@ exit:
 void neardal_destroy(void)
 {
 	NEARDAL_TRACEIN();
-	if (neardalMgr.proxy != NULL) {
+	if (neardalMgr.constructed) {
 		neardal_tools_prv_free_gerror(&neardalMgr.gerror);
+		neardal_tag_prv_auto_write_clear();
 		neardal_mgr_destroy();
+		neardal_pool_prv_destroy();
 	}
 	neardal_agent_stop_owning_dbus_name();
 }
@@ -117,7 +107,7 @@ errorCode_t neardal_set_cb_adapter_added(adapter_cb cb_adp_added,
 	neardalMgr.cb.adp_added		= cb_adp_added;
 	neardalMgr.cb.adp_added_ud	= user_data;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(NULL);
 
 	return NEARDAL_SUCCESS;
@@ -135,7 +125,7 @@ errorCode_t neardal_set_cb_adapter_removed(adapter_cb cb_adp_removed,
 	neardalMgr.cb.adp_removed	= cb_adp_removed;
 	neardalMgr.cb.adp_removed_ud	= user_data;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(NULL);
 
 	return NEARDAL_SUCCESS;
@@ -153,7 +143,7 @@ errorCode_t neardal_set_cb_adapter_property_changed(
 	neardalMgr.cb.adp_prop_changed		= cb_adp_property_changed;
 	neardalMgr.cb.adp_prop_changed_ud	= user_data;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(NULL);
 
 	return NEARDAL_SUCCESS;
@@ -170,7 +160,7 @@ errorCode_t neardal_set_cb_tag_found(tag_cb cb_tag_found,
 	neardalMgr.cb.tag_found		= cb_tag_found;
 	neardalMgr.cb.tag_found_ud	= user_data;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(NULL);
 
 	return NEARDAL_SUCCESS;
@@ -187,12 +177,87 @@ errorCode_t neardal_set_cb_tag_lost(tag_cb cb_tag_lost,
 	neardalMgr.cb.tag_lost		= cb_tag_lost;
 	neardalMgr.cb.tag_lost_ud	= user_data;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
+		neardal_prv_construct(NULL);
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_set_cb_tag_trace: setup a client callback receiving tag detection
+ * timestamps when the tag is lost.
+ * cb_tag_trace = NULL to remove actual callback.
+ ****************************************************************************/
+errorCode_t neardal_set_cb_tag_trace(tag_trace_cb cb_tag_trace,
+				     void *user_data)
+{
+	neardalMgr.cb.tag_trace		= cb_tag_trace;
+	neardalMgr.cb.tag_trace_ud	= user_data;
+
+	if (!neardalMgr.constructed)
+		neardal_prv_construct(NULL);
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_set_cb_auto_write: setup a client callback receiving the outcome of
+ * the automatic writes.
+ * cb_auto_write = NULL to remove actual callback.
+ ****************************************************************************/
+errorCode_t neardal_set_cb_auto_write(auto_write_cb cb_auto_write,
+				      void *user_data)
+{
+	neardalMgr.cb.auto_write	= cb_auto_write;
+	neardalMgr.cb.auto_write_ud	= user_data;
+
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(NULL);
 
 	return NEARDAL_SUCCESS;
 }
 
+/*****************************************************************************
+ * neardal_get_tag_trace: Get detection timestamps of a specific NEARDAL tag
+ ****************************************************************************/
+errorCode_t neardal_get_tag_trace(const char *tagName,
+				  neardal_tag_trace **trace)
+{
+	errorCode_t	err		= NEARDAL_SUCCESS;
+	TagProp		*tagProp	= NULL;
+
+	if (!neardalMgr.constructed)
+		neardal_prv_construct(&err);
+
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	if (tagName == NULL || trace == NULL)
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	if (!(tagProp = neardal_mgr_tag_search(tagName)))
+		return NEARDAL_ERROR_NO_TAG;
+
+	return neardal_tag_prv_get_trace(tagProp, trace);
+}
+
+/*****************************************************************************
+ * neardal_free_tag_trace: Release memory allocated by neardal_get_tag_trace()
+ ****************************************************************************/
+void neardal_free_tag_trace(neardal_tag_trace *trace)
+{
+	int	ct;
+
+	if (trace == NULL)
+		return;
+
+	for (ct = 0; ct < trace->nbRecords && trace->records != NULL; ct++)
+		g_free(trace->records[ct].name);
+	g_free(trace->records);
+	g_free(trace->name);
+	g_free(trace);
+}
+
 /*****************************************************************************
  * neardal_set_cb_dev_found: setup a client callback for
  * 'NEARDAL DEVICE FOUND'.
@@ -204,7 +269,7 @@ errorCode_t neardal_set_cb_dev_found(dev_cb cb_dev_found,
 	neardalMgr.cb.dev_found		= cb_dev_found;
 	neardalMgr.cb.dev_found_ud	= user_data;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(NULL);
 
 	return NEARDAL_SUCCESS;
@@ -221,7 +286,7 @@ errorCode_t neardal_set_cb_dev_lost(dev_cb cb_dev_lost,
 	neardalMgr.cb.dev_lost		= cb_dev_lost;
 	neardalMgr.cb.dev_lost_ud	= user_data;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(NULL);
 
 	return NEARDAL_SUCCESS;
@@ -239,7 +304,7 @@ errorCode_t neardal_set_cb_record_found(record_cb cb_rcd_found,
 	neardalMgr.cb.rcd_found		= cb_rcd_found;
 	neardalMgr.cb.rcd_found_ud	= user_data;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(NULL);
 
 	return NEARDAL_SUCCESS;
@@ -322,7 +387,7 @@ errorCode_t neardal_get_adapters(char ***array, int *len)
 	AdpProp		*adapter	= NULL;
 	gsize		size;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(&err);
 
 	if (err != NEARDAL_SUCCESS || array == NULL)
@@ -400,7 +465,7 @@ errorCode_t neardal_get_adapter_properties(const char *adpName,
 	int		ct		= 0;	/* counter */
 	gsize		size;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(&err);
 
 	if (err != NEARDAL_SUCCESS || adpName == NULL || adapter == NULL)
@@ -478,10 +543,10 @@ errorCode_t neardal_set_adapter_property(const char *adpName,
 	errorCode_t	err		= NEARDAL_SUCCESS;
 	AdpProp		*adpProp	= NULL;
 	const gchar	*propKey	= NULL;
-	GVariant	*propValue	= NULL;
 	GVariant	*variantTmp	= NULL;
+	guint64		start;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(&err);
 
 	if (err != NEARDAL_SUCCESS || adpName == NULL)
@@ -501,29 +566,19 @@ errorCode_t neardal_set_adapter_property(const char *adpName,
 		break;
 	}
 
-	propValue = g_variant_new_variant(variantTmp);
-	g_variant_ref_sink(propValue);
-	NEARDAL_TRACE_LOG("Sending:\n%s=%s\n", propKey,
-			  g_variant_print(propValue, TRUE));
-
-	properties_call_set_sync(adpProp->props, "org.neard.Adapter",
-				propKey, propValue, 0, &neardalMgr.gerror);
-
-	if (neardalMgr.gerror == NULL)
-		err = NEARDAL_SUCCESS;
-	else {
-		NEARDAL_TRACE_ERR(
-			"DBUS Error (%d): %s\n",
-				 neardalMgr.gerror->code,
-				neardalMgr.gerror->message);
-		err = NEARDAL_ERROR_DBUS_INVOKE_METHOD_ERROR;
+	if (propKey == NULL) {
+		err = NEARDAL_ERROR_INVALID_PARAMETER;
+		goto exit;
 	}
 
+	start = neardal_metrics_prv_now();
+	err = neardalMgr.backend->adp_set(adpProp, propKey, variantTmp);
+	neardal_metrics_prv_op(NEARDAL_STATS_OP_SET, start,
+			       err != NEARDAL_SUCCESS);
+
 exit:
-	neardal_tools_prv_free_gerror(&neardalMgr.gerror);
-	neardalMgr.gerror = NULL;
-	g_variant_unref(propValue);
-	g_variant_unref(variantTmp);
+	if (variantTmp != NULL)
+		g_variant_unref(variantTmp);
 	return err;
 }
 
@@ -534,8 +589,10 @@ errorCode_t neardal_start_poll_loop(char *adpName, int mode)
 {
 	errorCode_t	err		= NEARDAL_SUCCESS;
 	AdpProp		*adpProp	= NULL;
+	const gchar	*modeName	= ADP_MODE_INITIATOR;
+	guint64		start;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(&err);
 	if (err != NEARDAL_SUCCESS)
 		return err;
@@ -545,41 +602,20 @@ errorCode_t neardal_start_poll_loop(char *adpName, int mode)
 	if (adpProp == NULL)
 		goto exit;
 
-	if (adpProp->proxy == NULL)
-		goto exit;
-
 	if (adpProp->polling) {
 		err = NEARDAL_ERROR_POLLING_ALREADY_ACTIVE;
 		goto exit;
 	}
 
-	if (mode == NEARD_ADP_MODE_INITIATOR)
-		org_neard_adapter_call_start_poll_loop_sync(adpProp->proxy,
-							ADP_MODE_INITIATOR,
-							NULL,
-							&neardalMgr.gerror);
-	else if (mode == NEARD_ADP_MODE_TARGET)
-		org_neard_adapter_call_start_poll_loop_sync(adpProp->proxy,
-							ADP_MODE_TARGET, NULL,
-							&neardalMgr.gerror);
+	if (mode == NEARD_ADP_MODE_TARGET)
+		modeName = ADP_MODE_TARGET;
 	else if (mode == NEARD_ADP_MODE_DUAL)
-		org_neard_adapter_call_start_poll_loop_sync(adpProp->proxy,
-							ADP_MODE_DUAL, NULL,
-							&neardalMgr.gerror);
-	else
-		org_neard_adapter_call_start_poll_loop_sync(adpProp->proxy
-							, ADP_MODE_INITIATOR
-							, NULL,
-							&neardalMgr.gerror);
+		modeName = ADP_MODE_DUAL;
 
-	if (neardalMgr.gerror != NULL) {
-		NEARDAL_TRACE_ERR(
-			"Error with neard dbus method (err:%d:'%s')\n"
-				, neardalMgr.gerror->code
-				, neardalMgr.gerror->message);
-		err = NEARDAL_ERROR_DBUS_INVOKE_METHOD_ERROR;
-		neardal_tools_prv_free_gerror(&neardalMgr.gerror);
-	}
+	start = neardal_metrics_prv_now();
+	err = neardalMgr.backend->adp_poll(adpProp, modeName);
+	neardal_metrics_prv_op(NEARDAL_STATS_OP_START_POLL_LOOP, start,
+			       err != NEARDAL_SUCCESS);
 
 exit:
 	return err;
@@ -592,8 +628,9 @@ errorCode_t neardal_stop_poll(char *adpName)
 {
 	errorCode_t	err = NEARDAL_SUCCESS;
 	AdpProp		*adpProp	= NULL;
+	guint64		start;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(&err);
 
 	if (err == NEARDAL_SUCCESS)
@@ -602,22 +639,11 @@ errorCode_t neardal_stop_poll(char *adpName)
 	if (adpProp == NULL)
 		goto exit;
 
-	if (adpProp->proxy == NULL)
-		goto exit;
-
 	if (adpProp->polling) {
-		org_neard_adapter_call_stop_poll_loop_sync(adpProp->proxy, NULL,
-						   &neardalMgr.gerror);
-
-		err = NEARDAL_SUCCESS;
-		if (neardalMgr.gerror != NULL) {
-			NEARDAL_TRACE_ERR(
-				"Error with neard dbus method (err:%d:'%s')\n"
-					, neardalMgr.gerror->code
-					, neardalMgr.gerror->message);
-			err = NEARDAL_ERROR_DBUS_INVOKE_METHOD_ERROR;
-			neardal_tools_prv_free_gerror(&neardalMgr.gerror);
-		}
+		start = neardal_metrics_prv_now();
+		err = neardalMgr.backend->adp_poll(adpProp, NULL);
+		neardal_metrics_prv_op(NEARDAL_STATS_OP_STOP_POLL_LOOP, start,
+				       err != NEARDAL_SUCCESS);
 	}
 
 exit:
@@ -641,7 +667,7 @@ errorCode_t neardal_get_tags(char *adpName, char ***array, int *len)
 	TagProp		*tag		= NULL;
 
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(&err);
 	else
 		err = NEARDAL_ERROR_NO_TAG;
@@ -723,7 +749,7 @@ errorCode_t neardal_get_tag_properties(const char *tagName,
 	RcdProp		*record		= NULL;
 	gsize		size;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(&err);
 
 	if (err != NEARDAL_SUCCESS || tagName == NULL || tag == NULL)
@@ -747,7 +773,7 @@ errorCode_t neardal_get_tag_properties(const char *tagName,
 	tagClient->name		= g_strdup(tagProp->name);
 	tagClient->type		= g_strdup(tagProp->type);
 	tagClient->readOnly	= (short) tagProp->readOnly;
-	tagClient->nbRecords	= (int) tagProp->rcdLen;
+	tagClient->nbRecords	= (int) tagProp->rcds.len;
 	if (tagClient->nbRecords > 0) {
 		err = NEARDAL_ERROR_NO_MEMORY;
 		size = (tagClient->nbRecords + 1) * sizeof(char *);
@@ -755,12 +781,9 @@ errorCode_t neardal_get_tag_properties(const char *tagName,
 		if (tagClient->records == NULL)
 			goto exit;
 
-		ct = 0;
-		while (ct < tagClient->nbRecords) {
-			record = g_list_nth_data(tagProp->rcdList, ct);
-			if (record != NULL)
-				tagClient->records[ct] = g_strdup(record->name);
-			ct++;
+		for (ct = 0; ct < tagClient->nbRecords; ct++) {
+			record = &tagProp->rcds.rcds[ct];
+			tagClient->records[ct] = g_strdup(record->name);
 		}
 		err = NEARDAL_SUCCESS;
 	}
@@ -812,7 +835,7 @@ errorCode_t neardal_get_devices(char *adpName, char ***array, int *len)
 	DevProp		*dev		= NULL;
 
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(&err);
 	else
 		err = NEARDAL_ERROR_NO_DEV;
@@ -888,7 +911,7 @@ errorCode_t neardal_get_dev_properties(const char *devName,
 	RcdProp		*record		= NULL;
 	gsize		size;
 
-	if (neardalMgr.proxy == NULL)
+	if (!neardalMgr.constructed)
 		neardal_prv_construct(&err);
 
 	if (err != NEARDAL_SUCCESS || devName == NULL || dev == NULL)
@@ -911,7 +934,7 @@ errorCode_t neardal_get_dev_properties(const char *devName,
 		goto exit;
 
 	devClient->name		= g_strdup(devProp->name);
-	devClient->nbRecords	= (int) devProp->rcdLen;
+	devClient->nbRecords	= (int) devProp->rcds.len;
 	if (devClient->nbRecords > 0) {
 		err = NEARDAL_ERROR_NO_MEMORY;
 		size = (devClient->nbRecords + 1) * sizeof(char *);
@@ -919,12 +942,9 @@ errorCode_t neardal_get_dev_properties(const char *devName,
 		if (devClient->records == NULL)
 			goto exit;
 
-		ct = 0;
-		while (ct < devClient->nbRecords) {
-			record = g_list_nth_data(devProp->rcdList, ct);
-			if (record != NULL)
-				devClient->records[ct++] = g_strdup(
-								record->name);
+		for (ct = 0; ct < devClient->nbRecords; ct++) {
+			record = &devProp->rcds.rcds[ct];
+			devClient->records[ct] = g_strdup(record->name);
 		}
 		err = NEARDAL_SUCCESS;
 	}
@@ -999,18 +1019,19 @@ exit:
  * NFC Agent Management
  ---------------------------------------------------------------------------*/
 /*****************************************************************************
- * neardal_agent_set_NDEF_cb: register or unregister a callback to handle a
- * record macthing a registered tag type. This callback will received the
- * whole NDEF as a raw byte stream and the records object paths.
- * If the callback is null, the agent is unregistered
+ * neardal_prv_set_ndef_agent: register or unregister the NDEF agent of a tag
+ * type, calling either cb_ndef_agent (copies) or cb_ndef_view_agent (views).
+ * If both callbacks are null, the agent is unregistered
  ****************************************************************************/
-errorCode_t neardal_agent_set_NDEF_cb(char *tagType
+static errorCode_t neardal_prv_set_ndef_agent(char *tagType
 				     , ndef_agent_cb cb_ndef_agent
+				     , ndef_agent_view_cb cb_ndef_view_agent
 				     , ndef_agent_free_cb cb_ndef_release_agent
 				     , void *user_data)
 {
 	errorCode_t		err	= NEARDAL_ERROR_INVALID_PARAMETER;
 	neardal_ndef_agent_t	agent;
+	guint64			start;
 
 
 	memset(&agent, 0, sizeof(neardal_ndef_agent_t));
@@ -1019,6 +1040,7 @@ errorCode_t neardal_agent_set_NDEF_cb(char *tagType
 	err = NEARDAL_ERROR_NO_MEMORY;
 
 	agent.cb_ndef_agent		= cb_ndef_agent;
+	agent.cb_ndef_view_agent	= cb_ndef_view_agent;
 	agent.cb_ndef_release_agent	= cb_ndef_release_agent;
 	agent.pid			= getpid();
 	agent.user_data			= user_data;
@@ -1038,13 +1060,16 @@ errorCode_t neardal_agent_set_NDEF_cb(char *tagType
 	if (agent.objPath == NULL)
 		goto exit;
 
-	if (cb_ndef_agent != NULL)
+	if (cb_ndef_agent != NULL || cb_ndef_view_agent != NULL) {
 		/* RegisterNDEFAgent */
+		start = neardal_metrics_prv_now();
 		org_neard_manager_call_register_ndefagent_sync(neardalMgr.proxy,
 							     agent.objPath,
 							     tagType, NULL,
 							&neardalMgr.gerror);
-	else
+		neardal_metrics_prv_op(NEARDAL_STATS_OP_REGISTER_NDEF_AGENT,
+				       start, neardalMgr.gerror != NULL);
+	} else
 		/* UnregisterNDEFAgent */
 		org_neard_manager_call_unregister_ndefagent_sync(neardalMgr.proxy,
 							    agent.objPath,
@@ -1075,31 +1100,49 @@ exit:
 }
 
 /*****************************************************************************
- * neardal_agent_set_handover_cb: register or unregister two callbacks to
- * handle handover connection. Two callbacks are used, the first one
- * (oob_request) is used to get Out Of Band data, the second one (oob_push) is
- * used to pass remote Out Of Band data.
- * If one of this callback is null, the agent is unregistered
+ * neardal_agent_set_NDEF_cb: register or unregister a callback to handle a
+ * record macthing a registered tag type. This callback will received the
+ * whole NDEF as a raw byte stream and the records object paths.
+ * If the callback is null, the agent is unregistered
  ****************************************************************************/
-errorCode_t neardal_agent_set_handover_cb(
-						const gchar* carrier
-					  , oob_push_agent_cb cb_oob_push_agent
-					  , oob_req_agent_cb  cb_oob_req_agent
-				, oob_agent_free_cb cb_oob_release_agent
-					  , void *user_data)
+errorCode_t neardal_agent_set_NDEF_cb(char *tagType
+				     , ndef_agent_cb cb_ndef_agent
+				     , ndef_agent_free_cb cb_ndef_release_agent
+				     , void *user_data)
+{
+	return neardal_prv_set_ndef_agent(tagType, cb_ndef_agent, NULL,
+					  cb_ndef_release_agent, user_data);
+}
+
+/*****************************************************************************
+ * neardal_agent_set_NDEF_view_cb: same as neardal_agent_set_NDEF_cb, the
+ * callback borrowing the NDEF message and records paths of the neard request
+ ****************************************************************************/
+errorCode_t neardal_agent_set_NDEF_view_cb(char *tagType
+				     , ndef_agent_view_cb cb_ndef_agent
+				     , ndef_agent_free_cb cb_ndef_release_agent
+				     , void *user_data)
+{
+	return neardal_prv_set_ndef_agent(tagType, NULL, cb_ndef_agent,
+					  cb_ndef_release_agent, user_data);
+}
+
+/*****************************************************************************
+ * neardal_prv_set_handover_agent: register or unregister the handover agent
+ * of a carrier, with either the copying callbacks or the view ones (agent
+ * filled by the caller). If one of the callbacks is null, the agent is
+ * unregistered
+ ****************************************************************************/
+static errorCode_t neardal_prv_set_handover_agent(const gchar *carrier
+					, neardal_handover_agent_t agent
+					, gboolean registering)
 {
 	errorCode_t			err;
-	neardal_handover_agent_t	agent;
 
 
 	err = NEARDAL_ERROR_NO_MEMORY;
 
-	memset(&agent, 0, sizeof(neardal_handover_agent_t));
-	agent.cb_oob_push_agent		= cb_oob_push_agent;
-	agent.cb_oob_req_agent		= cb_oob_req_agent;
-	agent.cb_oob_release_agent	= cb_oob_release_agent;
 	agent.pid			= getpid();
-	agent.user_data			= user_data;
 	agent.objPath			= g_strdup_printf("%s/handover/%d"
 							 , AGENT_PREFIX
 							 , agent.pid);
@@ -1111,7 +1154,7 @@ errorCode_t neardal_agent_set_handover_cb(
 	if (err != NEARDAL_SUCCESS)
 		goto exit;
 
-	if (cb_oob_push_agent != NULL && cb_oob_req_agent != NULL)
+	if (registering)
 		/* RegisterHandoverAgent */
 		org_neard_manager_call_register_handover_agent_sync(
 							       neardalMgr.proxy,
@@ -1142,6 +1185,57 @@ exit:
 	if (err != NEARDAL_SUCCESS)
 		neardal_tools_prv_free_gerror(&neardalMgr.gerror);
 	g_free(agent.objPath);
+	g_free(agent.carrierType);
 
 	return err;
 }
+
+/*****************************************************************************
+ * neardal_agent_set_handover_cb: register or unregister two callbacks to
+ * handle handover connection. Two callbacks are used, the first one
+ * (oob_request) is used to get Out Of Band data, the second one (oob_push) is
+ * used to pass remote Out Of Band data.
+ * If one of this callback is null, the agent is unregistered
+ ****************************************************************************/
+errorCode_t neardal_agent_set_handover_cb(
+						const gchar* carrier
+					  , oob_push_agent_cb cb_oob_push_agent
+					  , oob_req_agent_cb  cb_oob_req_agent
+				, oob_agent_free_cb cb_oob_release_agent
+					  , void *user_data)
+{
+	neardal_handover_agent_t	agent;
+
+	memset(&agent, 0, sizeof(neardal_handover_agent_t));
+	agent.cb_oob_push_agent		= cb_oob_push_agent;
+	agent.cb_oob_req_agent		= cb_oob_req_agent;
+	agent.cb_oob_release_agent	= cb_oob_release_agent;
+	agent.user_data			= user_data;
+
+	return neardal_prv_set_handover_agent(carrier, agent,
+					      cb_oob_push_agent != NULL &&
+					      cb_oob_req_agent != NULL);
+}
+
+/*****************************************************************************
+ * neardal_agent_set_handover_view_cb: same as neardal_agent_set_handover_cb,
+ * the callbacks borrowing the request blobs and handing over their reply
+ ****************************************************************************/
+errorCode_t neardal_agent_set_handover_view_cb(const char *carrier
+				, oob_push_agent_view_cb cb_oob_push_agent
+				, oob_req_agent_view_cb cb_oob_req_agent
+				, oob_agent_free_cb cb_oob_release_agent
+				, void *user_data)
+{
+	neardal_handover_agent_t	agent;
+
+	memset(&agent, 0, sizeof(neardal_handover_agent_t));
+	agent.cb_oob_push_view_agent	= cb_oob_push_agent;
+	agent.cb_oob_req_view_agent	= cb_oob_req_agent;
+	agent.cb_oob_release_agent	= cb_oob_release_agent;
+	agent.user_data			= user_data;
+
+	return neardal_prv_set_handover_agent(carrier, agent,
+					      cb_oob_push_agent != NULL &&
+					      cb_oob_req_agent != NULL);
+}
@@ -135,6 +135,252 @@ typedef struct {
 	unsigned int uriObjSize;/**< URI object size. */
 } neardal_record;
 
+/*!
+ * @brief NEARDAL timed neard operations (index in neardal_stats.ops)
+*/
+typedef enum {
+	NEARDAL_STATS_OP_WRITE = 0,		/**< Tag.Write */
+	NEARDAL_STATS_OP_PUSH,			/**< Device.Push */
+	NEARDAL_STATS_OP_START_POLL_LOOP,	/**< Adapter.StartPollLoop */
+	NEARDAL_STATS_OP_STOP_POLL_LOOP,	/**< Adapter.StopPollLoop */
+	NEARDAL_STATS_OP_SET,			/**< Properties.Set */
+	NEARDAL_STATS_OP_REGISTER_NDEF_AGENT,	/**< Manager.RegisterNDEFAgent */
+	NEARDAL_STATS_OP_GET_MANAGED_OBJECTS,	/**< ObjectManager.
+						 * GetManagedObjects */
+	NEARDAL_STATS_OP_GET_RAW_NDEF,		/**< Tag.GetRawNDEF */
+	NEARDAL_STATS_OP_COUNT
+} neardal_stats_op;
+
+/*!
+ * @brief NEARDAL tag detection stages (index in neardal_stats.stages)
+*/
+typedef enum {
+	NEARDAL_STATS_STAGE_TAG_REGISTER = 0,	/**< interfaces-added ->
+						 * tag registered */
+	NEARDAL_STATS_STAGE_TAG_PROXY,		/**< tag registered ->
+						 * proxy ready */
+	NEARDAL_STATS_STAGE_TAG_DISPATCH,	/**< proxy ready ->
+						 * 'tag found' dispatched */
+	NEARDAL_STATS_STAGE_TAG_CALLBACK,	/**< 'tag found' callback */
+	NEARDAL_STATS_STAGE_TAG_FOUND,		/**< interfaces-added ->
+						 * 'tag found' returned */
+	NEARDAL_STATS_STAGE_RCD_DISPATCH,	/**< record decoded ->
+						 * 'record found' dispatched */
+	NEARDAL_STATS_STAGE_RCD_CALLBACK,	/**< 'record found' callback */
+	NEARDAL_STATS_STAGE_RCD_FOUND,		/**< tag interfaces-added ->
+						 * 'record found' returned */
+	NEARDAL_STATS_STAGE_COUNT
+} neardal_stats_stage;
+
+/*!
+ * @brief NEARDAL startup steps (index in neardal_stats.startup), one sample
+ * per construction (per adapter for NEARDAL_STATS_STARTUP_ADP_PROXY)
+*/
+typedef enum {
+	NEARDAL_STATS_STARTUP_CONNECT = 0,	/**< bus connection */
+	NEARDAL_STATS_STARTUP_AGENT_NAME,	/**< agent name acquisition */
+	NEARDAL_STATS_STARTUP_MGR_PROXY,	/**< Manager proxy */
+	NEARDAL_STATS_STARTUP_OM_PROXY,		/**< ObjectManager proxy */
+	NEARDAL_STATS_STARTUP_GET_OBJECTS,	/**< GetManagedObjects and
+						 * adapters lookup */
+	NEARDAL_STATS_STARTUP_ADP_PROXY,	/**< one adapter: proxies,
+						 * properties, tags */
+	NEARDAL_STATS_STARTUP_ADAPTERS,		/**< all adapters */
+	NEARDAL_STATS_STARTUP_TOTAL,		/**< whole construction */
+	NEARDAL_STATS_STARTUP_RESYNC,		/**< neard restart: objects
+						 * fetched and diffed */
+	NEARDAL_STATS_STARTUP_COUNT
+} neardal_stats_startup;
+
+/*!
+ * @brief NEARDAL latency summary of one operation (nanoseconds).
+ * Percentiles are upper bounds of histogram buckets (~6% precision).
+*/
+typedef struct {
+/*! @brief operation (D-Bus method) or stage name */
+	const char		*name;
+/*! @brief Number of calls */
+	unsigned long long	count;
+/*! @brief Number of failed calls */
+	unsigned long long	errors;
+/*! @brief Sum of all call durations */
+	unsigned long long	sumNs;
+/*! @brief Fastest call */
+	unsigned long long	minNs;
+/*! @brief Slowest call */
+	unsigned long long	maxNs;
+/*! @brief Median */
+	unsigned long long	p50Ns;
+/*! @brief 90th percentile */
+	unsigned long long	p90Ns;
+/*! @brief 99th percentile */
+	unsigned long long	p99Ns;
+/*! @brief 99.9th percentile */
+	unsigned long long	p999Ns;
+} neardal_latency;
+
+/*!
+ * @brief NEARDAL counters and latencies snapshot.
+ * release with (@link neardal_free_stats @endlink)
+*/
+typedef struct {
+/*! @brief Number of adapters added */
+	unsigned long long	adaptersAdded;
+/*! @brief Number of adapters removed */
+	unsigned long long	adaptersRemoved;
+/*! @brief Number of tags found */
+	unsigned long long	tagsFound;
+/*! @brief Number of tags lost */
+	unsigned long long	tagsLost;
+/*! @brief Number of devices found */
+	unsigned long long	devsFound;
+/*! @brief Number of devices lost */
+	unsigned long long	devsLost;
+/*! @brief Number of records found */
+	unsigned long long	recordsFound;
+/*! @brief Number of records lost */
+	unsigned long long	recordsLost;
+/*! @brief Latency of outgoing neard calls (see neardal_stats_op) */
+	neardal_latency		ops[NEARDAL_STATS_OP_COUNT];
+/*! @brief Tag detection stages latency (see neardal_stats_stage) */
+	neardal_latency		stages[NEARDAL_STATS_STAGE_COUNT];
+/*! @brief Startup steps duration (see neardal_stats_startup) */
+	neardal_latency		startup[NEARDAL_STATS_STARTUP_COUNT];
+/*! @brief Tag, device, record block and name allocations */
+	unsigned long long	poolAllocs;
+/*! @brief Of those, allocations that reached the system allocator */
+	unsigned long long	poolSysAllocs;
+} neardal_stats;
+
+/*!
+ * @brief NEARDAL record detection timestamps (CLOCK_MONOTONIC nanoseconds,
+ * 0 if the stage was not reached)
+*/
+typedef struct {
+/*! @brief DBus interface record name (as identifier) */
+	char			*name;
+/*! @brief Record properties decoded */
+	unsigned long long	decodedNs;
+/*! @brief 'record found' callback invoked */
+	unsigned long long	dispatchedNs;
+/*! @brief 'record found' callback returned */
+	unsigned long long	returnedNs;
+} neardal_record_trace;
+
+/*!
+ * @brief NEARDAL tag detection timestamps (CLOCK_MONOTONIC nanoseconds,
+ * 0 if the stage was not reached)
+ * release with (@link neardal_free_tag_trace @endlink)
+*/
+typedef struct {
+/*! @brief DBus interface tag name (as identifier) */
+	char			*name;
+/*! @brief 'interfaces-added' signal received */
+	unsigned long long	ifaceAddedNs;
+/*! @brief Tag registered on its adapter */
+	unsigned long long	registeredNs;
+/*! @brief Tag DBus proxy ready */
+	unsigned long long	proxyReadyNs;
+/*! @brief 'tag found' callback invoked */
+	unsigned long long	dispatchedNs;
+/*! @brief 'tag found' callback returned */
+	unsigned long long	returnedNs;
+/*! @brief Number of records in tag */
+	int			nbRecords;
+/*! @brief records timestamps, in arrival order */
+	neardal_record_trace	*records;
+} neardal_tag_trace;
+
+/*!
+ * @brief Raw NDEF message of a tag. The bytes are those of the neard reply,
+ * not copied: valid until released with (@link neardal_free_raw_ndef
+ * @endlink)
+*/
+typedef struct {
+/*! @brief NDEF message */
+	const unsigned char	*data;
+/*! @brief NDEF message length */
+	unsigned int		len;
+/*! @brief Reply holding the message (private) */
+	void			*priv;
+} neardal_raw_ndef;
+
+/*!
+ * @brief Compiled record for repeated writes of the same record, one field
+ * changing (@link neardal_record_template_new @endlink)
+*/
+typedef struct neardal_record_template neardal_record_template;
+
+/*!
+ * @brief NDEF agent delivery (@link ndef_agent_view_cb @endlink): the NDEF
+ * message and the records paths, borrowed from the neard request. Valid
+ * during the callback; keep it longer with @link neardal_ndef_view_ref
+ * @endlink
+*/
+typedef struct {
+/*! @brief NDEF message */
+	const unsigned char	*data;
+/*! @brief NDEF message length */
+	unsigned int		len;
+/*! @brief records paths (as identifier=dbus object path), NULL terminated */
+	const char * const	*records;
+/*! @brief Number of records paths */
+	unsigned int		nbRecords;
+} neardal_ndef_view;
+
+/*!
+ * @brief Outcome of an automatic write (@link neardal_set_auto_write
+ * @endlink), timestamps as CLOCK_MONOTONIC nanoseconds
+*/
+typedef struct {
+/*! @brief DBus interface tag name (as identifier) */
+	const char		*tagName;
+/*! @brief Write result */
+	errorCode_t		error;
+/*! @brief 'interfaces-added' signal of the tag received */
+	unsigned long long	foundNs;
+/*! @brief Write sent to neard */
+	unsigned long long	writeNs;
+/*! @brief Write completed */
+	unsigned long long	doneNs;
+} neardal_auto_write_result;
+
+/*!
+ * @brief Read back verification outcome of a write
+ * (@link neardal_tag_write_verify @endlink)
+*/
+typedef enum {
+	NEARDAL_VERIFY_OK = 0,		/**< tag NDEF message as written */
+	NEARDAL_VERIFY_MISMATCH,	/**< tag NDEF message different, the
+					 * same twice in a row or at the
+					 * deadline */
+	NEARDAL_VERIFY_TIMEOUT,		/**< tag NDEF message not read before
+					 * the deadline */
+	NEARDAL_VERIFY_FAILED		/**< write failed or tag lost (see
+					 * error) */
+} neardal_verify_status;
+
+/*!
+ * @brief Outcome of a verified write, timestamps as CLOCK_MONOTONIC
+ * nanoseconds
+*/
+typedef struct {
+/*! @brief DBus interface tag name (as identifier) */
+	const char		*tagName;
+/*! @brief Verification outcome */
+	neardal_verify_status	status;
+/*! @brief Write or last read error code */
+	errorCode_t		error;
+/*! @brief Number of NDEF message reads */
+	unsigned int		reads;
+/*! @brief Write sent to neard */
+	unsigned long long	writeNs;
+/*! @brief Write completed */
+	unsigned long long	doneNs;
+/*! @brief Verification completed */
+	unsigned long long	verifiedNs;
+} neardal_verify_result;
+
 /* @}*/
 
 /*! @brief NEARDAL Callbacks
@@ -180,6 +426,24 @@ typedef void (*tag_cb) (const char *tagName, void *user_data);
  **/
 typedef void (*dev_cb) (const char *devName, void *user_data);
 
+/**
+ * @brief Callback prototype for a completed tag trace (tag lost)
+ *
+ * @param trace Tag detection timestamps (owned by NEARDAL)
+ * @param user_data Client user data
+ **/
+typedef void (*tag_trace_cb) (const neardal_tag_trace *trace,
+			      void *user_data);
+
+/**
+ * @brief Callback prototype for a completed automatic write
+ *
+ * @param result Write outcome and timestamps (valid during the callback)
+ * @param user_data Client user data
+ **/
+typedef void (*auto_write_cb) (const neardal_auto_write_result *result,
+			       void *user_data);
+
 /** @brief NEARDAL Record Callbacks ('RecordFound')
 */
 /**
@@ -203,6 +467,40 @@ typedef void (*ndef_agent_cb) (unsigned char **rcdArray, unsigned int rcdLen,
 			       unsigned char *ndefArray, unsigned int ndefLen,
 			       void *user_data);
 
+/**
+ * @brief Callback prototype for a registered tag type, without copies
+ * (@link neardal_agent_set_NDEF_view_cb @endlink)
+ *
+ * @param view NDEF message and records paths, borrowed for the duration of
+ * the callback
+ * @param user_data Client user data
+ **/
+typedef void (*ndef_agent_view_cb) (const neardal_ndef_view *view,
+				    void *user_data);
+
+/**
+ * @brief Callback prototype for an asynchronous raw NDEF read
+ * (@link neardal_tag_get_raw_ndef_async @endlink)
+ *
+ * @param tagName tag name (identifier)
+ * @param error read error code
+ * @param ndef raw NDEF message (NULL on error), owned by the client:
+ * release with @link neardal_free_raw_ndef @endlink
+ * @param user_data Client user data
+ **/
+typedef void (*raw_ndef_cb) (const char *tagName, errorCode_t error,
+			     neardal_raw_ndef *ndef, void *user_data);
+
+/**
+ * @brief Callback prototype for a verified write
+ * (@link neardal_tag_write_verify @endlink)
+ *
+ * @param result Write and verification outcome (valid during the callback)
+ * @param user_data Client user data
+ **/
+typedef void (*write_verify_cb) (const neardal_verify_result *result,
+				 void *user_data);
+
 /**
  * @brief Callback prototype to cleanup agent user data. Gets called when
  * Neard unregisters the agent.
@@ -252,6 +550,39 @@ typedef void (*oob_req_agent_cb) (unsigned char *blobEIR,
 typedef void (*oob_push_agent_cb) (unsigned char *blobEIR,
 				   unsigned int blobSize, void *user_data);
 
+/**
+ * @brief Same as @link oob_req_agent_cb @endlink, without copies: blob is
+ * borrowed from the neard request for the duration of the callback, and
+ * oobData is sent as is. If freeF is set, oobData belongs to NEARDAL which
+ * calls freeF once the reply is released (possibly from the GDBus thread);
+ * otherwise oobData is copied.
+ *
+ * @param blob EIR (or WSC) blob, NULL if none
+ * @param blobSize blob size (in bytes)
+ * @param oobData Out Of Band data returned (oobData* will be never null)
+ * @param oobDataSize Out Of Band data size returned (oobDataSize* will be
+ * never null)
+ * @param freeF Free function to release oobData
+ * @param user_data Client user data
+ **/
+typedef void (*oob_req_agent_view_cb) (const unsigned char *blob,
+				       unsigned int blobSize,
+				       unsigned char **oobData,
+				       unsigned int *oobDataSize,
+				       freeFunc *freeF, void *user_data);
+
+/**
+ * @brief Same as @link oob_push_agent_cb @endlink, blob being borrowed from
+ * the neard request for the duration of the callback
+ *
+ * @param blob EIR (or WSC) blob, NULL if none
+ * @param blobSize blob size (in bytes)
+ * @param user_data Client user data
+ **/
+typedef void (*oob_push_agent_view_cb) (const unsigned char *blob,
+					unsigned int blobSize,
+					void *user_data);
+
 
 /**
  * @brief Callback prototype to cleanup agent user data. Gets called when
@@ -456,6 +787,143 @@ errorCode_t neardal_get_tag_properties(const char *tagName,
  **/
 errorCode_t neardal_tag_write(neardal_record *record);
 
+/*! \fn errorCode_t neardal_record_template_new(
+ *					const neardal_record *record,
+ *					const char *field,
+ *					neardal_record_template **tmpl)
+ * @brief Compile a record for repeated writes (@link
+ * neardal_tag_write_template @endlink): its fields are encoded once, only
+ * 'field' being encoded again for each write
+ *
+ * @param record record to write (record->name is not used)
+ * @param field neard name of the changing string field ("URI",
+ * "Representation"...), its value in record being the constant prefix of
+ * the written values (may be NULL)
+ * @param tmpl compiled record, to release with @link
+ * neardal_record_template_free @endlink
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_record_template_new(const neardal_record *record,
+					const char *field,
+					neardal_record_template **tmpl);
+
+/*! \fn void neardal_record_template_free(neardal_record_template *tmpl)
+ * @brief Release a compiled record
+ *
+ * @param tmpl compiled record
+ **/
+void neardal_record_template_free(neardal_record_template *tmpl);
+
+/*! \fn errorCode_t neardal_tag_write_template(const char *tagName,
+ *				const neardal_record_template *tmpl,
+ *				const char *suffix)
+ * @brief Write a compiled record to an NFC tag, like @link
+ * neardal_tag_write @endlink
+ *
+ * @param tagName tag name (identifier)
+ * @param tmpl compiled record
+ * @param suffix appended to the template prefix to make the value of the
+ * changing field (may be NULL)
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_tag_write_template(const char *tagName,
+				       const neardal_record_template *tmpl,
+				       const char *suffix);
+
+/*! \fn errorCode_t neardal_tag_write_raw(const char *tagName,
+ *					  const unsigned char *ndef,
+ *					  unsigned int len)
+ * @brief Write an encoded NDEF message (e.g. from a neardal_ndef_builder,
+ * see neardal_ndef.h) to an NFC tag, as is
+ *
+ * @param tagName tag name (identifier)
+ * @param ndef NDEF message
+ * @param len NDEF message length
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_tag_write_raw(const char *tagName,
+				  const unsigned char *ndef, unsigned int len);
+
+/*! \fn errorCode_t neardal_set_auto_write(const char *filter,
+ *					  const unsigned char *ndef,
+ *					  unsigned int len)
+ * @brief Write an encoded NDEF message to every new writable tag matching
+ * 'filter', as soon as it appears: the write is sent from the neard
+ * 'interfaces-added' handler, before the 'tag found' callback. Outcomes are
+ * reported through @link neardal_set_cb_auto_write @endlink.
+ * ndef = NULL to stop writing.
+ *
+ * @param filter tag type (e.g. "Type 2"), or adapter or tag name prefix
+ * (starting with '/', e.g. "/org/neard/nfc0"); NULL matches every tag
+ * @param ndef NDEF message (copied)
+ * @param len NDEF message length
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_set_auto_write(const char *filter,
+				   const unsigned char *ndef, unsigned int len);
+
+/*! \fn errorCode_t neardal_tag_write_verify(const char *tagName,
+ *					    const unsigned char *ndef,
+ *					    unsigned int len,
+ *					    unsigned int timeoutMs,
+ *					    write_verify_cb cb,
+ *					    void *user_data)
+ * @brief Write an encoded NDEF message to an NFC tag, then read the tag
+ * NDEF message back (neard GetRawNDEF) and compare its hash with the
+ * written one. Asynchronous: the tag is read as soon as the write completes,
+ * then again every few milliseconds while it differs, until 'timeoutMs'.
+ * Two reads in a row returning the same different message end the
+ * verification (mismatch) before the deadline.
+ *
+ * @param tagName tag name (identifier)
+ * @param ndef NDEF message (copied)
+ * @param len NDEF message length
+ * @param timeoutMs verification deadline after the write completion (0: a
+ * single read)
+ * @param cb Client callback, receiving the outcome
+ * @param user_data Client user data
+ * @return errorCode_t error code (the callback is not invoked on error)
+ **/
+errorCode_t neardal_tag_write_verify(const char *tagName,
+				     const unsigned char *ndef,
+				     unsigned int len, unsigned int timeoutMs,
+				     write_verify_cb cb, void *user_data);
+
+/*! \fn errorCode_t neardal_tag_get_raw_ndef(const char *tagName,
+ *					     neardal_raw_ndef **ndef)
+ * @brief Read the raw NDEF message of an NFC tag (neard GetRawNDEF),
+ * without copying it out of the reply
+ *
+ * @param tagName tag name (identifier)
+ * @param ndef Pointer on the raw NDEF message, release with
+ * @link neardal_free_raw_ndef @endlink
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_tag_get_raw_ndef(const char *tagName,
+				     neardal_raw_ndef **ndef);
+
+/*! \fn errorCode_t neardal_tag_get_raw_ndef_async(const char *tagName,
+ *						   raw_ndef_cb cb,
+ *						   void *user_data)
+ * @brief Read the raw NDEF message of an NFC tag without waiting: 'cb' is
+ * invoked from the main loop once neard replied (the simulator replies
+ * before returning)
+ *
+ * @param tagName tag name (identifier)
+ * @param cb Client callback, receiving the message
+ * @param user_data Client user data
+ * @return errorCode_t error code (the callback is not invoked on error)
+ **/
+errorCode_t neardal_tag_get_raw_ndef_async(const char *tagName,
+					   raw_ndef_cb cb, void *user_data);
+
+/*! \fn void neardal_free_raw_ndef(neardal_raw_ndef *ndef)
+ * @brief Release a raw NDEF message
+ *
+ * @param ndef raw NDEF message (may be NULL)
+ **/
+void neardal_free_raw_ndef(neardal_raw_ndef *ndef);
+
 /*! \fn void neardal_free_tag(neardal_tag *tag)
  * @brief Release memory allocated for properties of a tag
  *
@@ -488,6 +956,52 @@ errorCode_t neardal_set_cb_tag_found(tag_cb cb_tag_found,
 errorCode_t neardal_set_cb_tag_lost(tag_cb cb_tag_lost,
 				    void *user_data);
 
+/*! \fn errorCode_t neardal_get_tag_trace(const char *tagName,
+ * neardal_tag_trace **trace)
+ * @brief Get detection timestamps of a tag (and of its records)
+ *
+ * @param tagName tag name (Dbus path)
+ * @param trace Pointer on pointer of a client tag trace struct,
+ * release with (@link neardal_free_tag_trace @endlink)
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_get_tag_trace(const char *tagName,
+				  neardal_tag_trace **trace);
+
+/*! \fn void neardal_free_tag_trace(neardal_tag_trace *trace)
+ * @brief Release memory allocated by neardal_get_tag_trace()
+ *
+ * @param trace Pointer on client tag trace struct
+ * @return nothing
+ **/
+void neardal_free_tag_trace(neardal_tag_trace *trace);
+
+/*! \fn errorCode_t neardal_set_cb_tag_trace(tag_trace_cb cb_tag_trace,
+ * void * user_data)
+ * @brief setup a client callback receiving the detection timestamps of a
+ * tag when it is lost.
+ * cb_tag_trace = NULL to remove actual callback.
+ *
+ * @param cb_tag_trace Client callback 'tag trace'
+ * @param user_data Client user data
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_set_cb_tag_trace(tag_trace_cb cb_tag_trace,
+				     void *user_data);
+
+/*! \fn errorCode_t neardal_set_cb_auto_write(auto_write_cb cb_auto_write,
+ * void * user_data)
+ * @brief setup a client callback receiving the outcome of the automatic
+ * writes (@link neardal_set_auto_write @endlink).
+ * cb_auto_write = NULL to remove actual callback.
+ *
+ * @param cb_auto_write Client callback 'auto write'
+ * @param user_data Client user data
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_set_cb_auto_write(auto_write_cb cb_auto_write,
+				      void *user_data);
+
 /*! \fn errorCode_t neardal_get_dev_properties(const char* devName,
  * neardal_dev **dev)
  * @brief Get properties of a specific NEARDAL dev
@@ -589,6 +1103,41 @@ errorCode_t neardal_agent_set_NDEF_cb(char *tagType
 				     , ndef_agent_free_cb cb_ndef_release_agent
 				      , void *user_data);
 
+/*! \fn errorCode_t neardal_agent_set_NDEF_view_cb(char *tagType,
+ *			ndef_agent_view_cb cb_ndef_agent,
+ *			ndef_agent_free_cb cb_ndef_release_agent,
+ *			void *user_data)
+ * @brief Same as @link neardal_agent_set_NDEF_cb @endlink, the NDEF message
+ * and the records paths being handed to the callback as they were received
+ * from neard, without copies.
+ * If the callback is null, the agent is unregistered.
+ * @param tagType tag type to register
+ * @param cb_ndef_agent Client callback for the registered tag type
+ * @param cb_ndef_release_agent Client callback to cleanup agent user data
+ * @param user_data Client user data
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_agent_set_NDEF_view_cb(char *tagType
+				      , ndef_agent_view_cb cb_ndef_agent
+				     , ndef_agent_free_cb cb_ndef_release_agent
+				      , void *user_data);
+
+/*! \fn neardal_ndef_view *neardal_ndef_view_ref(const neardal_ndef_view *view)
+ * @brief Keep an NDEF agent delivery after its callback returned (adds a
+ * reference, the data is still not copied)
+ * @param view view received by @link ndef_agent_view_cb @endlink
+ * @return the same view, to release with @link neardal_ndef_view_unref
+ * @endlink
+ **/
+neardal_ndef_view *neardal_ndef_view_ref(const neardal_ndef_view *view);
+
+/*! \fn void neardal_ndef_view_unref(neardal_ndef_view *view)
+ * @brief Release a reference taken with @link neardal_ndef_view_ref
+ * @endlink
+ * @param view view to release
+ **/
+void neardal_ndef_view_unref(neardal_ndef_view *view);
+
 
 /*! \fn errorCode_t neardal_agent_set_handover_cb(
  * 					  const gchar* carrier
@@ -611,6 +1160,28 @@ errorCode_t neardal_agent_set_handover_cb(
 				, oob_agent_free_cb cb_oob_release_agent
 					  , void *user_data);
 
+/*! \fn errorCode_t neardal_agent_set_handover_view_cb(
+ *				  const char *carrier
+ *				, oob_push_agent_view_cb cb_oob_push_agent
+ *				, oob_req_agent_view_cb cb_oob_req_agent
+ *				, oob_agent_free_cb cb_oob_release_agent
+ *				, void *user_data)
+ * @brief Same as @link neardal_agent_set_handover_cb @endlink, the handover
+ * blobs being exchanged without copies.
+ * If one of this callback is null, the agent is unregistered.
+ * @param carrier carrier type ("bluetooth" and "wifi" are valid choices)
+ * @param cb_oob_push_agent used to pass remote Out Of Band data
+ * @param cb_oob_req_agent used to get Out Of Band data
+ * @param cb_oob_release_agent used to cleanup agent user data
+ * @param user_data Client user data
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_agent_set_handover_view_cb(const char *carrier
+				, oob_push_agent_view_cb cb_oob_push_agent
+				, oob_req_agent_view_cb cb_oob_req_agent
+				, oob_agent_free_cb cb_oob_release_agent
+				, void *user_data);
+
 /*! @fn errorCode_t neardal_free_array(char ***array)
  *
  * @brief free memory used by array of adapters/tags/device or records
@@ -621,6 +1192,29 @@ errorCode_t neardal_agent_set_handover_cb(
  **/
 errorCode_t neardal_free_array(char ***array);
 
+/*! @fn errorCode_t neardal_get_stats(neardal_stats **stats)
+ *
+ * @brief Get a snapshot of NEARDAL event counters and neard calls latencies.
+ * Counters are process wide and kept across neardal_destroy().
+ *
+ * @param stats Pointer on pointer of a client stats struct (to store stats),
+ * release with (@link neardal_free_stats @endlink)
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_get_stats(neardal_stats **stats);
+
+/*! \fn void neardal_free_stats(neardal_stats *stats)
+ * @brief Release memory allocated by neardal_get_stats().
+ *
+ * @param stats Pointer on client stats struct
+ **/
+void neardal_free_stats(neardal_stats *stats);
+
+/*! \fn void neardal_reset_stats(void)
+ * @brief Clear all NEARDAL event counters and latency histograms.
+ **/
+void neardal_reset_stats(void);
+
 /**
  * Dump GVariant in a human readable format.
  */
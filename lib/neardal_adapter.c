@@ -30,16 +30,35 @@
 
 
 /*****************************************************************************
- * neardal_adp_prv_cb_tag_found: Callback called when a NFC tag is
- * found
+ * neardal_adp_prv_tag_found: add a tag to its adapter unless already known
+ * ('tagProp' not NULL), then notify it
  ****************************************************************************/
+static void neardal_adp_prv_tag_found(AdpProp *adpProp, const gchar *tagName,
+				      TagProp *tagProp)
+{
+	errorCode_t	err = NEARDAL_SUCCESS;
+
+	NEARDAL_PROBE1(tag_found, tagName);
+	if (tagProp == NULL) {
+		NEARDAL_TRACEF("Adding tag '%s'\n", tagName);
+		/* Invoking Callback 'Tag Found' before adding it (otherwise
+		 * callback 'Record Found' would be called before ) */
+		err = neardal_tag_prv_add((char *) tagName, adpProp);
+		tagProp = g_list_nth_data(adpProp->tagList, 0);
+		if (err == NEARDAL_SUCCESS)
+			neardal_tag_prv_run_hooks(tagProp);
+	}
+	if (err == NEARDAL_SUCCESS)
+		neardal_tag_notify_tag_found(tagProp);
+	NEARDAL_PROBE2(tag_found_done, tagName, err);
+}
+
 void neardal_adp_prv_cb_tag_found(OrgNeardTag *proxy,
 					     const gchar *arg_unnamed_arg0,
 					     void        *user_data)
 {
 	AdpProp		*adpProp	= user_data;
-	errorCode_t	err;
-	TagProp		*tagProp;
+	TagProp		*tagProp	= NULL;
 
 	NEARDAL_TRACEIN();
 	(void) proxy; /* remove warning */
@@ -47,14 +66,31 @@ void neardal_adp_prv_cb_tag_found(OrgNeardTag *proxy,
 	NEARDAL_ASSERT(arg_unnamed_arg0 != NULL);
 	NEARDAL_ASSERT(adpProp != NULL);
 
-	NEARDAL_TRACEF("Adding tag '%s'\n", arg_unnamed_arg0);
-	/* Invoking Callback 'Tag Found' before adding it (otherwise
-	 * callback 'Record Found' would be called before ) */
-	err = neardal_tag_prv_add((char *) arg_unnamed_arg0, adpProp);
-	if (err == NEARDAL_SUCCESS) {
-		tagProp = g_list_nth_data(adpProp->tagList, 0);
-		neardal_tag_notify_tag_found(tagProp);
+	/* Already known, e.g. listed by the adapter 'Tags' property */
+	neardal_adp_prv_get_tag(adpProp, (char *) arg_unnamed_arg0, &tagProp);
+	neardal_adp_prv_tag_found(adpProp, arg_unnamed_arg0, tagProp);
+	NEARDAL_TRACEF("NEARDAL LIB tagList contains %d elements\n",
+		      g_list_length(adpProp->tagList));
+}
+
+/*****************************************************************************
+ * neardal_adp_prv_tag_lost: notify and remove the tag of a link of the
+ * adapter tag list
+ ****************************************************************************/
+static void neardal_adp_prv_tag_lost(AdpProp *adpProp, GList *link)
+{
+	TagProp	*tagProp = link->data;
+
+	NEARDAL_PROBE1(tag_lost, tagProp->name);
+	NEARDAL_TRACEF("Removing tag '%s'\n", tagProp->name);
+	if (neardalMgr.cb.tag_lost != NULL) {
+		NEARDAL_PROBE_CB_DISPATCH("tag_lost", tagProp->name);
+		(neardalMgr.cb.tag_lost)(tagProp->name,
+					 neardalMgr.cb.tag_lost_ud);
+		NEARDAL_PROBE_CB_RETURN("tag_lost", tagProp->name);
 	}
+	NEARDAL_PROBE2(tag_lost_done, tagProp->name, NEARDAL_SUCCESS);
+	neardal_tag_prv_remove_link(link);
 	NEARDAL_TRACEF("NEARDAL LIB tagList contains %d elements\n",
 		      g_list_length(adpProp->tagList));
 }
@@ -68,27 +104,25 @@ void neardal_adp_prv_cb_tag_lost(OrgNeardTag *proxy,
 					   void *user_data)
 {
 	AdpProp		*adpProp	= user_data;
-	TagProp		*tagProp	= NULL;
-	errorCode_t	err;
+	TagProp		*tagProp;
+	GList		*node;
 
 	NEARDAL_TRACEIN();
 	(void) proxy; /* remove warning */
 	NEARDAL_ASSERT(arg_unnamed_arg0 != NULL);
 	NEARDAL_ASSERT(adpProp != NULL);
 
-	NEARDAL_TRACEF("Removing tag '%s'\n", arg_unnamed_arg0);
-	/* Invoking Callback 'Tag Found' before adding it (otherwise
-	 * callback 'Record Found' would be called before ) */
-	err = neardal_adp_prv_get_tag(adpProp, (char *) arg_unnamed_arg0,
-						  &tagProp);
-	if (err == NEARDAL_SUCCESS) {
-		if (neardalMgr.cb.tag_lost != NULL)
-			(neardalMgr.cb.tag_lost)((char *) arg_unnamed_arg0,
-					      neardalMgr.cb.tag_lost_ud);
-		neardal_tag_prv_remove(tagProp);
-		NEARDAL_TRACEF("NEARDAL LIB tagList contains %d elements\n",
-			      g_list_length(adpProp->tagList));
+	/* Same match as neardal_adp_prv_get_tag(), keeping the link */
+	for (node = adpProp->tagList; node != NULL; node = node->next) {
+		tagProp = node->data;
+		if (tagProp != NULL && !strncmp(tagProp->name, arg_unnamed_arg0,
+						strlen(tagProp->name))) {
+			neardal_adp_prv_tag_lost(adpProp, node);
+			return;
+		}
 	}
+	NEARDAL_PROBE1(tag_lost, arg_unnamed_arg0);
+	NEARDAL_PROBE2(tag_lost_done, arg_unnamed_arg0, NEARDAL_ERROR_NO_TAG);
 }
 
 /*****************************************************************************
@@ -121,6 +155,26 @@ void  neardal_adp_prv_cb_dev_found(void *proxy,
 		      g_list_length(adpProp->devList));
 }
 
+/*****************************************************************************
+ * neardal_adp_prv_dev_lost: notify and remove the dev of a link of the
+ * adapter dev list
+ ****************************************************************************/
+static void neardal_adp_prv_dev_lost(AdpProp *adpProp, GList *link)
+{
+	DevProp	*devProp = link->data;
+
+	NEARDAL_TRACEF("Removing dev '%s'\n", devProp->name);
+	if (neardalMgr.cb.dev_lost != NULL) {
+		NEARDAL_PROBE_CB_DISPATCH("dev_lost", devProp->name);
+		(neardalMgr.cb.dev_lost)(devProp->name,
+					 neardalMgr.cb.dev_lost_ud);
+		NEARDAL_PROBE_CB_RETURN("dev_lost", devProp->name);
+	}
+	neardal_dev_prv_remove_link(link);
+	NEARDAL_TRACEF("NEARDAL LIB devList contains %d elements\n",
+		      g_list_length(adpProp->devList));
+}
+
 /*****************************************************************************
  * neardal_adp_prv_cb_dev_lost: Callback called when a NFC dev is
  * lost (removed)
@@ -130,59 +184,89 @@ void neardal_adp_prv_cb_dev_lost(void *proxy,
 					   void *user_data)
 {
 	AdpProp		*adpProp	= user_data;
-	DevProp		*devProp	= NULL;
-	errorCode_t	err;
+	DevProp		*devProp;
+	GList		*node;
 
 	NEARDAL_TRACEIN();
 	(void) proxy; /* remove warning */
 	NEARDAL_ASSERT(arg_unnamed_arg0 != NULL);
 
 	neardal_mgr_prv_get_adapter((char *) arg_unnamed_arg0, &adpProp);
+	NEARDAL_ASSERT(adpProp != NULL);
 
-	NEARDAL_TRACEF("Removing dev '%s'\n", arg_unnamed_arg0);
-	/* Invoking Callback 'Dev Found' before adding it (otherwise
-	 * callback 'Record Found' would be called before ) */
-	err = neardal_adp_prv_get_dev(adpProp, (char *) arg_unnamed_arg0,
-						  &devProp);
-	if (err == NEARDAL_SUCCESS) {
-		if (neardalMgr.cb.dev_lost != NULL)
-			(neardalMgr.cb.dev_lost)((char *) arg_unnamed_arg0,
-					      neardalMgr.cb.dev_lost_ud);
-		neardal_dev_prv_remove(devProp);
-		NEARDAL_TRACEF("NEARDAL LIB devList contains %d elements\n",
-			      g_list_length(adpProp->devList));
+	/* Same match as neardal_adp_prv_get_dev(), keeping the link */
+	for (node = adpProp->devList; node != NULL; node = node->next) {
+		devProp = node->data;
+		if (devProp != NULL && !strncmp(devProp->name, arg_unnamed_arg0,
+						strlen(devProp->name))) {
+			neardal_adp_prv_dev_lost(adpProp, node);
+			return;
+		}
 	}
 }
 
 /*****************************************************************************
- * neardal_adp_prv_cb_property_changed: Callback called when a NFC tag
- * is found
+ * neardal_adp_prv_diff: set difference between an adapter list (TagProp or
+ * DevProp, name at 'nameOffset') and a 'Tags' or 'Devices' path array, in
+ * linear time: 'added' gets the array paths missing from the list, 'lost'
+ * the links of list entries missing from the array
  ****************************************************************************/
-static void neardal_adp_prv_cb_property_changed(OrgNeardAdapter *proxy,
-						const gchar *arg_unnamed_arg0,
-						GVariant *arg_unnamed_arg1,
-						void        *user_data)
+static void neardal_adp_prv_diff(GList *list, glong nameOffset,
+				 const gchar **array, gsize len,
+				 GPtrArray *added, GPtrArray *lost)
+{
+	GHashTable	*known, *next;
+	GList		*node;
+	gchar		*name;
+	gsize		i;
+
+	known = g_hash_table_new(g_str_hash, g_str_equal);
+	next = g_hash_table_new(g_str_hash, g_str_equal);
+
+	for (node = list; node != NULL; node = node->next) {
+		name = G_STRUCT_MEMBER(gchar *, node->data, nameOffset);
+		g_hash_table_insert(known, name, name);
+	}
+
+	for (i = 0; i < len; i++) {
+		if (g_hash_table_lookup(next, array[i]) != NULL)
+			continue;
+		g_hash_table_insert(next, (gpointer) array[i],
+				    (gpointer) array[i]);
+		if (g_hash_table_lookup(known, array[i]) == NULL)
+			g_ptr_array_add(added, (gpointer) array[i]);
+	}
+
+	for (node = list; node != NULL; node = node->next) {
+		name = G_STRUCT_MEMBER(gchar *, node->data, nameOffset);
+		if (g_hash_table_lookup(next, name) == NULL)
+			g_ptr_array_add(lost, node);
+	}
+
+	g_hash_table_destroy(known);
+	g_hash_table_destroy(next);
+}
+
+/*****************************************************************************
+ * neardal_adp_prv_property_changed: an adapter property changed
+ ****************************************************************************/
+static void neardal_adp_prv_property_changed(AdpProp *adpProp,
+					     const gchar *arg_unnamed_arg0,
+					     GVariant *arg_unnamed_arg1)
 {
-	AdpProp		*adpProp	= NULL;
 	errorCode_t	err		= NEARDAL_ERROR_NO_TAG;
-	char		*dbusObjPath	= NULL;
 	void		*clientValue	= NULL;
-	TagProp		*tagProp	= NULL;
-	DevProp		*devProp	= NULL;
-	gchar		**array		= NULL;
+	const gchar	**array		= NULL;
 	GVariant	*gvalue		= NULL;
+	GPtrArray	*added, *lost;
 	gsize		mode_len;
+	guint		i;
 
-	(void) proxy; /* remove warning */
-	(void) user_data; /* remove warning */
 	NEARDAL_TRACEIN();
 	NEARDAL_ASSERT(arg_unnamed_arg0 != NULL);
 
-	neardal_mgr_prv_get_adapter_from_proxy(proxy, &adpProp);
-	if (adpProp == NULL) {
-		err = NEARDAL_ERROR_GENERAL_ERROR;
-		goto exit;
-	}
+	added = g_ptr_array_new();
+	lost = g_ptr_array_new();
 
 	gvalue = g_variant_get_variant(arg_unnamed_arg1);
 	if (gvalue == NULL) {
@@ -193,13 +277,9 @@ static void neardal_adp_prv_cb_property_changed(OrgNeardAdapter *proxy,
 	NEARDAL_TRACEF(" arg_unnamed_arg0 : %s\n", arg_unnamed_arg0);
 
 	if (!strcmp(arg_unnamed_arg0, "Mode")) {
-		if (adpProp->mode != NULL) {
-			g_free(adpProp->mode);
-			adpProp->mode = NULL;
-		}
-
-		adpProp->mode = g_strdup(g_variant_get_string(gvalue, &mode_len));
-		clientValue = adpProp->mode;
+		adpProp->mode = g_intern_string(g_variant_get_string(gvalue,
+								     &mode_len));
+		clientValue = (gpointer) adpProp->mode;
 		NEARDAL_TRACEF("neardalMgr.mode=%s\n", adpProp->mode);
 	}
 
@@ -218,131 +298,91 @@ static void neardal_adp_prv_cb_property_changed(OrgNeardAdapter *proxy,
 	if (!strcmp(arg_unnamed_arg0, "Tags")) {
 		gsize tmpLen;
 
-		array = g_variant_dup_objv(gvalue, &tmpLen);
+		array = g_variant_get_objv(gvalue, &tmpLen);
 		adpProp->tagNb = tmpLen;
-		if (adpProp->tagNb <= 0) {	/* Remove all tags */
-			GList *node = NULL;
-			NEARDAL_TRACEF(
-				"Tag array empty! Removing all tags\n");
-			while (g_list_length(adpProp->tagList)) {
-				node = g_list_first(adpProp->tagList);
-				tagProp = (TagProp *) node->data;
-				neardal_adp_prv_cb_tag_lost(tagProp->proxy,
-							       tagProp->name,
-							       tagProp->parent);
-			}
-			g_strfreev(array);
-
-			err = NEARDAL_SUCCESS;
+		neardal_adp_prv_diff(adpProp->tagList,
+				     G_STRUCT_OFFSET(TagProp, name),
+				     array, tmpLen, added, lost);
+		NEARDAL_TRACEF("%u tags found, %u tags lost\n", added->len,
+			       lost->len);
+
+		/* Links found by the diff: no lookup per lost tag */
+		for (i = 0; i < lost->len; i++)
+			neardal_adp_prv_tag_lost(adpProp,
+						 g_ptr_array_index(lost, i));
+		/* TODO : for Neard Workaround, emulate 'TagFound' signals */
+		for (i = 0; i < added->len; i++)
+			neardal_adp_prv_tag_found(adpProp,
+						g_ptr_array_index(added, i),
+						NULL);
+
+		err = NEARDAL_SUCCESS;
+		if (tmpLen == 0)
 			goto exit;
-		}
-
-		/* Extract the tags arrays List from the GValue */
-		err = NEARDAL_ERROR_NO_ADAPTER;
-		tmpLen = 0;
-		while (tmpLen < adpProp->tagNb) {
-			/* Getting last tag (tags list not updated with
-			 * tags lost */
-			dbusObjPath = g_strdup(array[tmpLen++]);
-
-			/* TODO : for Neard Workaround, emulate 'TagFound'
-			 * signals */
-			err = neardal_adp_prv_get_tag(adpProp,
-							     dbusObjPath,
-							     &tagProp);
-			clientValue = dbusObjPath;
-			if (err == NEARDAL_ERROR_NO_TAG) {
-				neardal_adp_prv_cb_tag_found(NULL,
-								dbusObjPath,
-								adpProp);
-				err = NEARDAL_SUCCESS;
-			}
-		}
-		g_strfreev(array);
-		array = NULL;
+		clientValue = (char *) array[tmpLen - 1];
 	}
 
 	if (!strcmp(arg_unnamed_arg0, "Devices")) {
 		gsize tmpLen;
 
-		array = g_variant_dup_objv(gvalue, &tmpLen);
+		array = g_variant_get_objv(gvalue, &tmpLen);
 		adpProp->devNb = tmpLen;
-		if (adpProp->devNb <= 0) {	/* Remove all devs */
-			GList *node = NULL;
-			NEARDAL_TRACEF(
-				"Dev array empty! Removing all devs\n");
-			while (g_list_length(adpProp->devList)) {
-				node = g_list_first(adpProp->devList);
-				devProp = (DevProp *) node->data;
-				neardal_adp_prv_cb_dev_lost(NULL,
-							       devProp->name,
-							       devProp->parent);
-			}
-			g_strfreev(array);
-
-			err = NEARDAL_SUCCESS;
-			goto exit;
+		neardal_adp_prv_diff(adpProp->devList,
+				     G_STRUCT_OFFSET(DevProp, name),
+				     array, tmpLen, added, lost);
+		NEARDAL_TRACEF("%u devs found, %u devs lost\n", added->len,
+			       lost->len);
+
+		/* Links found by the diff: no lookup per lost dev */
+		for (i = 0; i < lost->len; i++)
+			neardal_adp_prv_dev_lost(adpProp,
+						 g_ptr_array_index(lost, i));
+		/* TODO : for Neard Workaround, emulate 'DevFound' signals */
+		for (i = 0; i < added->len; i++) {
+			clientValue = g_ptr_array_index(added, i);
+			neardal_adp_prv_cb_dev_found(NULL, clientValue,
+						     adpProp);
 		}
 
-		/* Extract the devs arrays List from the GValue */
-		err = NEARDAL_ERROR_NO_ADAPTER;
-		tmpLen = 0;
-		while (tmpLen < adpProp->devNb) {
-			/* Getting last dev (devs list not updated with
-			 * devs lost */
-			dbusObjPath = g_strdup(array[tmpLen++]);
-
-			/* TODO : for Neard Workaround, emulate 'DevFound'
-			 * signals */
-			err = neardal_adp_prv_get_dev(adpProp,
-						      dbusObjPath,
-						      &devProp);
-			if (err == NEARDAL_ERROR_NO_DEV) {
-				clientValue = dbusObjPath;
-				neardal_adp_prv_cb_dev_found(NULL,
-							     dbusObjPath,
-							     adpProp);
-				err = NEARDAL_SUCCESS;
-			}
-		}
-		g_strfreev(array);
-		array = NULL;
+		err = NEARDAL_SUCCESS;
+		if (tmpLen == 0)
+			goto exit;
 	}
 
-	if (neardalMgr.cb.adp_prop_changed != NULL)
+	if (neardalMgr.cb.adp_prop_changed != NULL) {
+		NEARDAL_PROBE_CB_DISPATCH("adp_prop_changed", adpProp->name);
 		(neardalMgr.cb.adp_prop_changed)(adpProp->name,
 						  (char *) arg_unnamed_arg0,
 						  clientValue,
 					neardalMgr.cb.adp_prop_changed_ud);
-	return;
+		NEARDAL_PROBE_CB_RETURN("adp_prop_changed", adpProp->name);
+	}
+	err = NEARDAL_SUCCESS;
 
 exit:
+	/* array items, 'added' paths and clientValue point into gvalue */
+	g_ptr_array_free(added, TRUE);
+	g_ptr_array_free(lost, TRUE);
+	g_free(array);
+	if (gvalue != NULL)
+		g_variant_unref(gvalue);
 	if (err != NEARDAL_SUCCESS)
 		NEARDAL_TRACEF("Exit with error code %d:%s\n", err,
 			      neardal_error_get_text(err));
-	return;
 }
 
-static void neardal_adp_prv_cb_properties_changed(
-				Properties *props __attribute__ ((unused)),
-				const gchar *interface,
-				GVariant *changed,
-				const gchar *const *invalidated,
-				void *user_data)
+/*****************************************************************************
+ * neardal_adp_prv_properties_changed: adapter properties changed
+ * ('changed' is the a{sv} dictionary of PropertiesChanged)
+ ****************************************************************************/
+void neardal_adp_prv_properties_changed(AdpProp *adp, GVariant *changed)
 {
 	char *s = NULL;
 	GVariant *v = NULL;
 	GVariantIter iter;
-	AdpProp *adp;
 
-	neardal_mgr_prv_get_adapter_from_proxy(user_data, &adp);
-
-	NEARDAL_ASSERT(adp != NULL);
-	NEARDAL_ASSERT(g_strv_length((gchar **) invalidated) == 0);
-
-	NEARDAL_TRACEF("Interface: %s\n", interface);
 	NEARDAL_TRACEF("Adapter: %s\n", adp->name);
-	NEARDAL_TRACEF("Changed: %s\n", g_variant_print(changed, TRUE));
+	NEARDAL_TRACEF("Changed: %s\n", neardal_trace_prv_variant(changed));
 
 	g_variant_iter_init(&iter, changed);
 
@@ -350,60 +390,70 @@ static void neardal_adp_prv_cb_properties_changed(
 		GVariant *vb = g_variant_new_variant(v);
 		g_variant_ref_sink(vb);
 		NEARDAL_TRACEF("Property: %s=%s\n", s,
-				g_variant_print(vb, TRUE));
-		neardal_adp_prv_cb_property_changed(user_data, s, vb, 0);
+				neardal_trace_prv_variant(vb));
+		neardal_adp_prv_property_changed(adp, s, vb);
 		g_variant_unref(vb);
 	}
 }
 
-static GVariant *neardal_adp_properties_get(char *name)
+static void neardal_adp_prv_cb_properties_changed(
+				Properties *props __attribute__ ((unused)),
+				const gchar *interface,
+				GVariant *changed,
+				const gchar *const *invalidated,
+				void *user_data)
 {
-	char *s = NULL;
-	GVariant *path = NULL, *interface = NULL, *properties, *tmp;
-	GVariantIter iter;
-	int i;
+	AdpProp *adp = NULL;
 
-	g_variant_iter_init(&iter, neardalMgr.dbus_objs);
+	neardal_mgr_prv_get_adapter_from_proxy(user_data, &adp);
 
-	for (i = 0; g_variant_iter_loop(&iter, "{o*}", &s, NULL); i++) {
-		if (strcmp(s, name) != 0)
-			continue;
-		g_free(s);
-		s = NULL;
-		path = g_variant_get_child_value(neardalMgr.dbus_objs, i);
-		NEARDAL_TRACEF("Found path: %s\n", g_variant_print(path, TRUE));
-		break;
-	}
+	NEARDAL_ASSERT(adp != NULL);
+	NEARDAL_ASSERT(g_strv_length((gchar **) invalidated) == 0);
 
-	if (!path)
-		return NULL;
+	NEARDAL_TRACEF("Interface: %s\n", interface);
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_ADP_CHANGED, adp->name, changed);
 
-	tmp = g_variant_get_child_value(path, 1);
-	g_variant_unref(path);
+	neardal_adp_prv_properties_changed(adp, changed);
+}
 
-	g_variant_iter_init(&iter, tmp);
+/*****************************************************************************
+ * neardal_adp_prv_sig_tag_found, neardal_adp_prv_sig_tag_lost: adapter
+ * 'TagFound' / 'TagLost' signals
+ ****************************************************************************/
+static void neardal_adp_prv_sig_tag_found(OrgNeardAdapter *proxy,
+					  const gchar *tagName,
+					  void *user_data)
+{
+	(void) proxy; /* remove warning */
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_TAG_FOUND, tagName, NULL);
+	neardal_adp_prv_cb_tag_found(NULL, tagName, user_data);
+}
 
-	for (i = 0; g_variant_iter_loop(&iter, "{s*}", &s, NULL); i++) {
-		if (strcmp(s, "org.neard.Adapter") != 0)
-			continue;
-		g_free(s);
-		s = NULL;
-		interface = g_variant_get_child_value(tmp, i);
-		g_variant_unref(tmp);
-		NEARDAL_TRACEF("Found interface: %s\n",
-				g_variant_print(interface, TRUE));
-		continue;
-	}
+static void neardal_adp_prv_sig_tag_lost(OrgNeardAdapter *proxy,
+					 const gchar *tagName,
+					 void *user_data)
+{
+	(void) proxy; /* remove warning */
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_TAG_LOST, tagName, NULL);
+	neardal_adp_prv_cb_tag_lost(NULL, tagName, user_data);
+}
 
-	if (!interface)
-		return NULL;
+/*****************************************************************************
+ * neardal_adp_properties_get: adapter properties from the GetManagedObjects
+ * reply (indexed by neardal_mgr_objects_add())
+ ****************************************************************************/
+static GVariant *neardal_adp_properties_get(char *name)
+{
+	GVariant *properties = NULL;
 
-	properties = g_variant_get_child_value(interface, 1);
-	g_variant_unref(interface);
+	if (neardalMgr.adp_props != NULL)
+		properties = g_hash_table_lookup(neardalMgr.adp_props, name);
+	if (properties == NULL)
+		return NULL;
 
-	NEARDAL_TRACEF("%s\n", g_variant_print(properties, TRUE));
+	NEARDAL_TRACEF("%s\n", neardal_trace_prv_variant(properties));
 
-	return properties;
+	return g_variant_ref(properties);
 }
 
 /*****************************************************************************
@@ -429,7 +479,7 @@ static errorCode_t neardal_adp_prv_read_properties(AdpProp *adpProp)
 		goto exit;
 	}
 
-	NEARDAL_TRACEF("Reading:\n%s\n", g_variant_print(tmp, TRUE));
+	NEARDAL_TRACEF("Reading:\n%s\n", neardal_trace_prv_variant(tmp));
 	tmpOut = g_variant_lookup_value(tmp, "Tags", G_VARIANT_TYPE_ARRAY);
 	if (tmpOut != NULL) {
 		array = g_variant_dup_objv(tmpOut, &len);
@@ -450,6 +500,7 @@ static errorCode_t neardal_adp_prv_read_properties(AdpProp *adpProp)
 			g_strfreev(array);
 			array = NULL;
 		}
+		g_variant_unref(tmpOut);
 	}
 
 	tmpOut = g_variant_lookup_value(tmp, "Devices", G_VARIANT_TYPE_ARRAY);
@@ -472,34 +523,43 @@ static errorCode_t neardal_adp_prv_read_properties(AdpProp *adpProp)
 			g_strfreev(array);
 			array = NULL;
 		}
+		g_variant_unref(tmpOut);
 	}
 
 	tmpOut = g_variant_lookup_value(tmp, "Polling", G_VARIANT_TYPE_BOOLEAN);
-	if (tmpOut != NULL)
+	if (tmpOut != NULL) {
 		adpProp->polling = g_variant_get_boolean(tmpOut);
+		g_variant_unref(tmpOut);
+	}
 
 	tmpOut = g_variant_lookup_value(tmp, "Powered", G_VARIANT_TYPE_BOOLEAN);
-	if (tmpOut != NULL)
+	if (tmpOut != NULL) {
 		adpProp->powered = g_variant_get_boolean(tmpOut);
+		g_variant_unref(tmpOut);
+	}
 
 	tmpOut = g_variant_lookup_value(tmp, "Mode", G_VARIANT_TYPE_STRING);
-	if (tmpOut != NULL)
-		adpProp->mode = g_variant_dup_string(tmpOut, &len);
+	if (tmpOut != NULL) {
+		adpProp->mode = g_intern_string(g_variant_get_string(tmpOut,
+								     NULL));
+		g_variant_unref(tmpOut);
+	}
 
 	tmpOut = g_variant_lookup_value(tmp, "Protocols",
 					G_VARIANT_TYPE_ARRAY);
 	if (tmpOut != NULL) {
-		adpProp->protocols = g_variant_dup_strv(tmpOut, &len);
+		adpProp->protocols = neardal_tools_prv_intern_strv(tmpOut,
+								   &len);
 		adpProp->lenProtocols = len;
 		if (adpProp->lenProtocols == 0) {
-			g_strfreev(adpProp->protocols);
+			g_free(adpProp->protocols);
 			adpProp->protocols = NULL;
 		}
+		g_variant_unref(tmpOut);
 	}
 
-exit:
 	g_variant_unref(tmp);
-	g_variant_unref(tmpOut);
+exit:
 	return err;
 }
 
@@ -510,14 +570,14 @@ errorCode_t neardal_adp_prv_get_tag(AdpProp *adpProp, gchar *tagName,
                                     TagProp **tagProp)
 {
 	errorCode_t	err	= NEARDAL_ERROR_NO_TAG;
-	guint		len = 0;
+	GList		*node;
 	TagProp		*tag;
 
 	NEARDAL_ASSERT_RET(adpProp != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
 	NEARDAL_ASSERT_RET(tagProp != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
 
-	while (len < g_list_length(adpProp->tagList)) {
-		tag = g_list_nth_data(adpProp->tagList, len);
+	for (node = adpProp->tagList; node != NULL; node = node->next) {
+		tag = node->data;
 		if (tag != NULL) {
 			if (!strncmp(tag->name, tagName, strlen(tag->name))) {
 				*tagProp = tag;
@@ -525,7 +585,6 @@ errorCode_t neardal_adp_prv_get_tag(AdpProp *adpProp, gchar *tagName,
 				break;
 			}
 		}
-		len++;
 	}
 
 	return err;
@@ -538,14 +597,14 @@ errorCode_t neardal_adp_prv_get_dev(AdpProp *adpProp, gchar *devName,
 				       DevProp **devProp)
 {
 	errorCode_t	err	= NEARDAL_ERROR_NO_DEV;
-	guint		len = 0;
+	GList		*node;
 	DevProp		*dev;
 
 	NEARDAL_ASSERT_RET(adpProp != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
 	NEARDAL_ASSERT_RET(devProp != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
 
-	while (len < g_list_length(adpProp->devList)) {
-		dev = g_list_nth_data(adpProp->devList, len);
+	for (node = adpProp->devList; node != NULL; node = node->next) {
+		dev = node->data;
 		if (dev != NULL) {
 			if (!strncmp(dev->name, devName, strlen(dev->name))) {
 				*devProp = dev;
@@ -553,30 +612,29 @@ errorCode_t neardal_adp_prv_get_dev(AdpProp *adpProp, gchar *devName,
 				break;
 			}
 		}
-		len++;
 	}
 
 	return err;
 }
 
 /*****************************************************************************
- * neardal_adp_init: Get Neard Manager Properties = NFC Adapters list.
- * Create a DBus proxy for the first one NFC adapter if present
- * Register Neard Manager signals ('PropertyChanged')
+ * neardal_adp_prv_dbus_init: DBus backend, create adapter proxies, read
+ * adapter properties and register adapter signals
  ****************************************************************************/
-static errorCode_t neardal_adp_prv_init(AdpProp *adpProp)
+errorCode_t neardal_adp_prv_dbus_init(AdpProp *adpProp)
 {
 	errorCode_t	err = NEARDAL_SUCCESS;
+	guint64		start = neardal_metrics_prv_now();
 
 	NEARDAL_TRACEIN();
 	NEARDAL_ASSERT_RET(adpProp != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
 
 	if (adpProp->proxy != NULL) {
 		g_signal_handlers_disconnect_by_func(adpProp->proxy,
-			NEARDAL_G_CALLBACK(neardal_adp_prv_cb_tag_found),
+			NEARDAL_G_CALLBACK(neardal_adp_prv_sig_tag_found),
 						     NULL);
 		g_signal_handlers_disconnect_by_func(adpProp->proxy,
-			NEARDAL_G_CALLBACK(neardal_adp_prv_cb_tag_lost),
+			NEARDAL_G_CALLBACK(neardal_adp_prv_sig_tag_lost),
 						     NULL);
 		g_object_unref(adpProp->proxy);
 	}
@@ -625,6 +683,8 @@ static errorCode_t neardal_adp_prv_init(AdpProp *adpProp)
 	}
 
 	err = neardal_adp_prv_read_properties(adpProp);
+	neardal_metrics_prv_startup(NEARDAL_STATS_STARTUP_ADP_PROXY, start,
+				    err != NEARDAL_SUCCESS);
 
 	NEARDAL_TRACEF("Register Neard-Adapter Signal ");
 	NEARDAL_TRACE("'PropertiesChanged'\n");
@@ -636,45 +696,117 @@ static errorCode_t neardal_adp_prv_init(AdpProp *adpProp)
 	NEARDAL_TRACEF("Register Neard-Adapter Signal ");
 	NEARDAL_TRACE("'TagFound'\n");
 	g_signal_connect(adpProp->proxy, NEARD_ADP_SIG_TAG_FOUND,
-			G_CALLBACK(neardal_adp_prv_cb_tag_found),
+			G_CALLBACK(neardal_adp_prv_sig_tag_found),
 			  adpProp);
 
 	NEARDAL_TRACEF("Register Neard-Adapter Signal ");
 	NEARDAL_TRACE("'TagLost'\n");
 	g_signal_connect(adpProp->proxy, NEARD_ADP_SIG_TAG_LOST,
-			G_CALLBACK(neardal_adp_prv_cb_tag_lost),
+			G_CALLBACK(neardal_adp_prv_sig_tag_lost),
 			  adpProp);
 
 	return err;
 }
 
 /*****************************************************************************
- * neardal_adp_prv_free: unref DBus proxy, disconnect Neard Adapter signals
+ * neardal_adp_prv_dbus_free: DBus backend, unregister adapter signals and
+ * unref adapter proxies
  ****************************************************************************/
-static void neardal_adp_prv_free(AdpProp **adpProp)
+void neardal_adp_prv_dbus_free(AdpProp *adpProp)
 {
-	NEARDAL_TRACEIN();
-	if ((*adpProp)->props) {
-		g_signal_handlers_disconnect_by_func((*adpProp)->props,
+	if (adpProp->props) {
+		g_signal_handlers_disconnect_by_func(adpProp->props,
 			NEARDAL_G_CALLBACK(
 				neardal_adp_prv_cb_properties_changed),
-						     (*adpProp)->proxy);
-		g_object_unref((*adpProp)->props);
-		(*adpProp)->props = NULL;
-	}
-	if ((*adpProp)->proxy != NULL) {
-		g_signal_handlers_disconnect_by_func((*adpProp)->proxy,
-			NEARDAL_G_CALLBACK(neardal_adp_prv_cb_tag_found), NULL);
-		g_signal_handlers_disconnect_by_func((*adpProp)->proxy,
-			NEARDAL_G_CALLBACK(neardal_adp_prv_cb_tag_lost), NULL);
-		g_object_unref((*adpProp)->proxy);
-		(*adpProp)->proxy = NULL;
+						     adpProp->proxy);
+		g_object_unref(adpProp->props);
+		adpProp->props = NULL;
 	}
+	if (adpProp->proxy != NULL) {
+		g_signal_handlers_disconnect_by_func(adpProp->proxy,
+			NEARDAL_G_CALLBACK(neardal_adp_prv_sig_tag_found), NULL);
+		g_signal_handlers_disconnect_by_func(adpProp->proxy,
+			NEARDAL_G_CALLBACK(neardal_adp_prv_sig_tag_lost), NULL);
+		g_object_unref(adpProp->proxy);
+		adpProp->proxy = NULL;
+	}
+}
+
+/*****************************************************************************
+ * neardal_adp_prv_dbus_set: DBus backend, set an adapter property
+ ****************************************************************************/
+errorCode_t neardal_adp_prv_dbus_set(AdpProp *adpProp, const gchar *key,
+				     GVariant *value)
+{
+	errorCode_t	err		= NEARDAL_SUCCESS;
+	GVariant	*propValue;
+
+	propValue = g_variant_new_variant(value);
+	g_variant_ref_sink(propValue);
+	NEARDAL_TRACE_LOG("Sending:\n%s=%s\n", key,
+			  neardal_trace_prv_variant(propValue));
+
+	properties_call_set_sync(adpProp->props, "org.neard.Adapter",
+				key, propValue, 0, &neardalMgr.gerror);
+
+	if (neardalMgr.gerror != NULL) {
+		NEARDAL_TRACE_ERR(
+			"DBUS Error (%d): %s\n",
+				 neardalMgr.gerror->code,
+				neardalMgr.gerror->message);
+		err = NEARDAL_ERROR_DBUS_INVOKE_METHOD_ERROR;
+		neardal_tools_prv_free_gerror(&neardalMgr.gerror);
+	}
+	g_variant_unref(propValue);
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_ADP_SET, adpProp->name,
+			g_variant_new_int32(err));
+
+	return err;
+}
+
+/*****************************************************************************
+ * neardal_adp_prv_dbus_poll: DBus backend, start ('mode' != NULL) or stop
+ * polling
+ ****************************************************************************/
+errorCode_t neardal_adp_prv_dbus_poll(AdpProp *adpProp, const gchar *mode)
+{
+	errorCode_t	err = NEARDAL_SUCCESS;
+
+	if (adpProp->proxy == NULL)
+		return err;
+
+	if (mode != NULL)
+		org_neard_adapter_call_start_poll_loop_sync(adpProp->proxy,
+							mode, NULL,
+							&neardalMgr.gerror);
+	else
+		org_neard_adapter_call_stop_poll_loop_sync(adpProp->proxy,
+							NULL,
+							&neardalMgr.gerror);
+
+	if (neardalMgr.gerror != NULL) {
+		NEARDAL_TRACE_ERR(
+			"Error with neard dbus method (err:%d:'%s')\n"
+				, neardalMgr.gerror->code
+				, neardalMgr.gerror->message);
+		err = NEARDAL_ERROR_DBUS_INVOKE_METHOD_ERROR;
+		neardal_tools_prv_free_gerror(&neardalMgr.gerror);
+	}
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_ADP_POLL, adpProp->name,
+			g_variant_new_int32(err));
+
+	return err;
+}
+
+/*****************************************************************************
+ * neardal_adp_prv_free: release backend resources and adapter properties
+ ****************************************************************************/
+static void neardal_adp_prv_free(AdpProp **adpProp)
+{
+	NEARDAL_TRACEIN();
+	neardalMgr.backend->adp_free(*adpProp);
 	g_free((*adpProp)->name);
-	if ((*adpProp)->mode != NULL)
-		g_free((*adpProp)->mode);
-	if ((*adpProp)->protocols != NULL)
-		g_strfreev((*adpProp)->protocols);
+	g_free((*adpProp)->protocols);
 	g_free((*adpProp));
 	(*adpProp) = NULL;
 }
@@ -705,22 +837,26 @@ errorCode_t neardal_adp_add(gchar *adapterName)
 
 		adpList = &neardalMgr.prop.adpList;
 		*adpList = g_list_prepend(*adpList, (gpointer) adpProp);
-		err = neardal_adp_prv_init(adpProp);
+		err = neardalMgr.backend->adp_init(adpProp);
+		if (err == NEARDAL_SUCCESS)
+			neardal_metrics_prv_count(NEARDAL_COUNTER_ADP_ADDED);
 
 		NEARDAL_TRACEF("NEARDAL LIB adapterList contains %d elements\n",
 			g_list_length(*adpList));
 
 		/* Invoke client cb 'adapter added' */
-		if (neardalMgr.cb.adp_added != NULL)
-				(neardalMgr.cb.adp_added)((char *) adapterName,
+		if (neardalMgr.cb.adp_added != NULL) {
+			NEARDAL_PROBE_CB_DISPATCH("adp_added", adapterName);
+			(neardalMgr.cb.adp_added)((char *) adapterName,
 						neardalMgr.cb.adp_added_ud);
+			NEARDAL_PROBE_CB_RETURN("adp_added", adapterName);
+		}
 
 		/* Notify 'Tag Found' */
 		len = 0;
 		while (len < g_list_length(adpProp->tagList)) {
 			tagProp = g_list_nth_data(adpProp->tagList, len++);
 			neardal_tag_notify_tag_found(tagProp);
-			len++;
 		}
 	} else
 		NEARDAL_TRACEF("Adapter '%s' already added\n", adapterName);
@@ -734,8 +870,6 @@ errorCode_t neardal_adp_add(gchar *adapterName)
  ****************************************************************************/
 errorCode_t neardal_adp_remove(AdpProp *adpProp)
 {
-	TagProp		*tagProp;
-	GList		*node = NULL;
 	GList		**adpList;
 
 	NEARDAL_ASSERT_RET(adpProp != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
@@ -743,14 +877,12 @@ errorCode_t neardal_adp_remove(AdpProp *adpProp)
 	NEARDAL_TRACEF("Removing adapter:%s\n", adpProp->name);
 
 	/* Remove all tags */
-	while (g_list_length(adpProp->tagList)) {
-		node = g_list_first(adpProp->tagList);
-		tagProp = (TagProp *) node->data;
-		neardal_tag_prv_remove(tagProp);
-	}
+	while (adpProp->tagList != NULL)
+		neardal_tag_prv_remove_link(adpProp->tagList);
 
 	adpList = &neardalMgr.prop.adpList;
 	(*adpList) = g_list_remove((*adpList), (gconstpointer) adpProp);
+	neardal_metrics_prv_count(NEARDAL_COUNTER_ADP_REMOVED);
 	neardal_adp_prv_free(&adpProp);
 
 	return NEARDAL_SUCCESS;
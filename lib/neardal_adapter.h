@@ -30,6 +30,12 @@
 #define NEARD_ADP_SIG_TAG_FOUND				"tag-found"
 #define NEARD_ADP_SIG_TAG_LOST				"tag-lost"
 
+/* Adapter 'Mode' values */
+#define	ADP_MODE_IDLE					"Idle"
+#define	ADP_MODE_INITIATOR				"Initiator"
+#define	ADP_MODE_TARGET					"Target"
+#define	ADP_MODE_DUAL					"Dual"
+
 /* NEARDAL Adapter Properties */
 typedef struct {
 	OrgNeardAdapter		*proxy;		/* The proxy connected to Neard
@@ -37,11 +43,11 @@ typedef struct {
 	Properties		*props;
 	gchar			*name;		/* DBus interface name
 						(as id) */
-	gchar			*mode;		/* NFC radio mode */
+	const gchar		*mode;		/* NFC radio mode (interned) */
 	void			*parent;
 	gboolean		polling;	/* adapter polling active ? */
 	gboolean		powered;	/* adapter powered ? */
-	gchar			**protocols;	/* protocols list */
+	const gchar		**protocols;	/* protocols list (interned) */
 	gsize			lenProtocols;
 	gsize			tagNb;
 	GList			*tagList;	/* Neard adapter tags list
@@ -51,6 +57,34 @@ typedef struct {
 						available */
 } AdpProp;
 
+/*****************************************************************************
+ * neardal_adp_prv_cb_tag_found: Callback called when a NFC tag is found
+ ****************************************************************************/
+void neardal_adp_prv_cb_tag_found(OrgNeardTag *proxy,
+				  const gchar *arg_unnamed_arg0,
+				  void *user_data);
+
+/*****************************************************************************
+ * neardal_adp_prv_cb_tag_lost: Callback called when a NFC tag is lost
+ * (removed)
+ ****************************************************************************/
+void neardal_adp_prv_cb_tag_lost(OrgNeardTag *proxy,
+				 const gchar *arg_unnamed_arg0,
+				 void *user_data);
+
+/*****************************************************************************
+ * neardal_adp_prv_cb_dev_found: Callback called when a NFC dev is found
+ ****************************************************************************/
+void neardal_adp_prv_cb_dev_found(void *proxy, const gchar *arg_unnamed_arg0,
+				  void *user_data);
+
+/*****************************************************************************
+ * neardal_adp_prv_cb_dev_lost: Callback called when a NFC dev is lost
+ * (removed)
+ ****************************************************************************/
+void neardal_adp_prv_cb_dev_lost(void *proxy, const gchar *arg_unnamed_arg0,
+				 void *user_data);
+
 /*****************************************************************************
  * neardal_adp_prv_get_tag: Get NEARDAL tag from name
  ****************************************************************************/
@@ -75,4 +109,34 @@ errorCode_t neardal_adp_add(gchar *adapterName);
  ****************************************************************************/
 errorCode_t neardal_adp_remove(AdpProp *adpProp);
 
+/*****************************************************************************
+ * neardal_adp_prv_properties_changed: apply adapter properties changes
+ * ('changed' being a PropertiesChanged a{sv} dictionary)
+ ****************************************************************************/
+void neardal_adp_prv_properties_changed(AdpProp *adp, GVariant *changed);
+
+/*****************************************************************************
+ * neardal_adp_prv_dbus_init: DBus backend, create adapter proxies, read
+ * adapter properties and register adapter signals
+ ****************************************************************************/
+errorCode_t neardal_adp_prv_dbus_init(AdpProp *adpProp);
+
+/*****************************************************************************
+ * neardal_adp_prv_dbus_free: DBus backend, unregister adapter signals and
+ * unref adapter proxies
+ ****************************************************************************/
+void neardal_adp_prv_dbus_free(AdpProp *adpProp);
+
+/*****************************************************************************
+ * neardal_adp_prv_dbus_set: DBus backend, set an adapter property
+ ****************************************************************************/
+errorCode_t neardal_adp_prv_dbus_set(AdpProp *adpProp, const gchar *key,
+				     GVariant *value);
+
+/*****************************************************************************
+ * neardal_adp_prv_dbus_poll: DBus backend, start ('mode' != NULL) or stop
+ * polling
+ ****************************************************************************/
+errorCode_t neardal_adp_prv_dbus_poll(AdpProp *adpProp, const gchar *mode);
+
 #endif /* NEARDAL_ADAPTER_H */
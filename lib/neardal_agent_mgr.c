@@ -35,6 +35,100 @@ static gboolean neardal_agent_prv_remove(gchar *objPath)
 						     , objPath);
 }
 
+/* NDEF agent delivery: the public view, and the request parts it borrows */
+typedef struct {
+	neardal_ndef_view	view;		/* must be first */
+	gint			refs;
+	GVariant		*ndef;		/* 'ay' */
+	GVariant		*records;	/* 'ao' (or 'as') */
+	const gchar		*paths[];	/* view.records */
+} neardalNdefView;
+
+/*****************************************************************************
+ * neardal_agent_prv_ndef_view: NDEF agent view on a GetNDEF request. Records
+ * paths and NDEF bytes point into 'values'
+ ****************************************************************************/
+static neardalNdefView *neardal_agent_prv_ndef_view(GVariant *values)
+{
+	neardalNdefView	*view;
+	GVariant	*records;
+	GVariantIter	iter;
+	const gchar	*format	= NULL;
+	const gchar	*path;
+	gsize		nbRecords = 0;
+	gsize		len;
+	gsize		i	= 0;
+
+	records = g_variant_lookup_value(values, "Records", NULL);
+	if (records != NULL) {
+		if (g_variant_is_of_type(records,
+					 G_VARIANT_TYPE_OBJECT_PATH_ARRAY))
+			format = "&o";
+		else if (g_variant_is_of_type(records,
+					      G_VARIANT_TYPE_STRING_ARRAY))
+			format = "&s";
+		if (format != NULL)
+			nbRecords = g_variant_n_children(records);
+	}
+
+	view = g_try_malloc0(sizeof(neardalNdefView)
+			     + (nbRecords + 1) * sizeof(gchar *));
+	if (view == NULL) {
+		if (records != NULL)
+			g_variant_unref(records);
+		return NULL;
+	}
+
+	view->refs = 1;
+	view->records = records;
+	if (format != NULL) {
+		g_variant_iter_init(&iter, records);
+		while (i < nbRecords
+		       && g_variant_iter_next(&iter, format, &path))
+			view->paths[i++] = path;
+	}
+	view->view.records = (const char * const *) view->paths;
+	view->view.nbRecords = i;
+
+	view->ndef = g_variant_lookup_value(values, "NDEF",
+					    G_VARIANT_TYPE_BYTESTRING);
+	if (view->ndef != NULL) {
+		view->view.data = g_variant_get_fixed_array(view->ndef, &len,
+							    sizeof(guint8));
+		view->view.len = len;
+	}
+
+	return view;
+}
+
+neardal_ndef_view *neardal_ndef_view_ref(const neardal_ndef_view *view)
+{
+	neardalNdefView	*ndefView = (neardalNdefView *) view;
+
+	g_return_val_if_fail(view != NULL, NULL);
+
+	g_atomic_int_inc(&ndefView->refs);
+
+	return &ndefView->view;
+}
+
+void neardal_ndef_view_unref(neardal_ndef_view *view)
+{
+	neardalNdefView	*ndefView = (neardalNdefView *) view;
+
+	if (view == NULL)
+		return;
+
+	if (!g_atomic_int_dec_and_test(&ndefView->refs))
+		return;
+
+	if (ndefView->ndef != NULL)
+		g_variant_unref(ndefView->ndef);
+	if (ndefView->records != NULL)
+		g_variant_unref(ndefView->records);
+	g_free(ndefView);
+}
+
 static gboolean on_GetNDEF(neardalNDEFAgent             *ndefAgent,
                            GDBusMethodInvocation       *invocation
                            , GVariant                   *values
@@ -51,13 +145,27 @@ static gboolean on_GetNDEF(neardalNDEFAgent             *ndefAgent,
 	(void) invocation;      /* Avoid warning */
 
 	NEARDAL_TRACEIN();
-	NEARDAL_TRACEF("%s\n", g_variant_print(values, TRUE));
+	NEARDAL_TRACEF("%s\n", neardal_trace_prv_variant(values));
+	NEARDAL_PROBE1(agent_get_ndef, agent_data ? agent_data->objPath : NULL);
 
 	if (agent_data != NULL) {
 		NEARDAL_TRACEF("ndefAgent pid=%d, obj path is : %s\n"
 			      , agent_data->pid
 			      , agent_data->objPath);
-		if (agent_data->cb_ndef_agent != NULL) {
+		if (agent_data->cb_ndef_view_agent != NULL) {
+			neardalNdefView	*view;
+
+			view = neardal_agent_prv_ndef_view(values);
+			if (view != NULL) {
+				NEARDAL_PROBE_CB_DISPATCH("ndef_agent",
+							  agent_data->objPath);
+				(agent_data->cb_ndef_view_agent)(&view->view,
+							agent_data->user_data);
+				NEARDAL_PROBE_CB_RETURN("ndef_agent",
+							agent_data->objPath);
+				neardal_ndef_view_unref(&view->view);
+			}
+		} else if (agent_data->cb_ndef_agent != NULL) {
 			GVariant	*tmpOut	 = NULL;
 
 			tmpOut = g_variant_lookup_value(values, "Records",
@@ -70,6 +178,7 @@ static gboolean on_GetNDEF(neardalNDEFAgent             *ndefAgent,
 					g_strfreev(rcdArray);
 					rcdArray = NULL;
 				}
+				g_variant_unref(tmpOut);
 			}
 			tmpOut = g_variant_lookup_value(values, "NDEF",
 							G_VARIANT_TYPE_ARRAY);
@@ -83,18 +192,26 @@ static gboolean on_GetNDEF(neardalNDEFAgent             *ndefAgent,
 						memcpy(ndefArray, value
 						      , ndefLen);
 				}
+				g_variant_unref(tmpOut);
 			}
+			NEARDAL_PROBE_CB_DISPATCH("ndef_agent",
+						  agent_data->objPath);
 			(agent_data->cb_ndef_agent)(
 					(unsigned char **) rcdArray
 					, rcdLen
 					, (unsigned char *) ndefArray
 					, ndefLen
 					, agent_data->user_data);
+			NEARDAL_PROBE_CB_RETURN("ndef_agent",
+						agent_data->objPath);
 			g_free(ndefArray);
 			g_strfreev(rcdArray);
 		}
 	}
 
+	NEARDAL_PROBE1(agent_get_ndef_done,
+		       agent_data ? agent_data->objPath : NULL);
+
 	return TRUE;
 }
 
@@ -110,9 +227,14 @@ static gboolean on_NDEF_Release( neardalNDEFAgent		*agent
 	if (agent_data != NULL) {
 		NEARDAL_TRACEF("agent '%s'\n",agent_data->objPath);
 
-		if (agent_data->cb_ndef_release_agent)
+		if (agent_data->cb_ndef_release_agent) {
+			NEARDAL_PROBE_CB_DISPATCH("ndef_release",
+						  agent_data->objPath);
 			(agent_data->cb_ndef_release_agent)(
 							agent_data->user_data);
+			NEARDAL_PROBE_CB_RETURN("ndef_release",
+						agent_data->objPath);
+		}
 
 		if (neardal_agent_prv_remove(agent_data->objPath) == TRUE)
 			NEARDAL_TRACE("removed\n");
@@ -135,6 +257,66 @@ static void on_ndef_object_removed( GDBusObjectManager *manager
 	on_NDEF_Release( NEARDAL_NDEFAGENT(object), NULL, user_data);
 }
 
+/* Handover blob keys, by carrier */
+static const gchar *neardal_agent_oob_keys[] = {"EIR", "nokia.com:bt", "WSC",
+						NULL};
+
+/*****************************************************************************
+ * neardal_agent_prv_oob_blob: first handover blob of a request, borrowed
+ * from 'values' (returned 'ay' to unref, NULL if none)
+ ****************************************************************************/
+static GVariant *neardal_agent_prv_oob_blob(GVariant *values,
+					    const gchar **key,
+					    const guint8 **blob, gsize *blobLen)
+{
+	GVariant	*tmpOut;
+	guint		counter;
+
+	*key = NULL;
+	*blob = NULL;
+	*blobLen = 0;
+	for (counter = 0; neardal_agent_oob_keys[counter] != NULL; counter++) {
+		tmpOut = g_variant_lookup_value(values,
+						neardal_agent_oob_keys[counter],
+						G_VARIANT_TYPE_BYTESTRING);
+		if (tmpOut != NULL) {
+			*key = neardal_agent_oob_keys[counter];
+			*blob = g_variant_get_fixed_array(tmpOut, blobLen,
+							  sizeof(guint8));
+			return tmpOut;
+		}
+	}
+
+	return NULL;
+}
+
+/*****************************************************************************
+ * neardal_agent_prv_oob_reply: RequestOOB reply {key: oobData}. oobData is
+ * not copied when the client gave a free function, which is then called
+ * once the reply is released (possibly from the GDBus thread)
+ ****************************************************************************/
+static GVariant *neardal_agent_prv_oob_reply(const gchar *key,
+					     unsigned char *oobData,
+					     unsigned int oobDataLen,
+					     freeFunc freeF)
+{
+	GVariantBuilder	builder;
+
+	g_variant_builder_init(&builder, G_VARIANT_TYPE_VARDICT);
+	if (freeF == NULL)
+		neardal_tools_prv_add_dict_entry(&builder, key, oobData,
+						 oobDataLen,
+						 NEARDAL_TYPE_BYTE_ARRAY);
+	else
+		g_variant_builder_add(&builder, "{sv}", key,
+				      g_variant_new_from_data(
+						G_VARIANT_TYPE_BYTESTRING,
+						oobData, oobDataLen, TRUE,
+						freeF, oobData));
+
+	return g_variant_builder_end(&builder);
+}
+
 static gboolean on_RequestOOB(neardalHandoverAgent	*handoverAgent
 			      , GDBusMethodInvocation	*invocation
 			      , GVariant		*values
@@ -144,80 +326,90 @@ static gboolean on_RequestOOB(neardalHandoverAgent	*handoverAgent
 	unsigned char  			*oobData	= NULL;
 	unsigned int			oobDataLen	= 0;
 	void				(*freeFunc)(void *) = NULL;
-	const gchar* 		blobKeys[] = {"EIR", "nokia.com:bt", "WSC", NULL};
-	gchar	   			*blob		= NULL;
-	gsize	   			blobLen		= 0;
-	gconstpointer			value;
+	const gchar			*blobKey;
+	const guint8			*blob;
+	gsize	   			blobLen;
+	gchar	   			*blobCopy	= NULL;
+	GVariant			*blobVariant;
 	GVariant			*result;
 	errorCode_t			err;
-	guint 				counter;
 
 	(void) handoverAgent;       /* Avoid warning */
 	(void) invocation;      /* Avoid warning */
 	err = NEARDAL_ERROR_GENERAL_ERROR;
 
 	NEARDAL_TRACEIN();
-	NEARDAL_TRACEF("%s\n", g_variant_print(values, TRUE));
+	NEARDAL_TRACEF("%s\n", neardal_trace_prv_variant(values));
+	NEARDAL_PROBE1(agent_request_oob,
+		       agent_data ? agent_data->objPath : NULL);
+
+	blobVariant = neardal_agent_prv_oob_blob(values, &blobKey, &blob,
+						 &blobLen);
 
 	if (agent_data != NULL) {
 		NEARDAL_TRACEF("handoverAgent pid=%d, obj path is : %s\n"
 			      , agent_data->pid
 			      , agent_data->objPath);
-		if (agent_data->cb_oob_req_agent != NULL) {
-			GVariant	*tmpOut	 = NULL;
-
-			for(counter = 0; blobKeys[counter] != NULL; counter++) {
-				tmpOut = g_variant_lookup_value(values, blobKeys[counter],
-								G_VARIANT_TYPE_ARRAY);
-				if (tmpOut != NULL) {
-					value = g_variant_get_data(tmpOut);
-					blobLen = g_variant_get_size(tmpOut);
-
-					if (blobLen > 0) {
-						blob = g_try_malloc0(blobLen);
-						if (blob != NULL)
-							memcpy(blob, value
-							      , blobLen);
-					}
-					break;
-				}
+		if (agent_data->cb_oob_req_view_agent != NULL) {
+			NEARDAL_PROBE_CB_DISPATCH("oob_req_agent",
+						  agent_data->objPath);
+			(agent_data->cb_oob_req_view_agent)(
+							blob
+						       , blobLen
+						       , &oobData
+						       , &oobDataLen
+						       , &freeFunc
+						, agent_data->user_data);
+			NEARDAL_PROBE_CB_RETURN("oob_req_agent",
+						agent_data->objPath);
+		} else if (agent_data->cb_oob_req_agent != NULL) {
+			if (blobLen > 0) {
+				blobCopy = g_try_malloc0(blobLen);
+				if (blobCopy != NULL)
+					memcpy(blobCopy, blob, blobLen);
 			}
 
+			NEARDAL_PROBE_CB_DISPATCH("oob_req_agent",
+						  agent_data->objPath);
 			(agent_data->cb_oob_req_agent)(
-							(unsigned char *) blob
+							(unsigned char *) blobCopy
 						       , blobLen
 						       , &oobData
 						       , &oobDataLen
 						       , &freeFunc
 						, agent_data->user_data);
-			if ((oobData != NULL) && (blobKeys[counter] != NULL)) {
-				GVariantBuilder	*dictBuilder		= NULL;
-
- 				dictBuilder = g_variant_builder_new(
-							G_VARIANT_TYPE_ARRAY);
-				err = neardal_tools_prv_add_dict_entry(
-								dictBuilder,
-								blobKeys[counter], oobData, oobDataLen
-					     				, -1);
-				result = g_variant_builder_end(dictBuilder);
-
-				NEARDAL_TRACE_LOG("Sending:\n%s\n",
-						  g_variant_print(result
-								  , TRUE));
-
-				neardal_handover_agent_complete_request_oob(
-								handoverAgent
-								, invocation
-								, result);
-				err = NEARDAL_SUCCESS;
-			}
+			NEARDAL_PROBE_CB_RETURN("oob_req_agent",
+						agent_data->objPath);
+		}
+		if ((oobData != NULL) && (blobKey != NULL)) {
+			/* View agents hand oobData over to the reply, the
+			 * others get it back (released) right away */
+			if (agent_data->cb_oob_req_view_agent != NULL) {
+				result = neardal_agent_prv_oob_reply(blobKey,
+							oobData, oobDataLen,
+							freeFunc);
+				oobData = NULL;
+			} else
+				result = neardal_agent_prv_oob_reply(blobKey,
+							oobData, oobDataLen,
+							NULL);
+
+			NEARDAL_TRACE_LOG("Sending:\n%s\n",
+				neardal_trace_prv_variant(result));
+
+			neardal_handover_agent_complete_request_oob(
+							handoverAgent
+							, invocation
+							, result);
+			err = NEARDAL_SUCCESS;
 		}
 	}
 
 	if (freeFunc != NULL && oobData != NULL)
 		(freeFunc)(oobData);
-	if (blob != NULL)
-		g_free(blob);
+	g_free(blobCopy);
+	if (blobVariant != NULL)
+		g_variant_unref(blobVariant);
 
 	if (err != NEARDAL_SUCCESS)
 		g_dbus_method_invocation_return_error(invocation,
@@ -225,6 +417,9 @@ static gboolean on_RequestOOB(neardalHandoverAgent	*handoverAgent
 					G_DBUS_ERROR_FAILED,
 					"%s", neardal_error_get_text(err));
 
+	NEARDAL_PROBE2(agent_request_oob_done,
+		       agent_data ? agent_data->objPath : NULL, err);
+
 	return TRUE;
 }
 
@@ -234,50 +429,59 @@ static gboolean on_PushOOB(neardalHandoverAgent	*handoverAgent
 			   , gpointer			user_data)
 {
 	neardal_handover_agent_t	*agent_data	= user_data;
-	gconstpointer			value;
-	const gchar* 		blobKeys[] = {"EIR", "nokia.com:bt", "WSC", NULL};
-	gchar	   			*blob		= NULL;
-	gsize	   			blobLen		= 0;
-	guint 				counter;
+	const gchar			*blobKey;
+	const guint8			*blob;
+	gsize	   			blobLen;
+	gchar	   			*blobCopy	= NULL;
+	GVariant			*blobVariant;
 
 	(void) handoverAgent;       /* Avoid warning */
 	(void) invocation;      /* Avoid warning */
 
 	NEARDAL_TRACEIN();
-	NEARDAL_TRACEF("%s\n", g_variant_print(values, TRUE));
+	NEARDAL_TRACEF("%s\n", neardal_trace_prv_variant(values));
+
+	blobVariant = neardal_agent_prv_oob_blob(values, &blobKey, &blob,
+						 &blobLen);
 
 	if (agent_data != NULL) {
 		NEARDAL_TRACEF("handoverAgent pid=%d, obj path is : %s\n"
 			      , agent_data->pid
 			      , agent_data->objPath);
-		if (agent_data->cb_oob_push_agent != NULL) {
-			GVariant	*tmpOut	 = NULL;
-
-			for(counter = 0; blobKeys[counter] != NULL; counter++) {
-				tmpOut = g_variant_lookup_value(values, blobKeys[counter],
-								G_VARIANT_TYPE_ARRAY);
-				if (tmpOut != NULL) {
-					value = g_variant_get_data(tmpOut);
-					blobLen = g_variant_get_size(tmpOut);
-
-					if (blobLen > 0) {
-						blob = g_try_malloc0(blobLen);
-						if (blob != NULL)
-							memcpy(blob, value
-							      , blobLen);
-					}
-					break;
-				}
+		if (agent_data->cb_oob_push_view_agent != NULL) {
+			NEARDAL_PROBE_CB_DISPATCH("oob_push_agent",
+						  agent_data->objPath);
+			(agent_data->cb_oob_push_view_agent)(blob, blobLen,
+							agent_data->user_data);
+			NEARDAL_PROBE_CB_RETURN("oob_push_agent",
+						agent_data->objPath);
+			if (invocation != NULL)
+				neardal_handover_agent_complete_push_oob(
+							handoverAgent
+							, invocation);
+		} else if (agent_data->cb_oob_push_agent != NULL) {
+			if (blobLen > 0) {
+				blobCopy = g_try_malloc0(blobLen);
+				if (blobCopy != NULL)
+					memcpy(blobCopy, blob, blobLen);
 			}
+			NEARDAL_PROBE_CB_DISPATCH("oob_push_agent",
+						  agent_data->objPath);
  			(agent_data->cb_oob_push_agent)(
-							(unsigned char *) blob
+							(unsigned char *) blobCopy
 						       , blobLen
 						, agent_data->user_data);
+			NEARDAL_PROBE_CB_RETURN("oob_push_agent",
+						agent_data->objPath);
  			if (invocation != NULL)
  				neardal_handover_agent_complete_push_oob(handoverAgent, invocation);
 		}
 	}
 
+	g_free(blobCopy);
+	if (blobVariant != NULL)
+		g_variant_unref(blobVariant);
+
 	return TRUE;
 }
 
@@ -293,9 +497,14 @@ static gboolean on_Handover_Release( neardalHandoverAgent	*agent
 	if (agent_data != NULL) {
 		NEARDAL_TRACEF("agent '%s'\n",agent_data->objPath);
 
-		if (agent_data->cb_oob_release_agent)
+		if (agent_data->cb_oob_release_agent) {
+			NEARDAL_PROBE_CB_DISPATCH("oob_release",
+						  agent_data->objPath);
 			(agent_data->cb_oob_release_agent)(
 							agent_data->user_data);
+			NEARDAL_PROBE_CB_RETURN("oob_release",
+						agent_data->objPath);
+		}
 
 		if (neardal_agent_prv_remove(agent_data->objPath) == TRUE)
 			NEARDAL_TRACE("removed\n");
@@ -354,7 +563,8 @@ errorCode_t neardal_ndefagent_prv_manage(neardal_ndef_agent_t agentData)
 
 	NEARDAL_TRACEIN();
 
-	if (agentData.cb_ndef_agent != NULL) {
+	if (agentData.cb_ndef_agent != NULL ||
+	    agentData.cb_ndef_view_agent != NULL) {
 		data = g_try_malloc0(sizeof(neardal_ndef_agent_t));
 		if (data == NULL)
 			return NEARDAL_ERROR_NO_MEMORY;
@@ -411,8 +621,10 @@ errorCode_t neardal_handoveragent_prv_manage(
 
         NEARDAL_TRACEIN();
 
-        if (agentData.cb_oob_push_agent != NULL &&
-	    agentData.cb_oob_req_agent != NULL) {
+        if ((agentData.cb_oob_push_agent != NULL &&
+	     agentData.cb_oob_req_agent != NULL) ||
+	    (agentData.cb_oob_push_view_agent != NULL &&
+	     agentData.cb_oob_req_view_agent != NULL)) {
                 data = g_try_malloc0(sizeof(neardal_handover_agent_t));
                 if (data == NULL)
                         return NEARDAL_ERROR_NO_MEMORY;
@@ -39,6 +39,10 @@ typedef struct {
 							and records object path
 							*/
 
+	ndef_agent_view_cb	cb_ndef_view_agent;	/* same, borrowing the
+							request data instead
+							of copying it */
+
 	ndef_agent_free_cb	cb_ndef_release_agent;	/* client callback gets
 							called when Neard
 							unregisters the agent.
@@ -67,6 +71,9 @@ typedef struct {
 							data to agent to start
 							handover */
 
+	oob_req_agent_view_cb	cb_oob_req_view_agent;	/* same as above, */
+	oob_push_agent_view_cb	cb_oob_push_view_agent;	/* without copies */
+
 	oob_agent_free_cb	cb_oob_release_agent;	/* client callback gets
 							called when Neard
 							unregisters the agent.
@@ -0,0 +1,425 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include "neardal.h"
+#include "neardal_capture.h"
+#include "neardal_sim.h"
+#include "neardal_prv.h"
+#include "neardal_adapter.h"
+
+#define CAPTURE_MAGIC		"NDALCAP1"
+#define CAPTURE_MAGIC_LEN	8
+
+FILE *neardal_capture_fp;
+
+/* Capture start time (ns) */
+static guint64 sCaptureStart;
+
+/* Event data types (NULL: no data) */
+static const gchar *sCaptureTypes[NEARDAL_CAPTURE_COUNT] = {
+	[NEARDAL_CAPTURE_OBJECTS]		= "a{oa{sa{sv}}}",
+	[NEARDAL_CAPTURE_IFACES_ADDED]		= "a{sa{sv}}",
+	[NEARDAL_CAPTURE_IFACES_REMOVED]	= "as",
+	[NEARDAL_CAPTURE_ADP_CHANGED]		= "a{sv}",
+	[NEARDAL_CAPTURE_ADP_SET]		= "i",
+	[NEARDAL_CAPTURE_ADP_POLL]		= "i",
+	[NEARDAL_CAPTURE_TAG_WRITE]		= "i",
+	[NEARDAL_CAPTURE_TAG_RAW_NDEF]		= "(iay)",
+	[NEARDAL_CAPTURE_DEV_PUSH]		= "i",
+};
+
+/* Replayed method replies, by event: object path -> GQueue of replies */
+static GHashTable *sReplayReplies[NEARDAL_CAPTURE_COUNT];
+
+/*****************************************************************************
+ * neardal_capture_prv_event: append an event to the capture file. A write
+ * error ends the capture.
+ ****************************************************************************/
+void neardal_capture_prv_event(neardalCaptureEvent event, const gchar *path,
+			       GVariant *data)
+{
+	GVariant	*normal = NULL;
+	guint8		kind = event;
+	guint64		ts;
+	guint16		pathLen;
+	guint32		dataLen = 0;
+	gsize		len;
+	gboolean	ok;
+
+	if (data != NULL) {
+		g_variant_ref_sink(data);
+		if (sCaptureTypes[event] != NULL &&
+		    g_variant_is_of_type(data,
+					 G_VARIANT_TYPE(sCaptureTypes[event])))
+			normal = g_variant_get_normal_form(data);
+		g_variant_unref(data);
+		if (normal == NULL)
+			return;
+		dataLen = g_variant_get_size(normal);
+	}
+
+	if (neardal_capture_fp == NULL || path == NULL) {
+		if (normal != NULL)
+			g_variant_unref(normal);
+		return;
+	}
+
+	len = strlen(path);
+	ts = GUINT64_TO_LE(neardal_metrics_prv_now() - sCaptureStart);
+	pathLen = GUINT16_TO_LE(MIN(len, G_MAXUINT16));
+	dataLen = GUINT32_TO_LE(dataLen);
+
+	ok = fwrite(&kind, 1, 1, neardal_capture_fp) == 1 &&
+	     fwrite(&ts, sizeof(ts), 1, neardal_capture_fp) == 1 &&
+	     fwrite(&pathLen, sizeof(pathLen), 1, neardal_capture_fp) == 1 &&
+	     fwrite(path, 1, MIN(len, G_MAXUINT16), neardal_capture_fp) ==
+		MIN(len, G_MAXUINT16) &&
+	     fwrite(&dataLen, sizeof(dataLen), 1, neardal_capture_fp) == 1;
+	if (normal != NULL) {
+		ok = ok && fwrite(g_variant_get_data(normal), 1,
+				  g_variant_get_size(normal),
+				  neardal_capture_fp) ==
+			   g_variant_get_size(normal);
+		g_variant_unref(normal);
+	}
+
+	if (!ok) {
+		NEARDAL_TRACE_ERR("Capture write error, capture stopped\n");
+		neardal_capture_stop();
+	}
+}
+
+/*****************************************************************************
+ * neardal_capture_start: start capturing received traffic
+ ****************************************************************************/
+errorCode_t neardal_capture_start(const char *fileName)
+{
+	FILE	*fp;
+
+	if (fileName == NULL)
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	if (neardal_capture_fp != NULL)
+		return NEARDAL_ERROR_GENERAL_ERROR;
+
+	fp = fopen(fileName, "wb");
+	if (fp == NULL) {
+		NEARDAL_TRACE_ERR("Can't create capture file %s\n", fileName);
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+	}
+
+	if (fwrite(CAPTURE_MAGIC, CAPTURE_MAGIC_LEN, 1, fp) != 1) {
+		fclose(fp);
+		return NEARDAL_ERROR_GENERAL_ERROR;
+	}
+
+	sCaptureStart = neardal_metrics_prv_now();
+	neardal_capture_fp = fp;
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_capture_stop: stop capturing
+ ****************************************************************************/
+errorCode_t neardal_capture_stop(void)
+{
+	FILE *fp = neardal_capture_fp;
+
+	if (fp == NULL)
+		return NEARDAL_ERROR_GENERAL_ERROR;
+
+	neardal_capture_fp = NULL;
+
+	return fclose(fp) == 0 ? NEARDAL_SUCCESS : NEARDAL_ERROR_GENERAL_ERROR;
+}
+
+/*****************************************************************************
+ * neardal_capture_prv_read: read one event. Returns FALSE at the end of the
+ * capture, sets 'err' if the event is corrupted.
+ ****************************************************************************/
+static gboolean neardal_capture_prv_read(FILE *fp, guint8 *kind, guint64 *ts,
+					 gchar **path, GVariant **data,
+					 errorCode_t *err)
+{
+	guint16	pathLen;
+	guint32	dataLen;
+	gchar	*buf;
+
+	*path = NULL;
+	*data = NULL;
+
+	if (fread(kind, 1, 1, fp) != 1)
+		return FALSE;	/* End of capture */
+
+	*err = NEARDAL_ERROR_INVALID_RECORD;
+	if (*kind >= NEARDAL_CAPTURE_COUNT ||
+	    fread(ts, sizeof(*ts), 1, fp) != 1 ||
+	    fread(&pathLen, sizeof(pathLen), 1, fp) != 1)
+		return FALSE;
+	*ts = GUINT64_FROM_LE(*ts);
+	pathLen = GUINT16_FROM_LE(pathLen);
+
+	*path = g_malloc(pathLen + 1);
+	if (fread(*path, 1, pathLen, fp) != pathLen)
+		goto error;
+	(*path)[pathLen] = '\0';
+	if (!g_variant_is_object_path(*path) ||
+	    fread(&dataLen, sizeof(dataLen), 1, fp) != 1)
+		goto error;
+	dataLen = GUINT32_FROM_LE(dataLen);
+
+	if (sCaptureTypes[*kind] == NULL) {
+		if (dataLen != 0)
+			goto error;
+	} else {
+		buf = g_try_malloc(dataLen ? dataLen : 1);
+		if (buf == NULL || fread(buf, 1, dataLen, fp) != dataLen) {
+			g_free(buf);
+			goto error;
+		}
+		*data = g_variant_new_from_data(
+				G_VARIANT_TYPE(sCaptureTypes[*kind]), buf,
+				dataLen, FALSE, g_free, buf);
+		g_variant_ref_sink(*data);
+	}
+
+	*err = NEARDAL_SUCCESS;
+	return TRUE;
+
+error:
+	g_free(*path);
+	*path = NULL;
+	return FALSE;
+}
+
+/*****************************************************************************
+ * neardal_capture_prv_replies_free: release a queue of replayed replies
+ ****************************************************************************/
+static void neardal_capture_prv_replies_free(gpointer data)
+{
+	GQueue		*replies = data;
+	GVariant	*reply;
+
+	while ((reply = g_queue_pop_head(replies)) != NULL)
+		g_variant_unref(reply);
+	g_queue_free(replies);
+}
+
+/*****************************************************************************
+ * neardal_capture_prv_replay_clear: drop the replies of the last replay
+ ****************************************************************************/
+void neardal_capture_prv_replay_clear(void)
+{
+	guint	i;
+
+	for (i = 0; i < NEARDAL_CAPTURE_COUNT; i++) {
+		if (sReplayReplies[i] != NULL)
+			g_hash_table_destroy(sReplayReplies[i]);
+		sReplayReplies[i] = NULL;
+	}
+}
+
+/*****************************************************************************
+ * neardal_capture_prv_queue_reply: keep a captured method reply for the
+ * call it answers
+ ****************************************************************************/
+static void neardal_capture_prv_queue_reply(guint8 kind, const gchar *path,
+					    GVariant *data)
+{
+	GQueue	*replies;
+
+	if (sReplayReplies[kind] == NULL)
+		sReplayReplies[kind] = g_hash_table_new_full(g_str_hash,
+					g_str_equal, g_free,
+					neardal_capture_prv_replies_free);
+
+	replies = g_hash_table_lookup(sReplayReplies[kind], path);
+	if (replies == NULL) {
+		replies = g_queue_new();
+		g_hash_table_insert(sReplayReplies[kind], g_strdup(path),
+				    replies);
+	}
+	g_queue_push_tail(replies, g_variant_ref(data));
+}
+
+/*****************************************************************************
+ * neardal_capture_prv_reply: next replayed reply of a call on 'path'
+ ****************************************************************************/
+GVariant *neardal_capture_prv_reply(neardalCaptureEvent event,
+				    const gchar *path)
+{
+	GQueue	*replies;
+
+	if (sReplayReplies[event] == NULL)
+		return NULL;
+
+	replies = g_hash_table_lookup(sReplayReplies[event], path);
+	if (replies == NULL)
+		return NULL;
+
+	return g_queue_pop_head(replies);
+}
+
+/*****************************************************************************
+ * neardal_capture_prv_replay_event: feed one event to its NEARDAL handler
+ ****************************************************************************/
+static void neardal_capture_prv_replay_event(guint8 kind, const gchar *path,
+					     GVariant *data)
+{
+	AdpProp		*adpProp = NULL;
+	const gchar	**interfaces;
+	gchar		*adpName;
+
+	switch (kind) {
+	case NEARDAL_CAPTURE_OBJECTS:
+		neardal_mgr_objects_sync(data);
+		break;
+
+	case NEARDAL_CAPTURE_IFACES_ADDED:
+		neardal_mgr_interfaces_added(NULL, path, data);
+		break;
+
+	case NEARDAL_CAPTURE_IFACES_REMOVED:
+		interfaces = g_variant_get_strv(data, NULL);
+		neardal_mgr_interfaces_removed(NULL, path, interfaces);
+		g_free(interfaces);
+		break;
+
+	case NEARDAL_CAPTURE_ADP_ADDED:
+		neardal_sim_add_adapter(path);
+		break;
+
+	case NEARDAL_CAPTURE_ADP_REMOVED:
+		neardal_sim_remove_adapter(path);
+		break;
+
+	case NEARDAL_CAPTURE_ADP_CHANGED:
+		if (neardal_mgr_prv_get_adapter((gchar *) path, &adpProp) ==
+		    NEARDAL_SUCCESS)
+			neardal_adp_prv_properties_changed(adpProp, data);
+		break;
+
+	case NEARDAL_CAPTURE_TAG_FOUND:
+	case NEARDAL_CAPTURE_TAG_LOST:
+		adpName = neardal_dirname(path);
+		if (adpName != NULL &&
+		    neardal_mgr_prv_get_adapter(adpName, &adpProp) ==
+		    NEARDAL_SUCCESS) {
+			if (kind == NEARDAL_CAPTURE_TAG_FOUND)
+				neardal_adp_prv_cb_tag_found(NULL, path,
+							     adpProp);
+			else
+				neardal_adp_prv_cb_tag_lost(NULL, path,
+							    adpProp);
+		}
+		g_free(adpName);
+		break;
+
+	default:
+		/* Method replies, loaded before the replay */
+		break;
+	}
+}
+
+/*****************************************************************************
+ * neardal_replay: replay a capture on the simulator
+ ****************************************************************************/
+errorCode_t neardal_replay(const char *fileName, int realTime,
+			   unsigned int *nbEvents)
+{
+	errorCode_t	err = NEARDAL_SUCCESS;
+	FILE		*fp;
+	gchar		magic[CAPTURE_MAGIC_LEN];
+	guint8		kind;
+	guint64		ts, start, now;
+	gchar		*path;
+	GVariant	*data;
+	guint		count = 0;
+
+	if (nbEvents != NULL)
+		*nbEvents = 0;
+	if (fileName == NULL)
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	err = neardal_sim_enable(TRUE);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+	neardal_prv_construct(&err);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	fp = fopen(fileName, "rb");
+	if (fp == NULL) {
+		NEARDAL_TRACE_ERR("Can't open capture file %s\n", fileName);
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+	}
+	if (fread(magic, sizeof(magic), 1, fp) != 1 ||
+	    memcmp(magic, CAPTURE_MAGIC, CAPTURE_MAGIC_LEN) != 0) {
+		fclose(fp);
+		return NEARDAL_ERROR_INVALID_RECORD;
+	}
+
+	/* Method replies first: they answer the calls the client makes while
+	 * the events are replayed (e.g. a read from its 'tag found' callback,
+	 * captured before its reply) */
+	neardal_capture_prv_replay_clear();
+	while (neardal_capture_prv_read(fp, &kind, &ts, &path, &data, &err)) {
+		if (kind >= NEARDAL_CAPTURE_ADP_SET)
+			neardal_capture_prv_queue_reply(kind, path, data);
+		g_free(path);
+		if (data != NULL)
+			g_variant_unref(data);
+	}
+	err = NEARDAL_SUCCESS;
+	if (fseek(fp, CAPTURE_MAGIC_LEN, SEEK_SET) != 0) {
+		fclose(fp);
+		return NEARDAL_ERROR_GENERAL_ERROR;
+	}
+
+	start = neardal_metrics_prv_now();
+	while (neardal_capture_prv_read(fp, &kind, &ts, &path, &data, &err)) {
+		if (realTime) {
+			now = neardal_metrics_prv_now();
+			if (start + ts > now)
+				g_usleep((start + ts - now) / 1000);
+		}
+		neardal_capture_prv_replay_event(kind, path, data);
+		count++;
+
+		g_free(path);
+		if (data != NULL)
+			g_variant_unref(data);
+	}
+	fclose(fp);
+
+	if (err != NEARDAL_SUCCESS)
+		NEARDAL_TRACE_ERR("Corrupted capture %s (event %u)\n", fileName,
+				  count);
+	if (nbEvents != NULL)
+		*nbEvents = count;
+
+	return err;
+}
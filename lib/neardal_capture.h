@@ -0,0 +1,87 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+/*!
+ * @file neardal_capture.h
+ *
+ * @brief Capture of the neard traffic received by NEARDAL, and replay.
+ *
+ * A capture records every signal and method reply NEARDAL acts upon, with
+ * its reception time, in a compact binary file. Setting the NEARDAL_CAPTURE
+ * environment variable to a file name starts a capture when NEARDAL is
+ * constructed, without changing the application.
+ *
+ * A replay feeds a capture back through the same NEARDAL handlers, on the
+ * in-process simulator (see neardal_sim.h), at the original pace or as fast
+ * as possible: client callbacks see the same events as during the capture,
+ * and the calls made on an object get its captured replies, in order.
+ *
+ ******************************************************************************/
+
+#ifndef NEARDAL_CAPTURE_H
+#define NEARDAL_CAPTURE_H
+#include "neardal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif	/* __cplusplus */
+
+/*! \fn errorCode_t neardal_capture_start(const char *fileName)
+ * @brief Start capturing received traffic into a file (truncated): the
+ * initial objects, objects added and removed, adapters added and removed,
+ * adapter property changes, tags found and lost, and the replies of adapter
+ * Set/StartPollLoop/StopPollLoop, tag Write/GetRawNDEF and device Push.
+ * Tag, record and device property changes are not received by NEARDAL, so
+ * they are not captured.
+ *
+ * @param fileName capture file
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_capture_start(const char *fileName);
+
+/*! \fn errorCode_t neardal_capture_stop(void)
+ * @brief Stop capturing, close the capture file
+ *
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_capture_stop(void);
+
+/*! \fn errorCode_t neardal_replay(const char *fileName, int realTime,
+ *				  unsigned int *nbEvents)
+ * @brief Replay a capture on the simulator. The simulator is selected if
+ * NEARDAL is not already constructed on DBus. Client callbacks are invoked
+ * synchronously, from this function. Until the next replay, calls on an
+ * object get its captured method replies in order, then the simulator's
+ * own once they run out (writes answered from the capture don't change
+ * the simulated tag: the captured events do).
+ *
+ * @param fileName capture file
+ * @param realTime non zero: respect the captured event times, 0: as fast as
+ * possible
+ * @param nbEvents optional, number of events replayed
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_replay(const char *fileName, int realTime,
+			   unsigned int *nbEvents);
+
+#ifdef __cplusplus
+}
+#endif	/* __cplusplus */
+
+#endif /* NEARDAL_CAPTURE_H */
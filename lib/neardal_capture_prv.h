@@ -0,0 +1,84 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef NEARDAL_CAPTURE_PRV_H
+#define NEARDAL_CAPTURE_PRV_H
+
+/* Traffic capture (neardal_capture_start()): every event NEARDAL receives
+ * is appended to the capture file, with its reception time. Tag, record and
+ * device PropertiesChanged are not received (NEARDAL doesn't subscribe to
+ * them), hence not captured. Capture file:
+ *
+ *   header	"NDALCAP1"
+ *   event	u8 kind, u64 time (ns since capture start), u16 path length,
+ *		path, u32 data length, data (serialized GVariant, type given
+ *		by the kind below, no data if none)
+ *
+ * Integers are little endian. */
+typedef enum {
+	NEARDAL_CAPTURE_OBJECTS = 0,	/* GetManagedObjects: a{oa{sa{sv}}} */
+	NEARDAL_CAPTURE_IFACES_ADDED,	/* InterfacesAdded: a{sa{sv}} */
+	NEARDAL_CAPTURE_IFACES_REMOVED,	/* InterfacesRemoved: as */
+	NEARDAL_CAPTURE_ADP_ADDED,	/* Manager AdapterAdded */
+	NEARDAL_CAPTURE_ADP_REMOVED,	/* Manager AdapterRemoved */
+	NEARDAL_CAPTURE_ADP_CHANGED,	/* Adapter PropertiesChanged: a{sv} */
+	NEARDAL_CAPTURE_TAG_FOUND,	/* Adapter TagFound */
+	NEARDAL_CAPTURE_TAG_LOST,	/* Adapter TagLost */
+	/* Method replies, from here (errorCode_t of the call, path of the
+	 * object called) */
+	NEARDAL_CAPTURE_ADP_SET,	/* Adapter property Set: i */
+	NEARDAL_CAPTURE_ADP_POLL,	/* Adapter Start/StopPollLoop: i */
+	NEARDAL_CAPTURE_TAG_WRITE,	/* Tag Write: i */
+	NEARDAL_CAPTURE_TAG_RAW_NDEF,	/* Tag GetRawNDEF: (iay) */
+	NEARDAL_CAPTURE_DEV_PUSH,	/* Device Push: i */
+	NEARDAL_CAPTURE_COUNT
+} neardalCaptureEvent;
+
+/* Capture file, NULL when not capturing */
+extern FILE *neardal_capture_fp;
+
+/* Record an event if capturing ('data' is only evaluated then, and
+ * consumed if floating) */
+#define NEARDAL_CAPTURE(event, path, data)				\
+	do {								\
+		if (neardal_capture_fp != NULL)				\
+			neardal_capture_prv_event((event), (path), (data)); \
+	} while (0)
+
+/*****************************************************************************
+ * neardal_capture_prv_event: append an event to the capture file
+ ****************************************************************************/
+void neardal_capture_prv_event(neardalCaptureEvent event, const gchar *path,
+			       GVariant *data);
+
+/*****************************************************************************
+ * neardal_capture_prv_reply: next captured method reply for the object
+ * 'path', loaded by neardal_replay() (NULL if none left), for the simulator
+ * to answer the call with
+ ****************************************************************************/
+GVariant *neardal_capture_prv_reply(neardalCaptureEvent event,
+				    const gchar *path);
+
+/*****************************************************************************
+ * neardal_capture_prv_replay_clear: drop the replies of the last replay
+ ****************************************************************************/
+void neardal_capture_prv_replay_clear(void);
+
+#endif	/* NEARDAL_CAPTURE_PRV_H */
@@ -27,8 +27,9 @@
 static void neardal_dev_prv_free(DevProp **devProp)
 {
 	NEARDAL_TRACEIN();
-	g_free((*devProp)->name);
-	g_free((*devProp));
+	neardal_record_prv_clear(&(*devProp)->rcds);
+	neardal_pool_prv_strfree((*devProp)->name);
+	neardal_pool_prv_free(NEARDAL_POOL_DEV, *devProp);
 	(*devProp) = NULL;
 }
 
@@ -39,33 +40,38 @@ static void neardal_dev_prv_free(DevProp **devProp)
 void neardal_dev_notify_dev_found(DevProp *devProp)
 {
 	RcdProp *rcdProp;
-	gsize	len;
+	guint	i;
 
 	NEARDAL_ASSERT(devProp != NULL);
 
 	if (devProp->notified == FALSE && neardalMgr.cb.dev_found != NULL) {
+		NEARDAL_PROBE_CB_DISPATCH("dev_found", devProp->name);
 		(neardalMgr.cb.dev_found)(devProp->name,
 					   neardalMgr.cb.dev_found_ud);
+		NEARDAL_PROBE_CB_RETURN("dev_found", devProp->name);
 		devProp->notified = TRUE;
 	}
 
-	len = 0;
-	if (neardalMgr.cb.rcd_found != NULL)
-		while (len < g_list_length(devProp->rcdList)) {
-			rcdProp = g_list_nth_data(devProp->rcdList, len++);
-			if (rcdProp->notified == FALSE) {
-				(neardalMgr.cb.rcd_found)(rcdProp->name,
-						neardalMgr.cb.rcd_found_ud);
-				rcdProp->notified = TRUE;
-			}
-		}
+	if (neardalMgr.cb.rcd_found == NULL)
+		return;
+
+	for (i = neardal_record_prv_next_pending(&devProp->rcds, 0);
+	     i < devProp->rcds.len;
+	     i = neardal_record_prv_next_pending(&devProp->rcds, i + 1)) {
+		rcdProp = &devProp->rcds.rcds[i];
+		neardal_record_prv_set_notified(&devProp->rcds, i);
+		NEARDAL_PROBE_CB_DISPATCH("rcd_found", rcdProp->name);
+		(neardalMgr.cb.rcd_found)(rcdProp->name,
+					  neardalMgr.cb.rcd_found_ud);
+		NEARDAL_PROBE_CB_RETURN("rcd_found", rcdProp->name);
+	}
 }
 
 errorCode_t neardal_dev_push(neardal_record *record)
 {
-	GError		*gerror	= NULL;
 	errorCode_t	err;
 	GVariant	*in;
+	guint64		start;
 
 	neardal_prv_construct(&err);
 	if (err != NEARDAL_SUCCESS)
@@ -73,23 +79,46 @@ errorCode_t neardal_dev_push(neardal_record *record)
 
 	in = neardal_record_to_g_variant(record);
 
-	g_dbus_connection_call_sync(neardalMgr.conn,
-					"org.neard",
-                                        record->name,
-                                        "org.neard.Device",
-                                        "Push",
-					g_variant_new("(@a{sv})", in),
-					NULL,
-                                        G_DBUS_CALL_FLAGS_NONE,
-                                        3000, /* 3 secs */
-                                        NULL,
-                                        &gerror);
+	NEARDAL_PROBE1(dev_push, record->name);
+	start = neardal_metrics_prv_now();
+	err = neardalMgr.backend->dev_push(record->name, in);
+	neardal_metrics_prv_op(NEARDAL_STATS_OP_PUSH, start,
+			       err != NEARDAL_SUCCESS);
+	NEARDAL_PROBE2(dev_push_done, record->name, err);
+exit:
+	return err;
+}
+
+/*****************************************************************************
+ * neardal_dev_prv_dbus_push: DBus backend, invoke Neard Device 'Push' method
+ ****************************************************************************/
+errorCode_t neardal_dev_prv_dbus_push(const gchar *devName, GVariant *record)
+{
+	GError		*gerror	= NULL;
+	GVariant	*ret;
+	errorCode_t	err	= NEARDAL_SUCCESS;
+
+	ret = g_dbus_connection_call_sync(neardalMgr.conn,
+					  "org.neard",
+					  devName,
+					  "org.neard.Device",
+					  "Push",
+					  g_variant_new("(@a{sv})", record),
+					  NULL,
+					  G_DBUS_CALL_FLAGS_NONE,
+					  3000, /* 3 secs */
+					  NULL,
+					  &gerror);
 	if (gerror) {
 		NEARDAL_TRACE_ERR("Can't push record: %s\n", gerror->message);
 		g_error_free(gerror);
 		err = NEARDAL_ERROR_DBUS_CANNOT_INVOKE_METHOD;
 	}
-exit:
+	if (ret != NULL)
+		g_variant_unref(ret);
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_DEV_PUSH, devName,
+			g_variant_new_int32(err));
+
 	return err;
 }
 
@@ -107,14 +136,17 @@ errorCode_t neardal_dev_prv_add(gchar *devName, void *parent)
 			  , NEARDAL_ERROR_INVALID_PARAMETER);
 
 	NEARDAL_TRACEF("Adding dev:%s\n", devName);
-	devProp = g_try_malloc0(sizeof(DevProp));
+	devProp = neardal_pool_prv_alloc0(NEARDAL_POOL_DEV);
 	if (devProp == NULL)
 		goto error;
 
-	devProp->name	= g_strdup(devName);
+	devProp->name	= neardal_pool_prv_strdup(devName);
+	if (devProp->name == NULL)
+		goto error;
 	devProp->parent	= adpProp;
 
 	adpProp->devList = g_list_prepend(adpProp->devList, devProp);
+	neardal_metrics_prv_count(NEARDAL_COUNTER_DEV_FOUND);
 
 	NEARDAL_TRACEF("NEARDAL LIB devList contains %d elements\n",
 		      g_list_length(adpProp->devList));
@@ -122,10 +154,10 @@ errorCode_t neardal_dev_prv_add(gchar *devName, void *parent)
 	return NEARDAL_SUCCESS;
 
 error:
-	if (devProp->name != NULL)
-		g_free(devProp->name);
-	if (devProp != NULL)
-		g_free(devProp);
+	if (devProp != NULL) {
+		neardal_pool_prv_strfree(devProp->name);
+		neardal_pool_prv_free(NEARDAL_POOL_DEV, devProp);
+	}
 
 	return err;
 }
@@ -136,17 +168,27 @@ error:
  ****************************************************************************/
 void neardal_dev_prv_remove(DevProp *devProp)
 {
-	RcdProp		*rcdProp	= NULL;
-	GList		*node;
 	AdpProp		*adpProp;
 
 	NEARDAL_ASSERT(devProp != NULL);
 
+	adpProp = devProp->parent;
+	neardal_dev_prv_remove_link(g_list_find(adpProp->devList, devProp));
+}
+
+void neardal_dev_prv_remove_link(GList *link)
+{
+	DevProp		*devProp;
+	AdpProp		*adpProp;
+
+	NEARDAL_ASSERT(link != NULL);
+	devProp = link->data;
+
 	NEARDAL_TRACEF("Removing dev:%s\n", devProp->name);
 
 	adpProp = devProp->parent;
-	adpProp->devList = g_list_remove(adpProp->devList,
-					 (gconstpointer) devProp);
+	adpProp->devList = g_list_delete_link(adpProp->devList, link);
+	neardal_metrics_prv_count(NEARDAL_COUNTER_DEV_LOST);
 
 	neardal_dev_prv_free(&devProp);
 }
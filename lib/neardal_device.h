@@ -31,8 +31,7 @@ typedef struct {
 	void		*parent;  /* parent (adapter ) */
 	gboolean	notified; /* Already notified to client? */
 
-	gsize		rcdLen;
-	GList		*rcdList;	/* dev's records paths */
+	RcdArray	rcds;		/* dev's records */
 } DevProp;
 
 /*****************************************************************************
@@ -53,4 +52,15 @@ errorCode_t neardal_dev_prv_add(gchar *devName, void *parent);
  *****************************************************************************/
 void neardal_dev_prv_remove(DevProp *devProp);
 
+/******************************************************************************
+ * neardal_dev_prv_remove_link: same, for the dev of a link of its adapter
+ * dev list (no list walk)
+ *****************************************************************************/
+void neardal_dev_prv_remove_link(GList *link);
+
+/******************************************************************************
+ * neardal_dev_prv_dbus_push: DBus backend, push a record to a device
+ *****************************************************************************/
+errorCode_t neardal_dev_prv_dbus_push(const gchar *devName, GVariant *record);
+
 #endif /* NEARDAL_DEV_H */
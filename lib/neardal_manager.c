@@ -28,11 +28,7 @@
 
 #include "neardal.h"
 #include "neardal_prv.h"
-
-void neardal_adp_prv_cb_tag_found(OrgNeardTag *proxy,
-			const gchar *arg_unnamed_arg0, void *user_data);
-void neardal_adp_prv_cb_tag_lost(OrgNeardTag *proxy,
-			const gchar *arg_unnamed_arg0, void *user_data);
+#include "neardal_adapter.h"
 
 TagProp *neardal_mgr_tag_search(const gchar *tag)
 {
@@ -77,7 +73,7 @@ static void neardal_mgr_tag_add(const gchar *path, GVariant *tag)
 	char *adapter = NULL;
 	AdpProp *adpProp = NULL;
 
-	NEARDAL_TRACEF("Tag: %s\n", g_variant_print(tag, TRUE));
+	NEARDAL_TRACEF("Tag: %s\n", neardal_trace_prv_variant(tag));
 
 	if (!g_variant_lookup(tag, "Adapter", "o", &adapter) ||
 			neardal_mgr_prv_get_adapter(adapter, &adpProp) !=
@@ -96,11 +92,6 @@ error:
 	g_free(adapter);
 }
 
-void neardal_adp_prv_cb_dev_found(void *proxy,
-				const gchar *arg_unnamed_arg0, void *user_data);
-void neardal_adp_prv_cb_dev_lost(void *proxy,
-				const gchar *arg_unnamed_arg0, void *user_data);
-
 static AdpProp *neardal_adapter_find_by_child(const char *path)
 {
 	char *name = neardal_dirname(path);
@@ -110,20 +101,25 @@ static AdpProp *neardal_adapter_find_by_child(const char *path)
 	return adapter;
 }
 
-static void neardal_mgr_interfaces_added(ObjectManager *om,
-					const gchar *path, GVariant *interfaces)
+void neardal_mgr_interfaces_added(ObjectManager *om, const gchar *path,
+				  GVariant *interfaces)
 {
 	GVariant *v = NULL;
 
+	neardalMgr.ifaceAddedTs = neardal_metrics_prv_now();
+	NEARDAL_PROBE1(mgr_interfaces_added, path);
+
 	NEARDAL_TRACEF("path=%s\n", path);
-	NEARDAL_TRACEF("interfaces=%s\n", g_variant_print(interfaces, TRUE));
+	NEARDAL_TRACEF("interfaces=%s\n",
+		       neardal_trace_prv_variant(interfaces));
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_IFACES_ADDED, path, interfaces);
 
 	if (g_variant_lookup(interfaces, "org.neard.Record", "*",
 				(void *) &v)) {
 		GVariant *record;
 		if ((record = neardal_data_insert(path, "Record", v)))
 			neardal_record_add(record);
-		return;
+		goto exit;
 	}
 
 	if (g_variant_lookup(interfaces, "org.neard.Device", "*",
@@ -131,16 +127,109 @@ static void neardal_mgr_interfaces_added(ObjectManager *om,
 		AdpProp *adp = neardal_adapter_find_by_child(path);
 		if (adp)
 			neardal_adp_prv_cb_dev_found(NULL, path, adp);
-		return;
+		goto exit;
 	}
 
 	if (g_variant_lookup(interfaces, "org.neard.Tag", "*", (void *) &v)) {
 		neardal_mgr_tag_add(path, v);
-		return;
+		goto exit;
 	}
 
 	NEARDAL_TRACE_ERR("Unsupported interface change: path=%s, "
-		"interface=%s\n", path, g_variant_print(interfaces, TRUE));
+		"interface=%s\n", path, neardal_trace_prv_variant(interfaces));
+exit:
+	if (v != NULL)
+		g_variant_unref(v);
+	neardalMgr.ifaceAddedTs = 0;
+	NEARDAL_PROBE1(mgr_interfaces_added_done, path);
+}
+
+/*****************************************************************************
+ * neardal_mgr_objects_add: register a whole topology in one pass over the
+ * GetManagedObjects reply: tag and record properties go to dbus_data and
+ * adapter properties are indexed while reading it. Objects then appear in
+ * dependency order (objects come in any order in the reply): adapters, then
+ * tags and devices, then records.
+ ****************************************************************************/
+errorCode_t neardal_mgr_objects_add(GVariant *objects)
+{
+	errorCode_t	err = NEARDAL_ERROR_NO_ADAPTER;
+	GVariantIter	iter;
+	const gchar	*path;
+	GVariant	*interfaces, *v;
+	GPtrArray	*adapters, *tags, *devices, *records;
+	AdpProp		*adp;
+	guint		i;
+
+	/* Paths point into 'objects' */
+	adapters = g_ptr_array_new();
+	tags = g_ptr_array_new();
+	devices = g_ptr_array_new();
+	records = g_ptr_array_new();
+
+	if (neardalMgr.adp_props == NULL)
+		neardalMgr.adp_props = g_hash_table_new_full(g_str_hash,
+				g_str_equal, g_free,
+				(GDestroyNotify) g_variant_unref);
+
+	g_variant_iter_init(&iter, objects);
+	while (g_variant_iter_next(&iter, "{&o@a{sa{sv}}}", &path,
+				   &interfaces)) {
+		if ((v = g_variant_lookup_value(interfaces, "org.neard.Adapter",
+						NULL))) {
+			g_hash_table_replace(neardalMgr.adp_props,
+					     g_strdup(path), v);
+			g_ptr_array_add(adapters, (gpointer) path);
+		} else if ((v = g_variant_lookup_value(interfaces,
+						"org.neard.Tag", NULL))) {
+			g_datalist_set_data_full(&(neardalMgr.dbus_data), path,
+					v, (GDestroyNotify) g_variant_unref);
+			g_ptr_array_add(tags, (gpointer) path);
+		} else if ((v = g_variant_lookup_value(interfaces,
+						"org.neard.Device", NULL))) {
+			g_variant_unref(v);
+			g_ptr_array_add(devices, (gpointer) path);
+		} else if ((v = g_variant_lookup_value(interfaces,
+						"org.neard.Record", NULL))) {
+			neardal_data_insert(path, "Record", v);
+			g_variant_unref(v);
+			g_ptr_array_add(records, (gpointer) path);
+		}
+		g_variant_unref(interfaces);
+	}
+	NEARDAL_TRACEF("Found %u adapter(s), %u tag(s), %u device(s), "
+		       "%u record(s)\n", adapters->len, tags->len,
+		       devices->len, records->len);
+
+	/* Adapters read their properties from adp_props, tags from
+	 * dbus_data */
+	for (i = 0; i < adapters->len; i++) {
+		err = neardal_adp_add(g_ptr_array_index(adapters, i));
+		if (err != NEARDAL_SUCCESS)
+			break;
+	}
+
+	for (i = 0; i < tags->len; i++) {
+		path = g_ptr_array_index(tags, i);
+		neardal_mgr_tag_add(path, neardal_data_search(path));
+	}
+
+	for (i = 0; i < devices->len; i++) {
+		path = g_ptr_array_index(devices, i);
+		if ((adp = neardal_adapter_find_by_child(path)))
+			neardal_adp_prv_cb_dev_found(NULL, path, adp);
+	}
+
+	for (i = 0; i < records->len; i++)
+		neardal_record_add(neardal_data_search(
+					g_ptr_array_index(records, i)));
+
+	g_ptr_array_free(adapters, TRUE);
+	g_ptr_array_free(tags, TRUE);
+	g_ptr_array_free(devices, TRUE);
+	g_ptr_array_free(records, TRUE);
+
+	return err;
 }
 
 static void neardal_mgr_tag_remove(const gchar *tag)
@@ -154,12 +243,14 @@ static void neardal_mgr_tag_remove(const gchar *tag)
 		return;
 	}
 
-	NEARDAL_TRACEF("Tag's objects: %s\n", g_variant_print(v, TRUE));
+	NEARDAL_TRACEF("Tag's objects: %s\n", neardal_trace_prv_variant(v));
 
 	if (!g_variant_lookup(v, "Adapter", "o", &adapter) ||
 			neardal_mgr_prv_get_adapter(adapter, &adpProp)
-				!= NEARDAL_SUCCESS)
+				!= NEARDAL_SUCCESS) {
+		g_free(adapter);
 		return;
+	}
 
 	NEARDAL_TRACEF("Adapter: %s=%p\n", adapter, (void *) adpProp);
 
@@ -170,18 +261,15 @@ static void neardal_mgr_tag_remove(const gchar *tag)
 	g_free(adapter);
 }
 
-static void neardal_mgr_interfaces_removed(ObjectManager *om,
-						const gchar *path,
-						const gchar *const *interfaces)
+/*****************************************************************************
+ * neardal_mgr_prv_object_remove: unregister the objects of a neard path
+ ****************************************************************************/
+static void neardal_mgr_prv_object_remove(const gchar *path,
+					  const gchar *const *interfaces)
 {
-	char *s = g_strjoinv("' '", (gchar **)interfaces);
+	char *s;
 	int i = 0;
 
-	NEARDAL_TRACEF("path=%s\n", path);
-	NEARDAL_TRACEF("interfaces='%s'\n", s);
-
-	g_free(s);
-
 	while ((s = (char *) interfaces[i++])) {
 		if (strcmp(s, "org.neard.Record") == 0) {
 			GVariant *record;
@@ -214,6 +302,23 @@ static void neardal_mgr_interfaces_removed(ObjectManager *om,
 	}
 }
 
+void neardal_mgr_interfaces_removed(ObjectManager *om, const gchar *path,
+				    const gchar *const *interfaces)
+{
+	char *s = g_strjoinv("' '", (gchar **)interfaces);
+
+	NEARDAL_PROBE1(mgr_interfaces_removed, path);
+	NEARDAL_TRACEF("path=%s\n", path);
+	NEARDAL_TRACEF("interfaces='%s'\n", s);
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_IFACES_REMOVED, path,
+			g_variant_new_strv(interfaces, -1));
+
+	g_free(s);
+
+	neardal_mgr_prv_object_remove(path, interfaces);
+	NEARDAL_PROBE1(mgr_interfaces_removed_done, path);
+}
+
 /*****************************************************************************
  * neardal_mgr_prv_cb_property_changed: Callback called when a NFC Manager
  * Property is changed
@@ -249,7 +354,8 @@ static void neardal_mgr_prv_cb_adapter_added(OrgNeardManager *proxy,
 	(void) user_data; /* remove warning */
 
 	NEARDAL_ASSERT(arg_unnamed_arg0 != NULL);
-	
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_ADP_ADDED, arg_unnamed_arg0, NULL);
+
 	err = neardal_adp_add((char *) arg_unnamed_arg0);
 	if (err != NEARDAL_SUCCESS)
 		return;
@@ -258,6 +364,25 @@ static void neardal_mgr_prv_cb_adapter_added(OrgNeardManager *proxy,
 		      g_list_length(neardalMgr.prop.adpList));
 }
 
+/*****************************************************************************
+ * neardal_mgr_prv_adapter_remove: notify the client and unregister an adapter
+ ****************************************************************************/
+static void neardal_mgr_prv_adapter_remove(AdpProp *adpProp)
+{
+	/* Invoke client cb 'adapter removed' */
+	if (neardalMgr.cb.adp_removed != NULL) {
+		NEARDAL_PROBE_CB_DISPATCH("adp_removed", adpProp->name);
+		(neardalMgr.cb.adp_removed)(adpProp->name,
+					 neardalMgr.cb.adp_removed_ud);
+		NEARDAL_PROBE_CB_RETURN("adp_removed", adpProp->name);
+	}
+
+	if (neardalMgr.adp_props != NULL)
+		g_hash_table_remove(neardalMgr.adp_props, adpProp->name);
+
+	neardal_adp_remove(adpProp);
+}
+
 /*****************************************************************************
  * neardal_mgr_prv_cb_adapter_removed: Callback called when a NFC adapter
  * is removed
@@ -266,92 +391,300 @@ static void neardal_mgr_prv_cb_adapter_removed(OrgNeardManager *proxy,
 					       const gchar *arg_unnamed_arg0,
 					       void *user_data)
 {
-	GList	*node	= NULL;
+	AdpProp	*adpProp = NULL;
 
 	NEARDAL_TRACEIN();
 	(void) proxy; /* remove warning */
 	(void) user_data; /* remove warning */
 
 	NEARDAL_ASSERT(arg_unnamed_arg0 != NULL);
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_ADP_REMOVED, arg_unnamed_arg0, NULL);
 
-	node = g_list_first(neardalMgr.prop.adpList);
-	if (node == NULL) {
+	if (neardal_mgr_prv_get_adapter((gchar *) arg_unnamed_arg0, &adpProp)
+	    != NEARDAL_SUCCESS) {
 		NEARDAL_TRACE_ERR("NFC adapter not found! (%s)\n",
 				  arg_unnamed_arg0);
 		return;
 	}
 
-	/* Invoke client cb 'adapter removed' */
-	if (neardalMgr.cb.adp_removed != NULL)
-		(neardalMgr.cb.adp_removed)((char *) arg_unnamed_arg0,
-					 neardalMgr.cb.adp_removed_ud);
-
-	neardal_adp_remove(((AdpProp *)node->data));
+	neardal_mgr_prv_adapter_remove(adpProp);
 
 	NEARDAL_TRACEF("NEARDAL LIB adapterList contains %d elements\n",
 		      g_list_length(neardalMgr.prop.adpList));
 }
 
-static void neardal_mgr_adapters_parse(GVariant *v, char ***adps, gsize *nadps)
+/*****************************************************************************
+ * neardal_mgr_prv_get_objects: get every neard object, with its properties
+ ****************************************************************************/
+static errorCode_t neardal_mgr_prv_get_objects(GVariant **objects)
 {
-	char *s = NULL;
-	char *t = NULL;
-	GVariantIter iter, *iter2;
-
-	*adps = g_new0(char *, g_variant_n_children(v) + 1);
-	*nadps = 0;
-
-	g_variant_iter_init(&iter, v);
-
-	while (g_variant_iter_loop(&iter, "{oa{sa{sv}}}", &s, &iter2, NULL)) {
-		while (g_variant_iter_loop(iter2, "{s*}", &t, NULL)) {
-			if(!strcmp(t, "org.neard.Adapter"))
-			{
-				NEARDAL_TRACEF("Found adapter: %s\n", s);
-				(*adps)[(*nadps)++] = s;
-				s = NULL;
-				g_free(t);
-				break;
-			}
+	errorCode_t	err		= NEARDAL_SUCCESS;
+	gboolean	ok;
+	guint64		start;
+
+	NEARDAL_ASSERT_RET(objects != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
+
+	start = neardal_metrics_prv_now();
+	ok = object_manager_call_get_managed_objects_sync(neardalMgr.dbus_om,
+			objects, NULL, &neardalMgr.gerror);
+	neardal_metrics_prv_op(NEARDAL_STATS_OP_GET_MANAGED_OBJECTS, start, !ok);
+
+	if (ok) {
+		NEARDAL_CAPTURE(NEARDAL_CAPTURE_OBJECTS, "/", *objects);
+		NEARDAL_TRACEF("Reading:\n%s\n",
+				neardal_trace_prv_variant(*objects));
+	} else {
+		err = NEARDAL_ERROR_DBUS_CANNOT_INVOKE_METHOD;
+		NEARDAL_TRACE_ERR("%d:%s\n", neardalMgr.gerror->code,
+				 neardalMgr.gerror->message);
+		neardal_tools_prv_free_gerror(&neardalMgr.gerror);
+	}
+
+	return err;
+}
+
+
+/*****************************************************************************
+ * neardal_mgr_prv_object_known: TRUE if the object of a GetManagedObjects
+ * entry is already registered (same kinds, same order as
+ * neardal_mgr_objects_add())
+ ****************************************************************************/
+static gboolean neardal_mgr_prv_has_iface(GVariant *interfaces,
+					  const gchar *iface)
+{
+	GVariant *v = g_variant_lookup_value(interfaces, iface, NULL);
+
+	if (v == NULL)
+		return FALSE;
+	g_variant_unref(v);
+
+	return TRUE;
+}
+
+static gboolean neardal_mgr_prv_object_known(const gchar *path,
+					     GVariant *interfaces)
+{
+	AdpProp		*adpProp = NULL;
+	DevProp		*devProp;
+	GList		*node;
+
+	if (neardal_mgr_prv_has_iface(interfaces, "org.neard.Adapter")) {
+		if (neardal_mgr_prv_get_adapter((gchar *) path, &adpProp)
+		    != NEARDAL_SUCCESS)
+			return FALSE;
+		return strcmp(adpProp->name, path) == 0;
+	}
+
+	if (neardal_mgr_prv_has_iface(interfaces, "org.neard.Tag"))
+		return neardal_data_search(path) != NULL;
+
+	if (neardal_mgr_prv_has_iface(interfaces, "org.neard.Device")) {
+		adpProp = neardal_adapter_find_by_child(path);
+		if (adpProp == NULL)
+			return FALSE;
+		for (node = adpProp->devList; node != NULL; node = node->next) {
+			devProp = node->data;
+			if (strcmp(devProp->name, path) == 0)
+				return TRUE;
 		}
+		return FALSE;
 	}
 
-	if (!*nadps) {
-		g_free(*adps);
+	if (neardal_mgr_prv_has_iface(interfaces, "org.neard.Record"))
+		return neardal_data_search(path) != NULL;
+
+	/* Unsupported: nothing to add */
+	return TRUE;
+}
+
+typedef struct {
+	GHashTable	*present;	/* paths of the GetManagedObjects reply */
+	GPtrArray	*records;	/* stale records */
+	GPtrArray	*tags;		/* stale tags */
+	GPtrArray	*lost;		/* stale tags only known by adapters */
+} neardalMgrStale;
+
+static void neardal_mgr_prv_stale_data(GQuark id, gpointer data,
+				       gpointer user_data)
+{
+	neardalMgrStale	*stale = user_data;
+	const gchar	*path = g_quark_to_string(id);
+	const gchar	*type = NULL;
+
+	if (g_hash_table_lookup(stale->present, path) != NULL)
 		return;
-	}
 
-	NEARDAL_TRACEF("Found %lu adapter(s)\n", *nadps);
+	/* Records are stored with their NEARDAL type, tags as sent by neard */
+	if (g_variant_lookup((GVariant *) data, "NeardalType", "&s", &type) &&
+	    strcmp(type, "Record") == 0)
+		g_ptr_array_add(stale->records, g_strdup(path));
+	else
+		g_ptr_array_add(stale->tags, g_strdup(path));
 }
 
 /*****************************************************************************
- * neardal_mgr_prv_get_all_adapters: Check if neard has an adapter
+ * neardal_mgr_objects_sync: bring the registry in line with a
+ * GetManagedObjects reply: objects missing from the reply are removed
+ * (records, tags, devices, then adapters), unknown ones are added. Objects
+ * present on both sides are left untouched, without any client callback.
  ****************************************************************************/
-static errorCode_t neardal_mgr_prv_get_all_adapters(gchar ***adpArray,
-						    gsize *len)
+errorCode_t neardal_mgr_objects_sync(GVariant *objects)
 {
-	errorCode_t	err		= NEARDAL_ERROR_NO_ADAPTER;
+	errorCode_t	err;
+	static const gchar *const rcdIface[] = { "org.neard.Record", NULL };
+	static const gchar *const tagIface[] = { "org.neard.Tag", NULL };
+	neardalMgrStale	stale;
+	GVariantBuilder	builder;
+	GVariantIter	iter;
+	GVariant	*interfaces, *v, *added;
+	const gchar	*path;
+	GPtrArray	*devices, *adapters;
+	GList		*node, *child;
+	AdpProp		*adpProp;
+	DevProp		*devProp;
+	TagProp		*tagProp;
+	guint		i;
+
+	stale.present = g_hash_table_new(g_str_hash, g_str_equal);
+	stale.records = g_ptr_array_new_with_free_func(g_free);
+	stale.tags = g_ptr_array_new_with_free_func(g_free);
+	stale.lost = g_ptr_array_new_with_free_func(g_free);
+	devices = g_ptr_array_new_with_free_func(g_free);
+	adapters = g_ptr_array_new_with_free_func(g_free);
+
+	/* Objects to add, adapter properties refreshed */
+	g_variant_builder_init(&builder, G_VARIANT_TYPE("a{oa{sa{sv}}}"));
+	g_variant_iter_init(&iter, objects);
+	while (g_variant_iter_next(&iter, "{&o@a{sa{sv}}}", &path,
+				   &interfaces)) {
+		g_hash_table_insert(stale.present, (gpointer) path,
+				    (gpointer) path);
+		if (!neardal_mgr_prv_object_known(path, interfaces))
+			g_variant_builder_add(&builder, "{o@a{sa{sv}}}", path,
+					      interfaces);
+		else if (neardalMgr.adp_props != NULL &&
+			 (v = g_variant_lookup_value(interfaces,
+						"org.neard.Adapter", NULL)))
+			g_hash_table_replace(neardalMgr.adp_props,
+					     g_strdup(path), v);
+		g_variant_unref(interfaces);
+	}
+	added = g_variant_ref_sink(g_variant_builder_end(&builder));
+
+	/* Stale objects, collected first: removal updates the lists */
+	g_datalist_foreach(&(neardalMgr.dbus_data), neardal_mgr_prv_stale_data,
+			   &stale);
+	for (node = neardalMgr.prop.adpList; node != NULL; node = node->next) {
+		adpProp = node->data;
+		for (child = adpProp->tagList; child != NULL;
+		     child = child->next) {
+			tagProp = child->data;
+			if (!g_hash_table_lookup(stale.present, tagProp->name) &&
+			    neardal_data_search(tagProp->name) == NULL)
+				g_ptr_array_add(stale.lost,
+						g_strdup(tagProp->name));
+		}
+		for (child = adpProp->devList; child != NULL;
+		     child = child->next) {
+			devProp = child->data;
+			if (!g_hash_table_lookup(stale.present, devProp->name))
+				g_ptr_array_add(devices,
+						g_strdup(devProp->name));
+		}
+		if (!g_hash_table_lookup(stale.present, adpProp->name))
+			g_ptr_array_add(adapters, g_strdup(adpProp->name));
+	}
 
-	NEARDAL_ASSERT_RET(adpArray != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
+	NEARDAL_TRACEF("Stale: %u adapters, %u tags, %u devices, %u records\n",
+		       adapters->len, stale.tags->len + stale.lost->len,
+		       devices->len, stale.records->len);
+
+	for (i = 0; i < stale.records->len; i++)
+		neardal_mgr_prv_object_remove(g_ptr_array_index(stale.records,
+								i), rcdIface);
+	for (i = 0; i < stale.tags->len; i++)
+		neardal_mgr_prv_object_remove(g_ptr_array_index(stale.tags, i),
+					      tagIface);
+	for (i = 0; i < stale.lost->len; i++) {
+		path = g_ptr_array_index(stale.lost, i);
+		adpProp = neardal_adapter_find_by_child(path);
+		if (adpProp != NULL)
+			neardal_adp_prv_cb_tag_lost(NULL, path, adpProp);
+	}
+	for (i = 0; i < devices->len; i++) {
+		path = g_ptr_array_index(devices, i);
+		adpProp = neardal_adapter_find_by_child(path);
+		if (adpProp != NULL)
+			neardal_adp_prv_cb_dev_lost(NULL, path, adpProp);
+	}
+	for (i = 0; i < adapters->len; i++) {
+		if (neardal_mgr_prv_get_adapter(g_ptr_array_index(adapters, i),
+						&adpProp) == NEARDAL_SUCCESS)
+			neardal_mgr_prv_adapter_remove(adpProp);
+	}
 
-	if (object_manager_call_get_managed_objects_sync(neardalMgr.dbus_om,
-			&neardalMgr.dbus_objs, NULL, &neardalMgr.gerror)) {
-		NEARDAL_TRACEF("Reading:\n%s\n",
-				g_variant_print(neardalMgr.dbus_objs, TRUE));
-		NEARDAL_TRACEF("Parsing neard adapters...\n");
+	err = neardal_mgr_objects_add(added);
+	if (err == NEARDAL_ERROR_NO_ADAPTER && neardalMgr.prop.adpList != NULL)
+		err = NEARDAL_SUCCESS;
 
-		neardal_mgr_adapters_parse(neardalMgr.dbus_objs, adpArray, len);
+	g_variant_unref(added);
+	g_hash_table_destroy(stale.present);
+	g_ptr_array_free(stale.records, TRUE);
+	g_ptr_array_free(stale.tags, TRUE);
+	g_ptr_array_free(stale.lost, TRUE);
+	g_ptr_array_free(devices, TRUE);
+	g_ptr_array_free(adapters, TRUE);
 
-		err = *len ? NEARDAL_SUCCESS : NEARDAL_ERROR_NO_ADAPTER;
+	return err;
+}
 
-	} else {
-		err = NEARDAL_ERROR_DBUS_CANNOT_INVOKE_METHOD;
-		NEARDAL_TRACE_ERR("%d:%s\n", neardalMgr.gerror->code,
-				 neardalMgr.gerror->message);
-		neardal_tools_prv_free_gerror(&neardalMgr.gerror);
+/*****************************************************************************
+ * neardal_mgr_prv_neard_appeared: neard owns its bus name. After a restart,
+ * the registry is resynchronized with the new neard objects (proxies follow
+ * the name owner by themselves)
+ ****************************************************************************/
+static void neardal_mgr_prv_neard_appeared(GDBusConnection *conn,
+					   const gchar *name,
+					   const gchar *owner,
+					   gpointer user_data)
+{
+	errorCode_t	err;
+	GVariant	*objects = NULL;
+	guint64		start;
+
+	(void) conn; /* remove warning */
+	(void) user_data; /* remove warning */
+
+	NEARDAL_TRACEF("%s owned by %s\n", name, owner);
+	if (!neardalMgr.neardLost)
+		return;
+	neardalMgr.neardLost = FALSE;
+
+	start = neardal_metrics_prv_now();
+	err = neardal_mgr_prv_get_objects(&objects);
+	if (err == NEARDAL_SUCCESS) {
+		err = neardal_mgr_objects_sync(objects);
+		g_variant_unref(objects);
 	}
+	neardal_metrics_prv_startup(NEARDAL_STATS_STARTUP_RESYNC, start,
+				    err != NEARDAL_SUCCESS &&
+				    err != NEARDAL_ERROR_NO_ADAPTER);
+	NEARDAL_TRACEF("Resync done (%s)\n", neardal_error_get_text(err));
+}
 
-	return err;
+/*****************************************************************************
+ * neardal_mgr_prv_neard_vanished: neard lost its bus name (or is not
+ * running yet). Objects are kept until neard comes back.
+ ****************************************************************************/
+static void neardal_mgr_prv_neard_vanished(GDBusConnection *conn,
+					   const gchar *name,
+					   gpointer user_data)
+{
+	(void) conn; /* remove warning */
+	(void) user_data; /* remove warning */
+
+	NEARDAL_TRACEF("%s vanished\n", name);
+	neardalMgr.neardLost = TRUE;
 }
 
 
@@ -413,19 +746,38 @@ errorCode_t neardal_mgr_prv_get_adapter_from_proxy(OrgNeardAdapter *adpProxy,
 }
 
 /*****************************************************************************
- * neardal_mgr_create: Get Neard Manager Properties = NFC Adapters list.
+ * neardal_mgr_prv_dbus_create: DBus backend, connect to the bus, get Neard
+ * Manager Properties = NFC Adapters list.
  * Create a DBus proxy for the first one NFC adapter if present
  * Register Neard Manager signals ('PropertyChanged')
  ****************************************************************************/
-errorCode_t neardal_mgr_create(void)
+static errorCode_t neardal_mgr_prv_dbus_create(void)
 {
 	errorCode_t	err;
-	gchar		**adpArray = NULL;
-	gsize		adpArrayLen;
-	char		*adpName;
-	guint		len;
+	GVariant	*objects = NULL;
+	guint64		start;
 
 	NEARDAL_TRACEIN();
+	/* Create DBUS connection */
+	start = neardal_metrics_prv_now();
+	neardalMgr.conn = g_bus_get_sync(NEARDAL_DBUS_TYPE, NULL,
+					 &neardalMgr.gerror);
+	neardal_metrics_prv_startup(NEARDAL_STATS_STARTUP_CONNECT, start,
+				    neardalMgr.conn == NULL);
+	if (neardalMgr.conn == NULL) {
+		NEARDAL_TRACE_ERR("Unable to connect to dbus: %s\n",
+				  neardalMgr.gerror->message);
+		neardal_tools_prv_free_gerror(&neardalMgr.gerror);
+		return NEARDAL_ERROR_DBUS;
+	}
+
+	start = neardal_metrics_prv_now();
+	err = neardal_agent_acquire_dbus_name();
+	neardal_metrics_prv_startup(NEARDAL_STATS_STARTUP_AGENT_NAME, start,
+				    err != NEARDAL_SUCCESS);
+	if (err != NEARDAL_SUCCESS)
+		NEARDAL_TRACE_ERR("Agent not managed!\n");
+
 	if (neardalMgr.proxy != NULL) {
 		g_signal_handlers_disconnect_by_func(neardalMgr.proxy,
 			NEARDAL_G_CALLBACK(neardal_mgr_prv_cb_property_changed),
@@ -440,12 +792,15 @@ errorCode_t neardal_mgr_create(void)
 		neardalMgr.proxy = NULL;
 	}
 
+	start = neardal_metrics_prv_now();
 	neardalMgr.proxy = org_neard_manager_proxy_new_sync(neardalMgr.conn,
 					G_DBUS_OBJECT_MANAGER_CLIENT_FLAGS_NONE,
 							NEARD_DBUS_SERVICE,
 							NEARD_MGR_PATH,
 							NULL, /* GCancellable */
 							&neardalMgr.gerror);
+	neardal_metrics_prv_startup(NEARDAL_STATS_STARTUP_MGR_PROXY, start,
+				    neardalMgr.gerror != NULL);
 
 	if (neardalMgr.gerror != NULL) {
 		NEARDAL_TRACE_ERR(
@@ -456,8 +811,6 @@ errorCode_t neardal_mgr_create(void)
 		return NEARDAL_ERROR_DBUS_CANNOT_CREATE_PROXY;
 	}
 
-	g_datalist_init(&(neardalMgr.dbus_data));
-
 	if (neardalMgr.dbus_om != NULL) {
 		g_signal_handlers_disconnect_by_func(neardalMgr.dbus_om,
 			NEARDAL_G_CALLBACK(neardal_mgr_interfaces_added), NULL);
@@ -469,9 +822,12 @@ errorCode_t neardal_mgr_create(void)
 
 	neardalMgr.gerror = NULL;
 
+	start = neardal_metrics_prv_now();
 	neardalMgr.dbus_om = object_manager_proxy_new_sync(neardalMgr.conn, 0,
 				NEARD_DBUS_SERVICE, NEARD_MGR_PATH, NULL,
 				&neardalMgr.gerror);
+	neardal_metrics_prv_startup(NEARDAL_STATS_STARTUP_OM_PROXY, start,
+				    neardalMgr.gerror != NULL);
 	if (neardalMgr.gerror) {
 		NEARDAL_TRACE_ERR("Error creating ObjectManager proxy: %s\n",
 					neardalMgr.gerror->message);
@@ -480,16 +836,20 @@ errorCode_t neardal_mgr_create(void)
 		neardalMgr.proxy = NULL;
 		return NEARDAL_ERROR_DBUS_CANNOT_CREATE_PROXY;
 	}
-
-	/* Get and store NFC adapters (is present) */
-	err = neardal_mgr_prv_get_all_adapters(&adpArray, &adpArrayLen);
-	if (adpArray != NULL && adpArrayLen > 0) {
-		len = 0;
-		while (len < adpArrayLen && err == NEARDAL_SUCCESS) {
-			adpName =  adpArray[len++];
-			err = neardal_adp_add(adpName);
-		}
-		g_strfreev(adpArray);
+	neardalMgr.constructed = TRUE;
+
+	/* Get and register all neard objects */
+	start = neardal_metrics_prv_now();
+	err = neardal_mgr_prv_get_objects(&objects);
+	neardal_metrics_prv_startup(NEARDAL_STATS_STARTUP_GET_OBJECTS, start,
+				    err != NEARDAL_SUCCESS);
+	if (err == NEARDAL_SUCCESS) {
+		start = neardal_metrics_prv_now();
+		err = neardal_mgr_objects_add(objects);
+		neardal_metrics_prv_startup(NEARDAL_STATS_STARTUP_ADAPTERS,
+					    start, err != NEARDAL_SUCCESS &&
+					    err != NEARDAL_ERROR_NO_ADAPTER);
+		g_variant_unref(objects);
 	}
 
 	/* Register for manager signals 'PropertyChanged(String,Variant)' */
@@ -519,25 +879,29 @@ errorCode_t neardal_mgr_create(void)
 	g_signal_connect(neardalMgr.dbus_om, "interfaces-removed",
 		G_CALLBACK(neardal_mgr_interfaces_removed), NULL);
 
+	/* Watch neard restarts */
+	neardalMgr.neardLost = (err != NEARDAL_SUCCESS &&
+				err != NEARDAL_ERROR_NO_ADAPTER);
+	if (neardalMgr.neardWatchId == 0)
+		neardalMgr.neardWatchId = g_bus_watch_name_on_connection(
+					neardalMgr.conn, NEARD_DBUS_SERVICE,
+					G_BUS_NAME_WATCHER_FLAGS_NONE,
+					neardal_mgr_prv_neard_appeared,
+					neardal_mgr_prv_neard_vanished,
+					NULL, NULL);
+
 	return err;
 }
 
 /*****************************************************************************
- * neardal_mgr_destroy: unref DBus proxy, disconnect Neard Manager signals
+ * neardal_mgr_prv_dbus_destroy: DBus backend, unref DBus proxy, disconnect
+ * Neard Manager signals
  ****************************************************************************/
-void neardal_mgr_destroy(void)
+static void neardal_mgr_prv_dbus_destroy(void)
 {
-	GList	*node;
-	GList	**tmpList;
-
-	NEARDAL_TRACEIN();
-	/* Remove all adapters */
-	tmpList = &neardalMgr.prop.adpList;
-	while (g_list_length((*tmpList))) {
-		node = g_list_first((*tmpList));
-		neardal_adp_remove(((AdpProp *)node->data));
-	}
-	neardalMgr.prop.adpList = (*tmpList);
+	if (neardalMgr.neardWatchId > 0)
+		g_bus_unwatch_name(neardalMgr.neardWatchId);
+	neardalMgr.neardWatchId = 0;
 
 	if (neardalMgr.proxy == NULL)
 		return;
@@ -560,12 +924,72 @@ void neardal_mgr_destroy(void)
 	g_signal_handlers_disconnect_by_func(neardalMgr.dbus_om,
 		NEARDAL_G_CALLBACK(neardal_mgr_interfaces_removed), NULL);
 
+	g_object_unref(neardalMgr.dbus_om);
+	neardalMgr.dbus_om = NULL;
+}
+
+/* Neard reached over DBus (default backend) */
+const neardalMgrBackend neardal_mgr_dbus_backend = {
+	.name		= "dbus",
+	.create		= neardal_mgr_prv_dbus_create,
+	.destroy	= neardal_mgr_prv_dbus_destroy,
+	.adp_init	= neardal_adp_prv_dbus_init,
+	.adp_free	= neardal_adp_prv_dbus_free,
+	.tag_init	= neardal_tag_prv_dbus_init,
+	.tag_free	= neardal_tag_prv_dbus_free,
+	.adp_set	= neardal_adp_prv_dbus_set,
+	.adp_poll	= neardal_adp_prv_dbus_poll,
+	.tag_write	= neardal_tag_prv_dbus_write,
+	.tag_write_async = neardal_tag_prv_dbus_write_async,
+	.tag_get_raw_ndef = neardal_tag_prv_dbus_get_raw_ndef,
+	.tag_get_raw_ndef_async = neardal_tag_prv_dbus_get_raw_ndef_async,
+	.dev_push	= neardal_dev_prv_dbus_push
+};
+
+/*****************************************************************************
+ * neardal_mgr_create: create the selected backend (DBus by default), which
+ * reports adapters and NFC objects through neardal_adp_add() and
+ * neardal_mgr_interfaces_added()
+ ****************************************************************************/
+errorCode_t neardal_mgr_create(void)
+{
+	NEARDAL_TRACEIN();
+	if (neardalMgr.backend == NULL)
+		neardalMgr.backend = &neardal_mgr_dbus_backend;
+	NEARDAL_TRACEF("Backend: %s\n", neardalMgr.backend->name);
+
+	g_datalist_init(&(neardalMgr.dbus_data));
+
+	return neardalMgr.backend->create();
+}
+
+/*****************************************************************************
+ * neardal_mgr_destroy: remove adapters, destroy the backend
+ ****************************************************************************/
+void neardal_mgr_destroy(void)
+{
+	GList	*node;
+	GList	**tmpList;
+
+	NEARDAL_TRACEIN();
+	/* Remove all adapters */
+	tmpList = &neardalMgr.prop.adpList;
+	while (g_list_length((*tmpList))) {
+		node = g_list_first((*tmpList));
+		neardal_adp_remove(((AdpProp *)node->data));
+	}
+	neardalMgr.prop.adpList = (*tmpList);
+
+	if (!neardalMgr.constructed)
+		return;
+
+	neardalMgr.backend->destroy();
+
 	g_datalist_clear(&(neardalMgr.dbus_data));
 	neardalMgr.dbus_data = NULL;
+	if (neardalMgr.adp_props != NULL)
+		g_hash_table_destroy(neardalMgr.adp_props);
+	neardalMgr.adp_props = NULL;
 
-	g_variant_unref(neardalMgr.dbus_objs);
-	neardalMgr.dbus_objs = NULL;
-
-	g_object_unref(neardalMgr.dbus_om);
-	neardalMgr.dbus_om = NULL;
+	neardalMgr.constructed = FALSE;
 }
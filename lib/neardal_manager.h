@@ -22,6 +22,7 @@
 #define NEARDAL_MANAGER_H
 
 #include "neardal_adapter.h"
+#include "dbus-object-manager.h"
 
 #define NEARD_DBUS_SERVICE			"org.neard"
 #define NEARD_MGR_PATH				"/"
@@ -35,6 +36,41 @@ typedef struct {
 	GList	*adpList;	/* List of available adapter (AdpProp*) */
 } MgrProp;
 
+/* NEARDAL Manager backend: source of adapters, tags, devices and records
+ * (neard over DBus, or the in-process simulator), and sink of the calls
+ * made on them. Objects are reported to the manager through
+ * neardal_mgr_interfaces_added() / neardal_mgr_interfaces_removed() */
+typedef struct {
+	const gchar	*name;
+	/* Connect, get initial adapters; set neardalMgr.constructed */
+	errorCode_t	(*create)(void);
+	void		(*destroy)(void);
+	/* Per object setup (proxies, properties) and teardown */
+	errorCode_t	(*adp_init)(AdpProp *adpProp);
+	void		(*adp_free)(AdpProp *adpProp);
+	errorCode_t	(*tag_init)(TagProp *tagProp);
+	void		(*tag_free)(TagProp *tagProp);
+	/* Operations ('mode' NULL stops polling) */
+	errorCode_t	(*adp_set)(AdpProp *adpProp, const gchar *key,
+				   GVariant *value);
+	errorCode_t	(*adp_poll)(AdpProp *adpProp, const gchar *mode);
+	errorCode_t	(*tag_write)(TagProp *tagProp, GVariant *record);
+	void		(*tag_write_async)(TagProp *tagProp, GVariant *record,
+					   neardalWriteDone done,
+					   gpointer data);
+	errorCode_t	(*tag_get_raw_ndef)(TagProp *tagProp, GVariant **ndef);
+	void		(*tag_get_raw_ndef_async)(TagProp *tagProp,
+						  neardalRawNdefDone done,
+						  gpointer data);
+	errorCode_t	(*dev_push)(const gchar *devName, GVariant *record);
+} neardalMgrBackend;
+
+/* neard DBus backend (default) */
+extern const neardalMgrBackend neardal_mgr_dbus_backend;
+
+/* In-process simulator backend (see neardal_sim.h) */
+extern const neardalMgrBackend neardal_mgr_sim_backend;
+
 /*****************************************************************************
  * neardal_mgr_prv_get_adapter: Get NEARDAL Adapter from name
  ****************************************************************************/
@@ -56,6 +92,32 @@ errorCode_t neardal_mgr_create(void);
 TagProp *neardal_mgr_tag_search(const gchar *tag);
 TagProp *neardal_mgr_tag_search_by_record(const gchar *record);
 
+/*****************************************************************************
+ * neardal_mgr_interfaces_added: register objects of a new neard path
+ * (ObjectManager 'interfaces-added' handler, also fed by the simulator)
+ ****************************************************************************/
+void neardal_mgr_interfaces_added(ObjectManager *om, const gchar *path,
+				  GVariant *interfaces);
+
+/*****************************************************************************
+ * neardal_mgr_interfaces_removed: unregister objects of a neard path
+ * (ObjectManager 'interfaces-removed' handler, also fed by the simulator)
+ ****************************************************************************/
+void neardal_mgr_interfaces_removed(ObjectManager *om, const gchar *path,
+				    const gchar *const *interfaces);
+
+/*****************************************************************************
+ * neardal_mgr_objects_add: register every object of a GetManagedObjects
+ * reply (a{oa{sa{sv}}}): adapters, tags, devices and records
+ ****************************************************************************/
+errorCode_t neardal_mgr_objects_add(GVariant *objects);
+
+/*****************************************************************************
+ * neardal_mgr_objects_sync: remove the objects missing from a
+ * GetManagedObjects reply and add the new ones (neard restart)
+ ****************************************************************************/
+errorCode_t neardal_mgr_objects_sync(GVariant *objects);
+
 /*****************************************************************************
  * neardal_mgr_destroy: unref DBus proxy, disconnect Neard Manager signals
  ****************************************************************************/
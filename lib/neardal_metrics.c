@@ -0,0 +1,298 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <glib.h>
+
+#include "neardal.h"
+#include "neardal_prv.h"
+
+/* NEARDAL metrics registry */
+typedef struct {
+	guint64		counters[NEARDAL_COUNTER_COUNT];
+	neardalHist	ops[NEARDAL_STATS_OP_COUNT];
+	neardalHist	stages[NEARDAL_STATS_STAGE_COUNT];
+	neardalHist	startup[NEARDAL_STATS_STARTUP_COUNT];
+} neardalMetrics;
+
+/* Kept outside of neardalMgr: survives neardal_destroy() */
+static neardalMetrics sMetrics;
+
+static const char *sOpNames[NEARDAL_STATS_OP_COUNT] = {
+	[NEARDAL_STATS_OP_WRITE]		= "Write",
+	[NEARDAL_STATS_OP_PUSH]			= "Push",
+	[NEARDAL_STATS_OP_START_POLL_LOOP]	= "StartPollLoop",
+	[NEARDAL_STATS_OP_STOP_POLL_LOOP]	= "StopPollLoop",
+	[NEARDAL_STATS_OP_SET]			= "Set",
+	[NEARDAL_STATS_OP_REGISTER_NDEF_AGENT]	= "RegisterNDEFAgent",
+	[NEARDAL_STATS_OP_GET_MANAGED_OBJECTS]	= "GetManagedObjects",
+	[NEARDAL_STATS_OP_GET_RAW_NDEF]		= "GetRawNDEF",
+};
+
+static const char *sStageNames[NEARDAL_STATS_STAGE_COUNT] = {
+	[NEARDAL_STATS_STAGE_TAG_REGISTER]	= "TagRegister",
+	[NEARDAL_STATS_STAGE_TAG_PROXY]		= "TagProxy",
+	[NEARDAL_STATS_STAGE_TAG_DISPATCH]	= "TagDispatch",
+	[NEARDAL_STATS_STAGE_TAG_CALLBACK]	= "TagCallback",
+	[NEARDAL_STATS_STAGE_TAG_FOUND]		= "TagFound",
+	[NEARDAL_STATS_STAGE_RCD_DISPATCH]	= "RecordDispatch",
+	[NEARDAL_STATS_STAGE_RCD_CALLBACK]	= "RecordCallback",
+	[NEARDAL_STATS_STAGE_RCD_FOUND]		= "RecordFound",
+};
+
+static const char *sStartupNames[NEARDAL_STATS_STARTUP_COUNT] = {
+	[NEARDAL_STATS_STARTUP_CONNECT]		= "Connect",
+	[NEARDAL_STATS_STARTUP_AGENT_NAME]	= "AgentName",
+	[NEARDAL_STATS_STARTUP_MGR_PROXY]	= "ManagerProxy",
+	[NEARDAL_STATS_STARTUP_OM_PROXY]	= "ObjectManagerProxy",
+	[NEARDAL_STATS_STARTUP_GET_OBJECTS]	= "GetManagedObjects",
+	[NEARDAL_STATS_STARTUP_ADP_PROXY]	= "AdapterProxy",
+	[NEARDAL_STATS_STARTUP_ADAPTERS]	= "Adapters",
+	[NEARDAL_STATS_STARTUP_TOTAL]		= "Total",
+	[NEARDAL_STATS_STARTUP_RESYNC]		= "Resync",
+};
+
+/*****************************************************************************
+ * neardal_metrics_prv_now: monotonic clock, in nanoseconds
+ ****************************************************************************/
+guint64 neardal_metrics_prv_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (guint64) ts.tv_sec * 1000000000ULL + (guint64) ts.tv_nsec;
+}
+
+/*****************************************************************************
+ * neardal_metrics_prv_hist_index: bucket holding 'value'
+ ****************************************************************************/
+static guint neardal_metrics_prv_hist_index(guint64 value)
+{
+	guint msb, shift;
+
+	if (value < NEARDAL_HIST_SUB_COUNT)
+		return (guint) value;
+
+	if (value >> NEARDAL_HIST_MAX_BITS)
+		return NEARDAL_HIST_BUCKETS - 1;
+
+	msb = 63 - __builtin_clzll(value);
+	shift = msb - NEARDAL_HIST_SUB_BITS;
+
+	return (shift + 1) * NEARDAL_HIST_SUB_COUNT +
+		(guint) (value >> shift) - NEARDAL_HIST_SUB_COUNT;
+}
+
+/*****************************************************************************
+ * neardal_metrics_prv_hist_upper: highest value held by bucket 'index'
+ ****************************************************************************/
+static guint64 neardal_metrics_prv_hist_upper(guint index)
+{
+	guint64 sub;
+	guint shift;
+
+	if (index < NEARDAL_HIST_SUB_COUNT)
+		return index;
+
+	shift = index / NEARDAL_HIST_SUB_COUNT - 1;
+	sub = index % NEARDAL_HIST_SUB_COUNT + NEARDAL_HIST_SUB_COUNT;
+
+	return ((sub + 1) << shift) - 1;
+}
+
+/*****************************************************************************
+ * neardal_metrics_prv_hist_percentile: value at or below which 'permil'
+ * thousandths of the samples fall
+ ****************************************************************************/
+static guint64 neardal_metrics_prv_hist_percentile(const neardalHist *hist,
+						   guint permil)
+{
+	guint64 target, seen = 0;
+	guint index;
+
+	if (hist->count == 0)
+		return 0;
+
+	target = (hist->count * permil + 999) / 1000;
+	if (target == 0)
+		target = 1;
+
+	for (index = 0; index < NEARDAL_HIST_BUCKETS; index++) {
+		seen += hist->buckets[index];
+		if (seen >= target)
+			return MIN(neardal_metrics_prv_hist_upper(index),
+				   hist->max);
+	}
+
+	return hist->max;
+}
+
+/*****************************************************************************
+ * neardal_metrics_prv_hist_add: add one sample to an histogram
+ ****************************************************************************/
+void neardal_metrics_prv_hist_add(neardalHist *hist, guint64 value,
+				  gboolean failed)
+{
+	if (hist->count == 0 || value < hist->min)
+		hist->min = value;
+	if (value > hist->max)
+		hist->max = value;
+	hist->count++;
+	hist->sum += value;
+	if (failed)
+		hist->errors++;
+	hist->buckets[neardal_metrics_prv_hist_index(value)]++;
+}
+
+/*****************************************************************************
+ * neardal_metrics_prv_hist_export: fill client latency summary from an
+ * histogram
+ ****************************************************************************/
+void neardal_metrics_prv_hist_export(const neardalHist *hist,
+				     const char *name, neardal_latency *out)
+{
+	out->name	= name;
+	out->count	= hist->count;
+	out->errors	= hist->errors;
+	out->sumNs	= hist->sum;
+	out->minNs	= hist->min;
+	out->maxNs	= hist->max;
+	out->p50Ns	= neardal_metrics_prv_hist_percentile(hist, 500);
+	out->p90Ns	= neardal_metrics_prv_hist_percentile(hist, 900);
+	out->p99Ns	= neardal_metrics_prv_hist_percentile(hist, 990);
+	out->p999Ns	= neardal_metrics_prv_hist_percentile(hist, 999);
+}
+
+/*****************************************************************************
+ * neardal_metrics_prv_count: increment an event counter
+ ****************************************************************************/
+void neardal_metrics_prv_count(neardalCounter counter)
+{
+	NEARDAL_ASSERT(counter < NEARDAL_COUNTER_COUNT);
+
+	sMetrics.counters[counter]++;
+}
+
+/*****************************************************************************
+ * neardal_metrics_prv_op: record the latency of a D-Bus operation started at
+ * 'start' (see neardal_metrics_prv_now())
+ ****************************************************************************/
+void neardal_metrics_prv_op(neardal_stats_op op, guint64 start,
+			    gboolean failed)
+{
+	NEARDAL_ASSERT(op < NEARDAL_STATS_OP_COUNT);
+
+	neardal_metrics_prv_hist_add(&sMetrics.ops[op],
+				     neardal_metrics_prv_now() - start, failed);
+}
+
+/*****************************************************************************
+ * neardal_metrics_prv_stage: record the latency of a tag detection stage
+ * (ignored if one of the timestamps is missing)
+ ****************************************************************************/
+void neardal_metrics_prv_stage(neardal_stats_stage stage, guint64 from,
+			       guint64 to)
+{
+	NEARDAL_ASSERT(stage < NEARDAL_STATS_STAGE_COUNT);
+
+	if (from == 0 || to < from)
+		return;
+
+	neardal_metrics_prv_hist_add(&sMetrics.stages[stage], to - from,
+				     FALSE);
+}
+
+/*****************************************************************************
+ * neardal_metrics_prv_startup: record the duration of a startup step started
+ * at 'start'
+ ****************************************************************************/
+void neardal_metrics_prv_startup(neardal_stats_startup step, guint64 start,
+				 gboolean failed)
+{
+	NEARDAL_ASSERT(step < NEARDAL_STATS_STARTUP_COUNT);
+
+	neardal_metrics_prv_hist_add(&sMetrics.startup[step],
+				     neardal_metrics_prv_now() - start, failed);
+}
+
+/*****************************************************************************
+ * neardal_get_stats: Get a snapshot of NEARDAL counters and latencies
+ ****************************************************************************/
+errorCode_t neardal_get_stats(neardal_stats **stats)
+{
+	neardal_stats	*out;
+	guint64		*c = sMetrics.counters;
+	int		op, stage, step;
+
+	NEARDAL_ASSERT_RET(stats != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
+
+	out = g_try_malloc0(sizeof(neardal_stats));
+	if (out == NULL)
+		return NEARDAL_ERROR_NO_MEMORY;
+
+	out->adaptersAdded	= c[NEARDAL_COUNTER_ADP_ADDED];
+	out->adaptersRemoved	= c[NEARDAL_COUNTER_ADP_REMOVED];
+	out->tagsFound		= c[NEARDAL_COUNTER_TAG_FOUND];
+	out->tagsLost		= c[NEARDAL_COUNTER_TAG_LOST];
+	out->devsFound		= c[NEARDAL_COUNTER_DEV_FOUND];
+	out->devsLost		= c[NEARDAL_COUNTER_DEV_LOST];
+	out->recordsFound	= c[NEARDAL_COUNTER_RCD_FOUND];
+	out->recordsLost	= c[NEARDAL_COUNTER_RCD_LOST];
+	out->poolAllocs		= c[NEARDAL_COUNTER_POOL_ALLOCS];
+	out->poolSysAllocs	= c[NEARDAL_COUNTER_POOL_SYS_ALLOCS];
+
+	for (op = 0; op < NEARDAL_STATS_OP_COUNT; op++)
+		neardal_metrics_prv_hist_export(&sMetrics.ops[op],
+						sOpNames[op], &out->ops[op]);
+
+	for (stage = 0; stage < NEARDAL_STATS_STAGE_COUNT; stage++)
+		neardal_metrics_prv_hist_export(&sMetrics.stages[stage],
+						sStageNames[stage],
+						&out->stages[stage]);
+
+	for (step = 0; step < NEARDAL_STATS_STARTUP_COUNT; step++)
+		neardal_metrics_prv_hist_export(&sMetrics.startup[step],
+						sStartupNames[step],
+						&out->startup[step]);
+
+	*stats = out;
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_free_stats: Release memory allocated by neardal_get_stats()
+ ****************************************************************************/
+void neardal_free_stats(neardal_stats *stats)
+{
+	g_free(stats);
+}
+
+/*****************************************************************************
+ * neardal_reset_stats: Clear all NEARDAL counters and latencies
+ ****************************************************************************/
+void neardal_reset_stats(void)
+{
+	memset(&sMetrics, 0, sizeof(sMetrics));
+}
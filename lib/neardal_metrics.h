@@ -0,0 +1,103 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef NEARDAL_METRICS_H
+#define NEARDAL_METRICS_H
+
+/* HDR-style log-linear histogram: values below NEARDAL_HIST_SUB_COUNT have
+ * their own bucket, each following power of two is split in
+ * NEARDAL_HIST_SUB_COUNT linear sub-buckets (~6% relative precision) */
+#define NEARDAL_HIST_SUB_BITS		4
+#define NEARDAL_HIST_SUB_COUNT		(1 << NEARDAL_HIST_SUB_BITS)
+#define NEARDAL_HIST_MAX_BITS		40	/* values clamped to ~18 min */
+#define NEARDAL_HIST_BUCKETS		((NEARDAL_HIST_MAX_BITS - \
+					NEARDAL_HIST_SUB_BITS + 1) * \
+					NEARDAL_HIST_SUB_COUNT)
+
+/* NEARDAL latency histogram (nanoseconds) */
+typedef struct {
+	guint64		count;		/* Number of samples */
+	guint64		errors;		/* Number of failed operations */
+	guint64		sum;		/* Sum of samples */
+	guint64		min;		/* Smallest sample */
+	guint64		max;		/* Largest sample */
+	guint64		buckets[NEARDAL_HIST_BUCKETS];
+} neardalHist;
+
+/* NEARDAL event counters */
+typedef enum {
+	NEARDAL_COUNTER_ADP_ADDED = 0,
+	NEARDAL_COUNTER_ADP_REMOVED,
+	NEARDAL_COUNTER_TAG_FOUND,
+	NEARDAL_COUNTER_TAG_LOST,
+	NEARDAL_COUNTER_DEV_FOUND,
+	NEARDAL_COUNTER_DEV_LOST,
+	NEARDAL_COUNTER_RCD_FOUND,
+	NEARDAL_COUNTER_RCD_LOST,
+	NEARDAL_COUNTER_POOL_ALLOCS,
+	NEARDAL_COUNTER_POOL_SYS_ALLOCS,
+	NEARDAL_COUNTER_COUNT
+} neardalCounter;
+
+/*****************************************************************************
+ * neardal_metrics_prv_now: monotonic clock, in nanoseconds
+ ****************************************************************************/
+guint64 neardal_metrics_prv_now(void);
+
+/*****************************************************************************
+ * neardal_metrics_prv_count: increment an event counter
+ ****************************************************************************/
+void neardal_metrics_prv_count(neardalCounter counter);
+
+/*****************************************************************************
+ * neardal_metrics_prv_op: record the latency of a D-Bus operation started at
+ * 'start' (see neardal_metrics_prv_now())
+ ****************************************************************************/
+void neardal_metrics_prv_op(neardal_stats_op op, guint64 start,
+			    gboolean failed);
+
+/*****************************************************************************
+ * neardal_metrics_prv_stage: record the latency of a tag detection stage
+ * (ignored if one of the timestamps is missing)
+ ****************************************************************************/
+void neardal_metrics_prv_stage(neardal_stats_stage stage, guint64 from,
+			       guint64 to);
+
+/*****************************************************************************
+ * neardal_metrics_prv_startup: record the duration of a startup step started
+ * at 'start'
+ ****************************************************************************/
+void neardal_metrics_prv_startup(neardal_stats_startup step, guint64 start,
+				 gboolean failed);
+
+/*****************************************************************************
+ * neardal_metrics_prv_hist_add: add one sample to an histogram
+ ****************************************************************************/
+void neardal_metrics_prv_hist_add(neardalHist *hist, guint64 value,
+				  gboolean failed);
+
+/*****************************************************************************
+ * neardal_metrics_prv_hist_export: fill client latency summary from an
+ * histogram
+ ****************************************************************************/
+void neardal_metrics_prv_hist_export(const neardalHist *hist,
+				     const char *name, neardal_latency *out);
+
+#endif /* NEARDAL_METRICS_H */
@@ -0,0 +1,718 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+
+#include "neardal.h"
+#include "neardal_ndef.h"
+#include "neardal_prv.h"
+#include "neardal_ndef_prv.h"
+
+/* NFC Forum URI RTD abbreviations, by identifier code */
+static const gchar * const sUriPrefixes[] = {
+	"", "http://www.", "https://www.", "http://", "https://", "tel:",
+	"mailto:", "ftp://anonymous:anonymous@", "ftp://ftp.", "ftps://",
+	"sftp://", "smb://", "nfs://", "ftp://", "dav://", "news:",
+	"telnet://", "imap:", "rtsp://", "urn:", "pop:", "sip:", "sips:",
+	"tftp:", "btspp://", "btl2cap://", "btgoep://", "tcpobex://",
+	"irdaobex://", "file://", "urn:epc:id:", "urn:epc:tag:",
+	"urn:epc:pat:", "urn:epc:raw:", "urn:epc:", "urn:nfc:"
+};
+
+/* Message being built */
+struct neardal_ndef_builder {
+	GByteArray	*msg;
+	guint		last;		/* last record header offset */
+};
+
+/* One record chunk header, offsets into the message */
+typedef struct {
+	guint8	flags;
+	guint	typeLen;
+	guint	idLen;
+	guint	payloadLen;
+	guint	type;		/* type offset */
+	guint	id;		/* id offset */
+	guint	payload;	/* payload offset */
+	guint	end;		/* next chunk offset */
+} neardalNdefHdr;
+
+/*****************************************************************************
+ * neardal_ndef_prv_header: decode the chunk header at 'offset', checking
+ * that the whole chunk fits in 'len' bytes
+ ****************************************************************************/
+static gboolean neardal_ndef_prv_header(const guint8 *data, guint len,
+					guint offset, neardalNdefHdr *hdr)
+{
+	guint64	pos = offset;
+
+	if (pos + 2 > len)
+		return FALSE;
+	hdr->flags	= data[pos++];
+	hdr->typeLen	= data[pos++];
+
+	if (hdr->flags & NEARDAL_NDEF_FLAG_SR) {
+		if (pos + 1 > len)
+			return FALSE;
+		hdr->payloadLen = data[pos++];
+	} else {
+		if (pos + 4 > len)
+			return FALSE;
+		hdr->payloadLen = (guint) data[pos] << 24 |
+				  (guint) data[pos + 1] << 16 |
+				  (guint) data[pos + 2] << 8 |
+				  (guint) data[pos + 3];
+		pos += 4;
+	}
+
+	hdr->idLen = 0;
+	if (hdr->flags & NEARDAL_NDEF_FLAG_IL) {
+		if (pos + 1 > len)
+			return FALSE;
+		hdr->idLen = data[pos++];
+	}
+
+	hdr->type = pos;
+	pos += hdr->typeLen;
+	hdr->id = pos;
+	pos += hdr->idLen;
+	hdr->payload = pos;
+	pos += hdr->payloadLen;
+	if (pos > len)
+		return FALSE;
+	hdr->end = pos;
+
+	return TRUE;
+}
+
+/*****************************************************************************
+ * neardal_ndef_iter_init: start walking a raw NDEF message
+ ****************************************************************************/
+errorCode_t neardal_ndef_iter_init(neardal_ndef_iter *iter,
+				   const unsigned char *data,
+				   unsigned int len)
+{
+	NEARDAL_ASSERT_RET(iter != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
+	NEARDAL_ASSERT_RET(data != NULL || len == 0,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	iter->data	= data;
+	iter->len	= len;
+	iter->offset	= 0;
+	iter->end	= (len == 0);
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_ndef_iter_next: parse the next record, following its chunks
+ ****************************************************************************/
+errorCode_t neardal_ndef_iter_next(neardal_ndef_iter *iter,
+				   neardal_ndef_record *record)
+{
+	neardalNdefHdr	hdr;
+	guint64		total;
+	guint		start;
+	guint8		tnf;
+
+	NEARDAL_ASSERT_RET(iter != NULL && record != NULL,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	if (iter->end)
+		return NEARDAL_ERROR_NO_RECORD;
+
+	start = iter->offset;
+	if (!neardal_ndef_prv_header(iter->data, iter->len, start, &hdr))
+		goto invalid;
+
+	/* Message Begin on the first record only */
+	if (!(hdr.flags & NEARDAL_NDEF_FLAG_MB) != (start != 0))
+		goto invalid;
+
+	tnf = hdr.flags & NEARDAL_NDEF_TNF_MASK;
+	if (tnf == NEARDAL_NDEF_TNF_UNCHANGED)
+		goto invalid;
+	if (tnf == NEARDAL_NDEF_TNF_EMPTY &&
+	    (hdr.typeLen != 0 || hdr.idLen != 0 || hdr.payloadLen != 0))
+		goto invalid;
+	if (tnf == NEARDAL_NDEF_TNF_UNKNOWN && hdr.typeLen != 0)
+		goto invalid;
+
+	record->tnf		= (neardal_ndef_tnf) tnf;
+	record->flags		= hdr.flags;
+	record->type		= iter->data + hdr.type;
+	record->typeLen		= hdr.typeLen;
+	record->id		= hdr.idLen ? iter->data + hdr.id : NULL;
+	record->idLen		= hdr.idLen;
+	record->payload		= iter->data + hdr.payload;
+	record->payloadLen	= hdr.payloadLen;
+	record->nbChunks	= 1;
+	total			= hdr.payloadLen;
+
+	/* Middle and terminating chunks: no type, no id, TNF 'unchanged' */
+	while (hdr.flags & NEARDAL_NDEF_FLAG_CF) {
+		if (hdr.flags & NEARDAL_NDEF_FLAG_ME)
+			goto invalid;
+		if (!neardal_ndef_prv_header(iter->data, iter->len, hdr.end,
+					     &hdr))
+			goto invalid;
+		if ((hdr.flags & NEARDAL_NDEF_TNF_MASK) !=
+		    NEARDAL_NDEF_TNF_UNCHANGED ||
+		    (hdr.flags & (NEARDAL_NDEF_FLAG_MB | NEARDAL_NDEF_FLAG_IL)) ||
+		    hdr.typeLen != 0)
+			goto invalid;
+		total += hdr.payloadLen;
+		record->nbChunks++;
+	}
+	if (total > G_MAXUINT)
+		goto invalid;
+
+	record->totalLen	= total;
+	record->raw		= iter->data + start;
+	record->rawLen		= hdr.end - start;
+
+	iter->offset = hdr.end;
+	iter->end = (hdr.flags & NEARDAL_NDEF_FLAG_ME) != 0;
+	if (!iter->end && iter->offset == iter->len)
+		goto invalid;
+
+	return NEARDAL_SUCCESS;
+
+invalid:
+	iter->end = TRUE;
+	return NEARDAL_ERROR_INVALID_RECORD;
+}
+
+/*****************************************************************************
+ * neardal_ndef_iter_nested: walk a Smart Poster or Handover message
+ ****************************************************************************/
+errorCode_t neardal_ndef_iter_nested(neardal_ndef_iter *iter,
+				     const neardal_ndef_record *record)
+{
+	static const char	*handovers[] = { "Hs", "Hr", "Hm", "Hi" };
+	guint			i;
+
+	NEARDAL_ASSERT_RET(iter != NULL && record != NULL,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	if (record->nbChunks != 1)
+		return NEARDAL_ERROR_INVALID_RECORD;
+
+	if (neardal_ndef_record_is(record, NEARDAL_NDEF_TNF_WELL_KNOWN, "Sp"))
+		return neardal_ndef_iter_init(iter, record->payload,
+					      record->payloadLen);
+
+	/* Handover: version byte, then the message */
+	for (i = 0; i < G_N_ELEMENTS(handovers); i++)
+		if (neardal_ndef_record_is(record, NEARDAL_NDEF_TNF_WELL_KNOWN,
+					   handovers[i]) &&
+		    record->payloadLen >= 1)
+			return neardal_ndef_iter_init(iter,
+						      record->payload + 1,
+						      record->payloadLen - 1);
+
+	return NEARDAL_ERROR_INVALID_RECORD;
+}
+
+/*****************************************************************************
+ * neardal_ndef_chunk_next: next payload chunk of a record
+ ****************************************************************************/
+errorCode_t neardal_ndef_chunk_next(const neardal_ndef_record *record,
+				    unsigned int *offset,
+				    const unsigned char **payload,
+				    unsigned int *payloadLen)
+{
+	neardalNdefHdr hdr;
+
+	NEARDAL_ASSERT_RET(record != NULL && offset != NULL &&
+			   payload != NULL && payloadLen != NULL,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	if (*offset >= record->rawLen)
+		return NEARDAL_ERROR_NO_RECORD;
+
+	if (!neardal_ndef_prv_header(record->raw, record->rawLen, *offset,
+				     &hdr))
+		return NEARDAL_ERROR_INVALID_RECORD;
+
+	*payload = record->raw + hdr.payload;
+	*payloadLen = hdr.payloadLen;
+	*offset = hdr.end;
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_ndef_record_is: test a record TNF and type
+ ****************************************************************************/
+int neardal_ndef_record_is(const neardal_ndef_record *record,
+			   neardal_ndef_tnf tnf, const char *type)
+{
+	gsize len;
+
+	NEARDAL_ASSERT_RET(record != NULL && type != NULL, FALSE);
+
+	len = strlen(type);
+
+	return record->tnf == tnf && record->typeLen == len &&
+	       memcmp(record->type, type, len) == 0;
+}
+
+/*****************************************************************************
+ * neardal_ndef_builder_new: create an empty message builder
+ ****************************************************************************/
+errorCode_t neardal_ndef_builder_new(neardal_ndef_builder **builder)
+{
+	NEARDAL_ASSERT_RET(builder != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
+
+	*builder = g_try_malloc0(sizeof(neardal_ndef_builder));
+	if (*builder == NULL)
+		return NEARDAL_ERROR_NO_MEMORY;
+	(*builder)->msg = g_byte_array_new();
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_ndef_builder_free: release a builder and its message
+ ****************************************************************************/
+void neardal_ndef_builder_free(neardal_ndef_builder *builder)
+{
+	if (builder == NULL)
+		return;
+
+	g_byte_array_free(builder->msg, TRUE);
+	g_free(builder);
+}
+
+/*****************************************************************************
+ * neardal_ndef_builder_reset: empty the message
+ ****************************************************************************/
+void neardal_ndef_builder_reset(neardal_ndef_builder *builder)
+{
+	NEARDAL_ASSERT(builder != NULL);
+
+	g_byte_array_set_size(builder->msg, 0);
+	builder->last = 0;
+}
+
+/*****************************************************************************
+ * neardal_ndef_builder_get: encoded message
+ ****************************************************************************/
+errorCode_t neardal_ndef_builder_get(const neardal_ndef_builder *builder,
+				     const unsigned char **data,
+				     unsigned int *len)
+{
+	NEARDAL_ASSERT_RET(builder != NULL && data != NULL && len != NULL,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	*data = builder->msg->data;
+	*len = builder->msg->len;
+
+	return builder->msg->len ? NEARDAL_SUCCESS : NEARDAL_ERROR_NO_RECORD;
+}
+
+/*****************************************************************************
+ * neardal_ndef_prv_append: append a record header, type and id, the payload
+ * being appended by the caller ('payloadLen' bytes). The previous record is
+ * no longer the last one: its Message End flag moves to this record.
+ ****************************************************************************/
+static errorCode_t neardal_ndef_prv_append(neardal_ndef_builder *builder,
+					   guint8 tnf, const guint8 *type,
+					   guint typeLen, const guint8 *id,
+					   guint idLen, guint payloadLen)
+{
+	guint8	hdr[7];
+	guint	n = 0;
+
+	NEARDAL_ASSERT_RET(builder != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
+
+	if (tnf >= NEARDAL_NDEF_TNF_UNCHANGED || typeLen > G_MAXUINT8 ||
+	    idLen > G_MAXUINT8 || (typeLen != 0 && type == NULL) ||
+	    (idLen != 0 && id == NULL))
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+	if ((guint64) builder->msg->len + 7 + typeLen + idLen + payloadLen >
+	    G_MAXUINT)
+		return NEARDAL_ERROR_NO_MEMORY;
+
+	hdr[n++] = tnf | NEARDAL_NDEF_FLAG_ME;
+	if (builder->msg->len == 0)
+		hdr[0] |= NEARDAL_NDEF_FLAG_MB;
+	else
+		builder->msg->data[builder->last] &= ~NEARDAL_NDEF_FLAG_ME;
+	if (idLen != 0)
+		hdr[0] |= NEARDAL_NDEF_FLAG_IL;
+
+	hdr[n++] = typeLen;
+	if (payloadLen <= G_MAXUINT8) {
+		hdr[0] |= NEARDAL_NDEF_FLAG_SR;
+		hdr[n++] = payloadLen;
+	} else {
+		hdr[n++] = payloadLen >> 24;
+		hdr[n++] = payloadLen >> 16;
+		hdr[n++] = payloadLen >> 8;
+		hdr[n++] = payloadLen;
+	}
+	if (idLen != 0)
+		hdr[n++] = idLen;
+
+	builder->last = builder->msg->len;
+	g_byte_array_append(builder->msg, hdr, n);
+	g_byte_array_append(builder->msg, type, typeLen);
+	g_byte_array_append(builder->msg, id, idLen);
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_ndef_add_record: append a record
+ ****************************************************************************/
+errorCode_t neardal_ndef_add_record(neardal_ndef_builder *builder,
+				    neardal_ndef_tnf tnf,
+				    const unsigned char *type,
+				    unsigned int typeLen,
+				    const unsigned char *id,
+				    unsigned int idLen,
+				    const unsigned char *payload,
+				    unsigned int payloadLen)
+{
+	errorCode_t err;
+
+	NEARDAL_ASSERT_RET(payload != NULL || payloadLen == 0,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	err = neardal_ndef_prv_append(builder, tnf, type, typeLen, id, idLen,
+				      payloadLen);
+	if (err == NEARDAL_SUCCESS)
+		g_byte_array_append(builder->msg, payload, payloadLen);
+
+	return err;
+}
+
+/*****************************************************************************
+ * neardal_ndef_add_text: append a UTF-8 Text record
+ ****************************************************************************/
+errorCode_t neardal_ndef_add_text(neardal_ndef_builder *builder,
+				  const char *lang, const char *text)
+{
+	guint8		status;
+	gsize		langLen, textLen;
+	errorCode_t	err;
+
+	NEARDAL_ASSERT_RET(lang != NULL && text != NULL,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	langLen = strlen(lang);
+	textLen = strlen(text);
+	if (langLen > 0x3F || textLen > G_MAXUINT - 1 - langLen)
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	/* Status: UTF-8 (bit 7 clear), language code length */
+	status = langLen;
+	err = neardal_ndef_prv_append(builder, NEARDAL_NDEF_TNF_WELL_KNOWN,
+				      (const guint8 *) "T", 1, NULL, 0,
+				      1 + langLen + textLen);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+	g_byte_array_append(builder->msg, &status, 1);
+	g_byte_array_append(builder->msg, (const guint8 *) lang, langLen);
+	g_byte_array_append(builder->msg, (const guint8 *) text, textLen);
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_ndef_add_uri: append a URI record, longest known prefix
+ * abbreviated
+ ****************************************************************************/
+errorCode_t neardal_ndef_add_uri(neardal_ndef_builder *builder,
+				 const char *uri)
+{
+	guint8		code = 0;
+	gsize		prefixLen = 0, len;
+	guint		i;
+	errorCode_t	err;
+
+	NEARDAL_ASSERT_RET(uri != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
+
+	for (i = 1; i < G_N_ELEMENTS(sUriPrefixes); i++) {
+		len = strlen(sUriPrefixes[i]);
+		if (len > prefixLen && !strncmp(uri, sUriPrefixes[i], len)) {
+			code = i;
+			prefixLen = len;
+		}
+	}
+
+	len = strlen(uri + prefixLen);
+	if (len > G_MAXUINT - 1)
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	err = neardal_ndef_prv_append(builder, NEARDAL_NDEF_TNF_WELL_KNOWN,
+				      (const guint8 *) "U", 1, NULL, 0,
+				      1 + len);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+	g_byte_array_append(builder->msg, &code, 1);
+	g_byte_array_append(builder->msg, (const guint8 *) uri + prefixLen,
+			    len);
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_ndef_add_mime: append a MIME record
+ ****************************************************************************/
+errorCode_t neardal_ndef_add_mime(neardal_ndef_builder *builder,
+				  const char *mime, const unsigned char *data,
+				  unsigned int len)
+{
+	NEARDAL_ASSERT_RET(mime != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
+
+	return neardal_ndef_add_record(builder, NEARDAL_NDEF_TNF_MIME,
+				       (const guint8 *) mime, strlen(mime),
+				       NULL, 0, data, len);
+}
+
+/*****************************************************************************
+ * neardal_ndef_add_external: append an external type record
+ ****************************************************************************/
+errorCode_t neardal_ndef_add_external(neardal_ndef_builder *builder,
+				      const char *type,
+				      const unsigned char *data,
+				      unsigned int len)
+{
+	NEARDAL_ASSERT_RET(type != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
+
+	return neardal_ndef_add_record(builder, NEARDAL_NDEF_TNF_EXTERNAL,
+				       (const guint8 *) type, strlen(type),
+				       NULL, 0, data, len);
+}
+
+/*****************************************************************************
+ * neardal_ndef_add_smart_poster: append a Smart Poster record
+ ****************************************************************************/
+errorCode_t neardal_ndef_add_smart_poster(neardal_ndef_builder *builder,
+					  const neardal_ndef_builder *content)
+{
+	NEARDAL_ASSERT_RET(content != NULL && content->msg->len != 0,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+	NEARDAL_ASSERT_RET(content != builder,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	return neardal_ndef_add_record(builder, NEARDAL_NDEF_TNF_WELL_KNOWN,
+				       (const guint8 *) "Sp", 2, NULL, 0,
+				       content->msg->data, content->msg->len);
+}
+
+/*****************************************************************************
+ * neardal_ndef_add_handover: append a Handover record
+ ****************************************************************************/
+errorCode_t neardal_ndef_add_handover(neardal_ndef_builder *builder,
+				      const char *type, unsigned char version,
+				      const neardal_ndef_builder *carriers)
+{
+	errorCode_t err;
+
+	NEARDAL_ASSERT_RET(type != NULL && carriers != NULL &&
+			   carriers != builder,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	if (carriers->msg->len > G_MAXUINT - 1)
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	err = neardal_ndef_prv_append(builder, NEARDAL_NDEF_TNF_WELL_KNOWN,
+				      (const guint8 *) type, strlen(type),
+				      NULL, 0, 1 + carriers->msg->len);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+	g_byte_array_append(builder->msg, &version, 1);
+	g_byte_array_append(builder->msg, carriers->msg->data,
+			    carriers->msg->len);
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_ndef_add_alternative_carrier: append an 'ac' record
+ ****************************************************************************/
+errorCode_t neardal_ndef_add_alternative_carrier(neardal_ndef_builder *builder,
+						 unsigned char cps,
+						 const char *carrierDataRef)
+{
+	guint8		payload[2 + G_MAXUINT8 + 1];
+	gsize		len;
+
+	NEARDAL_ASSERT_RET(carrierDataRef != NULL,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	len = strlen(carrierDataRef);
+	if (len > G_MAXUINT8)
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	/* CPS, carrier data reference, no auxiliary data reference */
+	payload[0] = cps & 0x03;
+	payload[1] = len;
+	memcpy(payload + 2, carrierDataRef, len);
+	payload[2 + len] = 0;
+
+	return neardal_ndef_add_record(builder, NEARDAL_NDEF_TNF_WELL_KNOWN,
+				       (const guint8 *) "ac", 2, NULL, 0,
+				       payload, 3 + len);
+}
+
+/*****************************************************************************
+ * neardal_ndef_prv_add_str: add a string property, if valid UTF-8
+ ****************************************************************************/
+static void neardal_ndef_prv_add_str(GVariantBuilder *b, const gchar *key,
+				     const gchar *prefix, const guint8 *data,
+				     gsize len)
+{
+	gchar *str;
+
+	if (!g_utf8_validate((const gchar *) data, len, NULL))
+		return;
+
+	str = g_strndup((const gchar *) data, len);
+	if (prefix != NULL) {
+		gchar *tmp = str;
+
+		str = g_strconcat(prefix, tmp, NULL);
+		g_free(tmp);
+	}
+	g_variant_builder_add(b, "{sv}", key, g_variant_new_string(str));
+	g_free(str);
+}
+
+/*****************************************************************************
+ * neardal_ndef_prv_text: add Text record fields (Encoding, Language,
+ * Representation)
+ ****************************************************************************/
+static void neardal_ndef_prv_text(GVariantBuilder *b,
+				  const neardal_ndef_record *record)
+{
+	const guint8	*p = record->payload;
+	guint		langLen;
+	gsize		len;
+	gchar		*str;
+
+	if (record->payloadLen < 1)
+		return;
+	langLen = p[0] & 0x3F;
+	if (1 + langLen > record->payloadLen)
+		return;
+
+	neardal_ndef_prv_add_str(b, "Language", NULL, p + 1, langLen);
+	p += 1 + langLen;
+	len = record->payloadLen - 1 - langLen;
+
+	if (!(record->payload[0] & 0x80)) {
+		g_variant_builder_add(b, "{sv}", "Encoding",
+				      g_variant_new_string("UTF-8"));
+		neardal_ndef_prv_add_str(b, "Representation", NULL, p, len);
+		return;
+	}
+
+	g_variant_builder_add(b, "{sv}", "Encoding",
+			      g_variant_new_string("UTF-16"));
+	str = g_convert((const gchar *) p, len, "UTF-8", "UTF-16", NULL, &len,
+			NULL);
+	if (str != NULL)
+		neardal_ndef_prv_add_str(b, "Representation", NULL,
+					 (const guint8 *) str, len);
+	g_free(str);
+}
+
+/*****************************************************************************
+ * neardal_ndef_prv_uri: add URI record fields (URI, Size), prefix expanded
+ ****************************************************************************/
+static void neardal_ndef_prv_uri(GVariantBuilder *b,
+				 const neardal_ndef_record *record)
+{
+	const guint8	*p = record->payload;
+	const gchar	*prefix;
+
+	if (record->payloadLen < 1)
+		return;
+
+	prefix = p[0] < G_N_ELEMENTS(sUriPrefixes) ? sUriPrefixes[p[0]] : "";
+	g_variant_builder_add(b, "{sv}", "Size",
+			      g_variant_new_uint32(strlen(prefix) +
+						   record->payloadLen - 1));
+	neardal_ndef_prv_add_str(b, "URI", prefix, p + 1,
+				 record->payloadLen - 1);
+}
+
+/*****************************************************************************
+ * neardal_ndef_prv_record_props: neard record properties of an NDEF record
+ ****************************************************************************/
+GVariant *neardal_ndef_prv_record_props(const neardal_ndef_record *record)
+{
+	GVariantBuilder		b;
+	neardal_ndef_iter	iter;
+	neardal_ndef_record	nested;
+	const gchar		*type = "Unknown";
+	gboolean		title = FALSE;
+
+	g_variant_builder_init(&b, G_VARIANT_TYPE("a{sv}"));
+
+	if (neardal_ndef_record_is(record, NEARDAL_NDEF_TNF_WELL_KNOWN, "T")) {
+		type = "Text";
+		neardal_ndef_prv_text(&b, record);
+	} else if (neardal_ndef_record_is(record, NEARDAL_NDEF_TNF_WELL_KNOWN,
+					  "U")) {
+		type = "URI";
+		neardal_ndef_prv_uri(&b, record);
+	} else if (neardal_ndef_record_is(record, NEARDAL_NDEF_TNF_WELL_KNOWN,
+					  "Sp")) {
+		/* URI and first title, a chunked poster (payload not
+		 * contiguous) being left empty */
+		type = "SmartPoster";
+		if (neardal_ndef_iter_nested(&iter, record) != NEARDAL_SUCCESS)
+			goto end;
+		while (neardal_ndef_iter_next(&iter, &nested) ==
+		       NEARDAL_SUCCESS) {
+			if (neardal_ndef_record_is(&nested,
+					NEARDAL_NDEF_TNF_WELL_KNOWN, "U"))
+				neardal_ndef_prv_uri(&b, &nested);
+			else if (!title && neardal_ndef_record_is(&nested,
+					NEARDAL_NDEF_TNF_WELL_KNOWN, "T")) {
+				neardal_ndef_prv_text(&b, &nested);
+				title = TRUE;
+			}
+		}
+	} else if (neardal_ndef_record_is(record, NEARDAL_NDEF_TNF_WELL_KNOWN,
+					  "Hs"))
+		type = "HandoverSelect";
+	else if (neardal_ndef_record_is(record, NEARDAL_NDEF_TNF_WELL_KNOWN,
+					"Hr"))
+		type = "HandoverRequest";
+	else if (record->tnf == NEARDAL_NDEF_TNF_MIME) {
+		type = "MIME";
+		neardal_ndef_prv_add_str(&b, "MIME", NULL, record->type,
+					 record->typeLen);
+	}
+
+end:
+	g_variant_builder_add(&b, "{sv}", "Type", g_variant_new_string(type));
+
+	return g_variant_builder_end(&b);
+}
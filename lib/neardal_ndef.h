@@ -0,0 +1,366 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+/*!
+ * @file neardal_ndef.h
+ *
+ * @brief NDEF message parser.
+ *
+ * Walks a raw NDEF message (e.g. the ndefArray of an ndef_agent_cb callback)
+ * in place: records are returned as views (pointers and lengths) into the
+ * caller's buffer, nothing is allocated nor copied, whatever the message
+ * size. The buffer must stay valid while views are used.
+ *
+ * Chunked records are returned once, with the payload of their first chunk;
+ * their whole payload is reached chunk by chunk (neardal_ndef_chunk_next()).
+ * Smart Poster and Handover records carry a nested message, walked with
+ * neardal_ndef_iter_nested().
+ *
+ * A builder encodes records (Text, URI, MIME, external types, Smart Poster,
+ * Handover...) into one contiguous message, e.g. written as is with
+ * neardal_tag_write_raw(): encoded once, written to any number of tags.
+ *
+ ******************************************************************************/
+
+#ifndef NEARDAL_NDEF_H
+#define NEARDAL_NDEF_H
+#include "neardal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif	/* __cplusplus */
+
+/*!
+ * @brief NDEF record Type Name Format
+*/
+typedef enum {
+	NEARDAL_NDEF_TNF_EMPTY = 0,		/**< no type, id nor payload */
+	NEARDAL_NDEF_TNF_WELL_KNOWN,		/**< NFC Forum RTD ("U", "T",
+						 * "Sp", "Hs"...) */
+	NEARDAL_NDEF_TNF_MIME,			/**< RFC 2046 media type */
+	NEARDAL_NDEF_TNF_URI,			/**< RFC 3986 absolute URI */
+	NEARDAL_NDEF_TNF_EXTERNAL,		/**< NFC Forum external type */
+	NEARDAL_NDEF_TNF_UNKNOWN,		/**< unknown, no type */
+	NEARDAL_NDEF_TNF_UNCHANGED,		/**< chunk of a chunked record */
+	NEARDAL_NDEF_TNF_RESERVED
+} neardal_ndef_tnf;
+
+/*! @brief NDEF record header flags */
+#define NEARDAL_NDEF_FLAG_MB	0x80	/**< Message Begin */
+#define NEARDAL_NDEF_FLAG_ME	0x40	/**< Message End */
+#define NEARDAL_NDEF_FLAG_CF	0x20	/**< Chunk Flag */
+#define NEARDAL_NDEF_FLAG_SR	0x10	/**< Short Record */
+#define NEARDAL_NDEF_FLAG_IL	0x08	/**< ID Length present */
+#define NEARDAL_NDEF_TNF_MASK	0x07
+
+/*!
+ * @brief NDEF message walk state (see @link neardal_ndef_iter_init
+ * @endlink). Opaque, may be copied to restart from a given record.
+*/
+typedef struct {
+/*! @brief Message being walked */
+	const unsigned char	*data;
+/*! @brief Message length */
+	unsigned int		len;
+/*! @brief Offset of the next record */
+	unsigned int		offset;
+/*! @brief Message End seen */
+	int			end;
+} neardal_ndef_iter;
+
+/*!
+ * @brief NDEF record view: pointers into the parsed message
+*/
+typedef struct {
+/*! @brief Type Name Format (see neardal_ndef_tnf) */
+	neardal_ndef_tnf	tnf;
+/*! @brief Header byte (NEARDAL_NDEF_FLAG_*) of the first chunk */
+	unsigned char		flags;
+/*! @brief Record type */
+	const unsigned char	*type;
+/*! @brief Record type length */
+	unsigned int		typeLen;
+/*! @brief Record id (NULL when none) */
+	const unsigned char	*id;
+/*! @brief Record id length */
+	unsigned int		idLen;
+/*! @brief Payload (first chunk only if chunked) */
+	const unsigned char	*payload;
+/*! @brief Payload length (first chunk only if chunked) */
+	unsigned int		payloadLen;
+/*! @brief Whole payload length, all chunks */
+	unsigned int		totalLen;
+/*! @brief Number of chunks (1: not chunked) */
+	unsigned int		nbChunks;
+/*! @brief Whole record, all chunks, header included */
+	const unsigned char	*raw;
+/*! @brief Whole record length */
+	unsigned int		rawLen;
+} neardal_ndef_record;
+
+/*! \fn errorCode_t neardal_ndef_iter_init(neardal_ndef_iter *iter,
+ *					   const unsigned char *data,
+ *					   unsigned int len)
+ * @brief Start walking a raw NDEF message
+ *
+ * @param iter walk state to initialize
+ * @param data raw NDEF message (not copied)
+ * @param len message length
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_ndef_iter_init(neardal_ndef_iter *iter,
+				   const unsigned char *data,
+				   unsigned int len);
+
+/*! \fn errorCode_t neardal_ndef_iter_next(neardal_ndef_iter *iter,
+ *					   neardal_ndef_record *record)
+ * @brief Parse the next record of the message
+ *
+ * @param iter walk state
+ * @param record record view, filled on success
+ * @return NEARDAL_SUCCESS, NEARDAL_ERROR_NO_RECORD at the end of the message,
+ * NEARDAL_ERROR_INVALID_RECORD if the message is malformed (truncated record,
+ * bad chunk sequence, missing Message Begin or End...)
+ **/
+errorCode_t neardal_ndef_iter_next(neardal_ndef_iter *iter,
+				   neardal_ndef_record *record);
+
+/*! \fn errorCode_t neardal_ndef_iter_nested(neardal_ndef_iter *iter,
+ *					     const neardal_ndef_record *record)
+ * @brief Start walking the message nested in a Smart Poster ("Sp") or
+ * Handover ("Hs", "Hr", "Hm", "Hi") record. For handover records the first
+ * payload byte (version) is skipped.
+ *
+ * @param iter walk state to initialize
+ * @param record container record (not chunked)
+ * @return errorCode_t error code (NEARDAL_ERROR_INVALID_RECORD if the record
+ * is not a container)
+ **/
+errorCode_t neardal_ndef_iter_nested(neardal_ndef_iter *iter,
+				     const neardal_ndef_record *record);
+
+/*! \fn errorCode_t neardal_ndef_chunk_next(const neardal_ndef_record *record,
+ *					    unsigned int *offset,
+ *					    const unsigned char **payload,
+ *					    unsigned int *payloadLen)
+ * @brief Walk the payload chunks of a record (one chunk if not chunked)
+ *
+ * @param record record returned by neardal_ndef_iter_next()
+ * @param offset walk state, set to 0 before the first call
+ * @param payload chunk payload view
+ * @param payloadLen chunk payload length
+ * @return NEARDAL_SUCCESS, NEARDAL_ERROR_NO_RECORD after the last chunk
+ **/
+errorCode_t neardal_ndef_chunk_next(const neardal_ndef_record *record,
+				    unsigned int *offset,
+				    const unsigned char **payload,
+				    unsigned int *payloadLen);
+
+/*! \fn int neardal_ndef_record_is(const neardal_ndef_record *record,
+ *				   neardal_ndef_tnf tnf, const char *type)
+ * @brief Test a record Type Name Format and type
+ *
+ * @param record record view
+ * @param tnf expected Type Name Format
+ * @param type expected type (NUL terminated)
+ * @return non zero if the record matches
+ **/
+int neardal_ndef_record_is(const neardal_ndef_record *record,
+			   neardal_ndef_tnf tnf, const char *type);
+
+/*!
+ * @brief NDEF message builder (opaque, see @link neardal_ndef_builder_new
+ * @endlink)
+*/
+typedef struct neardal_ndef_builder neardal_ndef_builder;
+
+/*! \fn errorCode_t neardal_ndef_builder_new(neardal_ndef_builder **builder)
+ * @brief Create an empty NDEF message builder
+ * release with (@link neardal_ndef_builder_free @endlink)
+ *
+ * @param builder pointer on the new builder
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_ndef_builder_new(neardal_ndef_builder **builder);
+
+/*! \fn void neardal_ndef_builder_free(neardal_ndef_builder *builder)
+ * @brief Release a builder and its message
+ *
+ * @param builder builder (may be NULL)
+ **/
+void neardal_ndef_builder_free(neardal_ndef_builder *builder);
+
+/*! \fn void neardal_ndef_builder_reset(neardal_ndef_builder *builder)
+ * @brief Empty the message, keeping the builder memory for the next one
+ *
+ * @param builder builder
+ **/
+void neardal_ndef_builder_reset(neardal_ndef_builder *builder);
+
+/*! \fn errorCode_t neardal_ndef_builder_get(
+ *				const neardal_ndef_builder *builder,
+ *				const unsigned char **data, unsigned int *len)
+ * @brief Encoded message: view valid until the builder is modified or freed
+ *
+ * @param builder builder
+ * @param data encoded message
+ * @param len encoded message length
+ * @return errorCode_t error code (NEARDAL_ERROR_NO_RECORD if empty)
+ **/
+errorCode_t neardal_ndef_builder_get(const neardal_ndef_builder *builder,
+				     const unsigned char **data,
+				     unsigned int *len);
+
+/*! \fn errorCode_t neardal_ndef_add_record(neardal_ndef_builder *builder,
+ *					    neardal_ndef_tnf tnf,
+ *					    const unsigned char *type,
+ *					    unsigned int typeLen,
+ *					    const unsigned char *id,
+ *					    unsigned int idLen,
+ *					    const unsigned char *payload,
+ *					    unsigned int payloadLen)
+ * @brief Append a record (short record form when the payload allows it)
+ *
+ * @param builder builder
+ * @param tnf Type Name Format (not NEARDAL_NDEF_TNF_UNCHANGED)
+ * @param type record type (up to 255 bytes)
+ * @param typeLen record type length
+ * @param id record id (up to 255 bytes), NULL if none
+ * @param idLen record id length
+ * @param payload record payload
+ * @param payloadLen record payload length
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_ndef_add_record(neardal_ndef_builder *builder,
+				    neardal_ndef_tnf tnf,
+				    const unsigned char *type,
+				    unsigned int typeLen,
+				    const unsigned char *id,
+				    unsigned int idLen,
+				    const unsigned char *payload,
+				    unsigned int payloadLen);
+
+/*! \fn errorCode_t neardal_ndef_add_text(neardal_ndef_builder *builder,
+ *					  const char *lang, const char *text)
+ * @brief Append a Text record (UTF-8)
+ *
+ * @param builder builder
+ * @param lang IANA language code, e.g. "en" (up to 63 characters)
+ * @param text text
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_ndef_add_text(neardal_ndef_builder *builder,
+				  const char *lang, const char *text);
+
+/*! \fn errorCode_t neardal_ndef_add_uri(neardal_ndef_builder *builder,
+ *					 const char *uri)
+ * @brief Append a URI record, its scheme abbreviated when possible
+ *
+ * @param builder builder
+ * @param uri URI, e.g. "https://www.example.com"
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_ndef_add_uri(neardal_ndef_builder *builder,
+				 const char *uri);
+
+/*! \fn errorCode_t neardal_ndef_add_mime(neardal_ndef_builder *builder,
+ *					  const char *mime,
+ *					  const unsigned char *data,
+ *					  unsigned int len)
+ * @brief Append a MIME record
+ *
+ * @param builder builder
+ * @param mime media type, e.g. "text/vcard"
+ * @param data payload
+ * @param len payload length
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_ndef_add_mime(neardal_ndef_builder *builder,
+				  const char *mime, const unsigned char *data,
+				  unsigned int len);
+
+/*! \fn errorCode_t neardal_ndef_add_external(neardal_ndef_builder *builder,
+ *					      const char *type,
+ *					      const unsigned char *data,
+ *					      unsigned int len)
+ * @brief Append an NFC Forum external type record
+ *
+ * @param builder builder
+ * @param type external type, e.g. "example.com:perso"
+ * @param data payload
+ * @param len payload length
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_ndef_add_external(neardal_ndef_builder *builder,
+				      const char *type,
+				      const unsigned char *data,
+				      unsigned int len);
+
+/*! \fn errorCode_t neardal_ndef_add_smart_poster(
+ *					neardal_ndef_builder *builder,
+ *					const neardal_ndef_builder *content)
+ * @brief Append a Smart Poster record holding the message of 'content'
+ * (URI, titles, action...)
+ *
+ * @param builder builder
+ * @param content Smart Poster message
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_ndef_add_smart_poster(neardal_ndef_builder *builder,
+					  const neardal_ndef_builder *content);
+
+/*! \fn errorCode_t neardal_ndef_add_handover(neardal_ndef_builder *builder,
+ *					      const char *type,
+ *					      unsigned char version,
+ *					      const neardal_ndef_builder *carriers)
+ * @brief Append a Handover record: version, then the message of 'carriers'
+ * (alternative carrier records). Carrier configuration records follow, in
+ * the outer message, with ids referenced by the alternative carriers.
+ *
+ * @param builder builder
+ * @param type "Hs" (select), "Hr" (request), "Hm" or "Hi"
+ * @param version handover version, e.g. 0x12
+ * @param carriers alternative carriers message
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_ndef_add_handover(neardal_ndef_builder *builder,
+				      const char *type, unsigned char version,
+				      const neardal_ndef_builder *carriers);
+
+/*! \fn errorCode_t neardal_ndef_add_alternative_carrier(
+ *					neardal_ndef_builder *builder,
+ *					unsigned char cps,
+ *					const char *carrierDataRef)
+ * @brief Append an Alternative Carrier ("ac") record, without auxiliary
+ * data reference
+ *
+ * @param builder builder
+ * @param cps carrier power state (0: inactive, 1: active, 2: activating)
+ * @param carrierDataRef id of the carrier configuration record
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_ndef_add_alternative_carrier(neardal_ndef_builder *builder,
+						 unsigned char cps,
+						 const char *carrierDataRef);
+
+#ifdef __cplusplus
+}
+#endif	/* __cplusplus */
+
+#endif /* NEARDAL_NDEF_H */
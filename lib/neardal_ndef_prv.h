@@ -0,0 +1,33 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef NEARDAL_NDEF_PRV_H
+#define NEARDAL_NDEF_PRV_H
+
+#include "neardal_ndef.h"
+
+/*****************************************************************************
+ * neardal_ndef_prv_record_props: neard record properties (a{sv}, floating)
+ * of an NDEF record, as neard would announce it: Type ("Text", "URI",
+ * "SmartPoster", "MIME", "HandoverSelect"...) and the matching fields
+ ****************************************************************************/
+GVariant *neardal_ndef_prv_record_props(const neardal_ndef_record *record);
+
+#endif /* NEARDAL_NDEF_PRV_H */
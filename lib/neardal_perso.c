@@ -0,0 +1,868 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <glib.h>
+
+#include "neardal.h"
+#include "neardal_ndef.h"
+#include "neardal_perso.h"
+#include "neardal_prv.h"
+
+#define NEARDAL_PERSO_WINDOW	64	/* rows encoded ahead */
+#define NEARDAL_PERSO_ATTEMPTS	3	/* writes of a row before failing */
+#define NEARDAL_PERSO_FLUSH_MS	50	/* invalid rows / end check period */
+
+/* Reader slot tokens */
+#define NEARDAL_PERSO_SLOT	GINT_TO_POINTER(1)
+#define NEARDAL_PERSO_QUIT	GINT_TO_POINTER(2)
+
+/* Row fields */
+typedef enum {
+	NEARDAL_PERSO_URI = 0,
+	NEARDAL_PERSO_TEXT,
+	NEARDAL_PERSO_LANG,
+	NEARDAL_PERSO_MIME,
+	NEARDAL_PERSO_PAYLOAD,
+	NEARDAL_PERSO_NB_FIELDS
+} neardalPersoField;
+
+static const gchar * const sPersoFields[NEARDAL_PERSO_NB_FIELDS] = {
+	"uri", "text", "lang", "mime", "payload"
+};
+
+/* File format, known from the first row */
+typedef enum {
+	NEARDAL_PERSO_UNKNOWN = 0,
+	NEARDAL_PERSO_CSV,
+	NEARDAL_PERSO_NDJSON
+} neardalPersoFormat;
+
+/* Encoded row */
+typedef struct {
+	guint64		row;
+	errorCode_t	err;		/* NEARDAL_SUCCESS: 'request' ready */
+	GVariant	*request;	/* {'Type': 'Raw', 'NDEF': ay} */
+	guint		attempts;
+} neardalPersoItem;
+
+/* End of the file (last item of the reader) */
+static neardalPersoItem sPersoEnd;
+
+struct neardal_perso {
+	gint			refs;		/* owner + writes in flight */
+	neardal_perso_cb	cb;
+	gpointer		user_data;
+
+	/* Reader thread */
+	gint			fd;		/* file read */
+	gint			wakeup[2];	/* pipe waking the reader up on
+						 * stop */
+	GString			*buf;		/* read, not parsed yet */
+	gboolean		fdEnd;
+	GThread			*thread;
+	GAsyncQueue		*ready;		/* encoded rows, to main loop */
+	volatile gint		nbReady;	/* rows in 'ready' (not the end
+						 * of file) */
+	GAsyncQueue		*slots;		/* free window slots, to reader */
+	neardalPersoFormat	format;
+	gint			columns[NEARDAL_PERSO_NB_FIELDS];
+	guint			nbColumns;
+
+	/* Main loop */
+	GQueue			pending;	/* rows waiting for a tag */
+	gboolean		eof;		/* reader done */
+	gboolean		stopped;
+	guint			flushId;
+	neardal_perso_stats	stats;
+	guint64			startTs;
+	guint64			foundToWriteNs;	/* totals, written rows */
+	guint64			foundToDoneNs;
+};
+
+/* Write in progress */
+typedef struct {
+	neardal_perso		*perso;
+	neardalPersoItem	*item;
+	gchar			*tagName;
+	guint64			foundTs;
+	guint64			writeTs;
+} neardalPersoWrite;
+
+static void neardal_perso_prv_item_free(neardalPersoItem *item)
+{
+	if (item == NULL || item == &sPersoEnd)
+		return;
+	if (item->request != NULL)
+		g_variant_unref(item->request);
+	g_free(item);
+}
+
+/*---------------------------------------------------------------------------
+ * Reader thread: rows parsing and encoding
+ ---------------------------------------------------------------------------*/
+/*****************************************************************************
+ * neardal_perso_prv_read_line: next line of the file, without end of line.
+ * FALSE at the end of the file or when the run is stopped (the file is
+ * polled with the wakeup pipe, a pipe or terminal may never be readable)
+ ****************************************************************************/
+static gboolean neardal_perso_prv_read_line(neardal_perso *perso,
+					    GString *line)
+{
+	struct pollfd	fds[2];
+	gchar		buf[4096];
+	gchar		*eol;
+	gssize		len;
+
+	g_string_truncate(line, 0);
+	for (;;) {
+		eol = memchr(perso->buf->str, '\n', perso->buf->len);
+		if (eol != NULL) {
+			len = eol - perso->buf->str;
+			g_string_append_len(line, perso->buf->str, len);
+			g_string_erase(perso->buf, 0, len + 1);
+			break;
+		}
+		if (perso->fdEnd) {
+			if (perso->buf->len == 0)
+				return FALSE;
+			g_string_append_len(line, perso->buf->str,
+					    perso->buf->len);
+			g_string_truncate(perso->buf, 0);
+			break;
+		}
+
+		fds[0].fd = perso->fd;
+		fds[0].events = POLLIN;
+		fds[1].fd = perso->wakeup[0];
+		fds[1].events = POLLIN;
+		if (poll(fds, 2, -1) < 0) {
+			if (errno == EINTR)
+				continue;
+			return FALSE;
+		}
+		if (fds[1].revents != 0)
+			return FALSE;
+
+		len = read(perso->fd, buf, sizeof(buf));
+		if (len > 0)
+			g_string_append_len(perso->buf, buf, len);
+		else if (len == 0 || (errno != EINTR && errno != EAGAIN))
+			perso->fdEnd = TRUE;
+	}
+
+	if (line->len > 0 && line->str[line->len - 1] == '\r')
+		g_string_truncate(line, line->len - 1);
+
+	return TRUE;
+}
+
+/*****************************************************************************
+ * neardal_perso_prv_field: field index of a column or member name, -1 if
+ * unknown
+ ****************************************************************************/
+static gint neardal_perso_prv_field(const gchar *name)
+{
+	gint	i;
+
+	for (i = 0; i < NEARDAL_PERSO_NB_FIELDS; i++)
+		if (!g_ascii_strcasecmp(name, sPersoFields[i]))
+			return i;
+
+	return -1;
+}
+
+/*****************************************************************************
+ * neardal_perso_prv_csv_split: CSV fields of a line
+ ****************************************************************************/
+static gboolean neardal_perso_prv_csv_split(const gchar *line,
+					    GPtrArray *cols)
+{
+	const gchar	*c = line;
+	GString		*s = g_string_new(NULL);
+
+	for (;;) {
+		g_string_truncate(s, 0);
+		if (*c == '"') {
+			for (c++; ; c++) {
+				if (*c == '\0')
+					goto error;	/* unterminated */
+				if (*c == '"') {
+					if (c[1] != '"') {
+						c++;
+						break;
+					}
+					c++;
+				}
+				g_string_append_c(s, *c);
+			}
+			if (*c != ',' && *c != '\0')
+				goto error;
+		} else
+			while (*c != ',' && *c != '\0')
+				g_string_append_c(s, *c++);
+
+		g_ptr_array_add(cols, g_strdup(s->str));
+		if (*c == '\0')
+			break;
+		c++;
+	}
+	g_string_free(s, TRUE);
+
+	return TRUE;
+
+error:
+	g_string_free(s, TRUE);
+	return FALSE;
+}
+
+/*****************************************************************************
+ * neardal_perso_prv_csv: row fields of a CSV line. A first line naming
+ * columns sets the columns order (*header TRUE)
+ ****************************************************************************/
+static gboolean neardal_perso_prv_csv(neardal_perso *perso,
+				      const gchar *line, guint64 row,
+				      gchar **fields, gboolean *header)
+{
+	GPtrArray	*cols = g_ptr_array_new_with_free_func(g_free);
+	gboolean	ok;
+	gint		field;
+	guint		i;
+
+	*header = FALSE;
+	ok = neardal_perso_prv_csv_split(line, cols);
+	if (ok && row == 1 && cols->len > 0 &&
+	    neardal_perso_prv_field(g_ptr_array_index(cols, 0)) >= 0) {
+		perso->nbColumns = MIN(cols->len, NEARDAL_PERSO_NB_FIELDS);
+		for (i = 0; i < perso->nbColumns; i++)
+			perso->columns[i] = neardal_perso_prv_field(
+						g_ptr_array_index(cols, i));
+		*header = TRUE;
+	} else if (ok) {
+		for (i = 0; i < cols->len && i < perso->nbColumns; i++) {
+			field = perso->columns[i];
+			if (field < 0 || !*(gchar *) g_ptr_array_index(cols, i))
+				continue;
+			g_free(fields[field]);
+			fields[field] = g_strdup(g_ptr_array_index(cols, i));
+		}
+	}
+	g_ptr_array_free(cols, TRUE);
+
+	return ok;
+}
+
+/*****************************************************************************
+ * neardal_perso_prv_json_string: JSON string at *p (moved after it)
+ ****************************************************************************/
+static gchar *neardal_perso_prv_json_string(const gchar **p)
+{
+	const gchar	*c = *p;
+	GString		*s;
+	gunichar	u, low;
+	gint		i, d;
+
+	if (*c != '"')
+		return NULL;
+
+	s = g_string_new(NULL);
+	for (c++; *c != '"'; c++) {
+		if (*c == '\0')
+			goto error;
+		if (*c != '\\') {
+			g_string_append_c(s, *c);
+			continue;
+		}
+		switch (*++c) {
+		case '"':
+		case '\\':
+		case '/':
+			g_string_append_c(s, *c);
+			break;
+		case 'b':
+			g_string_append_c(s, '\b');
+			break;
+		case 'f':
+			g_string_append_c(s, '\f');
+			break;
+		case 'n':
+			g_string_append_c(s, '\n');
+			break;
+		case 'r':
+			g_string_append_c(s, '\r');
+			break;
+		case 't':
+			g_string_append_c(s, '\t');
+			break;
+		case 'u':
+			for (u = 0, i = 1; i <= 4; i++) {
+				d = g_ascii_xdigit_value(c[i]);
+				if (d < 0)
+					goto error;
+				u = (u << 4) | d;
+			}
+			c += 4;
+			if (u >= 0xD800 && u < 0xDC00) {
+				/* Surrogate pair */
+				if (c[1] != '\\' || c[2] != 'u')
+					goto error;
+				for (low = 0, i = 3; i <= 6; i++) {
+					d = g_ascii_xdigit_value(c[i]);
+					if (d < 0)
+						goto error;
+					low = (low << 4) | d;
+				}
+				if (low < 0xDC00 || low > 0xDFFF)
+					goto error;
+				u = 0x10000 + ((u - 0xD800) << 10) +
+				    (low - 0xDC00);
+				c += 6;
+			} else if (u >= 0xDC00 && u <= 0xDFFF)
+				goto error;
+			g_string_append_unichar(s, u);
+			break;
+		default:
+			goto error;
+		}
+	}
+	*p = c + 1;
+
+	return g_string_free(s, FALSE);
+
+error:
+	g_string_free(s, TRUE);
+	return NULL;
+}
+
+#define NEARDAL_PERSO_WS(p)	while (g_ascii_isspace(*(p))) (p)++
+
+/*****************************************************************************
+ * neardal_perso_prv_json: row fields of an NDJSON line: flat object, string
+ * (or null) values, unknown members ignored
+ ****************************************************************************/
+static gboolean neardal_perso_prv_json(const gchar *line, gchar **fields)
+{
+	const gchar	*p = line;
+	gchar		*key, *value;
+	gint		field;
+
+	NEARDAL_PERSO_WS(p);
+	if (*p++ != '{')
+		return FALSE;
+	NEARDAL_PERSO_WS(p);
+	if (*p == '}')
+		goto end;
+
+	for (;;) {
+		key = neardal_perso_prv_json_string(&p);
+		if (key == NULL)
+			return FALSE;
+		NEARDAL_PERSO_WS(p);
+		if (*p++ != ':') {
+			g_free(key);
+			return FALSE;
+		}
+		NEARDAL_PERSO_WS(p);
+		if (!strncmp(p, "null", 4)) {
+			value = NULL;
+			p += 4;
+		} else if ((value = neardal_perso_prv_json_string(&p)) ==
+			   NULL) {
+			g_free(key);
+			return FALSE;
+		}
+
+		field = neardal_perso_prv_field(key);
+		g_free(key);
+		if (field >= 0 && value != NULL && *value) {
+			g_free(fields[field]);
+			fields[field] = value;
+		} else
+			g_free(value);
+
+		NEARDAL_PERSO_WS(p);
+		if (*p == '}')
+			break;
+		if (*p++ != ',')
+			return FALSE;
+		NEARDAL_PERSO_WS(p);
+	}
+
+end:
+	p++;
+	NEARDAL_PERSO_WS(p);
+
+	return *p == '\0';
+}
+
+/*****************************************************************************
+ * neardal_perso_prv_encode: NDEF message of a row, as a neard 'Raw' record
+ ****************************************************************************/
+static errorCode_t neardal_perso_prv_encode(neardal_ndef_builder *builder,
+					    gchar **fields,
+					    GVariant **request)
+{
+	const unsigned char	*data;
+	unsigned int		len;
+	guchar			*payload;
+	gsize			payloadLen;
+	errorCode_t		err = NEARDAL_SUCCESS;
+
+	neardal_ndef_builder_reset(builder);
+
+	if (fields[NEARDAL_PERSO_URI] != NULL)
+		err = neardal_ndef_add_uri(builder, fields[NEARDAL_PERSO_URI]);
+
+	if (err == NEARDAL_SUCCESS && fields[NEARDAL_PERSO_TEXT] != NULL)
+		err = neardal_ndef_add_text(builder,
+				fields[NEARDAL_PERSO_LANG] ?
+				fields[NEARDAL_PERSO_LANG] : "en",
+				fields[NEARDAL_PERSO_TEXT]);
+
+	if (err == NEARDAL_SUCCESS && fields[NEARDAL_PERSO_PAYLOAD] != NULL) {
+		payload = g_base64_decode(fields[NEARDAL_PERSO_PAYLOAD],
+					  &payloadLen);
+		err = neardal_ndef_add_mime(builder,
+				fields[NEARDAL_PERSO_MIME] ?
+				fields[NEARDAL_PERSO_MIME] :
+				"application/octet-stream",
+				payload, payloadLen);
+		g_free(payload);
+	}
+
+	if (err == NEARDAL_SUCCESS)
+		err = neardal_ndef_builder_get(builder, &data, &len);
+	if (err != NEARDAL_SUCCESS)
+		return NEARDAL_ERROR_INVALID_RECORD;
+
+	*request = g_variant_ref_sink(g_variant_new_parsed(
+				"{'Type': <'Raw'>, 'NDEF': <%@ay>}",
+				neardal_tools_prv_bytes(data, len)));
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_perso_prv_parse: encoded row of a line (NULL: blank line or CSV
+ * header)
+ ****************************************************************************/
+static neardalPersoItem *neardal_perso_prv_parse(neardal_perso *perso,
+						 neardal_ndef_builder *builder,
+						 const gchar *line,
+						 guint64 row)
+{
+	neardalPersoItem	*item;
+	gchar			*fields[NEARDAL_PERSO_NB_FIELDS];
+	gboolean		ok, header = FALSE;
+	const gchar		*c = line;
+	gint			i;
+
+	NEARDAL_PERSO_WS(c);
+	if (*c == '\0')
+		return NULL;
+
+	if (perso->format == NEARDAL_PERSO_UNKNOWN)
+		perso->format = *c == '{' ? NEARDAL_PERSO_NDJSON :
+					    NEARDAL_PERSO_CSV;
+
+	memset(fields, 0, sizeof(fields));
+	if (perso->format == NEARDAL_PERSO_NDJSON)
+		ok = neardal_perso_prv_json(line, fields);
+	else
+		ok = neardal_perso_prv_csv(perso, line, row, fields, &header);
+
+	item = NULL;
+	if (!header) {
+		item = g_new0(neardalPersoItem, 1);
+		item->row = row;
+		item->err = NEARDAL_ERROR_INVALID_RECORD;
+		if (ok)
+			item->err = neardal_perso_prv_encode(builder, fields,
+							     &item->request);
+	}
+
+	for (i = 0; i < NEARDAL_PERSO_NB_FIELDS; i++)
+		g_free(fields[i]);
+
+	return item;
+}
+
+/*****************************************************************************
+ * neardal_perso_prv_reader: reader thread, encodes rows as long as window
+ * slots are free
+ ****************************************************************************/
+static gpointer neardal_perso_prv_reader(gpointer data)
+{
+	neardal_perso		*perso = data;
+	neardal_ndef_builder	*builder = NULL;
+	neardalPersoItem	*item;
+	GString			*line = g_string_new(NULL);
+	guint64			row = 0;
+
+	if (neardal_ndef_builder_new(&builder) != NEARDAL_SUCCESS)
+		goto end;
+
+	while (g_async_queue_pop(perso->slots) == NEARDAL_PERSO_SLOT) {
+		item = NULL;
+		while (item == NULL &&
+		       neardal_perso_prv_read_line(perso, line))
+			item = neardal_perso_prv_parse(perso, builder,
+						       line->str, ++row);
+		if (item == NULL)
+			break;
+		g_atomic_int_inc(&perso->nbReady);
+		g_async_queue_push(perso->ready, item);
+	}
+
+end:
+	g_async_queue_push(perso->ready, &sPersoEnd);
+	neardal_ndef_builder_free(builder);
+	g_string_free(line, TRUE);
+
+	return NULL;
+}
+
+/*---------------------------------------------------------------------------
+ * Main loop: writes and reports
+ ---------------------------------------------------------------------------*/
+static void neardal_perso_prv_unref(neardal_perso *perso)
+{
+	neardalPersoItem	*item;
+
+	if (--perso->refs > 0)
+		return;
+
+	while ((item = g_queue_pop_head(&perso->pending)) != NULL)
+		neardal_perso_prv_item_free(item);
+	while ((item = g_async_queue_try_pop(perso->ready)) != NULL)
+		neardal_perso_prv_item_free(item);
+	g_async_queue_unref(perso->ready);
+	g_async_queue_unref(perso->slots);
+	if (perso->fd != STDIN_FILENO)
+		close(perso->fd);
+	close(perso->wakeup[0]);
+	close(perso->wakeup[1]);
+	g_string_free(perso->buf, TRUE);
+	g_free(perso);
+}
+
+/*****************************************************************************
+ * neardal_perso_prv_report: row outcome to the client
+ ****************************************************************************/
+static void neardal_perso_prv_report(neardal_perso *perso,
+				     neardalPersoItem *item,
+				     neardalPersoWrite *write,
+				     errorCode_t err, guint64 doneTs)
+{
+	neardal_perso_result	result;
+
+	memset(&result, 0, sizeof(result));
+	result.row = item->row;
+	result.error = err;
+	result.attempts = item->attempts;
+	if (write != NULL) {
+		result.foundNs = write->foundTs;
+		result.writeNs = write->writeTs;
+		result.doneNs = doneTs;
+	}
+
+	if (err == NEARDAL_SUCCESS) {
+		result.tagName = write->tagName;
+		perso->stats.written++;
+		perso->foundToWriteNs += write->writeTs - write->foundTs;
+		perso->foundToDoneNs += doneTs - write->foundTs;
+	} else if (write != NULL)
+		perso->stats.failed++;
+	else
+		perso->stats.invalid++;
+
+	if (perso->cb != NULL)
+		perso->cb(&result, perso->user_data);
+}
+
+/*****************************************************************************
+ * neardal_perso_prv_next: next row to write (NULL if none yet), invalid rows
+ * being reported on the way
+ ****************************************************************************/
+static neardalPersoItem *neardal_perso_prv_next(neardal_perso *perso)
+{
+	neardalPersoItem	*item;
+
+	item = g_queue_pop_head(&perso->pending);
+	while (item == NULL && !perso->eof && !perso->stopped &&
+	       (item = g_async_queue_try_pop(perso->ready)) != NULL) {
+		if (item == &sPersoEnd) {
+			perso->eof = TRUE;
+			item = NULL;
+			break;
+		}
+		g_atomic_int_add(&perso->nbReady, -1);
+		g_async_queue_push(perso->slots, NEARDAL_PERSO_SLOT);
+		perso->stats.rows++;
+
+		if (item->err != NEARDAL_SUCCESS) {
+			neardal_perso_prv_report(perso, item, NULL, item->err,
+						 0);
+			neardal_perso_prv_item_free(item);
+			item = NULL;
+		}
+	}
+
+	return item;
+}
+
+static gboolean neardal_perso_prv_tag_hook(TagProp *tagProp, gpointer data);
+
+/*****************************************************************************
+ * neardal_perso_prv_check_end: end the run once every row was handled, tags
+ * being no longer written. TRUE if the run ended (the client may have
+ * released it from the callback). Nothing to end once stopped
+ ****************************************************************************/
+static gboolean neardal_perso_prv_check_end(neardal_perso *perso)
+{
+	if (perso->stopped || perso->stats.finished || !perso->eof ||
+	    perso->stats.inFlight > 0 || !g_queue_is_empty(&perso->pending))
+		return FALSE;
+
+	perso->stats.finished = TRUE;
+	neardal_tag_prv_hook_remove(neardal_perso_prv_tag_hook, perso);
+	g_source_remove(perso->flushId);
+	perso->flushId = 0;
+
+	if (perso->cb != NULL)
+		perso->cb(NULL, perso->user_data);
+
+	return TRUE;
+}
+
+static gboolean neardal_perso_prv_flush(gpointer data)
+{
+	neardal_perso		*perso = data;
+	neardalPersoItem	*item;
+	gboolean		keep;
+
+	/* Invalid rows ahead of the next one to write (the client may stop
+	 * the run from their callback) */
+	perso->refs++;
+	item = neardal_perso_prv_next(perso);
+	if (item != NULL)
+		g_queue_push_head(&perso->pending, item);
+
+	keep = !neardal_perso_prv_check_end(perso) && !perso->stopped;
+	neardal_perso_prv_unref(perso);
+
+	return keep;
+}
+
+static void neardal_perso_prv_write_done(errorCode_t err, gpointer data)
+{
+	neardalPersoWrite	*write = data;
+	neardal_perso		*perso = write->perso;
+	neardalPersoItem	*item = write->item;
+	guint64			doneTs = neardal_metrics_prv_now();
+
+	perso->stats.inFlight--;
+	neardal_metrics_prv_op(NEARDAL_STATS_OP_WRITE, write->writeTs,
+			       err != NEARDAL_SUCCESS);
+	NEARDAL_PROBE2(tag_write_done, write->tagName, err);
+
+	if (!perso->stopped) {
+		if (err != NEARDAL_SUCCESS &&
+		    item->attempts < NEARDAL_PERSO_ATTEMPTS) {
+			/* Next tag */
+			g_queue_push_head(&perso->pending, item);
+			perso->stats.retries++;
+			item = NULL;
+		} else
+			neardal_perso_prv_report(perso, item, write, err,
+						 doneTs);
+		/* Not if stopped from the callback */
+		neardal_perso_prv_check_end(perso);
+	}
+
+	neardal_perso_prv_item_free(item);
+	g_free(write->tagName);
+	g_free(write);
+	neardal_perso_prv_unref(perso);
+}
+
+/*****************************************************************************
+ * neardal_perso_prv_tag_hook: write the next row to a new (writable) tag
+ ****************************************************************************/
+static gboolean neardal_perso_prv_tag_hook(TagProp *tagProp, gpointer data)
+{
+	neardal_perso		*perso = data;
+	neardalPersoItem	*item;
+	neardalPersoWrite	*write;
+
+	if (tagProp->readOnly)
+		return FALSE;
+
+	perso->refs++;
+	item = neardal_perso_prv_next(perso);
+	if (item != NULL && perso->stopped) {
+		g_queue_push_head(&perso->pending, item);
+		item = NULL;
+	}
+	if (item == NULL) {
+		neardal_perso_prv_unref(perso);
+		return FALSE;
+	}
+
+	write = g_new0(neardalPersoWrite, 1);
+	write->perso = perso;
+	write->item = item;
+	write->tagName = g_strdup(tagProp->name);
+	write->writeTs = neardal_metrics_prv_now();
+	write->foundTs = tagProp->ifaceAddedTs ? tagProp->ifaceAddedTs :
+						 write->writeTs;
+	item->attempts++;
+	/* The reference taken above is the write's */
+	perso->stats.inFlight++;
+
+	NEARDAL_PROBE1(tag_write, tagProp->name);
+	neardalMgr.backend->tag_write_async(tagProp, item->request,
+					    neardal_perso_prv_write_done,
+					    write);
+
+	return TRUE;
+}
+
+errorCode_t neardal_perso_start(const char *fileName, neardal_perso_cb cb,
+				void *user_data, neardal_perso **perso)
+{
+	neardal_perso	*out;
+	GError		*gerror = NULL;
+	errorCode_t	err;
+	gint		i;
+
+	NEARDAL_ASSERT_RET(fileName != NULL && perso != NULL,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	neardal_prv_construct(&err);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	out = g_try_malloc0(sizeof(neardal_perso));
+	if (out == NULL)
+		return NEARDAL_ERROR_NO_MEMORY;
+
+	out->refs = 1;
+	out->cb = cb;
+	out->user_data = user_data;
+	out->fd = strcmp(fileName, "-") ? open(fileName, O_RDONLY) :
+					   STDIN_FILENO;
+	if (out->fd < 0) {
+		NEARDAL_TRACE_ERR("Can't open '%s'\n", fileName);
+		g_free(out);
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+	}
+	if (pipe(out->wakeup) < 0) {
+		if (out->fd != STDIN_FILENO)
+			close(out->fd);
+		g_free(out);
+		return NEARDAL_ERROR_GENERAL_ERROR;
+	}
+	out->buf = g_string_new(NULL);
+	/* Default CSV columns */
+	out->nbColumns = 4;
+	out->columns[0] = NEARDAL_PERSO_URI;
+	out->columns[1] = NEARDAL_PERSO_TEXT;
+	out->columns[2] = NEARDAL_PERSO_MIME;
+	out->columns[3] = NEARDAL_PERSO_PAYLOAD;
+
+	g_queue_init(&out->pending);
+	out->ready = g_async_queue_new();
+	out->slots = g_async_queue_new();
+	for (i = 0; i < NEARDAL_PERSO_WINDOW; i++)
+		g_async_queue_push(out->slots, NEARDAL_PERSO_SLOT);
+
+	err = neardal_tag_prv_hook_add(neardal_perso_prv_tag_hook, out);
+	if (err != NEARDAL_SUCCESS) {
+		neardal_perso_prv_unref(out);
+		return err;
+	}
+
+#if GLIB_CHECK_VERSION(2, 32, 0)
+	out->thread = g_thread_try_new("neardal-perso",
+				       neardal_perso_prv_reader, out, &gerror);
+#else
+	out->thread = g_thread_create(neardal_perso_prv_reader, out, TRUE,
+				      &gerror);
+#endif
+	if (out->thread == NULL) {
+		NEARDAL_TRACE_ERR("Can't start reader: %s\n", gerror->message);
+		g_error_free(gerror);
+		neardal_tag_prv_hook_remove(neardal_perso_prv_tag_hook, out);
+		neardal_perso_prv_unref(out);
+		return NEARDAL_ERROR_GENERAL_ERROR;
+	}
+
+	out->flushId = g_timeout_add(NEARDAL_PERSO_FLUSH_MS,
+				     neardal_perso_prv_flush, out);
+	out->startTs = neardal_metrics_prv_now();
+	*perso = out;
+
+	return NEARDAL_SUCCESS;
+}
+
+void neardal_perso_get_stats(const neardal_perso *perso,
+			     neardal_perso_stats *stats)
+{
+	g_return_if_fail(perso != NULL && stats != NULL);
+
+	*stats = perso->stats;
+	stats->pending = g_queue_get_length((GQueue *) &perso->pending) +
+			 g_atomic_int_get(&perso->nbReady);
+	stats->elapsedNs = neardal_metrics_prv_now() - perso->startTs;
+	if (stats->elapsedNs > 0)
+		stats->writesPerSec = stats->written * 1e9 / stats->elapsedNs;
+	if (stats->written > 0) {
+		stats->meanFoundToWriteNs = perso->foundToWriteNs /
+					    stats->written;
+		stats->meanFoundToDoneNs = perso->foundToDoneNs /
+					   stats->written;
+	}
+}
+
+void neardal_perso_stop(neardal_perso *perso)
+{
+	if (perso == NULL)
+		return;
+
+	perso->stopped = TRUE;
+	neardal_tag_prv_hook_remove(neardal_perso_prv_tag_hook, perso);
+	if (perso->flushId != 0)
+		g_source_remove(perso->flushId);
+	perso->flushId = 0;
+
+	/* Wake the reader up, waiting for a slot or for the file */
+	g_async_queue_push(perso->slots, NEARDAL_PERSO_QUIT);
+	if (write(perso->wakeup[1], "", 1) < 0)
+		NEARDAL_TRACE_ERR("Can't wake the reader up\n");
+	g_thread_join(perso->thread);
+
+	neardal_perso_prv_unref(perso);
+}
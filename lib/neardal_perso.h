@@ -0,0 +1,160 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+/*!
+ * @file neardal_perso.h
+ *
+ * @brief Bulk tag personalisation from a CSV or NDJSON file.
+ *
+ * The file is read as a stream, one row per tag, by a background thread
+ * which encodes each row into a ready to send NDEF message, a window of
+ * rows ahead. Each tag appearing on any adapter then gets the next message
+ * from the 'interfaces-added' handler, before the client is notified: the
+ * write starts without encoding nor any round-trip.
+ *
+ * A row holds the records to write, in this order when present: a URI
+ * record, a Text record and a MIME record.
+ *  - CSV: fields "uri,text,mime,payload" by default, or as named by a first
+ *    header row among uri, text, lang, mime and payload. Fields may be
+ *    quoted ("" for a quote), not span lines.
+ *  - NDJSON: one object per line, same members, string values.
+ * 'lang' defaults to "en"; 'payload' is base64 encoded, 'mime' defaults to
+ * "application/octet-stream".
+ *
+ * A failed write is tried again on the next tags (up to 3 writes) before
+ * the row is reported as failed. Results are reported from the main loop.
+ *
+ ******************************************************************************/
+
+#ifndef NEARDAL_PERSO_H
+#define NEARDAL_PERSO_H
+#include "neardal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif	/* __cplusplus */
+
+/*!
+ * @brief Personalisation run (opaque, see @link neardal_perso_start
+ * @endlink)
+*/
+typedef struct neardal_perso neardal_perso;
+
+/*!
+ * @brief Outcome of a row
+*/
+typedef struct {
+/*! @brief Row line number in the file (1: first line) */
+	unsigned long long	row;
+/*! @brief Written tag name (NULL if the row was not written) */
+	const char		*tagName;
+/*! @brief NEARDAL_SUCCESS if written, NEARDAL_ERROR_INVALID_RECORD if the
+ * row can't be encoded, or the error of the last write */
+	errorCode_t		error;
+/*! @brief Writes of the row */
+	unsigned int		attempts;
+/*! @brief 'interfaces-added' of the written tag (ns) */
+	unsigned long long	foundNs;
+/*! @brief Write started (ns) */
+	unsigned long long	writeNs;
+/*! @brief Write completed (ns) */
+	unsigned long long	doneNs;
+} neardal_perso_result;
+
+/*!
+ * @brief Personalisation progress (@link neardal_perso_get_stats @endlink)
+*/
+typedef struct {
+/*! @brief Rows received from the reader */
+	unsigned long long	rows;
+/*! @brief Rows written */
+	unsigned long long	written;
+/*! @brief Rows whose last write failed */
+	unsigned long long	failed;
+/*! @brief Rows which could not be encoded */
+	unsigned long long	invalid;
+/*! @brief Writes tried again */
+	unsigned long long	retries;
+/*! @brief Encoded rows waiting for a tag */
+	unsigned int		pending;
+/*! @brief Writes in progress */
+	unsigned int		inFlight;
+/*! @brief All rows handled */
+	int			finished;
+/*! @brief Time since the start (ns) */
+	unsigned long long	elapsedNs;
+/*! @brief Rows written per second since the start */
+	double			writesPerSec;
+/*! @brief Mean 'interfaces-added' to write start, written rows (ns) */
+	unsigned long long	meanFoundToWriteNs;
+/*! @brief Mean 'interfaces-added' to write completion, written rows (ns) */
+	unsigned long long	meanFoundToDoneNs;
+} neardal_perso_stats;
+
+/**
+ * @brief Callback prototype for row outcomes (@link neardal_perso_start
+ * @endlink)
+ *
+ * @param result row outcome, valid during the callback; NULL once every
+ * row was handled (end of the run: tags are no longer written). The run may
+ * be released with @link neardal_perso_stop @endlink from the callback, no
+ * outcome being reported after that
+ * @param user_data Client user data
+ **/
+typedef void (*neardal_perso_cb) (const neardal_perso_result *result,
+				  void *user_data);
+
+/*! \fn errorCode_t neardal_perso_start(const char *fileName,
+ *				       neardal_perso_cb cb, void *user_data,
+ *				       neardal_perso **perso)
+ * @brief Start writing the rows of a file to the next tags to appear
+ *
+ * @param fileName CSV or NDJSON file ("-": standard input)
+ * @param cb Client callback for row outcomes (may be NULL)
+ * @param user_data Client user data
+ * @param perso started run, to release with @link neardal_perso_stop
+ * @endlink (also once finished)
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_perso_start(const char *fileName, neardal_perso_cb cb,
+				void *user_data, neardal_perso **perso);
+
+/*! \fn void neardal_perso_get_stats(const neardal_perso *perso,
+ *				    neardal_perso_stats *stats)
+ * @brief Get the progress of a run
+ *
+ * @param perso run
+ * @param stats filled with the run progress
+ **/
+void neardal_perso_get_stats(const neardal_perso *perso,
+			     neardal_perso_stats *stats);
+
+/*! \fn void neardal_perso_stop(neardal_perso *perso)
+ * @brief Stop a run and release it. Rows being written are not reported.
+ * Doesn't wait for the file (e.g. stdin) to be readable.
+ *
+ * @param perso run (may be NULL)
+ **/
+void neardal_perso_stop(neardal_perso *perso);
+
+#ifdef __cplusplus
+}
+#endif	/* __cplusplus */
+
+#endif /* NEARDAL_PERSO_H */
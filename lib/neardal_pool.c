@@ -0,0 +1,235 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+
+#include "neardal.h"
+#include "neardal_prv.h"
+
+#define NEARDAL_POOL_SLAB_OBJS	64	/* objects per slab */
+#define NEARDAL_POOL_STR_SLOT	64	/* marker byte, string and NUL */
+#define NEARDAL_POOL_ALIGN(size) \
+	(((size) + sizeof(guint64) - 1) & ~(sizeof(guint64) - 1))
+
+/* Free object: link to the next free one */
+typedef struct neardalPoolFree {
+	struct neardalPoolFree	*next;
+} neardalPoolFree;
+
+/* Slab header, objects follow */
+typedef struct neardalPoolSlab {
+	struct neardalPoolSlab	*next;
+} neardalPoolSlab;
+
+typedef struct {
+	gsize		size;		/* object size, aligned */
+	neardalPoolFree	*free;		/* free objects */
+	neardalPoolSlab	*slabs;		/* all slabs */
+} neardalPool;
+
+static neardalPool	sPools[NEARDAL_POOL_COUNT];
+static gint		sPoolEnabled = -1;	/* NEARDAL_POOL not read yet */
+
+/*****************************************************************************
+ * neardal_pool_prv_enabled: pools in use, unless NEARDAL_POOL=0
+ ****************************************************************************/
+static gboolean neardal_pool_prv_enabled(void)
+{
+	const gchar *env;
+
+	if (sPoolEnabled < 0) {
+		env = g_getenv("NEARDAL_POOL");
+		sPoolEnabled = (env == NULL || strcmp(env, "0") != 0);
+	}
+
+	return sPoolEnabled;
+}
+
+static gsize neardal_pool_prv_size(neardalPoolId id)
+{
+	switch (id) {
+	case NEARDAL_POOL_TAG:
+		return sizeof(TagProp);
+	case NEARDAL_POOL_DEV:
+		return sizeof(DevProp);
+	case NEARDAL_POOL_RCD:
+		return NEARDAL_RCD_BLOCK_SIZE(NEARDAL_RCD_FIRST_ALLOC);
+	default:
+		return NEARDAL_POOL_STR_SLOT;
+	}
+}
+
+/*****************************************************************************
+ * neardal_pool_prv_grow: add a slab of free objects to a pool
+ ****************************************************************************/
+static gboolean neardal_pool_prv_grow(neardalPool *pool)
+{
+	gsize		hdr = NEARDAL_POOL_ALIGN(sizeof(neardalPoolSlab));
+	neardalPoolSlab	*slab;
+	neardalPoolFree	*obj;
+	guint		i;
+
+	slab = g_try_malloc(hdr + pool->size * NEARDAL_POOL_SLAB_OBJS);
+	if (slab == NULL)
+		return FALSE;
+	neardal_metrics_prv_count(NEARDAL_COUNTER_POOL_SYS_ALLOCS);
+
+	slab->next = pool->slabs;
+	pool->slabs = slab;
+
+	/* Pushed backwards: objects handed out in address order */
+	for (i = NEARDAL_POOL_SLAB_OBJS; i > 0; i--) {
+		obj = (neardalPoolFree *) ((guint8 *) slab + hdr +
+					   (i - 1) * pool->size);
+		obj->next = pool->free;
+		pool->free = obj;
+	}
+
+	return TRUE;
+}
+
+static gpointer neardal_pool_prv_alloc(neardalPoolId id)
+{
+	neardalPool	*pool = &sPools[id];
+	neardalPoolFree	*obj;
+
+	neardal_metrics_prv_count(NEARDAL_COUNTER_POOL_ALLOCS);
+
+	if (!neardal_pool_prv_enabled()) {
+		neardal_metrics_prv_count(NEARDAL_COUNTER_POOL_SYS_ALLOCS);
+		return g_try_malloc(neardal_pool_prv_size(id));
+	}
+
+	if (pool->size == 0)
+		pool->size = NEARDAL_POOL_ALIGN(neardal_pool_prv_size(id));
+
+	if (pool->free == NULL && !neardal_pool_prv_grow(pool))
+		return NULL;
+
+	obj = pool->free;
+	pool->free = obj->next;
+
+	return obj;
+}
+
+/*****************************************************************************
+ * neardal_pool_prv_alloc0: zeroed object from a pool
+ ****************************************************************************/
+gpointer neardal_pool_prv_alloc0(neardalPoolId id)
+{
+	gpointer obj;
+
+	NEARDAL_ASSERT_RET(id < NEARDAL_POOL_COUNT, NULL);
+
+	obj = neardal_pool_prv_alloc(id);
+	if (obj != NULL)
+		memset(obj, 0, neardal_pool_prv_size(id));
+
+	return obj;
+}
+
+/*****************************************************************************
+ * neardal_pool_prv_free: give an object back to its pool
+ ****************************************************************************/
+void neardal_pool_prv_free(neardalPoolId id, gpointer obj)
+{
+	neardalPool	*pool = &sPools[id];
+	neardalPoolFree	*node = obj;
+
+	NEARDAL_ASSERT(id < NEARDAL_POOL_COUNT);
+
+	if (obj == NULL)
+		return;
+
+	if (!neardal_pool_prv_enabled()) {
+		g_free(obj);
+		return;
+	}
+
+	node->next = pool->free;
+	pool->free = node;
+}
+
+/*****************************************************************************
+ * neardal_pool_prv_strdup: the byte before the string tells where it comes
+ * from: 1 for the string pool, 0 for the heap (longer strings)
+ ****************************************************************************/
+gchar *neardal_pool_prv_strdup(const gchar *str)
+{
+	gchar	*slot;
+	gsize	len;
+
+	if (str == NULL)
+		return NULL;
+
+	len = strlen(str);
+	if (len + 2 <= NEARDAL_POOL_STR_SLOT) {
+		slot = neardal_pool_prv_alloc(NEARDAL_POOL_STR);
+		if (slot == NULL)
+			return NULL;
+		slot[0] = 1;
+	} else {
+		neardal_metrics_prv_count(NEARDAL_COUNTER_POOL_ALLOCS);
+		neardal_metrics_prv_count(NEARDAL_COUNTER_POOL_SYS_ALLOCS);
+		slot = g_try_malloc(len + 2);
+		if (slot == NULL)
+			return NULL;
+		slot[0] = 0;
+	}
+	memcpy(slot + 1, str, len + 1);
+
+	return slot + 1;
+}
+
+/*****************************************************************************
+ * neardal_pool_prv_strfree: release a neardal_pool_prv_strdup() string
+ ****************************************************************************/
+void neardal_pool_prv_strfree(gchar *str)
+{
+	gchar *slot;
+
+	if (str == NULL)
+		return;
+
+	slot = str - 1;
+	if (slot[0])
+		neardal_pool_prv_free(NEARDAL_POOL_STR, slot);
+	else
+		g_free(slot);
+}
+
+/*****************************************************************************
+ * neardal_pool_prv_destroy: release all slabs
+ ****************************************************************************/
+void neardal_pool_prv_destroy(void)
+{
+	neardalPoolSlab	*slab;
+	guint		id;
+
+	for (id = 0; id < NEARDAL_POOL_COUNT; id++) {
+		while ((slab = sPools[id].slabs) != NULL) {
+			sPools[id].slabs = slab->next;
+			g_free(slab);
+		}
+		sPools[id].free = NULL;
+	}
+}
@@ -0,0 +1,63 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef NEARDAL_POOL_H
+#define NEARDAL_POOL_H
+
+/* Fixed-size object pools: objects are carved out of slabs and recycled
+ * through a free list, slabs are only released by neardal_pool_prv_destroy().
+ * NEARDAL_POOL=0 in the environment falls back to g_malloc()/g_free(). */
+typedef enum {
+	NEARDAL_POOL_TAG = 0,	/* TagProp */
+	NEARDAL_POOL_DEV,	/* DevProp */
+	NEARDAL_POOL_RCD,	/* first records block (RcdArray) */
+	NEARDAL_POOL_STR,	/* short strings (object paths, types) */
+	NEARDAL_POOL_COUNT
+} neardalPoolId;
+
+/*****************************************************************************
+ * neardal_pool_prv_alloc0: zeroed object from a pool, NULL if out of memory
+ ****************************************************************************/
+gpointer neardal_pool_prv_alloc0(neardalPoolId id);
+
+/*****************************************************************************
+ * neardal_pool_prv_free: give an object back to its pool (NULL ignored)
+ ****************************************************************************/
+void neardal_pool_prv_free(neardalPoolId id, gpointer obj);
+
+/*****************************************************************************
+ * neardal_pool_prv_strdup: copy a string, short ones into the string pool.
+ * Release with neardal_pool_prv_strfree() only.
+ ****************************************************************************/
+gchar *neardal_pool_prv_strdup(const gchar *str);
+
+/*****************************************************************************
+ * neardal_pool_prv_strfree: release a neardal_pool_prv_strdup() string
+ * (NULL ignored)
+ ****************************************************************************/
+void neardal_pool_prv_strfree(gchar *str);
+
+/*****************************************************************************
+ * neardal_pool_prv_destroy: release all slabs (every object must have been
+ * given back)
+ ****************************************************************************/
+void neardal_pool_prv_destroy(void);
+
+#endif /* NEARDAL_POOL_H */
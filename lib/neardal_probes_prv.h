@@ -0,0 +1,51 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef NEARDAL_PROBES_PRV_H
+#define NEARDAL_PROBES_PRV_H
+
+/* USDT static probes, provider 'neardal' (configure --enable-sdt).
+ * A disabled probe costs a single nop, e.g.:
+ *   bpftrace -e 'usdt:/usr/lib/libneardal.so:neardal:tag_write { ... }'
+ *
+ * Probes come in pairs 'xxx' / 'xxx_done' around the same operation, the
+ * first argument being the DBus object path (string) and the 'done'
+ * probe adding the NEARDAL error code when relevant.
+ * 'cb_dispatch' / 'cb_return' surround every client callback invocation:
+ * arg0 is the callback kind ("tag_found", "rcd_found"...), arg1 the object
+ * path it is about. */
+#ifdef NEARDAL_SDT
+	#include <sys/sdt.h>
+
+	#define NEARDAL_PROBE1(name, a1)	DTRACE_PROBE1(neardal, name, \
+							      a1)
+	#define NEARDAL_PROBE2(name, a1, a2)	DTRACE_PROBE2(neardal, name, \
+							      a1, a2)
+#else
+	#define NEARDAL_PROBE1(name, a1)
+	#define NEARDAL_PROBE2(name, a1, a2)
+#endif /* NEARDAL_SDT */
+
+#define NEARDAL_PROBE_CB_DISPATCH(kind, path)	NEARDAL_PROBE2(cb_dispatch, \
+							       kind, path)
+#define NEARDAL_PROBE_CB_RETURN(kind, path)	NEARDAL_PROBE2(cb_return, \
+							       kind, path)
+
+#endif	/* NEARDAL_PROBES_PRV_H */
@@ -27,7 +27,11 @@
 #include "neardal_manager.h"
 #include "neardal_tools.h"
 #include "neardal_traces_prv.h"
+#include "neardal_probes_prv.h"
+#include "neardal_capture_prv.h"
 #include "neardal.h"
+#include "neardal_metrics.h"
+#include "neardal_pool.h"
 #include "dbus-object-manager.h"
 
 
@@ -76,21 +80,48 @@ typedef struct {
 	void		*rcd_found_ud;		/* User data for
 							client callback
 							'tag record found'*/
+
+	tag_trace_cb	tag_trace;		/* Client callback for
+							'tag trace' */
+	void		*tag_trace_ud;		/* User data for
+							client callback
+							'tag trace' */
+
+	auto_write_cb	auto_write;		/* Client callback for
+							'auto write' */
+	void		*auto_write_ud;		/* User data for
+							client callback
+							'auto write' */
 } neardalCb;
 
 /* NEARDAL context */
 typedef struct {
 	neardalCb	cb;			/* Neardal Callbacks */
+	const neardalMgrBackend *backend;	/* Neard access (DBus or
+						 * simulator, see
+						 * neardal_sim_enable()) */
+	gboolean	constructed;		/* Backend created */
 	GDBusConnection	*conn;			/* DBus connection */
 	OrgNeardManager	*proxy;			/* Neard Mgr dbus proxy */
 	ObjectManager	*dbus_om;
-	GVariant	*dbus_objs;
+	GHashTable	*adp_props;		/* Adapter path -> a{sv}, from
+						 * GetManagedObjects */
 	GData		*dbus_data;
 	MgrProp		prop;			/* Mgr Properties
 							(adapter list) */
 	guint		OwnerId;		/* dbus Id server side */
 						/* (for neard agent Mgnt) */
 	GDBusObjectManagerServer *agentMgr;	/* Object 'agent' Manager */
+	guint		neardWatchId;		/* neard name owner watch */
+	gboolean	neardLost;		/* neard gone, resync when it
+						 * comes back */
+
+	guint64		ifaceAddedTs;	/* 'interfaces-added' being handled
+					 * (reception time) */
+	GSList		*tagHooks;	/* tag arrival hooks (see
+					 * neardal_tag_prv_hook_add()) */
+	gchar		*autoWriteFilter; /* neardal_set_auto_write() */
+	GVariant	*autoWriteRqst;	/* 'Raw' write request, NULL: off */
 
 	errorCode_t	ec;		/* Lastest NEARDAL error */
 	GError		*gerror;	/* Lastest GError if available */
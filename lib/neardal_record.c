@@ -68,6 +68,108 @@ GVariant *neardal_record_to_g_variant(neardal_record *in)
 	return out;
 }
 
+errorCode_t neardal_record_template_new(const neardal_record *record,
+					const char *field,
+					neardal_record_template **tmpl)
+{
+	neardal_record_template	*out;
+	GVariantBuilder		b;
+	GVariantIter		iter;
+	GVariant		*full, *constant, *entry, *value;
+	const gchar		*key;
+	gchar			*prefix = NULL;
+	gsize			i, n;
+
+	NEARDAL_ASSERT_RET(record != NULL && field != NULL && tmpl != NULL,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	full = g_variant_ref_sink(neardal_record_to_g_variant(
+						(neardal_record *) record));
+
+	/* Every field but the changing one, whose value is the prefix */
+	g_variant_builder_init(&b, G_VARIANT_TYPE_VARDICT);
+	g_variant_iter_init(&iter, full);
+	while ((entry = g_variant_iter_next_value(&iter)) != NULL) {
+		g_variant_get(entry, "{&sv}", &key, &value);
+		if (strcmp(key, field))
+			g_variant_builder_add_value(&b, entry);
+		else if (g_variant_is_of_type(value, G_VARIANT_TYPE_STRING))
+			prefix = g_variant_dup_string(value, NULL);
+		else {
+			g_variant_unref(value);
+			g_variant_unref(entry);
+			g_variant_builder_clear(&b);
+			g_variant_unref(full);
+			return NEARDAL_ERROR_INVALID_PARAMETER;
+		}
+		g_variant_unref(value);
+		g_variant_unref(entry);
+	}
+	g_variant_unref(full);
+
+	constant = g_variant_ref_sink(g_variant_builder_end(&b));
+	/* Serialized now, written as is by each write */
+	g_variant_get_data(constant);
+	n = g_variant_n_children(constant);
+
+	out = g_try_malloc0(sizeof(neardal_record_template) +
+			    n * sizeof(GVariant *));
+	if (out == NULL) {
+		g_variant_unref(constant);
+		g_free(prefix);
+		return NEARDAL_ERROR_NO_MEMORY;
+	}
+
+	out->constant = constant;
+	out->key = g_variant_ref_sink(g_variant_new_string(field));
+	out->prefix = prefix;
+	out->nbEntries = n;
+	for (i = 0; i < n; i++)
+		out->entries[i] = g_variant_get_child_value(constant, i);
+	*tmpl = out;
+
+	return NEARDAL_SUCCESS;
+}
+
+void neardal_record_template_free(neardal_record_template *tmpl)
+{
+	gsize	i;
+
+	if (tmpl == NULL)
+		return;
+
+	for (i = 0; i < tmpl->nbEntries; i++)
+		g_variant_unref(tmpl->entries[i]);
+	g_variant_unref(tmpl->constant);
+	g_variant_unref(tmpl->key);
+	g_free(tmpl->prefix);
+	g_free(tmpl);
+}
+
+GVariant *neardal_record_prv_template_apply(
+				const neardal_record_template *tmpl,
+				const gchar *suffix)
+{
+	GVariantBuilder	b;
+	GVariant	*value;
+	gchar		*str;
+	gsize		i;
+
+	g_variant_builder_init(&b, G_VARIANT_TYPE_VARDICT);
+	/* Already serialized entries: copied as is, nothing parsed */
+	for (i = 0; i < tmpl->nbEntries; i++)
+		g_variant_builder_add_value(&b, tmpl->entries[i]);
+
+	str = g_strconcat(tmpl->prefix ? tmpl->prefix : "",
+			  suffix ? suffix : "", NULL);
+	value = g_variant_new_variant(g_variant_new_string(str));
+	g_free(str);
+	g_variant_builder_add_value(&b, g_variant_new_dict_entry(tmpl->key,
+								 value));
+
+	return g_variant_builder_end(&b);
+}
+
 neardal_record *neardal_g_variant_to_record(GVariant *in)
 {
 	neardal_record *out = g_new0(neardal_record, 1);
@@ -92,20 +194,202 @@ neardal_record *neardal_g_variant_to_record(GVariant *in)
 	return out;
 }
 
+RcdProp *neardal_record_prv_append(RcdArray *array)
+{
+	RcdProp	*rcds;
+	guint	alloc, i;
+
+	if (array->len == array->alloc) {
+		alloc = array->alloc ? array->alloc * 2 :
+				       NEARDAL_RCD_FIRST_ALLOC;
+		if (array->alloc == 0)
+			rcds = neardal_pool_prv_alloc0(NEARDAL_POOL_RCD);
+		else if (array->alloc == NEARDAL_RCD_FIRST_ALLOC) {
+			/* Out of the pool block */
+			rcds = g_try_malloc(NEARDAL_RCD_BLOCK_SIZE(alloc));
+			if (rcds != NULL)
+				memcpy(rcds, array->rcds, NEARDAL_RCD_BLOCK_SIZE(
+						NEARDAL_RCD_FIRST_ALLOC));
+		} else
+			rcds = g_try_realloc(array->rcds,
+					     NEARDAL_RCD_BLOCK_SIZE(alloc));
+		if (rcds == NULL)
+			return NULL;
+		if (array->alloc == NEARDAL_RCD_FIRST_ALLOC)
+			neardal_pool_prv_free(NEARDAL_POOL_RCD, array->rcds);
+
+		/* The bitmap follows the records: move it after them */
+		array->notified = (guint32 *) (rcds + alloc);
+		memmove(array->notified, rcds + array->alloc,
+			NEARDAL_RCD_WORDS(array->alloc) * sizeof(guint32));
+		for (i = NEARDAL_RCD_WORDS(array->alloc);
+		     i < NEARDAL_RCD_WORDS(alloc); i++)
+			array->notified[i] = 0;
+
+		array->rcds = rcds;
+		array->alloc = alloc;
+	}
+
+	i = array->len++;
+	memset(&array->rcds[i], 0, sizeof(RcdProp));
+	array->notified[i >> 5] &= ~(1U << (i & 31));
+
+	return &array->rcds[i];
+}
+
+gint neardal_record_prv_find(RcdArray *array, const gchar *name)
+{
+	guint i;
+
+	for (i = 0; i < array->len; i++)
+		if (!strcmp(array->rcds[i].name, name))
+			return i;
+
+	return -1;
+}
+
+void neardal_record_prv_remove_at(RcdArray *array, guint i)
+{
+	guint j;
+
+	neardal_pool_prv_strfree(array->rcds[i].name);
+	memmove(&array->rcds[i], &array->rcds[i + 1],
+		(array->len - i - 1) * sizeof(RcdProp));
+
+	for (j = i; j + 1 < array->len; j++)
+		if (NEARDAL_RCD_NOTIFIED(array, j + 1))
+			neardal_record_prv_set_notified(array, j);
+		else
+			array->notified[j >> 5] &= ~(1U << (j & 31));
+	array->len--;
+	array->notified[array->len >> 5] &= ~(1U << (array->len & 31));
+}
+
+void neardal_record_prv_clear(RcdArray *array)
+{
+	guint i;
+
+	for (i = 0; i < array->len; i++)
+		neardal_pool_prv_strfree(array->rcds[i].name);
+	if (array->alloc == NEARDAL_RCD_FIRST_ALLOC)
+		neardal_pool_prv_free(NEARDAL_POOL_RCD, array->rcds);
+	else
+		g_free(array->rcds);
+	memset(array, 0, sizeof(RcdArray));
+}
+
+guint neardal_record_prv_next_pending(RcdArray *array, guint from)
+{
+	guint32	word;
+
+	while (from < array->len) {
+		word = ~array->notified[from >> 5] >> (from & 31);
+		if (word != 0) {
+			from += g_bit_nth_lsf(word, -1);
+			break;
+		}
+		from = (from | 31) + 1;
+	}
+
+	return MIN(from, array->len);
+}
+
+void neardal_record_prv_set_notified(RcdArray *array, guint i)
+{
+	array->notified[i >> 5] |= 1U << (i & 31);
+}
+
+void neardal_record_prv_notify(RcdArray *array, guint i)
+{
+	RcdProp *rcdProp = &array->rcds[i];
+	TagProp *tagProp = rcdProp->parent;
+	const gchar *name = rcdProp->name;
+	guint64 decodedTs = rcdProp->decodedTs;
+	guint64 dispatchedTs, returnedTs;
+
+	/* Set before the callback, which may change the array */
+	neardal_record_prv_set_notified(array, i);
+	dispatchedTs = rcdProp->dispatchedTs = neardal_metrics_prv_now();
+	NEARDAL_PROBE_CB_DISPATCH("rcd_found", name);
+	neardalMgr.cb.rcd_found(name, neardalMgr.cb.rcd_found_ud);
+	NEARDAL_PROBE_CB_RETURN("rcd_found", name);
+	returnedTs = neardal_metrics_prv_now();
+	if (i < array->len)
+		array->rcds[i].returnedTs = returnedTs;
+
+	neardal_metrics_prv_stage(NEARDAL_STATS_STAGE_RCD_DISPATCH,
+			decodedTs, dispatchedTs);
+	neardal_metrics_prv_stage(NEARDAL_STATS_STAGE_RCD_CALLBACK,
+			dispatchedTs, returnedTs);
+	neardal_metrics_prv_stage(NEARDAL_STATS_STAGE_RCD_FOUND,
+			tagProp->ifaceAddedTs, returnedTs);
+}
+
+/* Tag owning a record, if any (device records have none) */
+static TagProp *neardal_record_prv_get_tag(const gchar *name)
+{
+	AdpProp *adpProp = NULL;
+	TagProp *tagProp = NULL;
+
+	if (neardal_mgr_prv_get_adapter((gchar *) name, &adpProp)
+			== NEARDAL_SUCCESS)
+		neardal_adp_prv_get_tag(adpProp, (gchar *) name, &tagProp);
+
+	return tagProp;
+}
+
 void neardal_record_add(GVariant *record)
 {
+	guint64 decodedTs = neardal_metrics_prv_now();
+	const gchar *name;
+	TagProp *tagProp = NULL;
+	RcdProp *rcdProp = NULL;
+
 	NEARDAL_TRACEIN();
 
 	neardal_g_variant_dump(record);
 
-	if (neardalMgr.cb.rcd_found != NULL)
-		neardalMgr.cb.rcd_found(neardal_g_variant_get(record, "Name", "&s"),
-					neardalMgr.cb.rcd_found_ud);
+	neardal_metrics_prv_count(NEARDAL_COUNTER_RCD_FOUND);
+
+	name = neardal_g_variant_get(record, "Name", "&s");
+
+	if (name != NULL && (tagProp = neardal_record_prv_get_tag(name)) &&
+			(rcdProp = neardal_record_prv_append(&tagProp->rcds))) {
+		rcdProp->name = neardal_pool_prv_strdup(name);
+		rcdProp->parent = tagProp;
+		rcdProp->decodedTs = decodedTs;
+	}
+
+	if (neardalMgr.cb.rcd_found == NULL)
+		return;
+
+	if (rcdProp != NULL)
+		neardal_record_prv_notify(&tagProp->rcds,
+					  tagProp->rcds.len - 1);
+	else {
+		NEARDAL_PROBE_CB_DISPATCH("rcd_found", name);
+		neardalMgr.cb.rcd_found(name, neardalMgr.cb.rcd_found_ud);
+		NEARDAL_PROBE_CB_RETURN("rcd_found", name);
+	}
 }
 
 void neardal_record_remove(GVariant *record)
 {
+	const gchar *name;
+	TagProp *tagProp;
+	gint i;
+
 	NEARDAL_TRACEIN();
 
 	neardal_g_variant_dump(record);
+
+	neardal_metrics_prv_count(NEARDAL_COUNTER_RCD_LOST);
+
+	name = neardal_g_variant_get(record, "Name", "&s");
+
+	if (name == NULL || !(tagProp = neardal_record_prv_get_tag(name)))
+		return;
+
+	if ((i = neardal_record_prv_find(&tagProp->rcds, name)) >= 0)
+		neardal_record_prv_remove_at(&tagProp->rcds, i);
 }
@@ -25,11 +25,89 @@
 typedef struct {
 	gchar		*name;	/* DBus interface name (as identifier) */
 	void		*parent; /* parent (tag) */
-	gboolean	notified; /* Already notified to client? */
+
+	/* Detection timestamps (see neardal_metrics_prv_now()) */
+	guint64		decodedTs;	/* properties decoded */
+	guint64		dispatchedTs;	/* 'record found' callback invoked */
+	guint64		returnedTs;	/* 'record found' callback returned */
 } RcdProp;
 
+/* Records of a tag or device: contiguous array followed by the bitmap of
+ * records already notified to the client, in a single allocation */
+typedef struct {
+	RcdProp		*rcds;
+	guint32		*notified;	/* bit i: rcds[i] notified */
+	guint		len;
+	guint		alloc;
+} RcdArray;
+
+#define NEARDAL_RCD_NOTIFIED(a, i) \
+	(((a)->notified[(i) >> 5] >> ((i) & 31)) & 1)
+
+/* Records block: 'n' records and their bitmap words. The first block
+ * (NEARDAL_RCD_FIRST_ALLOC records) comes from NEARDAL_POOL_RCD. */
+#define NEARDAL_RCD_WORDS(n)		(((n) + 31) / 32)
+#define NEARDAL_RCD_BLOCK_SIZE(n)	((n) * sizeof(RcdProp) + \
+					 NEARDAL_RCD_WORDS(n) * sizeof(guint32))
+#define NEARDAL_RCD_FIRST_ALLOC		2
+
+/* Compiled record: constant fields serialized once, and the changing one */
+struct neardal_record_template {
+	GVariant	*constant;	/* a{sv} without 'field', serialized */
+	GVariant	*key;		/* 's': changing field name */
+	gchar		*prefix;	/* changing field constant part */
+	gsize		nbEntries;
+	GVariant	*entries[];	/* {sv} of 'constant' */
+};
+
 void neardal_record_add(GVariant *record);
 void neardal_record_remove(GVariant *record);
 void neardal_record_free(neardal_record *record);
 
+/*****************************************************************************
+ * neardal_record_prv_template_apply: a{sv} to write for 'tmpl', the changing
+ * field being prefix + suffix (floating)
+ ****************************************************************************/
+GVariant *neardal_record_prv_template_apply(
+				const neardal_record_template *tmpl,
+				const gchar *suffix);
+
+/*****************************************************************************
+ * neardal_record_prv_append: new zeroed (not notified) record at the end of
+ * 'array', NULL if out of memory. Pointers to records are only valid until
+ * the array is modified.
+ ****************************************************************************/
+RcdProp *neardal_record_prv_append(RcdArray *array);
+
+/*****************************************************************************
+ * neardal_record_prv_find: index of record 'name', -1 if not found
+ ****************************************************************************/
+gint neardal_record_prv_find(RcdArray *array, const gchar *name);
+
+/*****************************************************************************
+ * neardal_record_prv_remove_at: remove (and free) record 'i', keeping order
+ ****************************************************************************/
+void neardal_record_prv_remove_at(RcdArray *array, guint i);
+
+/*****************************************************************************
+ * neardal_record_prv_clear: free all records and the array storage
+ ****************************************************************************/
+void neardal_record_prv_clear(RcdArray *array);
+
+/*****************************************************************************
+ * neardal_record_prv_next_pending: index of the first record not notified
+ * from index 'from' (whole notified words skipped), array->len if none
+ ****************************************************************************/
+guint neardal_record_prv_next_pending(RcdArray *array, guint from);
+
+/*****************************************************************************
+ * neardal_record_prv_set_notified: mark record 'i' as notified
+ ****************************************************************************/
+void neardal_record_prv_set_notified(RcdArray *array, guint i);
+
+/*****************************************************************************
+ * neardal_record_prv_notify: invoke 'record found' for record 'i' of a tag
+ ****************************************************************************/
+void neardal_record_prv_notify(RcdArray *array, guint i);
+
 #endif /* NEARDAL_RECORD_H */
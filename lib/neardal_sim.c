@@ -0,0 +1,886 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+#include <glib.h>
+
+#include "neardal.h"
+#include "neardal_sim.h"
+#include "neardal_prv.h"
+#include "neardal_ndef_prv.h"
+
+#define	SIM_IFACE_TAG		"org.neard.Tag"
+#define	SIM_IFACE_RECORD	"org.neard.Record"
+#define	SIM_IFACE_DEVICE	"org.neard.Device"
+
+/*****************************************************************************
+ * neardal_sim_prv_create: nothing to connect to, adapters are added by the
+ * application
+ ****************************************************************************/
+static errorCode_t neardal_sim_prv_create(void)
+{
+	neardalMgr.constructed = TRUE;
+	return NEARDAL_SUCCESS;
+}
+
+static void neardal_sim_prv_destroy(void)
+{
+	neardal_capture_prv_replay_clear();
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_adp_init: default adapter properties
+ ****************************************************************************/
+static errorCode_t neardal_sim_prv_adp_init(AdpProp *adpProp)
+{
+	adpProp->mode		= g_intern_static_string(ADP_MODE_IDLE);
+	adpProp->powered	= TRUE;
+	adpProp->polling	= FALSE;
+
+	return NEARDAL_SUCCESS;
+}
+
+static void neardal_sim_prv_adp_free(AdpProp *adpProp)
+{
+	(void) adpProp; /* remove warning */
+}
+
+static void neardal_sim_prv_tag_free(TagProp *tagProp)
+{
+	if (tagProp->ndef != NULL)
+		g_variant_unref(tagProp->ndef);
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_set_ndef: NDEF message now on the tag ('ay', NULL if
+ * unknown)
+ ****************************************************************************/
+static void neardal_sim_prv_set_ndef(TagProp *tagProp, GVariant *ndef)
+{
+	if (ndef != NULL)
+		g_variant_ref_sink(ndef);
+	if (tagProp->ndef != NULL)
+		g_variant_unref(tagProp->ndef);
+	tagProp->ndef = ndef;
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_replayed: answer a call on 'path' with its next captured
+ * reply, if a replayed capture has one left (see neardal_replay())
+ ****************************************************************************/
+static gboolean neardal_sim_prv_replayed(neardalCaptureEvent event,
+					 const gchar *path, errorCode_t *err)
+{
+	GVariant	*reply;
+
+	reply = neardal_capture_prv_reply(event, path);
+	if (reply == NULL)
+		return FALSE;
+
+	*err = g_variant_get_int32(reply);
+	g_variant_unref(reply);
+
+	return TRUE;
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_notify_adp: invoke client callback for 'adapter property
+ * changed'
+ ****************************************************************************/
+static void neardal_sim_prv_notify_adp(AdpProp *adpProp, const gchar *key,
+				       void *value)
+{
+	if (neardalMgr.cb.adp_prop_changed == NULL)
+		return;
+
+	NEARDAL_PROBE_CB_DISPATCH("adp_prop_changed", adpProp->name);
+	(neardalMgr.cb.adp_prop_changed)(adpProp->name, (char *) key, value,
+					 neardalMgr.cb.adp_prop_changed_ud);
+	NEARDAL_PROBE_CB_RETURN("adp_prop_changed", adpProp->name);
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_adp_set: only 'Powered' is writable
+ ****************************************************************************/
+static errorCode_t neardal_sim_prv_adp_set(AdpProp *adpProp,
+					   const gchar *key, GVariant *value)
+{
+	errorCode_t	err;
+
+	if (neardal_sim_prv_replayed(NEARDAL_CAPTURE_ADP_SET, adpProp->name,
+				     &err))
+		return err;
+
+	if (strcmp(key, "Powered") != 0 ||
+	    !g_variant_is_of_type(value, G_VARIANT_TYPE_BOOLEAN))
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	adpProp->powered = g_variant_get_boolean(value);
+	neardal_sim_prv_notify_adp(adpProp, key,
+				   GINT_TO_POINTER(adpProp->powered));
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_adp_poll: start ('mode' != NULL) or stop polling
+ ****************************************************************************/
+static errorCode_t neardal_sim_prv_adp_poll(AdpProp *adpProp,
+					    const gchar *mode)
+{
+	errorCode_t	err;
+
+	if (neardal_sim_prv_replayed(NEARDAL_CAPTURE_ADP_POLL, adpProp->name,
+				     &err))
+		return err;
+
+	if (mode != NULL && !adpProp->powered)
+		return NEARDAL_ERROR_DBUS_INVOKE_METHOD_ERROR;
+
+	adpProp->mode = g_intern_string(mode != NULL ? mode : ADP_MODE_IDLE);
+	adpProp->polling = (mode != NULL);
+
+	neardal_sim_prv_notify_adp(adpProp, "Mode", (gpointer) adpProp->mode);
+	neardal_sim_prv_notify_adp(adpProp, "Polling",
+				   GUINT_TO_POINTER(adpProp->polling));
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_emit_added: report a new object, as neard would do with
+ * ObjectManager 'InterfacesAdded'
+ ****************************************************************************/
+static void neardal_sim_prv_emit_added(const gchar *path, const gchar *iface,
+				       GVariant *props)
+{
+	GVariantBuilder	b;
+	GVariant	*interfaces;
+
+	g_variant_builder_init(&b, G_VARIANT_TYPE("a{sa{sv}}"));
+	g_variant_builder_add(&b, "{s@a{sv}}", iface, props);
+	interfaces = g_variant_ref_sink(g_variant_builder_end(&b));
+
+	neardal_mgr_interfaces_added(NULL, path, interfaces);
+
+	g_variant_unref(interfaces);
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_emit_removed: report a removed object, as neard would do
+ * with ObjectManager 'InterfacesRemoved'
+ ****************************************************************************/
+static void neardal_sim_prv_emit_removed(const gchar *path,
+					 const gchar *iface)
+{
+	const gchar *interfaces[] = { iface, NULL };
+
+	neardal_mgr_interfaces_removed(NULL, path, interfaces);
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_remove_records: remove records of a tag or device, last
+ * first (a tag's array shrinks as they are removed)
+ ****************************************************************************/
+static void neardal_sim_prv_remove_records(RcdArray *rcds)
+{
+	gchar	*name;
+	guint	i;
+
+	for (i = rcds->len; i-- > 0;) {
+		name = g_strdup(rcds->rcds[i].name);
+		neardal_sim_prv_emit_removed(name, SIM_IFACE_RECORD);
+		g_free(name);
+	}
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_tag_write_raw: a written NDEF message replaces the tag's
+ * records, one record per top level NDEF record
+ ****************************************************************************/
+static errorCode_t neardal_sim_prv_tag_write_raw(TagProp *tagProp,
+						 GVariant *ndef)
+{
+	neardal_ndef_iter	iter;
+	neardal_ndef_record	rcd;
+	const guint8		*data;
+	gsize			len;
+	errorCode_t		err;
+	guint			i;
+	gchar			*path;
+
+	data = g_variant_get_fixed_array(ndef, &len, sizeof(guint8));
+
+	/* Whole message checked first, as neard would */
+	neardal_ndef_iter_init(&iter, data, len);
+	while ((err = neardal_ndef_iter_next(&iter, &rcd)) == NEARDAL_SUCCESS)
+		;
+	if (err != NEARDAL_ERROR_NO_RECORD || len == 0)
+		return NEARDAL_ERROR_DBUS;
+
+	neardal_sim_prv_remove_records(&tagProp->rcds);
+
+	neardal_ndef_iter_init(&iter, data, len);
+	for (i = 0; neardal_ndef_iter_next(&iter, &rcd) == NEARDAL_SUCCESS;
+	     i++) {
+		path = g_strdup_printf("%s/record%u", tagProp->name, i);
+		neardal_sim_prv_emit_added(path, SIM_IFACE_RECORD,
+					neardal_ndef_prv_record_props(&rcd));
+		g_free(path);
+	}
+	neardal_sim_prv_set_ndef(tagProp, ndef);
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_encode_record: append a record, from its neard properties
+ * (Text, URI, SmartPoster and MIME records, the latter without payload: not
+ * a neard record property)
+ ****************************************************************************/
+static void neardal_sim_prv_encode_record(neardal_ndef_builder *builder,
+					  GVariant *props)
+{
+	neardal_ndef_builder	*sp;
+	const gchar		*type = NULL, *lang = "en", *text = NULL;
+	const gchar		*uri = "", *mime = NULL;
+
+	g_variant_lookup(props, "Type", "&s", &type);
+	g_variant_lookup(props, "Language", "&s", &lang);
+	g_variant_lookup(props, "Representation", "&s", &text);
+	g_variant_lookup(props, "URI", "&s", &uri);
+	g_variant_lookup(props, "MIME", "&s", &mime);
+	if (type == NULL)
+		return;
+
+	if (!strcmp(type, "Text"))
+		neardal_ndef_add_text(builder, lang, text ? text : "");
+	else if (!strcmp(type, "URI"))
+		neardal_ndef_add_uri(builder, uri);
+	else if (!strcmp(type, "SmartPoster") &&
+		 neardal_ndef_builder_new(&sp) == NEARDAL_SUCCESS) {
+		neardal_ndef_add_uri(sp, uri);
+		if (text != NULL)
+			neardal_ndef_add_text(sp, lang, text);
+		neardal_ndef_add_smart_poster(builder, sp);
+		neardal_ndef_builder_free(sp);
+	} else if (!strcmp(type, "MIME") && mime != NULL)
+		neardal_ndef_add_mime(builder, mime, NULL, 0);
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_encode: NDEF message ('ay', floating) of records given by
+ * their neard properties
+ ****************************************************************************/
+static GVariant *neardal_sim_prv_encode(GVariant **props, guint nbProps)
+{
+	neardal_ndef_builder	*builder;
+	const unsigned char	*data;
+	unsigned int		len;
+	GVariant		*ndef;
+	guint			i;
+
+	if (neardal_ndef_builder_new(&builder) != NEARDAL_SUCCESS)
+		return NULL;
+
+	for (i = 0; i < nbProps; i++)
+		if (props[i] != NULL)
+			neardal_sim_prv_encode_record(builder, props[i]);
+
+	neardal_ndef_builder_get(builder, &data, &len);
+	ndef = neardal_tools_prv_bytes(data, len);
+	neardal_ndef_builder_free(builder);
+
+	return ndef;
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_tag_write: the written record replaces the tag's ones
+ ****************************************************************************/
+static errorCode_t neardal_sim_prv_tag_write(TagProp *tagProp,
+					     GVariant *record)
+{
+	GVariantBuilder	b;
+	GVariantIter	iter;
+	const gchar	*key;
+	GVariant	*value, *props;
+	gchar		*path;
+	const gchar	*type = NULL;
+	errorCode_t	err;
+
+	g_variant_ref_sink(record);
+
+	if (neardal_sim_prv_replayed(NEARDAL_CAPTURE_TAG_WRITE, tagProp->name,
+				     &err)) {
+		g_variant_unref(record);
+		return err;
+	}
+
+	if (tagProp->readOnly) {
+		g_variant_unref(record);
+		return NEARDAL_ERROR_DBUS;
+	}
+
+	if (g_variant_lookup(record, "Type", "&s", &type) &&
+	    !strcmp(type, "Raw")) {
+		value = g_variant_lookup_value(record, "NDEF",
+					       G_VARIANT_TYPE_BYTESTRING);
+		err = NEARDAL_ERROR_DBUS;
+		if (value != NULL) {
+			err = neardal_sim_prv_tag_write_raw(tagProp, value);
+			g_variant_unref(value);
+		}
+		g_variant_unref(record);
+		return err;
+	}
+
+	/* Record 'Name' is the tag being written, not a record property */
+	g_variant_builder_init(&b, G_VARIANT_TYPE("a{sv}"));
+	g_variant_iter_init(&iter, record);
+	while (g_variant_iter_next(&iter, "{&sv}", &key, &value)) {
+		if (strcmp(key, "Name") != 0)
+			g_variant_builder_add(&b, "{sv}", key, value);
+		g_variant_unref(value);
+	}
+	g_variant_unref(record);
+	props = g_variant_ref_sink(g_variant_builder_end(&b));
+
+	neardal_sim_prv_remove_records(&tagProp->rcds);
+
+	path = g_strdup_printf("%s/record0", tagProp->name);
+	neardal_sim_prv_emit_added(path, SIM_IFACE_RECORD, props);
+	g_free(path);
+
+	/* Encoded once, as neard would write it */
+	neardal_sim_prv_set_ndef(tagProp, neardal_sim_prv_encode(&props, 1));
+	g_variant_unref(props);
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_tag_get_raw_ndef: copy of the message last written, or the
+ * tag's records encoded if it was never written
+ ****************************************************************************/
+static errorCode_t neardal_sim_prv_tag_get_raw_ndef(TagProp *tagProp,
+						    GVariant **ndef)
+{
+	GVariant	**props;
+	GVariant	*reply;
+	gconstpointer	data;
+	gsize		len;
+	guint		i;
+	gint32		err;
+
+	reply = neardal_capture_prv_reply(NEARDAL_CAPTURE_TAG_RAW_NDEF,
+					  tagProp->name);
+	if (reply != NULL) {
+		g_variant_get(reply, "(i@ay)", &err, ndef);
+		g_variant_unref(reply);
+		if (err != NEARDAL_SUCCESS) {
+			g_variant_unref(*ndef);
+			*ndef = NULL;
+		}
+		return err;
+	}
+
+	if (tagProp->ndef != NULL) {
+		data = g_variant_get_fixed_array(tagProp->ndef, &len,
+						 sizeof(guint8));
+		*ndef = g_variant_ref_sink(neardal_tools_prv_bytes(data, len));
+		return NEARDAL_SUCCESS;
+	}
+
+	props = g_new0(GVariant *, tagProp->rcds.len + 1);
+	for (i = 0; i < tagProp->rcds.len; i++)
+		props[i] = neardal_data_search(tagProp->rcds.rcds[i].name);
+	*ndef = neardal_sim_prv_encode(props, tagProp->rcds.len);
+	g_free(props);
+	if (*ndef == NULL)
+		return NEARDAL_ERROR_NO_MEMORY;
+	g_variant_ref_sink(*ndef);
+
+	return NEARDAL_SUCCESS;
+}
+
+static void neardal_sim_prv_tag_get_raw_ndef_async(TagProp *tagProp,
+						   neardalRawNdefDone done,
+						   gpointer data)
+{
+	GVariant	*ndef	= NULL;
+	errorCode_t	err;
+
+	err = neardal_sim_prv_tag_get_raw_ndef(tagProp, &ndef);
+	done(err, ndef, data);
+}
+
+/* Simulated asynchronous write */
+typedef struct {
+	gchar			*tagName;
+	GVariant		*record;
+	neardalWriteDone	done;
+	gpointer		data;
+} neardalSimWrite;
+
+static gboolean neardal_sim_prv_tag_write_idle(gpointer user_data)
+{
+	neardalSimWrite	*write = user_data;
+	TagProp		*tagProp;
+	errorCode_t	err = NEARDAL_ERROR_NO_TAG;
+
+	tagProp = neardal_mgr_tag_search(write->tagName);
+	if (tagProp != NULL)
+		err = neardal_sim_prv_tag_write(tagProp, write->record);
+	write->done(err, write->data);
+
+	g_variant_unref(write->record);
+	g_free(write->tagName);
+	g_free(write);
+
+	return FALSE;
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_tag_write_async: the write completes from the main loop,
+ * as a DBus reply would (not from within the caller, e.g. while the tag is
+ * being added)
+ ****************************************************************************/
+static void neardal_sim_prv_tag_write_async(TagProp *tagProp,
+					    GVariant *record,
+					    neardalWriteDone done,
+					    gpointer data)
+{
+	neardalSimWrite *write = g_new0(neardalSimWrite, 1);
+
+	write->tagName = g_strdup(tagProp->name);
+	write->record = g_variant_ref_sink(record);
+	write->done = done;
+	write->data = data;
+	g_idle_add(neardal_sim_prv_tag_write_idle, write);
+}
+
+static errorCode_t neardal_sim_prv_dev_push(const gchar *devName,
+					    GVariant *record)
+{
+	errorCode_t	err = NEARDAL_SUCCESS;
+
+	g_variant_unref(g_variant_ref_sink(record));
+	neardal_sim_prv_replayed(NEARDAL_CAPTURE_DEV_PUSH, devName, &err);
+
+	return err;
+}
+
+/* In-process simulator */
+const neardalMgrBackend neardal_mgr_sim_backend = {
+	.name		= "sim",
+	.create		= neardal_sim_prv_create,
+	.destroy	= neardal_sim_prv_destroy,
+	.adp_init	= neardal_sim_prv_adp_init,
+	.adp_free	= neardal_sim_prv_adp_free,
+	.tag_init	= neardal_tag_prv_read_properties,
+	.tag_free	= neardal_sim_prv_tag_free,
+	.adp_set	= neardal_sim_prv_adp_set,
+	.adp_poll	= neardal_sim_prv_adp_poll,
+	.tag_write	= neardal_sim_prv_tag_write,
+	.tag_write_async = neardal_sim_prv_tag_write_async,
+	.tag_get_raw_ndef = neardal_sim_prv_tag_get_raw_ndef,
+	.tag_get_raw_ndef_async = neardal_sim_prv_tag_get_raw_ndef_async,
+	.dev_push	= neardal_sim_prv_dev_push
+};
+
+/*****************************************************************************
+ * neardal_sim_prv_check: the simulator must be selected, NEARDAL
+ * constructed on it, and 'path' a valid object path
+ ****************************************************************************/
+static errorCode_t neardal_sim_prv_check(const char *path)
+{
+	errorCode_t	err = NEARDAL_SUCCESS;
+
+	if (neardalMgr.backend != &neardal_mgr_sim_backend)
+		return NEARDAL_ERROR_GENERAL_ERROR;
+
+	if (path == NULL || !g_variant_is_object_path(path))
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	if (!neardalMgr.constructed)
+		neardal_prv_construct(&err);
+
+	return err;
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_get_adapter: adapter owning a tag or device
+ ****************************************************************************/
+static AdpProp *neardal_sim_prv_get_adapter(const char *child)
+{
+	AdpProp	*adpProp	= NULL;
+	gchar	*adpName	= neardal_dirname(child);
+
+	if (adpName != NULL)
+		neardal_mgr_prv_get_adapter(adpName, &adpProp);
+	g_free(adpName);
+
+	return adpProp;
+}
+
+/*****************************************************************************
+ * neardal_sim_prv_tags_changed: report a new adapter 'Tags' property, as neard
+ * would do with 'PropertiesChanged'
+ ****************************************************************************/
+static void neardal_sim_prv_tags_changed(AdpProp *adpProp,
+					 const gchar *const *tags)
+{
+	GVariantBuilder	b;
+	GVariant	*changed;
+
+	g_variant_builder_init(&b, G_VARIANT_TYPE("a{sv}"));
+	g_variant_builder_add(&b, "{sv}", "Tags",
+			      g_variant_new_objv(tags, -1));
+	changed = g_variant_ref_sink(g_variant_builder_end(&b));
+
+	neardal_adp_prv_properties_changed(adpProp, changed);
+
+	g_variant_unref(changed);
+}
+
+/*****************************************************************************
+ * neardal_sim_enable: select the simulator or the DBus backend
+ ****************************************************************************/
+errorCode_t neardal_sim_enable(int enable)
+{
+	const neardalMgrBackend *backend;
+
+	backend = enable ? &neardal_mgr_sim_backend : &neardal_mgr_dbus_backend;
+
+	if (neardalMgr.constructed && neardalMgr.backend != backend)
+		return NEARDAL_ERROR_GENERAL_ERROR;
+
+	neardalMgr.backend = backend;
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_sim_add_adapter: add a simulated adapter
+ ****************************************************************************/
+errorCode_t neardal_sim_add_adapter(const char *adpName)
+{
+	errorCode_t	err;
+
+	err = neardal_sim_prv_check(adpName);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	if (neardal_mgr_prv_get_adapter((gchar *) adpName, NULL)
+			== NEARDAL_SUCCESS)
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	return neardal_adp_add((gchar *) adpName);
+}
+
+/*****************************************************************************
+ * neardal_sim_remove_adapter: remove a simulated adapter, its tags and
+ * devices
+ ****************************************************************************/
+errorCode_t neardal_sim_remove_adapter(const char *adpName)
+{
+	errorCode_t	err;
+	AdpProp		*adpProp = NULL;
+	TagProp		*tagProp;
+	DevProp		*devProp;
+
+	err = neardal_sim_prv_check(adpName);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	err = neardal_mgr_prv_get_adapter((gchar *) adpName, &adpProp);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	while (adpProp->tagList != NULL) {
+		tagProp = adpProp->tagList->data;
+		neardal_sim_remove_tag(tagProp->name);
+	}
+	while (adpProp->devList != NULL) {
+		devProp = adpProp->devList->data;
+		neardal_sim_remove_device(devProp->name);
+	}
+
+	/* Invoke client cb 'adapter removed' */
+	if (neardalMgr.cb.adp_removed != NULL) {
+		NEARDAL_PROBE_CB_DISPATCH("adp_removed", adpProp->name);
+		(neardalMgr.cb.adp_removed)(adpProp->name,
+					    neardalMgr.cb.adp_removed_ud);
+		NEARDAL_PROBE_CB_RETURN("adp_removed", adpProp->name);
+	}
+
+	return neardal_adp_remove(adpProp);
+}
+
+/*****************************************************************************
+ * neardal_sim_add_tag: make a tag appear on its adapter
+ ****************************************************************************/
+errorCode_t neardal_sim_add_tag(const char *tagName, const char *type,
+				int readOnly)
+{
+	errorCode_t	err;
+	AdpProp		*adpProp;
+	GVariantBuilder	b;
+
+	err = neardal_sim_prv_check(tagName);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	adpProp = neardal_sim_prv_get_adapter(tagName);
+	if (adpProp == NULL)
+		return NEARDAL_ERROR_NO_ADAPTER;
+
+	if (neardal_data_search(tagName) != NULL)
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	g_variant_builder_init(&b, G_VARIANT_TYPE("a{sv}"));
+	if (type != NULL)
+		g_variant_builder_add(&b, "{sv}", "Type",
+				      g_variant_new_string(type));
+	g_variant_builder_add(&b, "{sv}", "ReadOnly",
+			      g_variant_new_boolean(readOnly != 0));
+	g_variant_builder_add(&b, "{sv}", "Adapter",
+			      g_variant_new_object_path(adpProp->name));
+
+	neardal_sim_prv_emit_added(tagName, SIM_IFACE_TAG,
+				   g_variant_builder_end(&b));
+
+	return neardal_mgr_tag_search(tagName) != NULL ? NEARDAL_SUCCESS :
+							 NEARDAL_ERROR_NO_TAG;
+}
+
+/*****************************************************************************
+ * neardal_sim_add_record: add a record to a simulated tag or device
+ ****************************************************************************/
+errorCode_t neardal_sim_add_record(const neardal_record *record)
+{
+	errorCode_t	err;
+	neardal_record	props;
+	AdpProp		*adpProp;
+	TagProp		*tagProp;
+	DevProp		*devProp = NULL;
+	RcdProp		*rcdProp;
+	gchar		*parent;
+
+	if (record == NULL)
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	err = neardal_sim_prv_check(record->name);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	adpProp = neardal_sim_prv_get_adapter(record->name);
+	if (adpProp == NULL)
+		return NEARDAL_ERROR_NO_ADAPTER;
+
+	if (neardal_data_search(record->name) != NULL)
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	/* The record path is the object path, not a record property */
+	props = *record;
+	props.name = NULL;
+
+	neardal_sim_prv_emit_added(record->name, SIM_IFACE_RECORD,
+				   neardal_record_to_g_variant(&props));
+
+	/* Message written before: no longer the tag's one */
+	parent = neardal_dirname(record->name);
+	tagProp = parent ? neardal_mgr_tag_search(parent) : NULL;
+	if (tagProp != NULL)
+		neardal_sim_prv_set_ndef(tagProp, NULL);
+	else if (parent != NULL &&
+		 neardal_adp_prv_get_dev(adpProp, parent, &devProp) ==
+		 NEARDAL_SUCCESS &&
+		 (rcdProp = neardal_record_prv_append(&devProp->rcds)) != NULL) {
+		/* Kept for the device removal, already reported */
+		rcdProp->name = neardal_pool_prv_strdup(record->name);
+		neardal_record_prv_set_notified(&devProp->rcds,
+						devProp->rcds.len - 1);
+	}
+	g_free(parent);
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_sim_remove_tag: make a tag disappear, with its records
+ ****************************************************************************/
+errorCode_t neardal_sim_remove_tag(const char *tagName)
+{
+	errorCode_t	err;
+	TagProp		*tagProp;
+	gchar		*name;
+
+	err = neardal_sim_prv_check(tagName);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	tagProp = neardal_mgr_tag_search(tagName);
+	if (tagProp == NULL)
+		return NEARDAL_ERROR_NO_TAG;
+
+	/* 'tagName' may belong to the tag being removed */
+	name = g_strdup(tagName);
+	neardal_sim_prv_remove_records(&tagProp->rcds);
+	neardal_sim_prv_emit_removed(name, SIM_IFACE_TAG);
+	g_free(name);
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_sim_set_tags: replace the tags of an adapter through its 'Tags'
+ * property
+ ****************************************************************************/
+errorCode_t neardal_sim_set_tags(const char *adpName, const char **tags)
+{
+	errorCode_t	err;
+	AdpProp		*adpProp = NULL;
+	static const gchar *none[] = { NULL };
+	GHashTable	*next;
+	GPtrArray	*dropped;
+	GVariantBuilder	b;
+	GVariant	*props;
+	GList		*node;
+	TagProp		*tagProp;
+	guint		i;
+
+	err = neardal_sim_prv_check(adpName);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	err = neardal_mgr_prv_get_adapter((gchar *) adpName, &adpProp);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	if (tags == NULL)
+		tags = none;
+	for (i = 0; tags[i] != NULL; i++)
+		if (!g_variant_is_object_path(tags[i]) ||
+		    neardal_sim_prv_get_adapter(tags[i]) != adpProp)
+			return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	/* New tags properties, as neard 'InterfacesAdded' would bring them */
+	next = g_hash_table_new(g_str_hash, g_str_equal);
+	for (i = 0; tags[i] != NULL; i++) {
+		g_hash_table_insert(next, (gpointer) tags[i],
+				    (gpointer) tags[i]);
+		if (neardal_data_search(tags[i]) != NULL)
+			continue;
+
+		g_variant_builder_init(&b, G_VARIANT_TYPE("a{sv}"));
+		g_variant_builder_add(&b, "{sv}", "ReadOnly",
+				      g_variant_new_boolean(FALSE));
+		g_variant_builder_add(&b, "{sv}", "Adapter",
+				      g_variant_new_object_path(adpName));
+		props = g_variant_ref_sink(g_variant_builder_end(&b));
+		g_datalist_set_data_full(&(neardalMgr.dbus_data), tags[i],
+					 props,
+					 (GDestroyNotify) g_variant_unref);
+	}
+
+	dropped = g_ptr_array_new_with_free_func(g_free);
+	for (node = adpProp->tagList; node != NULL; node = node->next) {
+		tagProp = node->data;
+		if (g_hash_table_lookup(next, tagProp->name) != NULL)
+			continue;
+		g_ptr_array_add(dropped, g_strdup(tagProp->name));
+		neardal_sim_prv_remove_records(&tagProp->rcds);
+	}
+	g_hash_table_destroy(next);
+
+	neardal_sim_prv_tags_changed(adpProp, (const gchar *const *) tags);
+
+	for (i = 0; i < dropped->len; i++)
+		g_datalist_remove_data(&(neardalMgr.dbus_data),
+				       g_ptr_array_index(dropped, i));
+	g_ptr_array_free(dropped, TRUE);
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_sim_add_device: make a device appear on its adapter
+ ****************************************************************************/
+errorCode_t neardal_sim_add_device(const char *devName)
+{
+	errorCode_t	err;
+	AdpProp		*adpProp;
+	DevProp		*devProp = NULL;
+	GVariantBuilder	b;
+
+	err = neardal_sim_prv_check(devName);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	adpProp = neardal_sim_prv_get_adapter(devName);
+	if (adpProp == NULL)
+		return NEARDAL_ERROR_NO_ADAPTER;
+
+	if (neardal_adp_prv_get_dev(adpProp, (gchar *) devName, &devProp)
+			== NEARDAL_SUCCESS)
+		return NEARDAL_ERROR_INVALID_PARAMETER;
+
+	g_variant_builder_init(&b, G_VARIANT_TYPE("a{sv}"));
+	g_variant_builder_add(&b, "{sv}", "Adapter",
+			      g_variant_new_object_path(adpProp->name));
+
+	neardal_sim_prv_emit_added(devName, SIM_IFACE_DEVICE,
+				   g_variant_builder_end(&b));
+
+	return NEARDAL_SUCCESS;
+}
+
+/*****************************************************************************
+ * neardal_sim_remove_device: make a device disappear
+ ****************************************************************************/
+errorCode_t neardal_sim_remove_device(const char *devName)
+{
+	errorCode_t	err;
+	AdpProp		*adpProp;
+	DevProp		*devProp = NULL;
+	gchar		*name;
+
+	err = neardal_sim_prv_check(devName);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	adpProp = neardal_sim_prv_get_adapter(devName);
+	if (adpProp == NULL)
+		return NEARDAL_ERROR_NO_ADAPTER;
+
+	err = neardal_adp_prv_get_dev(adpProp, (gchar *) devName, &devProp);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	/* 'devName' may belong to the device being removed */
+	name = g_strdup(devName);
+	neardal_sim_prv_remove_records(&devProp->rcds);
+	neardal_sim_prv_emit_removed(name, SIM_IFACE_DEVICE);
+	g_free(name);
+
+	return NEARDAL_SUCCESS;
+}
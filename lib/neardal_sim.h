@@ -0,0 +1,132 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+/*!
+ * @file neardal_sim.h
+ *
+ * @brief In-process neard simulator: NEARDAL without DBus nor neard.
+ *
+ * Once enabled (before any other NEARDAL call), adapters, tags, records and
+ * devices are created by the application itself and reported through the
+ * usual NEARDAL callbacks, going through the same code as objects announced
+ * by neard. Writes and pushes complete immediately, except the asynchronous
+ * writes (personalisation, automatic and verified writes), completed from the
+ * main loop. Raw NDEF reads return the message last written to the tag as
+ * is; for records added with neardal_sim_add_record() instead, Text, URI,
+ * SmartPoster and MIME (without payload) records are encoded from their
+ * properties. NDEF and handover agents are not available.
+ *
+ ******************************************************************************/
+
+#ifndef NEARDAL_SIM_H
+#define NEARDAL_SIM_H
+#include "neardal.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif	/* __cplusplus */
+
+/*! \fn errorCode_t neardal_sim_enable(int enable)
+ * @brief Select the simulator (enable != 0) or neard over DBus (default).
+ * Must be called before NEARDAL is used or after neardal_destroy().
+ *
+ * @param enable use the simulator if non zero
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_sim_enable(int enable);
+
+/*! \fn errorCode_t neardal_sim_add_adapter(const char *adpName)
+ * @brief Add a simulated adapter (powered, not polling)
+ *
+ * @param adpName adapter DBus path, e.g. "/org/neard/nfc0"
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_sim_add_adapter(const char *adpName);
+
+/*! \fn errorCode_t neardal_sim_remove_adapter(const char *adpName)
+ * @brief Remove a simulated adapter, with its tags and devices
+ *
+ * @param adpName adapter DBus path
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_sim_remove_adapter(const char *adpName);
+
+/*! \fn errorCode_t neardal_sim_add_tag(const char *tagName, const char *type,
+ *				       int readOnly)
+ * @brief Make a tag appear on its adapter ('tag found')
+ *
+ * @param tagName tag DBus path, child of an adapter, e.g.
+ * "/org/neard/nfc0/tag0"
+ * @param type tag type ("Type 2"...), may be NULL
+ * @param readOnly tag read only flag
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_sim_add_tag(const char *tagName, const char *type,
+				int readOnly);
+
+/*! \fn errorCode_t neardal_sim_add_record(const neardal_record *record)
+ * @brief Add a record to a simulated tag or device ('record found')
+ *
+ * @param record record to add, record->name being the record DBus path,
+ * child of a tag or device (e.g. "/org/neard/nfc0/tag0/record0")
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_sim_add_record(const neardal_record *record);
+
+/*! \fn errorCode_t neardal_sim_remove_tag(const char *tagName)
+ * @brief Make a tag disappear, with its records ('tag lost')
+ *
+ * @param tagName tag DBus path
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_sim_remove_tag(const char *tagName);
+
+/*! \fn errorCode_t neardal_sim_set_tags(const char *adpName,
+ *					  const char **tags)
+ * @brief Replace the tags of an adapter at once, through its 'Tags' property
+ * (tags found and lost accordingly, without records)
+ *
+ * @param adpName adapter DBus path
+ * @param tags NULL terminated array of tag DBus paths, children of the
+ * adapter (NULL: no tag)
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_sim_set_tags(const char *adpName, const char **tags);
+
+/*! \fn errorCode_t neardal_sim_add_device(const char *devName)
+ * @brief Make a device appear on its adapter ('device found')
+ *
+ * @param devName device DBus path, child of an adapter
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_sim_add_device(const char *devName);
+
+/*! \fn errorCode_t neardal_sim_remove_device(const char *devName)
+ * @brief Make a device disappear ('device lost')
+ *
+ * @param devName device DBus path
+ * @return errorCode_t error code
+ **/
+errorCode_t neardal_sim_remove_device(const char *devName);
+
+#ifdef __cplusplus
+}
+#endif	/* __cplusplus */
+
+#endif /* NEARDAL_SIM_H */
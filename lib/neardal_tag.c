@@ -50,7 +50,7 @@ static void neardal_tag_prv_cb_property_changed(OrgNeardTag *proxy,
 
 	NEARDAL_TRACEF("str0='%s'\n", arg_unnamed_arg0);
 	NEARDAL_TRACEF("arg_unnamed_arg1=%s (%s)\n",
-		       g_variant_print (arg_unnamed_arg1, TRUE),
+		       neardal_trace_prv_variant(arg_unnamed_arg1),
 		       g_variant_get_type_string(arg_unnamed_arg1));
 
 
@@ -63,9 +63,10 @@ static void neardal_tag_prv_cb_property_changed(OrgNeardTag *proxy,
 }
 
 /*****************************************************************************
- * neardal_tag_prv_read_properties: Get Neard Tag Properties
+ * neardal_tag_prv_read_properties: Get Neard Tag Properties (from the
+ * 'interfaces added' dictionary stored in neardalMgr.dbus_data)
  ****************************************************************************/
-static errorCode_t neardal_tag_prv_read_properties(TagProp *tagProp)
+errorCode_t neardal_tag_prv_read_properties(TagProp *tagProp)
 {
 	errorCode_t	err		= NEARDAL_SUCCESS;
 	GVariant	*tmp		= NULL;
@@ -74,8 +75,6 @@ static errorCode_t neardal_tag_prv_read_properties(TagProp *tagProp)
 
 	NEARDAL_TRACEIN();
 	NEARDAL_ASSERT_RET(tagProp != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
-	NEARDAL_ASSERT_RET(tagProp->proxy != NULL
-			  , NEARDAL_ERROR_GENERAL_ERROR);
 
 	tmp = g_datalist_get_data(&(neardalMgr.dbus_data), tagProp->name);
 	if (tmp == NULL) {
@@ -83,37 +82,42 @@ static errorCode_t neardal_tag_prv_read_properties(TagProp *tagProp)
 		NEARDAL_TRACE_ERR("Unable to read tag's properties\n");
 		goto exit;
 	}
-	NEARDAL_TRACEF("Reading:\n%s\n", g_variant_print(tmp, TRUE));
+	NEARDAL_TRACEF("Reading:\n%s\n", neardal_trace_prv_variant(tmp));
 
 	tmpOut = g_variant_lookup_value(tmp, "TagType", G_VARIANT_TYPE_ARRAY);
 	if (tmpOut != NULL) {
-		tagProp->tagType = g_variant_dup_strv(tmpOut, &len);
+		tagProp->tagType = neardal_tools_prv_intern_strv(tmpOut, &len);
 		tagProp->tagTypeLen = len;
 		if (len == 0) {
-			g_strfreev(tagProp->tagType);
+			g_free(tagProp->tagType);
 			tagProp->tagType = NULL;
 		}
+		g_variant_unref(tmpOut);
 	}
 
 	tmpOut = g_variant_lookup_value(tmp, "Type", G_VARIANT_TYPE_STRING);
-	if (tmpOut != NULL)
-		tagProp->type = g_variant_dup_string(tmpOut, NULL);
+	if (tmpOut != NULL) {
+		tagProp->type = g_intern_string(
+					g_variant_get_string(tmpOut, NULL));
+		g_variant_unref(tmpOut);
+	}
 
 	tmpOut = g_variant_lookup_value(tmp, "ReadOnly",
 					G_VARIANT_TYPE_BOOLEAN);
-	if (tmpOut != NULL)
+	if (tmpOut != NULL) {
 		tagProp->readOnly = g_variant_get_boolean(tmpOut);
+		g_variant_unref(tmpOut);
+	}
 
 exit:
 	return err;
 }
 
 /*****************************************************************************
- * neardal_tag_init: Get Neard Manager Properties = NFC Tags list.
- * Create a DBus proxy for the first one NFC tag if present
- * Register Neard Manager signals ('PropertyChanged')
+ * neardal_tag_prv_dbus_init: DBus backend, create a DBus proxy for the NFC
+ * tag and read its properties
  ****************************************************************************/
-static errorCode_t neardal_tag_prv_init(TagProp *tagProp)
+errorCode_t neardal_tag_prv_dbus_init(TagProp *tagProp)
 {
 	errorCode_t	err = NEARDAL_SUCCESS;
 
@@ -152,60 +156,406 @@ static errorCode_t neardal_tag_prv_init(TagProp *tagProp)
 }
 
 /*****************************************************************************
- * neardal_tag_prv_free: unref DBus proxy, disconnect Neard Tag signals
+ * neardal_tag_prv_dbus_free: DBus backend, unref DBus proxy, disconnect
+ * Neard Tag signals
  ****************************************************************************/
-static void neardal_tag_prv_free(TagProp **tagProp)
+void neardal_tag_prv_dbus_free(TagProp *tagProp)
 {
-	NEARDAL_TRACEIN();
-	if ((*tagProp)->proxy != NULL) {
-		g_signal_handlers_disconnect_by_func((*tagProp)->proxy,
+	if (tagProp->proxy != NULL) {
+		g_signal_handlers_disconnect_by_func(tagProp->proxy,
 			NEARDAL_G_CALLBACK(neardal_tag_prv_cb_property_changed),
 						     NULL);
-		g_object_unref((*tagProp)->proxy);
-		(*tagProp)->proxy = NULL;
+		g_object_unref(tagProp->proxy);
+		tagProp->proxy = NULL;
+	}
+}
+
+/*****************************************************************************
+ * neardal_tag_prv_dbus_write: DBus backend, invoke Neard Tag 'Write' method
+ ****************************************************************************/
+errorCode_t neardal_tag_prv_dbus_write(TagProp *tagProp, GVariant *record)
+{
+	GError		*gerror	= NULL;
+	errorCode_t	err	= NEARDAL_SUCCESS;
+
+	if (org_neard_tag_call_write_sync(tagProp->proxy, record, NULL,
+					  &gerror) == FALSE) {
+		NEARDAL_TRACE_ERR("Can't write record: %s\n", gerror->message);
+		g_error_free(gerror);
+		err = NEARDAL_ERROR_DBUS;
 	}
-	g_free((*tagProp)->name);
-	g_free((*tagProp)->type);
-	g_strfreev((*tagProp)->tagType);
-	g_free((*tagProp));
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_TAG_WRITE, tagProp->name,
+			g_variant_new_int32(err));
+
+	return err;
+}
+
+/* Asynchronous 'Write' in progress */
+typedef struct {
+	neardalWriteDone	done;
+	gpointer		data;
+} neardalTagWriteCall;
+
+static void neardal_tag_prv_dbus_write_cb(GObject *source, GAsyncResult *res,
+					  gpointer user_data)
+{
+	neardalTagWriteCall	*call	= user_data;
+	GError			*gerror	= NULL;
+	errorCode_t		err	= NEARDAL_SUCCESS;
+
+	if (org_neard_tag_call_write_finish(ORG_NEARD_TAG(source), res,
+					    &gerror) == FALSE) {
+		NEARDAL_TRACE_ERR("Can't write record: %s\n", gerror->message);
+		g_error_free(gerror);
+		err = NEARDAL_ERROR_DBUS;
+	}
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_TAG_WRITE,
+			g_dbus_proxy_get_object_path(G_DBUS_PROXY(source)),
+			g_variant_new_int32(err));
+
+	call->done(err, call->data);
+	g_free(call);
+}
+
+/*****************************************************************************
+ * neardal_tag_prv_dbus_write_async: DBus backend, invoke Neard Tag 'Write'
+ * method, 'done' being called from the main loop
+ ****************************************************************************/
+void neardal_tag_prv_dbus_write_async(TagProp *tagProp, GVariant *record,
+				      neardalWriteDone done, gpointer data)
+{
+	neardalTagWriteCall *call = g_new0(neardalTagWriteCall, 1);
+
+	call->done = done;
+	call->data = data;
+	org_neard_tag_call_write(tagProp->proxy, record, NULL,
+				 neardal_tag_prv_dbus_write_cb, call);
+}
+
+/*****************************************************************************
+ * neardal_tag_prv_free: release backend resources and tag datas
+ ****************************************************************************/
+static void neardal_tag_prv_free(TagProp **tagProp)
+{
+	NEARDAL_TRACEIN();
+	neardalMgr.backend->tag_free(*tagProp);
+	neardal_record_prv_clear(&(*tagProp)->rcds);
+	neardal_pool_prv_strfree((*tagProp)->name);
+	g_free((*tagProp)->tagType);
+	neardal_pool_prv_free(NEARDAL_POOL_TAG, *tagProp);
 	(*tagProp) = NULL;
 }
 
+/*****************************************************************************
+ * neardal_tag_prv_raw_ndef_reply: captured 'GetRawNDEF' reply (no bytes on
+ * error)
+ ****************************************************************************/
+static GVariant *neardal_tag_prv_raw_ndef_reply(errorCode_t err,
+						GVariant *ndef)
+{
+	if (err != NEARDAL_SUCCESS || ndef == NULL)
+		return g_variant_new("(i@ay)", err,
+				     neardal_tools_prv_bytes(NULL, 0));
+
+	return g_variant_new("(i@ay)", err, ndef);
+}
+
+/*****************************************************************************
+ * neardal_tag_prv_dbus_get_raw_ndef: DBus backend, invoke Neard Tag
+ * 'GetRawNDEF' method
+ ****************************************************************************/
+errorCode_t neardal_tag_prv_dbus_get_raw_ndef(TagProp *tagProp,
+					      GVariant **ndef)
+{
+	GError		*gerror	= NULL;
+	errorCode_t	err	= NEARDAL_SUCCESS;
+
+	if (org_neard_tag_call_get_raw_ndef_sync(tagProp->proxy, ndef, NULL,
+						 &gerror) == FALSE) {
+		NEARDAL_TRACE_ERR("Can't read NDEF: %s\n", gerror->message);
+		g_error_free(gerror);
+		err = NEARDAL_ERROR_DBUS;
+	}
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_TAG_RAW_NDEF, tagProp->name,
+			neardal_tag_prv_raw_ndef_reply(err, *ndef));
+
+	return err;
+}
+
+/* Asynchronous 'GetRawNDEF' in progress */
+typedef struct {
+	neardalRawNdefDone	done;
+	gpointer		data;
+} neardalTagRawNdefCall;
+
+static void neardal_tag_prv_dbus_raw_ndef_cb(GObject *source,
+					     GAsyncResult *res,
+					     gpointer user_data)
+{
+	neardalTagRawNdefCall	*call	= user_data;
+	GVariant		*ndef	= NULL;
+	GError			*gerror	= NULL;
+	errorCode_t		err	= NEARDAL_SUCCESS;
+
+	if (org_neard_tag_call_get_raw_ndef_finish(ORG_NEARD_TAG(source),
+						   &ndef, res,
+						   &gerror) == FALSE) {
+		NEARDAL_TRACE_ERR("Can't read NDEF: %s\n", gerror->message);
+		g_error_free(gerror);
+		err = NEARDAL_ERROR_DBUS;
+	}
+	NEARDAL_CAPTURE(NEARDAL_CAPTURE_TAG_RAW_NDEF,
+			g_dbus_proxy_get_object_path(G_DBUS_PROXY(source)),
+			neardal_tag_prv_raw_ndef_reply(err, ndef));
+
+	call->done(err, ndef, call->data);
+	g_free(call);
+}
+
+/*****************************************************************************
+ * neardal_tag_prv_dbus_get_raw_ndef_async: DBus backend, invoke Neard Tag
+ * 'GetRawNDEF' method, 'done' being called from the main loop
+ ****************************************************************************/
+void neardal_tag_prv_dbus_get_raw_ndef_async(TagProp *tagProp,
+					     neardalRawNdefDone done,
+					     gpointer data)
+{
+	neardalTagRawNdefCall *call = g_new0(neardalTagRawNdefCall, 1);
+
+	call->done = done;
+	call->data = data;
+	org_neard_tag_call_get_raw_ndef(tagProp->proxy, NULL,
+					neardal_tag_prv_dbus_raw_ndef_cb, call);
+}
+
+/* Tag arrival hook */
+typedef struct {
+	neardalTagHook	hook;
+	gpointer	data;
+} neardalTagHookEntry;
+
+errorCode_t neardal_tag_prv_hook_add(neardalTagHook hook, gpointer data)
+{
+	neardalTagHookEntry *entry = g_try_malloc0(sizeof(neardalTagHookEntry));
+
+	if (entry == NULL)
+		return NEARDAL_ERROR_NO_MEMORY;
+
+	entry->hook = hook;
+	entry->data = data;
+	neardalMgr.tagHooks = g_slist_append(neardalMgr.tagHooks, entry);
+
+	return NEARDAL_SUCCESS;
+}
+
+void neardal_tag_prv_hook_remove(neardalTagHook hook, gpointer data)
+{
+	neardalTagHookEntry	*entry;
+	GSList			*node;
+
+	for (node = neardalMgr.tagHooks; node != NULL; node = node->next) {
+		entry = node->data;
+		if (entry->hook == hook && entry->data == data) {
+			neardalMgr.tagHooks = g_slist_delete_link(
+						neardalMgr.tagHooks, node);
+			g_free(entry);
+			return;
+		}
+	}
+}
+
+void neardal_tag_prv_run_hooks(TagProp *tagProp)
+{
+	neardalTagHookEntry	*entry;
+	GSList			*node, *next;
+
+	for (node = neardalMgr.tagHooks; node != NULL; node = next) {
+		/* A hook may remove itself */
+		next = node->next;
+		entry = node->data;
+		if (entry->hook(tagProp, entry->data))
+			return;
+	}
+}
+
+/* Automatic write in progress */
+typedef struct {
+	gchar		*tagName;
+	guint64		foundTs;
+	guint64		writeTs;
+} neardalAutoWrite;
+
+/*****************************************************************************
+ * neardal_tag_prv_auto_write_match: new tag to write automatically?
+ ****************************************************************************/
+static gboolean neardal_tag_prv_auto_write_match(TagProp *tagProp)
+{
+	const gchar	*filter = neardalMgr.autoWriteFilter;
+	gsize		len;
+
+	if (tagProp->readOnly)
+		return FALSE;
+	if (filter == NULL)
+		return TRUE;
+
+	if (*filter == '/') {
+		/* Adapter or tag name, not "/org/neard/nfc1" for "nfc10" */
+		len = strlen(filter);
+		return !strncmp(tagProp->name, filter, len) &&
+		       (tagProp->name[len] == '\0' ||
+			tagProp->name[len] == '/' || filter[len - 1] == '/');
+	}
+
+	return tagProp->type != NULL && !strcmp(tagProp->type, filter);
+}
+
+static void neardal_tag_prv_auto_write_done(errorCode_t err, gpointer data)
+{
+	neardalAutoWrite		*write	= data;
+	neardal_auto_write_result	result;
+
+	result.tagName = write->tagName;
+	result.error = err;
+	result.foundNs = write->foundTs;
+	result.writeNs = write->writeTs;
+	result.doneNs = neardal_metrics_prv_now();
+
+	neardal_metrics_prv_op(NEARDAL_STATS_OP_WRITE, write->writeTs,
+			       err != NEARDAL_SUCCESS);
+	NEARDAL_PROBE2(tag_write_done, write->tagName, err);
+
+	if (neardalMgr.cb.auto_write != NULL)
+		(neardalMgr.cb.auto_write)(&result,
+					    neardalMgr.cb.auto_write_ud);
+
+	g_free(write->tagName);
+	g_free(write);
+}
+
+/*****************************************************************************
+ * neardal_tag_prv_auto_write: tag arrival hook, write the automatic write
+ * message to a matching tag
+ ****************************************************************************/
+static gboolean neardal_tag_prv_auto_write(TagProp *tagProp, gpointer data)
+{
+	neardalAutoWrite	*write;
+
+	(void) data;
+
+	if (!neardal_tag_prv_auto_write_match(tagProp))
+		return FALSE;
+
+	write = g_new0(neardalAutoWrite, 1);
+	write->tagName = g_strdup(tagProp->name);
+	write->writeTs = neardal_metrics_prv_now();
+	write->foundTs = tagProp->ifaceAddedTs ? tagProp->ifaceAddedTs :
+						 write->writeTs;
+
+	NEARDAL_PROBE1(tag_write, tagProp->name);
+	neardalMgr.backend->tag_write_async(tagProp, neardalMgr.autoWriteRqst,
+					    neardal_tag_prv_auto_write_done,
+					    write);
+
+	return TRUE;
+}
+
+void neardal_tag_prv_auto_write_clear(void)
+{
+	if (neardalMgr.autoWriteRqst == NULL)
+		return;
+
+	neardal_tag_prv_hook_remove(neardal_tag_prv_auto_write, NULL);
+	g_variant_unref(neardalMgr.autoWriteRqst);
+	neardalMgr.autoWriteRqst = NULL;
+	g_free(neardalMgr.autoWriteFilter);
+	neardalMgr.autoWriteFilter = NULL;
+}
+
+errorCode_t neardal_set_auto_write(const char *filter,
+				   const unsigned char *ndef, unsigned int len)
+{
+	errorCode_t	err;
+	GVariant	*rqst;
+
+	NEARDAL_ASSERT_RET(ndef == NULL || len != 0,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+	NEARDAL_ASSERT_RET(filter == NULL || *filter != '\0',
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	neardal_prv_construct(&err);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	if (ndef == NULL) {
+		neardal_tag_prv_auto_write_clear();
+		return NEARDAL_SUCCESS;
+	}
+
+	/* neard 'Raw' record, encoded once for every tag */
+	rqst = g_variant_ref_sink(g_variant_new_parsed(
+				"{'Type': <'Raw'>, 'NDEF': <%@ay>}",
+				neardal_tools_prv_bytes(ndef, len)));
+
+	if (neardalMgr.autoWriteRqst == NULL) {
+		err = neardal_tag_prv_hook_add(neardal_tag_prv_auto_write,
+					       NULL);
+		if (err != NEARDAL_SUCCESS) {
+			g_variant_unref(rqst);
+			return err;
+		}
+	} else
+		g_variant_unref(neardalMgr.autoWriteRqst);
+
+	/* Writes in progress hold their own reference on the request */
+	neardalMgr.autoWriteRqst = rqst;
+	g_free(neardalMgr.autoWriteFilter);
+	neardalMgr.autoWriteFilter = g_strdup(filter);
+
+	return NEARDAL_SUCCESS;
+}
+
 /*****************************************************************************
  * neardal_tag_notify_tag_found: Invoke client callback for 'record found'
  * if present, and 'tag found' (if not already nofied)
  ****************************************************************************/
 void neardal_tag_notify_tag_found(TagProp *tagProp)
 {
-	RcdProp *rcdProp;
-	gsize	len;
+	guint	i;
 
 	NEARDAL_ASSERT(tagProp != NULL);
 
 	if (tagProp->notified == FALSE && neardalMgr.cb.tag_found != NULL) {
+		tagProp->dispatchedTs = neardal_metrics_prv_now();
+		NEARDAL_PROBE_CB_DISPATCH("tag_found", tagProp->name);
 		(neardalMgr.cb.tag_found)(tagProp->name,
 					   neardalMgr.cb.tag_found_ud);
+		NEARDAL_PROBE_CB_RETURN("tag_found", tagProp->name);
+		tagProp->returnedTs = neardal_metrics_prv_now();
 		tagProp->notified = TRUE;
+
+		neardal_metrics_prv_stage(NEARDAL_STATS_STAGE_TAG_DISPATCH,
+				tagProp->proxyReadyTs, tagProp->dispatchedTs);
+		neardal_metrics_prv_stage(NEARDAL_STATS_STAGE_TAG_CALLBACK,
+				tagProp->dispatchedTs, tagProp->returnedTs);
+		neardal_metrics_prv_stage(NEARDAL_STATS_STAGE_TAG_FOUND,
+				tagProp->ifaceAddedTs, tagProp->returnedTs);
 	}
 
-	len = 0;
-	if (neardalMgr.cb.rcd_found != NULL)
-		while (len < g_list_length(tagProp->rcdList)) {
-			rcdProp = g_list_nth_data(tagProp->rcdList, len++);
-			if (rcdProp->notified == FALSE) {
-				(neardalMgr.cb.rcd_found)(rcdProp->name,
-						neardalMgr.cb.rcd_found_ud);
-				rcdProp->notified = TRUE;
-			}
-		}
+	if (neardalMgr.cb.rcd_found == NULL)
+		return;
+
+	for (i = neardal_record_prv_next_pending(&tagProp->rcds, 0);
+	     i < tagProp->rcds.len;
+	     i = neardal_record_prv_next_pending(&tagProp->rcds, i + 1))
+		neardal_record_prv_notify(&tagProp->rcds, i);
 }
 
 errorCode_t neardal_tag_write(neardal_record *record)
 {
-	GError		*gerror	= NULL;
 	errorCode_t	err;
 	TagProp		*tag;
 	GVariant	*in;
+	guint64		start;
 
 	NEARDAL_ASSERT_RET(record != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
 
@@ -218,16 +568,383 @@ errorCode_t neardal_tag_write(neardal_record *record)
 
 	in = neardal_record_to_g_variant(record);
 
-	if (org_neard_tag_call_write_sync(tag->proxy, in, NULL, &gerror)
-			== FALSE) {
-		NEARDAL_TRACE_ERR("Can't write record: %s\n", gerror->message);
-		g_error_free(gerror);
-		err = NEARDAL_ERROR_DBUS;
-	}
+	NEARDAL_PROBE1(tag_write, tag->name);
+	start = neardal_metrics_prv_now();
+	err = neardalMgr.backend->tag_write(tag, in);
+	neardal_metrics_prv_op(NEARDAL_STATS_OP_WRITE, start,
+			       err != NEARDAL_SUCCESS);
+	NEARDAL_PROBE2(tag_write_done, tag->name, err);
 
 	return err;
 }
 
+errorCode_t neardal_tag_write_template(const char *tagName,
+				       const neardal_record_template *tmpl,
+				       const char *suffix)
+{
+	errorCode_t	err;
+	TagProp		*tag;
+	GVariant	*in;
+	guint64		start;
+
+	NEARDAL_ASSERT_RET(tagName != NULL && tmpl != NULL,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	neardal_prv_construct(&err);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	if (!(tag = neardal_mgr_tag_search(tagName)))
+		return NEARDAL_ERROR_NO_TAG;
+
+	in = neardal_record_prv_template_apply(tmpl, suffix);
+
+	NEARDAL_PROBE1(tag_write, tag->name);
+	start = neardal_metrics_prv_now();
+	err = neardalMgr.backend->tag_write(tag, in);
+	neardal_metrics_prv_op(NEARDAL_STATS_OP_WRITE, start,
+			       err != NEARDAL_SUCCESS);
+	NEARDAL_PROBE2(tag_write_done, tag->name, err);
+
+	return err;
+}
+
+errorCode_t neardal_tag_write_raw(const char *tagName,
+				  const unsigned char *ndef, unsigned int len)
+{
+	errorCode_t	err;
+	TagProp		*tag;
+	GVariant	*in;
+	guint64		start;
+
+	NEARDAL_ASSERT_RET(tagName != NULL && ndef != NULL && len != 0,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	neardal_prv_construct(&err);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	if (!(tag = neardal_mgr_tag_search(tagName)))
+		return NEARDAL_ERROR_NO_TAG;
+
+	/* neard 'Raw' record: the message is written as is */
+	in = g_variant_new_parsed("{'Type': <'Raw'>, 'NDEF': <%@ay>}",
+				  neardal_tools_prv_bytes(ndef, len));
+
+	NEARDAL_PROBE1(tag_write, tag->name);
+	start = neardal_metrics_prv_now();
+	err = neardalMgr.backend->tag_write(tag, in);
+	neardal_metrics_prv_op(NEARDAL_STATS_OP_WRITE, start,
+			       err != NEARDAL_SUCCESS);
+	NEARDAL_PROBE2(tag_write_done, tag->name, err);
+
+	return err;
+}
+
+/*****************************************************************************
+ * neardal_tag_prv_raw_ndef: client raw NDEF message, holding the 'ay' reply
+ * (consumed)
+ ****************************************************************************/
+static neardal_raw_ndef *neardal_tag_prv_raw_ndef(GVariant *ndef)
+{
+	neardal_raw_ndef	*out;
+	gsize			len;
+
+	out = g_try_malloc0(sizeof(neardal_raw_ndef));
+	if (out == NULL) {
+		g_variant_unref(ndef);
+		return NULL;
+	}
+
+	/* Backends hand over their reference */
+	if (g_variant_is_floating(ndef))
+		g_variant_ref_sink(ndef);
+	out->priv = ndef;
+	out->data = g_variant_get_fixed_array(ndef, &len, sizeof(guint8));
+	out->len = len;
+
+	return out;
+}
+
+errorCode_t neardal_tag_get_raw_ndef(const char *tagName,
+				     neardal_raw_ndef **ndef)
+{
+	errorCode_t	err;
+	TagProp		*tag;
+	GVariant	*out	= NULL;
+	guint64		start;
+
+	NEARDAL_ASSERT_RET(tagName != NULL && ndef != NULL,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	neardal_prv_construct(&err);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	if (!(tag = neardal_mgr_tag_search(tagName)))
+		return NEARDAL_ERROR_NO_TAG;
+
+	start = neardal_metrics_prv_now();
+	err = neardalMgr.backend->tag_get_raw_ndef(tag, &out);
+	neardal_metrics_prv_op(NEARDAL_STATS_OP_GET_RAW_NDEF, start,
+			       err != NEARDAL_SUCCESS);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	*ndef = neardal_tag_prv_raw_ndef(out);
+
+	return *ndef != NULL ? NEARDAL_SUCCESS : NEARDAL_ERROR_NO_MEMORY;
+}
+
+/* Client asynchronous raw NDEF read */
+typedef struct {
+	gchar		*tagName;
+	raw_ndef_cb	cb;
+	void		*user_data;
+	guint64		start;
+} neardalTagRawNdefRead;
+
+static void neardal_tag_prv_raw_ndef_done(errorCode_t err, GVariant *ndef,
+					  gpointer data)
+{
+	neardalTagRawNdefRead	*read	= data;
+	neardal_raw_ndef	*out	= NULL;
+
+	neardal_metrics_prv_op(NEARDAL_STATS_OP_GET_RAW_NDEF, read->start,
+			       err != NEARDAL_SUCCESS);
+	if (err == NEARDAL_SUCCESS) {
+		out = neardal_tag_prv_raw_ndef(ndef);
+		if (out == NULL)
+			err = NEARDAL_ERROR_NO_MEMORY;
+	}
+
+	read->cb(read->tagName, err, out, read->user_data);
+
+	g_free(read->tagName);
+	g_free(read);
+}
+
+errorCode_t neardal_tag_get_raw_ndef_async(const char *tagName,
+					   raw_ndef_cb cb, void *user_data)
+{
+	errorCode_t		err;
+	TagProp			*tag;
+	neardalTagRawNdefRead	*read;
+
+	NEARDAL_ASSERT_RET(tagName != NULL && cb != NULL,
+			   NEARDAL_ERROR_INVALID_PARAMETER);
+
+	neardal_prv_construct(&err);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	if (!(tag = neardal_mgr_tag_search(tagName)))
+		return NEARDAL_ERROR_NO_TAG;
+
+	read = g_try_malloc0(sizeof(neardalTagRawNdefRead));
+	if (read == NULL)
+		return NEARDAL_ERROR_NO_MEMORY;
+	read->tagName	= g_strdup(tagName);
+	read->cb	= cb;
+	read->user_data	= user_data;
+	read->start	= neardal_metrics_prv_now();
+
+	neardalMgr.backend->tag_get_raw_ndef_async(tag,
+					neardal_tag_prv_raw_ndef_done, read);
+
+	return NEARDAL_SUCCESS;
+}
+
+void neardal_free_raw_ndef(neardal_raw_ndef *ndef)
+{
+	if (ndef == NULL)
+		return;
+
+	g_variant_unref(ndef->priv);
+	g_free(ndef);
+}
+
+#define NEARDAL_VERIFY_RETRY_MS		20	/* read back period */
+#define NEARDAL_VERIFY_DIGEST_LEN	32	/* SHA-256 */
+
+/* Write with read back verification in progress */
+typedef struct {
+	gchar		*tagName;
+	write_verify_cb	cb;
+	gpointer	user_data;
+	gsize		len;		/* written message */
+	guint8		digest[NEARDAL_VERIFY_DIGEST_LEN];
+	guint		timeoutMs;
+	guint		reads;
+	gboolean	readOk;		/* a read succeeded: mismatch, not
+					 * timeout */
+	gboolean	lastWrong;	/* last read succeeded, message
+					 * different */
+	guint8		lastDigest[NEARDAL_VERIFY_DIGEST_LEN]; /* last read */
+	guint64		writeTs;
+	guint64		doneTs;
+	guint64		readTs;
+} neardalTagVerify;
+
+static void neardal_tag_prv_digest(const guchar *data, gsize len,
+				   guint8 *digest)
+{
+	GChecksum	*checksum = g_checksum_new(G_CHECKSUM_SHA256);
+	gsize		digestLen = NEARDAL_VERIFY_DIGEST_LEN;
+
+	g_checksum_update(checksum, data, len);
+	g_checksum_get_digest(checksum, digest, &digestLen);
+	g_checksum_free(checksum);
+}
+
+static void neardal_tag_prv_verify_report(neardalTagVerify *verify,
+					  neardal_verify_status status,
+					  errorCode_t err)
+{
+	neardal_verify_result	result;
+
+	result.tagName = verify->tagName;
+	result.status = status;
+	result.error = err;
+	result.reads = verify->reads;
+	result.writeNs = verify->writeTs;
+	result.doneNs = verify->doneTs;
+	result.verifiedNs = neardal_metrics_prv_now();
+
+	verify->cb(&result, verify->user_data);
+
+	g_free(verify->tagName);
+	g_free(verify);
+}
+
+static void neardal_tag_prv_verify_read(neardalTagVerify *verify);
+
+static gboolean neardal_tag_prv_verify_retry(gpointer data)
+{
+	neardal_tag_prv_verify_read(data);
+
+	return FALSE;
+}
+
+static void neardal_tag_prv_verify_read_done(errorCode_t err, GVariant *ndef,
+					     gpointer data)
+{
+	neardalTagVerify	*verify	= data;
+	guint8			digest[NEARDAL_VERIFY_DIGEST_LEN];
+	gconstpointer		bytes;
+	gsize			len;
+	gboolean		same	= FALSE;
+	gboolean		stale	= FALSE;
+
+	neardal_metrics_prv_op(NEARDAL_STATS_OP_GET_RAW_NDEF, verify->readTs,
+			       err != NEARDAL_SUCCESS);
+	if (err == NEARDAL_SUCCESS) {
+		verify->readOk = TRUE;
+		bytes = g_variant_get_fixed_array(ndef, &len, sizeof(guint8));
+		neardal_tag_prv_digest(bytes, len, digest);
+		same = len == verify->len &&
+		       !memcmp(digest, verify->digest, sizeof(digest));
+		/* The same different message twice in a row: it won't change */
+		stale = !same && verify->lastWrong &&
+			!memcmp(digest, verify->lastDigest, sizeof(digest));
+		memcpy(verify->lastDigest, digest, sizeof(digest));
+		g_variant_unref(ndef);
+	}
+	verify->lastWrong = err == NEARDAL_SUCCESS && !same;
+
+	if (same)
+		neardal_tag_prv_verify_report(verify, NEARDAL_VERIFY_OK,
+					      NEARDAL_SUCCESS);
+	else if (stale)
+		neardal_tag_prv_verify_report(verify, NEARDAL_VERIFY_MISMATCH,
+					      err);
+	else if (neardal_metrics_prv_now() - verify->doneTs >=
+		 (guint64) verify->timeoutMs * 1000000)
+		neardal_tag_prv_verify_report(verify, verify->readOk ?
+					      NEARDAL_VERIFY_MISMATCH :
+					      NEARDAL_VERIFY_TIMEOUT, err);
+	else
+		/* neard may not have read the tag again yet */
+		g_timeout_add(NEARDAL_VERIFY_RETRY_MS,
+			      neardal_tag_prv_verify_retry, verify);
+}
+
+/*****************************************************************************
+ * neardal_tag_prv_verify_read: read the tag NDEF message back
+ ****************************************************************************/
+static void neardal_tag_prv_verify_read(neardalTagVerify *verify)
+{
+	TagProp	*tag;
+
+	tag = neardal_mgr_tag_search(verify->tagName);
+	if (tag == NULL) {
+		neardal_tag_prv_verify_report(verify, NEARDAL_VERIFY_FAILED,
+					      NEARDAL_ERROR_NO_TAG);
+		return;
+	}
+
+	verify->reads++;
+	verify->readTs = neardal_metrics_prv_now();
+	neardalMgr.backend->tag_get_raw_ndef_async(tag,
+				neardal_tag_prv_verify_read_done, verify);
+}
+
+static void neardal_tag_prv_verify_write_done(errorCode_t err, gpointer data)
+{
+	neardalTagVerify	*verify	= data;
+
+	verify->doneTs = neardal_metrics_prv_now();
+	neardal_metrics_prv_op(NEARDAL_STATS_OP_WRITE, verify->writeTs,
+			       err != NEARDAL_SUCCESS);
+	NEARDAL_PROBE2(tag_write_done, verify->tagName, err);
+
+	if (err != NEARDAL_SUCCESS)
+		neardal_tag_prv_verify_report(verify, NEARDAL_VERIFY_FAILED,
+					      err);
+	else
+		neardal_tag_prv_verify_read(verify);
+}
+
+errorCode_t neardal_tag_write_verify(const char *tagName,
+				     const unsigned char *ndef,
+				     unsigned int len, unsigned int timeoutMs,
+				     write_verify_cb cb, void *user_data)
+{
+	errorCode_t		err;
+	TagProp			*tag;
+	neardalTagVerify	*verify;
+
+	NEARDAL_ASSERT_RET(tagName != NULL && ndef != NULL && len != 0 &&
+			   cb != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
+
+	neardal_prv_construct(&err);
+	if (err != NEARDAL_SUCCESS)
+		return err;
+
+	if (!(tag = neardal_mgr_tag_search(tagName)))
+		return NEARDAL_ERROR_NO_TAG;
+
+	verify = g_try_malloc0(sizeof(neardalTagVerify));
+	if (verify == NULL)
+		return NEARDAL_ERROR_NO_MEMORY;
+	verify->tagName		= g_strdup(tagName);
+	verify->cb		= cb;
+	verify->user_data	= user_data;
+	verify->len		= len;
+	verify->timeoutMs	= timeoutMs;
+	/* Only the digest is kept for the comparison */
+	neardal_tag_prv_digest(ndef, len, verify->digest);
+
+	NEARDAL_PROBE1(tag_write, tag->name);
+	verify->writeTs = neardal_metrics_prv_now();
+	neardalMgr.backend->tag_write_async(tag,
+			g_variant_new_parsed("{'Type': <'Raw'>, 'NDEF': <%@ay>}",
+					     neardal_tools_prv_bytes(ndef, len)),
+			neardal_tag_prv_verify_write_done, verify);
+
+	return NEARDAL_SUCCESS;
+}
+
 /*****************************************************************************
  * neardal_tag_prv_add: add new NFC tag, initialize DBus Proxy connection,
  * register tag signal
@@ -242,15 +959,27 @@ errorCode_t neardal_tag_prv_add(gchar *tagName, void *parent)
 			   , NEARDAL_ERROR_INVALID_PARAMETER);
 
 	NEARDAL_TRACEF("Adding tag:%s\n", tagName);
-	tagProp = g_try_malloc0(sizeof(TagProp));
+	tagProp = neardal_pool_prv_alloc0(NEARDAL_POOL_TAG);
 	if (tagProp == NULL)
 		goto error;
 
-	tagProp->name	= g_strdup(tagName);
+	tagProp->name	= neardal_pool_prv_strdup(tagName);
+	if (tagProp->name == NULL)
+		goto error;
 	tagProp->parent	= adpProp;
 
 	adpProp->tagList = g_list_prepend(adpProp->tagList, tagProp);
-	err = neardal_tag_prv_init(tagProp);
+	tagProp->ifaceAddedTs = neardalMgr.ifaceAddedTs;
+	tagProp->registeredTs = neardal_metrics_prv_now();
+	err = neardalMgr.backend->tag_init(tagProp);
+	if (err == NEARDAL_SUCCESS) {
+		tagProp->proxyReadyTs = neardal_metrics_prv_now();
+		neardal_metrics_prv_count(NEARDAL_COUNTER_TAG_FOUND);
+		neardal_metrics_prv_stage(NEARDAL_STATS_STAGE_TAG_REGISTER,
+				tagProp->ifaceAddedTs, tagProp->registeredTs);
+		neardal_metrics_prv_stage(NEARDAL_STATS_STAGE_TAG_PROXY,
+				tagProp->registeredTs, tagProp->proxyReadyTs);
+	}
 
 	NEARDAL_TRACEF("NEARDAL LIB tagList contains %d elements\n",
 		      g_list_length(adpProp->tagList));
@@ -258,10 +987,10 @@ errorCode_t neardal_tag_prv_add(gchar *tagName, void *parent)
 	return err;
 
 error:
-	if (tagProp->name != NULL)
-		g_free(tagProp->name);
-	if (tagProp != NULL)
-		g_free(tagProp);
+	if (tagProp != NULL) {
+		neardal_pool_prv_strfree(tagProp->name);
+		neardal_pool_prv_free(NEARDAL_POOL_TAG, tagProp);
+	}
 
 	return err;
 }
@@ -272,17 +1001,84 @@ error:
  ****************************************************************************/
 void neardal_tag_prv_remove(TagProp *tagProp)
 {
-	RcdProp		*rcdProp	= NULL;
-	GList		*node;
-	AdpProp		*adpProp;
+	AdpProp	*adpProp;
 
 	NEARDAL_ASSERT(tagProp != NULL);
 
+	adpProp = tagProp->parent;
+	neardal_tag_prv_remove_link(g_list_find(adpProp->tagList, tagProp));
+}
+
+void neardal_tag_prv_remove_link(GList *link)
+{
+	TagProp		*tagProp;
+	AdpProp		*adpProp;
+	neardal_tag_trace *trace;
+
+	NEARDAL_ASSERT(link != NULL);
+	tagProp = link->data;
+
 	NEARDAL_TRACEF("Removing tag:%s\n", tagProp->name);
 
+	if (neardalMgr.cb.tag_trace != NULL &&
+	    neardal_tag_prv_get_trace(tagProp, &trace) == NEARDAL_SUCCESS) {
+		NEARDAL_PROBE_CB_DISPATCH("tag_trace", tagProp->name);
+		(neardalMgr.cb.tag_trace)(trace, neardalMgr.cb.tag_trace_ud);
+		NEARDAL_PROBE_CB_RETURN("tag_trace", tagProp->name);
+		neardal_free_tag_trace(trace);
+	}
+
 	adpProp = tagProp->parent;
-	adpProp->tagList = g_list_remove(adpProp->tagList,
-					 (gconstpointer) tagProp);
+	adpProp->tagList = g_list_delete_link(adpProp->tagList, link);
+	neardal_metrics_prv_count(NEARDAL_COUNTER_TAG_LOST);
 
 	neardal_tag_prv_free(&tagProp);
 }
+
+/*****************************************************************************
+ * neardal_tag_prv_get_trace: copy tag (and records) detection timestamps to
+ * a client tag trace struct
+ ****************************************************************************/
+errorCode_t neardal_tag_prv_get_trace(TagProp *tagProp,
+				      neardal_tag_trace **trace)
+{
+	neardal_tag_trace	*out;
+	RcdProp			*rcdProp;
+	int			ct = 0;
+
+	NEARDAL_ASSERT_RET((tagProp != NULL) && (trace != NULL)
+			   , NEARDAL_ERROR_INVALID_PARAMETER);
+
+	out = g_try_malloc0(sizeof(neardal_tag_trace));
+	if (out == NULL)
+		return NEARDAL_ERROR_NO_MEMORY;
+
+	out->name		= g_strdup(tagProp->name);
+	out->ifaceAddedNs	= tagProp->ifaceAddedTs;
+	out->registeredNs	= tagProp->registeredTs;
+	out->proxyReadyNs	= tagProp->proxyReadyTs;
+	out->dispatchedNs	= tagProp->dispatchedTs;
+	out->returnedNs		= tagProp->returnedTs;
+	out->nbRecords		= (int) tagProp->rcds.len;
+
+	if (out->nbRecords > 0) {
+		out->records = g_try_malloc0(out->nbRecords *
+					     sizeof(neardal_record_trace));
+		if (out->records == NULL) {
+			neardal_free_tag_trace(out);
+			return NEARDAL_ERROR_NO_MEMORY;
+		}
+	}
+
+	for (ct = 0; ct < out->nbRecords; ct++) {
+		rcdProp = &tagProp->rcds.rcds[ct];
+		out->records[ct].name		= g_strdup(rcdProp->name);
+		out->records[ct].decodedNs	= rcdProp->decodedTs;
+		out->records[ct].dispatchedNs	= rcdProp->dispatchedTs;
+		out->records[ct].returnedNs	= rcdProp->returnedTs;
+	}
+
+	*trace = out;
+
+	return NEARDAL_SUCCESS;
+}
@@ -33,14 +33,22 @@ typedef struct {
 	void		*parent;  /* parent (adapter ) */
 	gboolean	notified; /* Already notified to client? */
 
-	gchar		*type;
+	const gchar	*type;		/* interned (g_intern_string()) */
 
-	gsize		rcdLen;
-	GList		*rcdList;	/* tag's records paths */
+	RcdArray	rcds;		/* tag's records */
 
-	gchar		**tagType;	/* array of tag types */
+	const gchar	**tagType;	/* array of tag types (interned) */
 	gsize		tagTypeLen;
 	gboolean	readOnly;	/* Read-Only flag */
+	GVariant	*ndef;		/* simulator: NDEF message written
+					 * ('ay'), NULL if never written */
+
+	/* Detection timestamps (see neardal_metrics_prv_now()) */
+	guint64		ifaceAddedTs;	/* 'interfaces-added' received */
+	guint64		registeredTs;	/* added to adapter tag list */
+	guint64		proxyReadyTs;	/* DBus proxy created */
+	guint64		dispatchedTs;	/* 'tag found' callback invoked */
+	guint64		returnedTs;	/* 'tag found' callback returned */
 } TagProp;
 
 /*****************************************************************************
@@ -61,4 +69,91 @@ errorCode_t neardal_tag_prv_add(gchar *tagName, void *parent);
  *****************************************************************************/
 void neardal_tag_prv_remove(TagProp *tagProp);
 
+/******************************************************************************
+ * neardal_tag_prv_remove_link: same, for the tag of a link of its adapter
+ * tag list (no list walk)
+ *****************************************************************************/
+void neardal_tag_prv_remove_link(GList *link);
+
+/******************************************************************************
+ * neardal_tag_prv_get_trace: copy tag (and records) detection timestamps to
+ * a client tag trace struct
+ *****************************************************************************/
+errorCode_t neardal_tag_prv_get_trace(TagProp *tagProp,
+				      neardal_tag_trace **trace);
+
+/******************************************************************************
+ * neardal_tag_prv_read_properties: read tag properties from the tag
+ * description received with 'interfaces-added'
+ *****************************************************************************/
+errorCode_t neardal_tag_prv_read_properties(TagProp *tagProp);
+
+/******************************************************************************
+ * neardal_tag_prv_dbus_init: DBus backend, create tag proxy and read tag
+ * properties
+ *****************************************************************************/
+errorCode_t neardal_tag_prv_dbus_init(TagProp *tagProp);
+
+/******************************************************************************
+ * neardal_tag_prv_dbus_free: DBus backend, unref tag proxy
+ *****************************************************************************/
+void neardal_tag_prv_dbus_free(TagProp *tagProp);
+
+/******************************************************************************
+ * neardal_tag_prv_dbus_write: DBus backend, write a record to a tag
+ *****************************************************************************/
+errorCode_t neardal_tag_prv_dbus_write(TagProp *tagProp, GVariant *record);
+
+/* Completion of an asynchronous write */
+typedef void (*neardalWriteDone)(errorCode_t err, gpointer data);
+
+/******************************************************************************
+ * neardal_tag_prv_dbus_write_async: DBus backend, asynchronous
+ * neardal_tag_prv_dbus_write()
+ *****************************************************************************/
+void neardal_tag_prv_dbus_write_async(TagProp *tagProp, GVariant *record,
+				      neardalWriteDone done, gpointer data);
+
+/* Tag arrival hook: called for each new tag, from 'interfaces-added', before
+ * the client is notified. Returns TRUE when it took the tag (e.g. started a
+ * write), the next hooks are then skipped. */
+typedef gboolean (*neardalTagHook)(TagProp *tagProp, gpointer data);
+
+/******************************************************************************
+ * neardal_tag_prv_hook_add / neardal_tag_prv_hook_remove: install or remove a
+ * tag arrival hook (hooks run in installation order)
+ *****************************************************************************/
+errorCode_t neardal_tag_prv_hook_add(neardalTagHook hook, gpointer data);
+void neardal_tag_prv_hook_remove(neardalTagHook hook, gpointer data);
+
+/******************************************************************************
+ * neardal_tag_prv_run_hooks: offer a new tag to the arrival hooks
+ *****************************************************************************/
+void neardal_tag_prv_run_hooks(TagProp *tagProp);
+
+/******************************************************************************
+ * neardal_tag_prv_auto_write_clear: stop automatic writes
+ *****************************************************************************/
+void neardal_tag_prv_auto_write_clear(void);
+
+/* Completion of an asynchronous raw NDEF read ('ndef' NULL on error,
+ * released by the callee) */
+typedef void (*neardalRawNdefDone)(errorCode_t err, GVariant *ndef,
+				   gpointer data);
+
+/******************************************************************************
+ * neardal_tag_prv_dbus_get_raw_ndef: DBus backend, read the raw NDEF message
+ * of a tag ('ay' of the reply, not copied)
+ *****************************************************************************/
+errorCode_t neardal_tag_prv_dbus_get_raw_ndef(TagProp *tagProp,
+					      GVariant **ndef);
+
+/******************************************************************************
+ * neardal_tag_prv_dbus_get_raw_ndef_async: DBus backend, asynchronous
+ * neardal_tag_prv_dbus_get_raw_ndef()
+ *****************************************************************************/
+void neardal_tag_prv_dbus_get_raw_ndef_async(TagProp *tagProp,
+					     neardalRawNdefDone done,
+					     gpointer data);
+
 #endif /* NEARDAL_TAG_H */
@@ -54,7 +54,8 @@ void neardal_g_variant_add_parsed(GVariant **v, const char *format, ...)
 	while (g_variant_iter_loop(&iter, "*", &i))
 		g_variant_builder_add_value(&b, i);
 
-	*v = g_variant_builder_end(&b);
+	g_variant_unref(*v);
+	*v = g_variant_ref_sink(g_variant_builder_end(&b));
 }
 
 void neardal_g_variant_dump(GVariant *data)
@@ -64,7 +65,7 @@ void neardal_g_variant_dump(GVariant *data)
 	GVariant *v = NULL;
 	g_variant_iter_init(&iter, data);
 	while (g_variant_iter_loop(&iter, "{sv}", &s, &v))
-		NEARDAL_TRACEF(".. %s = %s\n", s, g_variant_print(v, 0));
+		NEARDAL_TRACEF(".. %s = %s\n", s, neardal_trace_prv_variant(v));
 }
 
 void *neardal_g_variant_get(GVariant *data, const char *key, const char *fmt)
@@ -104,11 +105,12 @@ guint neardal_data_to_arrayv(void ***array)
 
 GVariant *neardal_data_insert(const char *name, const char *type, GVariant *in)
 {
-	GVariant *out = in;
+	GVariant *out = g_variant_ref(in);
 	GData **l = &(neardalMgr.dbus_data);
 	neardal_g_variant_add_parsed(&out, "{'NeardalType', <%s>}", type);
 	neardal_g_variant_add_parsed(&out, "{'Name', <%s>}", name);
-	g_datalist_set_data_full(l, name, g_variant_ref(out),
+	/* The list owns the only reference */
+	g_datalist_set_data_full(l, name, out,
 					(GDestroyNotify) g_variant_unref);
 	return out;
 }
@@ -181,6 +183,48 @@ GHashTable *neardal_tools_prv_create_dict(void)
 	return g_hash_table_new(g_str_hash, g_str_equal);
 }
 
+/*****************************************************************************
+ * neardal_tools_prv_intern_strv: NULL terminated array of the interned
+ * strings of a GVariant 'as' (free the array only, with g_free())
+ ****************************************************************************/
+const gchar **neardal_tools_prv_intern_strv(GVariant *strv, gsize *len)
+{
+	const gchar	**out;
+	const gchar	*str;
+	GVariantIter	iter;
+	gsize		i = 0;
+
+	*len = g_variant_n_children(strv);
+	out = g_try_malloc0((*len + 1) * sizeof(gchar *));
+	if (out == NULL) {
+		*len = 0;
+		return NULL;
+	}
+
+	g_variant_iter_init(&iter, strv);
+	while (g_variant_iter_next(&iter, "&s", &str))
+		out[i++] = g_intern_string(str);
+
+	return out;
+}
+
+/*****************************************************************************
+ * neardal_tools_prv_bytes: 'ay' GVariant holding a copy of 'data', made in
+ * one go (not byte per byte)
+ ****************************************************************************/
+GVariant *neardal_tools_prv_bytes(const void *data, gsize len)
+{
+#if GLIB_CHECK_VERSION(2, 32, 0)
+	return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, data, len,
+					 sizeof(guint8));
+#else
+	gpointer copy = g_memdup(data, len);
+
+	return g_variant_new_from_data(G_VARIANT_TYPE_BYTESTRING, copy, len,
+				       TRUE, g_free, copy);
+#endif
+}
+
 /*****************************************************************************
  * neardal_tools_prv_add_dict_entry: add an entry in a dictionnary
  ****************************************************************************/
@@ -190,10 +234,6 @@ errorCode_t neardal_tools_prv_add_dict_entry(GVariantBuilder *builder
 					     , int gVariantType)
 {
 	GVariant	*tmp			= NULL;
-	GVariantBuilder	*bytesArrayBuilder	= NULL;
-	unsigned char	*bytePtr;
-	gsize		count;
-	errorCode_t	err			= NEARDAL_SUCCESS;
 
 	NEARDAL_ASSERT_RET(builder != NULL, NEARDAL_ERROR_INVALID_PARAMETER);
 
@@ -204,31 +244,19 @@ errorCode_t neardal_tools_prv_add_dict_entry(GVariantBuilder *builder
 	case G_TYPE_UINT:
 		tmp = g_variant_new_uint32(GPOINTER_TO_UINT(value));
 		break;
+	case NEARDAL_TYPE_BYTE_ARRAY:
+		tmp = neardal_tools_prv_bytes(value, valueSize);
+		break;
 	default:
-		/* if valueSize > 0, consider value as byte array
-		 processing like g_variant_new_bytestring() but based on array
-		 size and not a null terminated string  (allowing byte = 0
-		 in array) */
-		if (valueSize > 0) {
-			err = NEARDAL_ERROR_GENERAL_ERROR;
-			bytePtr = (unsigned char*) value;
-			bytesArrayBuilder = g_variant_builder_new(
-						G_VARIANT_TYPE_BYTESTRING);
-			if (bytesArrayBuilder == NULL)
-				break;
-
-			for (count = 0; count < valueSize; count++)
-				g_variant_builder_add(bytesArrayBuilder, "y"
-						      , bytePtr[count]);
-
-			tmp = g_variant_builder_end(bytesArrayBuilder);
-			g_variant_builder_unref(bytesArrayBuilder);
-			err = NEARDAL_SUCCESS;
-		}
+		/* if valueSize > 0, consider value as byte array */
+		if (valueSize > 0)
+			tmp = neardal_tools_prv_bytes(value, valueSize);
 		break;
 	}
+	if (tmp == NULL)
+		return NEARDAL_ERROR_INVALID_PARAMETER;
 	g_variant_builder_add(builder, "{sv}", key, tmp);
 
-	return err;
+	return NEARDAL_SUCCESS;
 }
 
@@ -63,8 +63,24 @@ int neardal_tools_prv_cmp_path(const char *neardalPath, const char *reqPath);
  *****************************************************************************/
 GHashTable *neardal_tools_prv_create_dict(void);
 
+/******************************************************************************
+ * neardal_tools_prv_intern_strv: NULL terminated array of the interned
+ * strings of a GVariant 'as' (free the array only, with g_free())
+ *****************************************************************************/
+const gchar **neardal_tools_prv_intern_strv(GVariant *strv, gsize *len);
+
+/******************************************************************************
+ * neardal_tools_prv_bytes: 'ay' GVariant holding a copy of 'data', made in
+ * one go
+ *****************************************************************************/
+GVariant *neardal_tools_prv_bytes(const void *data, gsize len);
+
+/* neardal_tools_prv_add_dict_entry() type of a byte array value */
+#define NEARDAL_TYPE_BYTE_ARRAY	(-1)
+
 /******************************************************************************
  * neardal_tools_prv_add_dict_entry: add an entry in a dictionnary
+ * (gVariantType: G_TYPE_STRING, G_TYPE_UINT or NEARDAL_TYPE_BYTE_ARRAY)
  *****************************************************************************/
 errorCode_t neardal_tools_prv_add_dict_entry(GVariantBuilder *builder
 					     , const gchar *key, void *value
@@ -122,3 +122,22 @@ void neardal_trace_prv_dump_mem(char *bufToReadP, int size)
 	}
 	g_string_free(bufTrace, TRUE);
 }
+
+#define NB_VARIANT_STRINGS	4
+
+/*****************************************************************************
+ * neardal_trace_prv_variant: textual form of a GVariant, for traces. The
+ * string is owned by a small ring of buffers (a trace can hold up to
+ * NB_VARIANT_STRINGS of them) instead of being leaked by each trace call.
+ ****************************************************************************/
+const char *neardal_trace_prv_variant(GVariant *v)
+{
+	static gchar	*strings[NB_VARIANT_STRINGS];
+	static guint	next;
+	gchar		**slot = &strings[next++ % NB_VARIANT_STRINGS];
+
+	g_free(*slot);
+	*slot = v ? g_variant_print(v, TRUE) : g_strdup("(null)");
+
+	return *slot;
+}
@@ -43,5 +43,6 @@
 						"Error: " __VA_ARGS__)
 
 void neardal_trace_dump_mem(char *dataP, int size);
+const char *neardal_trace_prv_variant(GVariant *v);
 
 #endif	/* NEARDAL_TRACES_PRV_H */
@@ -0,0 +1,51 @@
+#!/bin/sh
+#
+# Run a command against neard-mock on a private bus:
+#   mock-run.sh [neard-mock options] -- command [args]
+# The private bus is exported as the system bus (DBUS_SYSTEM_BUS_ADDRESS),
+# so NEARDAL clients need no change.
+
+MOCK=${MOCK:-$(dirname "$0")/neard-mock}
+
+MOCK_ARGS=
+while [ $# -gt 0 ] && [ "$1" != "--" ]; do
+	MOCK_ARGS="$MOCK_ARGS $1"
+	shift
+done
+[ "$1" = "--" ] && shift
+
+if [ $# -eq 0 ]; then
+	echo "usage: $0 [neard-mock options] -- command [args]" >&2
+	exit 1
+fi
+
+eval $(dbus-daemon --session --fork --print-address=1 --print-pid=1 | {
+	read address; read pid
+	echo "BUS_ADDRESS='$address' BUS_PID=$pid"
+})
+[ -n "$BUS_ADDRESS" ] || { echo "Can't start dbus-daemon" >&2; exit 1; }
+export DBUS_SYSTEM_BUS_ADDRESS="$BUS_ADDRESS"
+
+$MOCK $MOCK_ARGS &
+MOCK_PID=$!
+
+cleanup() {
+	kill $MOCK_PID 2>/dev/null
+	wait $MOCK_PID 2>/dev/null
+	kill $BUS_PID 2>/dev/null
+}
+trap cleanup EXIT INT TERM
+
+i=0
+until gdbus call --system --dest org.neard --object-path / \
+	--method org.freedesktop.DBus.ObjectManager.GetManagedObjects \
+	>/dev/null 2>&1; do
+	i=$((i + 1))
+	if [ $i -gt 100 ] || ! kill -0 $MOCK_PID 2>/dev/null; then
+		echo "neard-mock did not start" >&2
+		exit 1
+	fi
+	sleep 0.05
+done
+
+"$@"
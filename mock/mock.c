@@ -0,0 +1,208 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* neard-mock: scriptable stand-in for the neard daemon, exporting the
+ * org.neard objects NEARDAL consumes plus a control interface
+ * (org.neardal.Mock at /org/neardal/mock) used by the benchmarks to inject
+ * tag storms deterministically. Run it on a private bus, see mock-run.sh */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "mock.h"
+
+/* Maximum tags created per storm tick, keeps the loop responsive */
+#define MOCK_STORM_BURST	64
+
+MockCtx mock = {
+	.nbAdapters	= 1,
+	.records	= 1,
+};
+
+static GMainLoop *sLoop;
+
+static GOptionEntry sOptions[] = {
+	{ "address", 'a', 0, G_OPTION_ARG_STRING, &mock.address,
+	  "Bus address (default: system bus)", "ADDRESS" },
+	{ "adapters", 'n', 0, G_OPTION_ARG_INT, &mock.nbAdapters,
+	  "Number of adapters (default: 1)", "N" },
+	{ "initial-tags", 'i', 0, G_OPTION_ARG_INT, &mock.initialTags,
+	  "Tags present at start, per adapter", "N" },
+	{ "records", 'r', 0, G_OPTION_ARG_INT, &mock.records,
+	  "Records per tag (default: 1)", "N" },
+	{ "rate", 'R', 0, G_OPTION_ARG_DOUBLE, &mock.rate,
+	  "Start a storm of N tags per second", "N" },
+	{ "count", 'c', 0, G_OPTION_ARG_INT, &mock.count,
+	  "Number of storm tags (default: unlimited)", "N" },
+	{ "dwell", 'd', 0, G_OPTION_ARG_INT, &mock.dwell,
+	  "Tag presence before 'tag lost' in ms (default: forever)", "MS" },
+	{ "write-latency", 'w', 0, G_OPTION_ARG_INT, &mock.writeLatency,
+	  "Write/Push completion delay in ms (default: 0)", "MS" },
+	{ NULL, 0, 0, 0, NULL, NULL, NULL }
+};
+
+/*---------------------------------------------------------------------------
+ * Tag storm
+ ---------------------------------------------------------------------------*/
+static gboolean mock_storm_tick(gpointer user_data)
+{
+	gdouble	elapsed;
+	guint64	due;
+	guint	burst = 0;
+
+	(void) user_data;
+
+	elapsed = (g_get_monotonic_time() - mock.stormStart) / 1000000.0;
+	due = (guint64) (mock.rate * elapsed) + 1;
+	if (mock.count > 0 && due > (guint64) mock.count)
+		due = mock.count;
+
+	while (mock.stormCreated < due && burst++ < MOCK_STORM_BURST) {
+		if (mock_tag_add(mock_adapter_next(), mock.records) == NULL)
+			break;
+		mock.stormCreated++;
+	}
+
+	if (mock.count > 0 && mock.stormCreated >= (guint64) mock.count) {
+		mock.stormId = 0;
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+/*****************************************************************************
+ * mock_storm_start: create 'rate' tags per second, 'count' tags overall
+ ****************************************************************************/
+void mock_storm_start(gdouble rate, gint count)
+{
+	mock_storm_stop();
+	if (rate <= 0)
+		return;
+
+	mock.rate = rate;
+	mock.count = count;
+	mock.stormStart = g_get_monotonic_time();
+	mock.stormCreated = 0;
+	mock.stormId = g_timeout_add(1, mock_storm_tick, NULL);
+}
+
+/*****************************************************************************
+ * mock_storm_stop: stop tags creation (present tags are kept)
+ ****************************************************************************/
+void mock_storm_stop(void)
+{
+	if (mock.stormId != 0)
+		g_source_remove(mock.stormId);
+	mock.stormId = 0;
+}
+
+/*****************************************************************************
+ * mock_quit: leave main loop
+ ****************************************************************************/
+void mock_quit(void)
+{
+	g_main_loop_quit(sLoop);
+}
+
+static void mock_name_acquired(GDBusConnection *conn, const gchar *name,
+			       gpointer user_data)
+{
+	(void) conn;
+	(void) user_data;
+
+	g_print("neard-mock: '%s' acquired, %d adapter(s)\n", name,
+		mock.nbAdapters);
+	if (mock.rate > 0)
+		mock_storm_start(mock.rate, mock.count);
+}
+
+static void mock_name_lost(GDBusConnection *conn, const gchar *name,
+			   gpointer user_data)
+{
+	(void) conn;
+	(void) user_data;
+
+	g_printerr("neard-mock: can't own '%s'\n", name);
+	g_main_loop_quit(sLoop);
+}
+
+int main(int argc, char *argv[])
+{
+	GOptionContext	*context;
+	GError		*error = NULL;
+	guint		ownerId;
+	int		ret = EXIT_FAILURE;
+
+	context = g_option_context_new("- mock neard daemon");
+	g_option_context_add_main_entries(context, sOptions, NULL);
+	if (!g_option_context_parse(context, &argc, &argv, &error)) {
+		g_printerr("%s\n", error->message);
+		goto exit;
+	}
+
+	if (mock.address != NULL)
+		mock.conn = g_dbus_connection_new_for_address_sync(mock.address,
+			G_DBUS_CONNECTION_FLAGS_AUTHENTICATION_CLIENT |
+			G_DBUS_CONNECTION_FLAGS_MESSAGE_BUS_CONNECTION,
+			NULL, NULL, &error);
+	else
+		mock.conn = g_bus_get_sync(G_BUS_TYPE_SYSTEM, NULL, &error);
+	if (mock.conn == NULL) {
+		g_printerr("Can't connect: %s\n", error->message);
+		goto exit;
+	}
+
+	sLoop = g_main_loop_new(NULL, FALSE);
+	if (!mock_bus_init(&error)) {
+		g_printerr("Can't export objects: %s\n", error->message);
+		goto exit;
+	}
+
+	ownerId = g_bus_own_name_on_connection(mock.conn, MOCK_DBUS_SERVICE,
+					       G_BUS_NAME_OWNER_FLAGS_NONE,
+					       mock_name_acquired,
+					       mock_name_lost, NULL, NULL);
+	g_main_loop_run(sLoop);
+	g_bus_unown_name(ownerId);
+
+	mock_storm_stop();
+	mock_remove_all(MOCK_TAG);
+	mock_remove_all(MOCK_DEVICE);
+	g_print("neard-mock: %" G_GUINT64_FORMAT " tags created, %"
+		G_GUINT64_FORMAT " writes, %" G_GUINT64_FORMAT " pushes\n",
+		mock.tagsCreated, mock.writes, mock.pushes);
+	ret = EXIT_SUCCESS;
+
+exit:
+	if (error != NULL)
+		g_error_free(error);
+	if (sLoop != NULL)
+		g_main_loop_unref(sLoop);
+	if (mock.conn != NULL)
+		g_object_unref(mock.conn);
+	g_option_context_free(context);
+	g_free(mock.address);
+
+	return ret;
+}
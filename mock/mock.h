@@ -0,0 +1,104 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef MOCK_H
+#define MOCK_H
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#define MOCK_DBUS_SERVICE	"org.neard"
+#define MOCK_MGR_PATH		"/"
+#define MOCK_ADP_PREFIX		"/org/neard/nfc"
+#define MOCK_CTL_PATH		"/org/neardal/mock"
+#define MOCK_CTL_IFACE		"org.neardal.Mock"
+
+/* Mock neard object kinds */
+typedef enum {
+	MOCK_ADAPTER = 0,
+	MOCK_TAG,
+	MOCK_RECORD,
+	MOCK_DEVICE
+} MockKind;
+
+/* Mock neard object (adapter, tag, record or device) */
+typedef struct MockObj {
+	MockKind	kind;
+	gchar		*path;		/* DBus object path */
+	struct MockObj	*parent;	/* adapter (tag, device), tag (record) */
+	GList		*children;	/* tags & devices, or records */
+	GHashTable	*props;		/* name -> GVariant (main interface) */
+	guint		regId;		/* object registration id */
+	guint		nextTag;	/* adapter: next tag index */
+	guint		nextDev;	/* adapter: next device index */
+	guint		dwellId;	/* tag: 'tag lost' timer */
+	GList		*pending;	/* tag, device: delayed Write/Push */
+	GByteArray	*ndef;		/* tag: raw NDEF message */
+} MockObj;
+
+/* Mock neard options and state */
+typedef struct {
+	GDBusConnection	*conn;
+	GList		*adapters;	/* MockObj adapters */
+	GList		*agents;	/* registered NDEF agents */
+
+	/* Options */
+	gchar		*address;	/* bus address (default: system bus) */
+	gint		nbAdapters;	/* adapters created at start */
+	gint		initialTags;	/* tags present at start (per adapter) */
+	gint		records;	/* records per tag */
+	gdouble		rate;		/* tag arrivals per second (storm) */
+	gint		count;		/* tags to create (0: unlimited) */
+	gint		dwell;		/* tag presence (ms, 0: forever) */
+	gint		writeLatency;	/* Write/Push completion delay (ms) */
+
+	/* Storm state */
+	guint		stormId;
+	gint64		stormStart;	/* g_get_monotonic_time() */
+	guint64		stormCreated;
+	guint		nextAdapter;	/* round robin */
+
+	/* Statistics */
+	guint64		tagsCreated;
+	guint64		tagsRemoved;
+	guint64		writes;
+	guint64		pushes;
+} MockCtx;
+
+extern MockCtx mock;
+
+/* mock_bus.c */
+guint64 mock_now(void);
+gboolean mock_bus_init(GError **error);
+MockObj *mock_adapter_add(void);
+void mock_adapter_remove(MockObj *adp);
+MockObj *mock_adapter_next(void);
+MockObj *mock_tag_add(MockObj *adapter, guint nbRecords);
+void mock_tag_remove(MockObj *tag);
+MockObj *mock_device_add(MockObj *adapter);
+void mock_device_remove(MockObj *dev);
+void mock_remove_all(MockKind kind);
+
+/* mock.c */
+void mock_storm_start(gdouble rate, gint count);
+void mock_storm_stop(void);
+void mock_quit(void);
+
+#endif /* MOCK_H */
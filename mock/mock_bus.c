@@ -0,0 +1,1307 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#define _GNU_SOURCE
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <glib.h>
+#include <gio/gio.h>
+
+#include "mock.h"
+
+/* Interfaces exported by the mock (neard interfaces, with the properties
+ * neard exposes, plus the mock control interface) */
+static const gchar sIntrospection[] =
+"<node>"
+" <interface name='org.freedesktop.DBus.ObjectManager'>"
+"  <method name='GetManagedObjects'>"
+"   <arg name='objects' type='a{oa{sa{sv}}}' direction='out'/>"
+"  </method>"
+"  <signal name='InterfacesAdded'>"
+"   <arg name='object' type='o'/>"
+"   <arg name='interfaces' type='a{sa{sv}}'/>"
+"  </signal>"
+"  <signal name='InterfacesRemoved'>"
+"   <arg name='object' type='o'/>"
+"   <arg name='interfaces' type='as'/>"
+"  </signal>"
+" </interface>"
+" <interface name='org.neard.Manager'>"
+"  <method name='GetProperties'>"
+"   <arg name='properties' type='a{sv}' direction='out'/>"
+"  </method>"
+"  <method name='SetProperty'>"
+"   <arg name='name' type='s' direction='in'/>"
+"   <arg name='value' type='v' direction='in'/>"
+"  </method>"
+"  <method name='RegisterHandoverAgent'>"
+"   <arg name='path' type='o' direction='in'/>"
+"   <arg name='type' type='s' direction='in'/>"
+"  </method>"
+"  <method name='UnregisterHandoverAgent'>"
+"   <arg name='path' type='o' direction='in'/>"
+"   <arg name='type' type='s' direction='in'/>"
+"  </method>"
+"  <method name='RegisterNDEFAgent'>"
+"   <arg name='path' type='o' direction='in'/>"
+"   <arg name='type' type='s' direction='in'/>"
+"  </method>"
+"  <method name='UnregisterNDEFAgent'>"
+"   <arg name='path' type='o' direction='in'/>"
+"   <arg name='type' type='s' direction='in'/>"
+"  </method>"
+"  <signal name='PropertyChanged'>"
+"   <arg name='name' type='s'/>"
+"   <arg name='value' type='v'/>"
+"  </signal>"
+"  <signal name='AdapterAdded'>"
+"   <arg name='adapter' type='o'/>"
+"  </signal>"
+"  <signal name='AdapterRemoved'>"
+"   <arg name='adapter' type='o'/>"
+"  </signal>"
+" </interface>"
+" <interface name='org.neard.Adapter'>"
+"  <method name='StartPollLoop'>"
+"   <arg name='name' type='s' direction='in'/>"
+"  </method>"
+"  <method name='StopPollLoop'/>"
+"  <property name='Mode' type='s' access='read'/>"
+"  <property name='Powered' type='b' access='readwrite'/>"
+"  <property name='Polling' type='b' access='read'/>"
+"  <property name='Protocols' type='as' access='read'/>"
+" </interface>"
+" <interface name='org.neard.Tag'>"
+"  <method name='Write'>"
+"   <arg name='attributes' type='a{sv}' direction='in'/>"
+"  </method>"
+"  <method name='GetRawNDEF'>"
+"   <arg name='NDEF' type='ay' direction='out'/>"
+"  </method>"
+"  <property name='Type' type='s' access='read'/>"
+"  <property name='Protocol' type='s' access='read'/>"
+"  <property name='ReadOnly' type='b' access='read'/>"
+"  <property name='Adapter' type='o' access='read'/>"
+" </interface>"
+" <interface name='org.neard.Record'>"
+"  <property name='Type' type='s' access='read'/>"
+"  <property name='Encoding' type='s' access='read'/>"
+"  <property name='Language' type='s' access='read'/>"
+"  <property name='Representation' type='s' access='read'/>"
+"  <property name='URI' type='s' access='read'/>"
+"  <property name='MIME' type='s' access='read'/>"
+"  <property name='Action' type='s' access='read'/>"
+"  <property name='Size' type='u' access='read'/>"
+" </interface>"
+" <interface name='org.neard.Device'>"
+"  <method name='Push'>"
+"   <arg name='attributes' type='a{sv}' direction='in'/>"
+"  </method>"
+"  <property name='Adapter' type='o' access='read'/>"
+" </interface>"
+" <interface name='" MOCK_CTL_IFACE "'>"
+"  <method name='InjectTags'>"
+"   <arg name='count' type='u' direction='in'/>"
+"   <arg name='created' type='u' direction='out'/>"
+"  </method>"
+"  <method name='RemoveTags'>"
+"   <arg name='removed' type='u' direction='out'/>"
+"  </method>"
+"  <method name='InjectDevice'>"
+"   <arg name='device' type='o' direction='out'/>"
+"  </method>"
+"  <method name='RemoveDevices'/>"
+"  <method name='SetAdapters'>"
+"   <arg name='count' type='u' direction='in'/>"
+"  </method>"
+"  <method name='StartStorm'>"
+"   <arg name='rate' type='d' direction='in'/>"
+"   <arg name='count' type='i' direction='in'/>"
+"  </method>"
+"  <method name='StopStorm'/>"
+"  <method name='SetRecords'>"
+"   <arg name='records' type='i' direction='in'/>"
+"  </method>"
+"  <method name='SetDwell'>"
+"   <arg name='dwell' type='i' direction='in'/>"
+"  </method>"
+"  <method name='SetWriteLatency'>"
+"   <arg name='latency' type='i' direction='in'/>"
+"  </method>"
+"  <method name='GetStats'>"
+"   <arg name='stats' type='a{sv}' direction='out'/>"
+"  </method>"
+"  <method name='Quit'/>"
+"  <signal name='TagInjected'>"
+"   <arg name='tag' type='o'/>"
+"   <arg name='timestamp' type='t'/>"
+"  </signal>"
+" </interface>"
+"</node>";
+
+static const gchar *sIfaceNames[] = {
+	[MOCK_ADAPTER]	= "org.neard.Adapter",
+	[MOCK_TAG]	= "org.neard.Tag",
+	[MOCK_RECORD]	= "org.neard.Record",
+	[MOCK_DEVICE]	= "org.neard.Device",
+};
+
+/* Registered NDEF agent */
+typedef struct {
+	gchar	*sender;
+	gchar	*path;
+	gchar	*type;
+} MockAgent;
+
+/* Delayed Write/Push */
+typedef struct {
+	MockObj			*obj;
+	GDBusMethodInvocation	*invocation;
+	GVariant		*attrs;
+	guint			id;
+} MockPending;
+
+static GDBusNodeInfo *sInfo;
+
+static const GDBusInterfaceVTable sVtable;
+
+/*****************************************************************************
+ * mock_now: monotonic clock, in nanoseconds (same clock as NEARDAL metrics)
+ ****************************************************************************/
+guint64 mock_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (guint64) ts.tv_sec * 1000000000ULL + (guint64) ts.tv_nsec;
+}
+
+/*---------------------------------------------------------------------------
+ * Objects
+ ---------------------------------------------------------------------------*/
+static void mock_obj_set(MockObj *obj, const gchar *name, GVariant *value)
+{
+	g_hash_table_replace(obj->props, g_strdup(name),
+			     g_variant_ref_sink(value));
+}
+
+static const gchar *mock_obj_get_str(MockObj *obj, const gchar *name)
+{
+	GVariant *v = g_hash_table_lookup(obj->props, name);
+
+	if (v == NULL || !g_variant_is_of_type(v, G_VARIANT_TYPE_STRING))
+		return NULL;
+
+	return g_variant_get_string(v, NULL);
+}
+
+static GVariant *mock_obj_props(MockObj *obj)
+{
+	GVariantBuilder	b;
+	GHashTableIter	iter;
+	gpointer	key, value;
+
+	g_variant_builder_init(&b, G_VARIANT_TYPE("a{sv}"));
+	g_hash_table_iter_init(&iter, obj->props);
+	while (g_hash_table_iter_next(&iter, &key, &value))
+		g_variant_builder_add(&b, "{sv}", key, value);
+
+	return g_variant_builder_end(&b);
+}
+
+static GVariant *mock_obj_ifaces(MockObj *obj)
+{
+	GVariantBuilder b;
+
+	g_variant_builder_init(&b, G_VARIANT_TYPE("a{sa{sv}}"));
+	g_variant_builder_add(&b, "{s@a{sv}}", sIfaceNames[obj->kind],
+			      mock_obj_props(obj));
+
+	return g_variant_builder_end(&b);
+}
+
+static void mock_obj_emit_changed(MockObj *obj, const gchar *name)
+{
+	GVariantBuilder b;
+
+	g_variant_builder_init(&b, G_VARIANT_TYPE("a{sv}"));
+	g_variant_builder_add(&b, "{sv}", name,
+			      g_hash_table_lookup(obj->props, name));
+
+	g_dbus_connection_emit_signal(mock.conn, NULL, obj->path,
+				      "org.freedesktop.DBus.Properties",
+				      "PropertiesChanged",
+				      g_variant_new("(sa{sv}as)",
+						    sIfaceNames[obj->kind],
+						    &b, NULL),
+				      NULL);
+}
+
+static MockObj *mock_obj_new(MockKind kind, MockObj *parent, gchar *path)
+{
+	MockObj *obj = g_new0(MockObj, 1);
+
+	obj->kind = kind;
+	obj->path = path;
+	obj->parent = parent;
+	obj->props = g_hash_table_new_full(g_str_hash, g_str_equal, g_free,
+					   (GDestroyNotify) g_variant_unref);
+	if (parent != NULL)
+		parent->children = g_list_append(parent->children, obj);
+
+	return obj;
+}
+
+static void mock_obj_register(MockObj *obj)
+{
+	GDBusInterfaceInfo	*iface;
+	GError			*error = NULL;
+
+	iface = g_dbus_node_info_lookup_interface(sInfo,
+						  sIfaceNames[obj->kind]);
+	obj->regId = g_dbus_connection_register_object(mock.conn, obj->path,
+						iface, &sVtable, obj, NULL,
+						&error);
+	if (obj->regId == 0) {
+		g_printerr("Can't register %s: %s\n", obj->path,
+			   error->message);
+		g_error_free(error);
+	}
+}
+
+static void mock_obj_announce(MockObj *obj)
+{
+	g_dbus_connection_emit_signal(mock.conn, NULL, MOCK_MGR_PATH,
+				      "org.freedesktop.DBus.ObjectManager",
+				      "InterfacesAdded",
+				      g_variant_new("(o@a{sa{sv}})", obj->path,
+						    mock_obj_ifaces(obj)),
+				      NULL);
+}
+
+static void mock_pending_free(MockPending *pending, const gchar *error)
+{
+	if (pending->id != 0)
+		g_source_remove(pending->id);
+	if (error != NULL)
+		g_dbus_method_invocation_return_dbus_error(
+				pending->invocation, "org.neard.Error.Failed",
+				error);
+	g_variant_unref(pending->attrs);
+	g_free(pending);
+}
+
+static void mock_obj_free(MockObj *obj)
+{
+	const gchar *ifaces[] = { sIfaceNames[obj->kind], NULL };
+
+	while (obj->children != NULL) {
+		MockObj *child = obj->children->data;
+
+		if (child->kind == MOCK_TAG)
+			mock_tag_remove(child);
+		else
+			mock_obj_free(child);
+	}
+
+	while (obj->pending != NULL) {
+		mock_pending_free(obj->pending->data, "Object removed");
+		obj->pending = g_list_delete_link(obj->pending, obj->pending);
+	}
+
+	if (obj->dwellId != 0)
+		g_source_remove(obj->dwellId);
+
+	if (obj->regId != 0) {
+		g_dbus_connection_unregister_object(mock.conn, obj->regId);
+		g_dbus_connection_emit_signal(mock.conn, NULL, MOCK_MGR_PATH,
+				"org.freedesktop.DBus.ObjectManager",
+				"InterfacesRemoved",
+				g_variant_new("(o^as)", obj->path, ifaces),
+				NULL);
+	}
+
+	if (obj->parent != NULL)
+		obj->parent->children = g_list_remove(obj->parent->children,
+						      obj);
+
+	if (obj->ndef != NULL)
+		g_byte_array_unref(obj->ndef);
+	g_hash_table_destroy(obj->props);
+	g_free(obj->path);
+	g_free(obj);
+}
+
+/*---------------------------------------------------------------------------
+ * NDEF encoding and decoding (enough for Text, URI, SmartPoster and MIME
+ * records)
+ ---------------------------------------------------------------------------*/
+static void mock_ndef_append(GByteArray *out, guint8 tnf, const gchar *type,
+			     const guint8 *payload, gsize len,
+			     gboolean mb, gboolean me)
+{
+	guint8	hdr	= tnf & 0x07;
+	guint8	typeLen	= (guint8) strlen(type);
+	guint8	len32[4];
+
+	if (mb)
+		hdr |= 0x80;
+	if (me)
+		hdr |= 0x40;
+	if (len < 256)
+		hdr |= 0x10;	/* Short Record */
+
+	g_byte_array_append(out, &hdr, 1);
+	g_byte_array_append(out, &typeLen, 1);
+	if (len < 256) {
+		len32[0] = (guint8) len;
+		g_byte_array_append(out, len32, 1);
+	} else {
+		len32[0] = (guint8) (len >> 24);
+		len32[1] = (guint8) (len >> 16);
+		len32[2] = (guint8) (len >> 8);
+		len32[3] = (guint8) len;
+		g_byte_array_append(out, len32, 4);
+	}
+	g_byte_array_append(out, (const guint8 *) type, typeLen);
+	g_byte_array_append(out, payload, len);
+}
+
+static void mock_ndef_text(GByteArray *out, const gchar *lang,
+			   const gchar *text, gboolean mb, gboolean me)
+{
+	GByteArray	*payload = g_byte_array_new();
+	guint8		status;
+
+	lang = lang ? lang : "en";
+	text = text ? text : "";
+	status = (guint8) (strlen(lang) & 0x3F);
+	g_byte_array_append(payload, &status, 1);
+	g_byte_array_append(payload, (const guint8 *) lang, strlen(lang));
+	g_byte_array_append(payload, (const guint8 *) text, strlen(text));
+	mock_ndef_append(out, 0x01, "T", payload->data, payload->len, mb, me);
+	g_byte_array_unref(payload);
+}
+
+static void mock_ndef_uri(GByteArray *out, const gchar *uri,
+			  gboolean mb, gboolean me)
+{
+	GByteArray	*payload = g_byte_array_new();
+	guint8		prefix = 0x00;	/* no URI abbreviation */
+
+	uri = uri ? uri : "";
+	g_byte_array_append(payload, &prefix, 1);
+	g_byte_array_append(payload, (const guint8 *) uri, strlen(uri));
+	mock_ndef_append(out, 0x01, "U", payload->data, payload->len, mb, me);
+	g_byte_array_unref(payload);
+}
+
+static void mock_ndef_record(GByteArray *out, MockObj *rcd,
+			     gboolean mb, gboolean me)
+{
+	const gchar	*type	= mock_obj_get_str(rcd, "Type");
+	const gchar	*rep	= mock_obj_get_str(rcd, "Representation");
+	const gchar	*lang	= mock_obj_get_str(rcd, "Language");
+	const gchar	*uri	= mock_obj_get_str(rcd, "URI");
+	const gchar	*mime	= mock_obj_get_str(rcd, "MIME");
+
+	if (type != NULL && !strcmp(type, "URI")) {
+		mock_ndef_uri(out, uri, mb, me);
+	} else if (type != NULL && !strcmp(type, "SmartPoster")) {
+		GByteArray *sp = g_byte_array_new();
+
+		mock_ndef_uri(sp, uri, TRUE, rep == NULL);
+		if (rep != NULL)
+			mock_ndef_text(sp, lang, rep, FALSE, TRUE);
+		mock_ndef_append(out, 0x01, "Sp", sp->data, sp->len, mb, me);
+		g_byte_array_unref(sp);
+	} else if (type != NULL && !strcmp(type, "MIME") && mime != NULL) {
+		rep = rep ? rep : "";
+		mock_ndef_append(out, 0x02, mime, (const guint8 *) rep,
+				 strlen(rep), mb, me);
+	} else {
+		mock_ndef_text(out, lang, rep, mb, me);
+	}
+}
+
+static void mock_tag_update_ndef(MockObj *tag)
+{
+	GByteArray	*out = g_byte_array_new();
+	GList		*node;
+
+	for (node = tag->children; node != NULL; node = node->next)
+		mock_ndef_record(out, node->data, node->prev == NULL,
+				 node->next == NULL);
+
+	if (tag->ndef != NULL)
+		g_byte_array_unref(tag->ndef);
+	tag->ndef = out;
+}
+
+static GVariant *mock_tag_ndef_variant(MockObj *tag)
+{
+#if GLIB_CHECK_VERSION(2, 32, 0)
+	return g_variant_new_fixed_array(G_VARIANT_TYPE_BYTE, tag->ndef->data,
+					 tag->ndef->len, sizeof(guint8));
+#else
+	gpointer copy = g_memdup(tag->ndef->data, tag->ndef->len);
+
+	return g_variant_new_from_data(G_VARIANT_TYPE_BYTESTRING, copy,
+				       tag->ndef->len, TRUE, g_free, copy);
+#endif
+}
+
+/* Add the Text or URI fields of a well known record payload */
+static void mock_ndef_decode_wk(GVariantBuilder *b, const gchar *type,
+				const guint8 *p, gsize len)
+{
+	static const gchar * const prefixes[] = {
+		"", "http://www.", "https://www.", "http://", "https://",
+		"tel:", "mailto:"
+	};
+	gchar	*s;
+	guint	langLen;
+
+	if (!strcmp(type, "T") && len >= 1 && 1 + (p[0] & 0x3F) <= len) {
+		langLen = p[0] & 0x3F;
+		s = g_strndup((const gchar *) p + 1, langLen);
+		g_variant_builder_add(b, "{sv}", "Language",
+				      g_variant_new_string(s));
+		g_free(s);
+		g_variant_builder_add(b, "{sv}", "Encoding",
+				      g_variant_new_string(p[0] & 0x80 ?
+							   "UTF-16" : "UTF-8"));
+		s = g_strndup((const gchar *) p + 1 + langLen,
+			      len - 1 - langLen);
+		if (!(p[0] & 0x80) && g_utf8_validate(s, -1, NULL))
+			g_variant_builder_add(b, "{sv}", "Representation",
+					      g_variant_new_string(s));
+		g_free(s);
+	} else if (!strcmp(type, "U") && len >= 1) {
+		s = g_strndup((const gchar *) p + 1, len - 1);
+		if (g_utf8_validate(s, -1, NULL)) {
+			gchar *uri = g_strconcat(p[0] < G_N_ELEMENTS(prefixes) ?
+						 prefixes[p[0]] : "", s, NULL);
+
+			g_variant_builder_add(b, "{sv}", "URI",
+					      g_variant_new_string(uri));
+			g_variant_builder_add(b, "{sv}", "Size",
+					      g_variant_new_uint32(strlen(uri)));
+			g_free(uri);
+		}
+		g_free(s);
+	}
+}
+
+/* Records of a raw NDEF message, as neard announces them (a{sv} each), or
+ * NULL if the message is malformed (chunked records are not supported) */
+static GPtrArray *mock_ndef_decode(const guint8 *data, gsize len)
+{
+	GPtrArray	*out;
+	GVariantBuilder	b;
+	GPtrArray	*nested;
+	gsize		pos = 0, typeLen, idLen, payloadLen;
+	guint8		flags = 0;
+	gchar		*type;
+	const gchar	*kind;
+
+	out = g_ptr_array_new_with_free_func((GDestroyNotify) g_variant_unref);
+	while (pos < len && !(flags & 0x40)) {
+		flags = data[pos++];
+		if ((flags & 0x20) || pos + 2 > len)	/* chunked, truncated */
+			goto error;
+		typeLen = data[pos++];
+		if (flags & 0x10) {
+			payloadLen = data[pos++];
+		} else {
+			if (pos + 4 > len)
+				goto error;
+			payloadLen = (gsize) data[pos] << 24 |
+				     (gsize) data[pos + 1] << 16 |
+				     (gsize) data[pos + 2] << 8 | data[pos + 3];
+			pos += 4;
+		}
+		idLen = 0;
+		if (flags & 0x08) {
+			if (pos + 1 > len)
+				goto error;
+			idLen = data[pos++];
+		}
+		if (pos + typeLen + idLen + payloadLen > len)
+			goto error;
+
+		type = g_strndup((const gchar *) data + pos, typeLen);
+		pos += typeLen + idLen;
+
+		g_variant_builder_init(&b, G_VARIANT_TYPE("a{sv}"));
+		kind = "Unknown";
+		if ((flags & 0x07) == 0x01 && !strcmp(type, "T")) {
+			kind = "Text";
+			mock_ndef_decode_wk(&b, type, data + pos, payloadLen);
+		} else if ((flags & 0x07) == 0x01 && !strcmp(type, "U")) {
+			kind = "URI";
+			mock_ndef_decode_wk(&b, type, data + pos, payloadLen);
+		} else if ((flags & 0x07) == 0x01 && !strcmp(type, "Sp")) {
+			kind = "SmartPoster";
+			nested = mock_ndef_decode(data + pos, payloadLen);
+			if (nested != NULL && nested->len > 0) {
+				GVariantIter	iter;
+				const gchar	*key;
+				GVariant	*value;
+
+				g_variant_iter_init(&iter,
+						    nested->pdata[0]);
+				while (g_variant_iter_next(&iter, "{&sv}",
+							   &key, &value)) {
+					if (strcmp(key, "Type") != 0)
+						g_variant_builder_add(&b,
+							"{sv}", key, value);
+					g_variant_unref(value);
+				}
+			}
+			if (nested != NULL)
+				g_ptr_array_free(nested, TRUE);
+		} else if ((flags & 0x07) == 0x02 &&
+			   g_utf8_validate(type, -1, NULL)) {
+			kind = "MIME";
+			g_variant_builder_add(&b, "{sv}", "MIME",
+					      g_variant_new_string(type));
+		}
+		g_variant_builder_add(&b, "{sv}", "Type",
+				      g_variant_new_string(kind));
+		g_ptr_array_add(out,
+				g_variant_ref_sink(g_variant_builder_end(&b)));
+		g_free(type);
+		pos += payloadLen;
+	}
+
+	if (!(flags & 0x40))
+		goto error;
+
+	return out;
+
+error:
+	g_ptr_array_free(out, TRUE);
+	return NULL;
+}
+
+/* 'NDEF' bytes of a 'Raw' Write, NULL for other record types */
+static GVariant *mock_write_raw_ndef(GVariant *attrs)
+{
+	const gchar *type = NULL;
+
+	if (!g_variant_lookup(attrs, "Type", "&s", &type) ||
+	    strcmp(type, "Raw") != 0)
+		return NULL;
+
+	return g_variant_lookup_value(attrs, "NDEF",
+				      G_VARIANT_TYPE_BYTESTRING);
+}
+
+/*---------------------------------------------------------------------------
+ * Adapters, tags, records, devices
+ ---------------------------------------------------------------------------*/
+MockObj *mock_adapter_add(void)
+{
+	static guint	index;
+	const gchar	*protocols[] = { "Felica", "MIFARE", "Jewel",
+					 "ISO-DEP", "NFC-DEP", NULL };
+	MockObj		*adp;
+
+	adp = mock_obj_new(MOCK_ADAPTER, NULL,
+			   g_strdup_printf(MOCK_ADP_PREFIX "%u", index++));
+	mock_obj_set(adp, "Mode", g_variant_new_string("Idle"));
+	mock_obj_set(adp, "Powered", g_variant_new_boolean(TRUE));
+	mock_obj_set(adp, "Polling", g_variant_new_boolean(FALSE));
+	mock_obj_set(adp, "Protocols", g_variant_new_strv(protocols, -1));
+
+	mock.adapters = g_list_append(mock.adapters, adp);
+	mock_obj_register(adp);
+
+	return adp;
+}
+
+void mock_adapter_remove(MockObj *adp)
+{
+	g_return_if_fail(adp != NULL && adp->kind == MOCK_ADAPTER);
+
+	mock.adapters = g_list_remove(mock.adapters, adp);
+	mock_obj_free(adp);
+}
+
+MockObj *mock_adapter_next(void)
+{
+	guint len = g_list_length(mock.adapters);
+
+	if (len == 0)
+		return NULL;
+
+	return g_list_nth_data(mock.adapters, mock.nextAdapter++ % len);
+}
+
+static MockObj *mock_record_add(MockObj *tag, GVariant *attrs)
+{
+	MockObj		*rcd;
+	GVariantIter	iter;
+	const gchar	*key;
+	GVariant	*value;
+
+	rcd = mock_obj_new(MOCK_RECORD, tag,
+			   g_strdup_printf("%s/record%u", tag->path,
+					   g_list_length(tag->children)));
+
+	g_variant_iter_init(&iter, attrs);
+	while (g_variant_iter_next(&iter, "{&sv}", &key, &value)) {
+		if (strcmp(key, "Name") != 0)
+			mock_obj_set(rcd, key, value);
+		g_variant_unref(value);
+	}
+
+	mock_obj_register(rcd);
+
+	return rcd;
+}
+
+/* Records content of storm tags: alternate Text and URI records */
+static GVariant *mock_record_attrs(MockObj *tag, guint index)
+{
+	GVariantBuilder	b;
+	gchar		*s;
+
+	g_variant_builder_init(&b, G_VARIANT_TYPE("a{sv}"));
+	if (index % 2 == 0) {
+		s = g_strdup_printf("Mock text %u of %s", index, tag->path);
+		g_variant_builder_add(&b, "{sv}", "Type",
+				      g_variant_new_string("Text"));
+		g_variant_builder_add(&b, "{sv}", "Encoding",
+				      g_variant_new_string("UTF-8"));
+		g_variant_builder_add(&b, "{sv}", "Language",
+				      g_variant_new_string("en"));
+		g_variant_builder_add(&b, "{sv}", "Representation",
+				      g_variant_new_string(s));
+	} else {
+		s = g_strdup_printf("http://mock.neard%s/%u", tag->path,
+				    index);
+		g_variant_builder_add(&b, "{sv}", "Type",
+				      g_variant_new_string("URI"));
+		g_variant_builder_add(&b, "{sv}", "URI",
+				      g_variant_new_string(s));
+		g_variant_builder_add(&b, "{sv}", "Size",
+				      g_variant_new_uint32(strlen(s)));
+	}
+	g_free(s);
+
+	return g_variant_ref_sink(g_variant_builder_end(&b));
+}
+
+static void mock_agents_notify(MockObj *tag)
+{
+	GList		*node, *rcd;
+	MockAgent	*agent;
+	GVariantBuilder	records;
+	GVariant	*values;
+	gboolean	match;
+
+	for (node = mock.agents; node != NULL; node = node->next) {
+		agent = node->data;
+
+		match = FALSE;
+		g_variant_builder_init(&records, G_VARIANT_TYPE("ao"));
+		for (rcd = tag->children; rcd != NULL; rcd = rcd->next) {
+			MockObj *r = rcd->data;
+			const gchar *type = mock_obj_get_str(r, "Type");
+
+			g_variant_builder_add(&records, "o", r->path);
+			if (type != NULL && !strcmp(type, agent->type))
+				match = TRUE;
+		}
+
+		if (!match) {
+			g_variant_builder_clear(&records);
+			continue;
+		}
+
+		values = g_variant_new_parsed("{'Records': <%@ao>, "
+					"'NDEF': <%@ay>}",
+					g_variant_builder_end(&records),
+					mock_tag_ndef_variant(tag));
+
+		g_dbus_connection_call(mock.conn, agent->sender, agent->path,
+				       "org.neard.NDEFAgent", "GetNDEF",
+				       g_variant_new("(@a{sv})", values),
+				       NULL, G_DBUS_CALL_FLAGS_NONE, -1,
+				       NULL, NULL, NULL);
+	}
+}
+
+static void mock_ctl_emit_tag_injected(MockObj *tag, guint64 timestamp)
+{
+	g_dbus_connection_emit_signal(mock.conn, NULL, MOCK_CTL_PATH,
+				      MOCK_CTL_IFACE, "TagInjected",
+				      g_variant_new("(ot)", tag->path,
+						    timestamp),
+				      NULL);
+}
+
+static gboolean mock_tag_dwell_cb(gpointer user_data)
+{
+	MockObj *tag = user_data;
+
+	tag->dwellId = 0;
+	mock_tag_remove(tag);
+
+	return FALSE;
+}
+
+MockObj *mock_tag_add(MockObj *adapter, guint nbRecords)
+{
+	MockObj		*tag;
+	GVariant	*attrs;
+	GList		*node;
+	guint		i;
+	guint64		timestamp = mock_now();
+
+	g_return_val_if_fail(adapter != NULL, NULL);
+
+	tag = mock_obj_new(MOCK_TAG, adapter,
+			   g_strdup_printf("%s/tag%u", adapter->path,
+					   adapter->nextTag++));
+	mock_obj_set(tag, "Type", g_variant_new_string("Type 2"));
+	mock_obj_set(tag, "Protocol", g_variant_new_string("MIFARE"));
+	mock_obj_set(tag, "ReadOnly", g_variant_new_boolean(FALSE));
+	mock_obj_set(tag, "Adapter", g_variant_new_object_path(adapter->path));
+
+	for (i = 0; i < nbRecords; i++) {
+		attrs = mock_record_attrs(tag, i);
+		mock_record_add(tag, attrs);
+		g_variant_unref(attrs);
+	}
+	mock_tag_update_ndef(tag);
+	mock_obj_register(tag);
+
+	/* neard announces the tag, then each of its records */
+	mock_ctl_emit_tag_injected(tag, timestamp);
+	mock_obj_announce(tag);
+	for (node = tag->children; node != NULL; node = node->next)
+		mock_obj_announce(node->data);
+
+	mock_agents_notify(tag);
+
+	if (mock.dwell > 0)
+		tag->dwellId = g_timeout_add(mock.dwell, mock_tag_dwell_cb,
+					     tag);
+	mock.tagsCreated++;
+
+	return tag;
+}
+
+void mock_tag_remove(MockObj *tag)
+{
+	g_return_if_fail(tag != NULL && tag->kind == MOCK_TAG);
+
+	mock.tagsRemoved++;
+	mock_obj_free(tag);
+}
+
+MockObj *mock_device_add(MockObj *adapter)
+{
+	MockObj *dev;
+
+	g_return_val_if_fail(adapter != NULL, NULL);
+
+	dev = mock_obj_new(MOCK_DEVICE, adapter,
+			   g_strdup_printf("%s/device%u", adapter->path,
+					   adapter->nextDev++));
+	mock_obj_set(dev, "Adapter", g_variant_new_object_path(adapter->path));
+	mock_obj_register(dev);
+	mock_obj_announce(dev);
+
+	return dev;
+}
+
+void mock_device_remove(MockObj *dev)
+{
+	g_return_if_fail(dev != NULL && dev->kind == MOCK_DEVICE);
+
+	mock_obj_free(dev);
+}
+
+void mock_remove_all(MockKind kind)
+{
+	GList	*adp, *node, *next;
+
+	for (adp = mock.adapters; adp != NULL; adp = adp->next)
+		for (node = ((MockObj *) adp->data)->children; node != NULL;
+		     node = next) {
+			MockObj *obj = node->data;
+
+			next = node->next;
+			if (obj->kind != kind)
+				continue;
+			if (kind == MOCK_TAG)
+				mock_tag_remove(obj);
+			else
+				mock_device_remove(obj);
+		}
+}
+
+static guint mock_count(MockKind kind)
+{
+	GList	*adp, *node;
+	guint	count = 0;
+
+	for (adp = mock.adapters; adp != NULL; adp = adp->next)
+		for (node = ((MockObj *) adp->data)->children; node != NULL;
+		     node = node->next)
+			if (((MockObj *) node->data)->kind == kind)
+				count++;
+
+	return count;
+}
+
+/*---------------------------------------------------------------------------
+ * Delayed Write / Push
+ ---------------------------------------------------------------------------*/
+static void mock_tag_write(MockObj *tag, GVariant *attrs)
+{
+	GVariant	*ndef = mock_write_raw_ndef(attrs);
+	GPtrArray	*records;
+	const guint8	*data;
+	gsize		len;
+	GList		*node;
+	guint		i;
+
+	while (tag->children != NULL)
+		mock_obj_free(tag->children->data);
+
+	if (ndef == NULL) {
+		mock_record_add(tag, attrs);
+		mock_tag_update_ndef(tag);
+		mock_obj_announce(tag->children->data);
+		return;
+	}
+
+	/* Raw: the message is kept as written, checked by mock_tag_call() */
+	data = g_variant_get_fixed_array(ndef, &len, sizeof(guint8));
+	records = mock_ndef_decode(data, len);
+	for (i = 0; records != NULL && i < records->len; i++)
+		mock_record_add(tag, records->pdata[i]);
+	if (records != NULL)
+		g_ptr_array_free(records, TRUE);
+
+	if (tag->ndef != NULL)
+		g_byte_array_unref(tag->ndef);
+	tag->ndef = g_byte_array_sized_new(len);
+	g_byte_array_append(tag->ndef, data, len);
+	g_variant_unref(ndef);
+
+	for (node = tag->children; node != NULL; node = node->next)
+		mock_obj_announce(node->data);
+}
+
+static gboolean mock_pending_cb(gpointer user_data)
+{
+	MockPending	*pending = user_data;
+	MockObj		*obj = pending->obj;
+
+	pending->id = 0;
+	obj->pending = g_list_remove(obj->pending, pending);
+
+	if (obj->kind == MOCK_TAG)
+		mock_tag_write(obj, pending->attrs);
+
+	g_dbus_method_invocation_return_value(pending->invocation, NULL);
+	mock_pending_free(pending, NULL);
+
+	return FALSE;
+}
+
+static void mock_pending_add(MockObj *obj, GDBusMethodInvocation *invocation,
+			     GVariant *parameters)
+{
+	MockPending *pending = g_new0(MockPending, 1);
+
+	pending->obj = obj;
+	pending->invocation = invocation;
+	g_variant_get(parameters, "(@a{sv})", &pending->attrs);
+
+	obj->pending = g_list_append(obj->pending, pending);
+	if (mock.writeLatency > 0)
+		pending->id = g_timeout_add(mock.writeLatency,
+					    mock_pending_cb, pending);
+	else
+		mock_pending_cb(pending);
+}
+
+/*---------------------------------------------------------------------------
+ * DBus interfaces
+ ---------------------------------------------------------------------------*/
+static void mock_get_managed_objects(GDBusMethodInvocation *invocation)
+{
+	GVariantBuilder	b;
+	GList		*adp, *node, *rcd;
+
+	g_variant_builder_init(&b, G_VARIANT_TYPE("a{oa{sa{sv}}}"));
+	for (adp = mock.adapters; adp != NULL; adp = adp->next) {
+		MockObj *a = adp->data;
+
+		g_variant_builder_add(&b, "{o@a{sa{sv}}}", a->path,
+				      mock_obj_ifaces(a));
+		for (node = a->children; node != NULL; node = node->next) {
+			MockObj *o = node->data;
+
+			g_variant_builder_add(&b, "{o@a{sa{sv}}}", o->path,
+					      mock_obj_ifaces(o));
+			for (rcd = o->children; rcd != NULL; rcd = rcd->next)
+				g_variant_builder_add(&b, "{o@a{sa{sv}}}",
+					((MockObj *) rcd->data)->path,
+					mock_obj_ifaces(rcd->data));
+		}
+	}
+
+	g_dbus_method_invocation_return_value(invocation,
+					      g_variant_new("(a{oa{sa{sv}}})",
+							    &b));
+}
+
+static void mock_manager_call(const gchar *sender, const gchar *method,
+			      GVariant *parameters,
+			      GDBusMethodInvocation *invocation)
+{
+	const gchar	*path, *type;
+	GList		*node;
+
+	if (!strcmp(method, "GetProperties")) {
+		GVariantBuilder b;
+
+		g_variant_builder_init(&b, G_VARIANT_TYPE("ao"));
+		for (node = mock.adapters; node != NULL; node = node->next)
+			g_variant_builder_add(&b, "o",
+					      ((MockObj *) node->data)->path);
+		g_dbus_method_invocation_return_value(invocation,
+			g_variant_new_parsed("({'Adapters': <%@ao>},)",
+					     g_variant_builder_end(&b)));
+		return;
+	}
+
+	if (!strcmp(method, "RegisterNDEFAgent")) {
+		MockAgent *agent = g_new0(MockAgent, 1);
+
+		g_variant_get(parameters, "(&o&s)", &path, &type);
+		agent->sender = g_strdup(sender);
+		agent->path = g_strdup(path);
+		agent->type = g_strdup(type);
+		mock.agents = g_list_append(mock.agents, agent);
+	} else if (!strcmp(method, "UnregisterNDEFAgent")) {
+		g_variant_get(parameters, "(&o&s)", &path, &type);
+		for (node = mock.agents; node != NULL; node = node->next) {
+			MockAgent *agent = node->data;
+
+			if (strcmp(agent->path, path) ||
+			    strcmp(agent->sender, sender))
+				continue;
+			mock.agents = g_list_delete_link(mock.agents, node);
+			g_free(agent->sender);
+			g_free(agent->path);
+			g_free(agent->type);
+			g_free(agent);
+			break;
+		}
+	}
+	/* SetProperty, (Un)RegisterHandoverAgent: accepted, nothing to do */
+
+	g_dbus_method_invocation_return_value(invocation, NULL);
+}
+
+static void mock_adapter_call(MockObj *adp, const gchar *method,
+			      GVariant *parameters,
+			      GDBusMethodInvocation *invocation)
+{
+	GVariant	*polling = g_hash_table_lookup(adp->props, "Polling");
+	gboolean	start = !strcmp(method, "StartPollLoop");
+	const gchar	*mode = "Idle";
+
+	if (g_variant_get_boolean(polling) == start) {
+		g_dbus_method_invocation_return_dbus_error(invocation,
+			start ? "org.neard.Error.InProgress" :
+				"org.neard.Error.NotReady",
+			start ? "Already polling" : "Not polling");
+		return;
+	}
+
+	if (start)
+		g_variant_get(parameters, "(&s)", &mode);
+
+	mock_obj_set(adp, "Polling", g_variant_new_boolean(start));
+	mock_obj_set(adp, "Mode", g_variant_new_string(mode));
+	g_dbus_method_invocation_return_value(invocation, NULL);
+
+	mock_obj_emit_changed(adp, "Polling");
+	mock_obj_emit_changed(adp, "Mode");
+}
+
+/* FALSE if a 'Raw' Write carries a malformed message */
+static gboolean mock_tag_check_raw(GVariant *parameters)
+{
+	GVariant	*attrs, *ndef;
+	GPtrArray	*records = NULL;
+	const guint8	*data;
+	gsize		len;
+	gboolean	ok = TRUE;
+
+	g_variant_get(parameters, "(@a{sv})", &attrs);
+	ndef = mock_write_raw_ndef(attrs);
+	if (ndef != NULL) {
+		data = g_variant_get_fixed_array(ndef, &len, sizeof(guint8));
+		records = mock_ndef_decode(data, len);
+		ok = records != NULL && records->len > 0;
+		g_variant_unref(ndef);
+	}
+	if (records != NULL)
+		g_ptr_array_free(records, TRUE);
+	g_variant_unref(attrs);
+
+	return ok;
+}
+
+static void mock_tag_call(MockObj *tag, const gchar *method,
+			  GVariant *parameters,
+			  GDBusMethodInvocation *invocation)
+{
+	GVariant *ro = g_hash_table_lookup(tag->props, "ReadOnly");
+
+	if (!strcmp(method, "GetRawNDEF")) {
+		g_dbus_method_invocation_return_value(invocation,
+			g_variant_new("(@ay)", mock_tag_ndef_variant(tag)));
+		return;
+	}
+
+	/* Write */
+	if (g_variant_get_boolean(ro)) {
+		g_dbus_method_invocation_return_dbus_error(invocation,
+				"org.neard.Error.PermissionDenied",
+				"Read-only tag");
+		return;
+	}
+
+	if (!mock_tag_check_raw(parameters)) {
+		g_dbus_method_invocation_return_dbus_error(invocation,
+				"org.neard.Error.InvalidArguments",
+				"Invalid NDEF message");
+		return;
+	}
+
+	mock.writes++;
+	mock_pending_add(tag, invocation, parameters);
+}
+
+static void mock_ctl_call(const gchar *method, GVariant *parameters,
+			  GDBusMethodInvocation *invocation)
+{
+	GVariant	*ret = NULL;
+	guint		count, i;
+	gint		value;
+	gdouble		rate;
+
+	if (!strcmp(method, "InjectTags")) {
+		g_variant_get(parameters, "(u)", &count);
+		for (i = 0; i < count; i++)
+			if (mock_tag_add(mock_adapter_next(),
+					 mock.records) == NULL)
+				break;
+		ret = g_variant_new("(u)", i);
+	} else if (!strcmp(method, "RemoveTags")) {
+		count = mock_count(MOCK_TAG);
+		mock_remove_all(MOCK_TAG);
+		ret = g_variant_new("(u)", count);
+	} else if (!strcmp(method, "InjectDevice")) {
+		MockObj *dev = mock_device_add(mock_adapter_next());
+
+		if (dev == NULL) {
+			g_dbus_method_invocation_return_dbus_error(invocation,
+					"org.neard.Error.NotReady",
+					"No adapter");
+			return;
+		}
+		ret = g_variant_new("(o)", dev->path);
+	} else if (!strcmp(method, "RemoveDevices")) {
+		mock_remove_all(MOCK_DEVICE);
+	} else if (!strcmp(method, "SetAdapters")) {
+		g_variant_get(parameters, "(u)", &count);
+		while (g_list_length(mock.adapters) < count)
+			mock_adapter_add();
+		while (g_list_length(mock.adapters) > count)
+			mock_adapter_remove(g_list_last(mock.adapters)->data);
+	} else if (!strcmp(method, "StartStorm")) {
+		g_variant_get(parameters, "(di)", &rate, &value);
+		mock_storm_start(rate, value);
+	} else if (!strcmp(method, "StopStorm")) {
+		mock_storm_stop();
+	} else if (!strcmp(method, "SetRecords")) {
+		g_variant_get(parameters, "(i)", &mock.records);
+	} else if (!strcmp(method, "SetDwell")) {
+		g_variant_get(parameters, "(i)", &mock.dwell);
+	} else if (!strcmp(method, "SetWriteLatency")) {
+		g_variant_get(parameters, "(i)", &mock.writeLatency);
+	} else if (!strcmp(method, "GetStats")) {
+		ret = g_variant_new_parsed("({'TagsCreated': <%t>, "
+					   "'TagsRemoved': <%t>, "
+					   "'Tags': <%u>, "
+					   "'Adapters': <%u>, "
+					   "'Writes': <%t>, "
+					   "'Pushes': <%t>},)",
+					   mock.tagsCreated, mock.tagsRemoved,
+					   mock_count(MOCK_TAG),
+					   g_list_length(mock.adapters),
+					   mock.writes, mock.pushes);
+	} else if (!strcmp(method, "Quit")) {
+		mock_quit();
+	}
+
+	g_dbus_method_invocation_return_value(invocation, ret);
+}
+
+static void mock_method_call(GDBusConnection *conn, const gchar *sender,
+			     const gchar *path, const gchar *iface,
+			     const gchar *method, GVariant *parameters,
+			     GDBusMethodInvocation *invocation,
+			     gpointer user_data)
+{
+	MockObj *obj = user_data;
+
+	(void) conn;
+	(void) path;
+
+	if (!strcmp(iface, "org.freedesktop.DBus.ObjectManager"))
+		mock_get_managed_objects(invocation);
+	else if (!strcmp(iface, "org.neard.Manager"))
+		mock_manager_call(sender, method, parameters, invocation);
+	else if (!strcmp(iface, MOCK_CTL_IFACE))
+		mock_ctl_call(method, parameters, invocation);
+	else if (obj->kind == MOCK_ADAPTER)
+		mock_adapter_call(obj, method, parameters, invocation);
+	else if (obj->kind == MOCK_TAG)
+		mock_tag_call(obj, method, parameters, invocation);
+	else if (obj->kind == MOCK_DEVICE) {
+		mock.pushes++;
+		mock_pending_add(obj, invocation, parameters);
+	} else
+		g_dbus_method_invocation_return_dbus_error(invocation,
+				"org.freedesktop.DBus.Error.UnknownMethod",
+				method);
+}
+
+static GVariant *mock_get_property(GDBusConnection *conn,
+				   const gchar *sender, const gchar *path,
+				   const gchar *iface, const gchar *name,
+				   GError **error, gpointer user_data)
+{
+	MockObj		*obj = user_data;
+	GVariant	*value;
+
+	(void) conn;
+	(void) sender;
+	(void) path;
+	(void) iface;
+
+	value = obj ? g_hash_table_lookup(obj->props, name) : NULL;
+	if (value == NULL) {
+		g_set_error(error, G_DBUS_ERROR, G_DBUS_ERROR_INVALID_ARGS,
+			    "No such property '%s'", name);
+		return NULL;
+	}
+
+	return g_variant_ref(value);
+}
+
+static gboolean mock_set_property(GDBusConnection *conn,
+				  const gchar *sender, const gchar *path,
+				  const gchar *iface, const gchar *name,
+				  GVariant *value, GError **error,
+				  gpointer user_data)
+{
+	MockObj *obj = user_data;
+
+	(void) conn;
+	(void) sender;
+	(void) path;
+	(void) iface;
+	(void) error;
+
+	mock_obj_set(obj, name, value);
+	mock_obj_emit_changed(obj, name);
+
+	return TRUE;
+}
+
+static const GDBusInterfaceVTable sVtable = {
+	mock_method_call,
+	mock_get_property,
+	mock_set_property,
+	{ NULL }
+};
+
+/*****************************************************************************
+ * mock_bus_init: export the manager, control interface and adapters
+ ****************************************************************************/
+gboolean mock_bus_init(GError **error)
+{
+	const gchar	*ifaces[] = { "org.freedesktop.DBus.ObjectManager",
+				      "org.neard.Manager" };
+	gint		i, j;
+
+	sInfo = g_dbus_node_info_new_for_xml(sIntrospection, error);
+	if (sInfo == NULL)
+		return FALSE;
+
+	for (i = 0; i < (gint) G_N_ELEMENTS(ifaces); i++)
+		if (g_dbus_connection_register_object(mock.conn, MOCK_MGR_PATH,
+			g_dbus_node_info_lookup_interface(sInfo, ifaces[i]),
+			&sVtable, NULL, NULL, error) == 0)
+			return FALSE;
+
+	if (g_dbus_connection_register_object(mock.conn, MOCK_CTL_PATH,
+			g_dbus_node_info_lookup_interface(sInfo,
+							  MOCK_CTL_IFACE),
+			&sVtable, NULL, NULL, error) == 0)
+		return FALSE;
+
+	for (i = 0; i < mock.nbAdapters; i++)
+		mock_adapter_add();
+
+	/* Initial tags stay until removed */
+	for (i = 0; i < mock.nbAdapters; i++) {
+		MockObj *adp = g_list_nth_data(mock.adapters, i);
+
+		for (j = 0; j < mock.initialTags; j++) {
+			MockObj *tag = mock_tag_add(adp, mock.records);
+
+			if (tag->dwellId != 0) {
+				g_source_remove(tag->dwellId);
+				tag->dwellId = 0;
+			}
+		}
+	}
+
+	return TRUE;
+}
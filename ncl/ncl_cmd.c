@@ -28,6 +28,7 @@
 #include <glib-object.h>
 
 #include "neardal.h"
+#include "neardal_perso.h"
 #include "ncl.h"
 #include "ncl_cmd.h"
 
@@ -1144,6 +1145,90 @@ static NCLError ncl_cmd_stop_poll(int argc, char *argv[])
  ****************************************************************************/
 
 
+/*****************************************************************************
+ * ncl_cmd_perso : BEGIN
+ * Write the rows of a CSV or NDJSON file to the tags presented one by one
+ ****************************************************************************/
+static neardal_perso *sNclPerso;
+
+static void ncl_cmd_perso_cb(const neardal_perso_result *result,
+			     void *user_data)
+{
+	neardal_perso_stats	stats;
+
+	(void) user_data;
+
+	if (result != NULL) {
+		if (result->error == NEARDAL_SUCCESS)
+			NCL_CMD_PRINT("Row %llu written to '%s' (%u attempt(s)"
+				      ", %llu us)\n", result->row,
+				      result->tagName, result->attempts,
+				      (result->doneNs - result->foundNs) / 1000);
+		else
+			NCL_CMD_PRINT("Row %llu failed (%u attempt(s)): %d='%s'"
+				      "\n", result->row, result->attempts,
+				      result->error,
+				      neardal_error_get_text(result->error));
+		return;
+	}
+
+	neardal_perso_get_stats(sNclPerso, &stats);
+	NCL_CMD_PRINTF("Personalisation done: %llu rows, %llu written, %llu "
+		       "failed, %llu invalid, %llu retries\n", stats.rows,
+		       stats.written, stats.failed, stats.invalid,
+		       stats.retries);
+	NCL_CMD_PRINT("%.1f writes/s, tag found to write %llu us, to done %llu "
+		      "us (mean)\n", stats.writesPerSec,
+		      stats.meanFoundToWriteNs / 1000,
+		      stats.meanFoundToDoneNs / 1000);
+
+	/* Run over: a new one may start */
+	neardal_perso_stop(sNclPerso);
+	sNclPerso = NULL;
+}
+
+static NCLError ncl_cmd_perso(int argc, char *argv[])
+{
+	errorCode_t	ec;
+
+	if (argc <= 1)
+		return NCLERR_PARSING_PARAMETERS;
+
+	if (!strcmp(argv[1], "--stop")) {
+		if (sNclPerso == NULL) {
+			NCL_CMD_PRINTF("No personalisation running\n");
+			return NCLERR_GLOBAL_ERROR;
+		}
+		neardal_perso_stop(sNclPerso);
+		sNclPerso = NULL;
+		return NCLERR_NOERROR;
+	}
+
+	if (sNclPerso != NULL) {
+		NCL_CMD_PRINTF("Personalisation already running (--stop)\n");
+		return NCLERR_GLOBAL_ERROR;
+	}
+
+	/* Install Neardal Callback*/
+	if (sNclCmdCtx.cb_initialized == false)
+		ncl_cmd_install_callback();
+
+	ec = neardal_perso_start(argv[1], ncl_cmd_perso_cb, NULL, &sNclPerso);
+	if (ec != NEARDAL_SUCCESS) {
+		NCL_CMD_PRINTF("Personalisation error:%d='%s'.\n", ec,
+			       neardal_error_get_text(ec));
+		return NCLERR_LIB_ERROR;
+	}
+	NCL_CMD_PRINTF("Present tags to write the rows of '%s' ('perso --stop'"
+		       " to stop)\n", argv[1]);
+
+	return NCLERR_NOERROR;
+}
+/*****************************************************************************
+ * ncl_cmd_perso : END
+ ****************************************************************************/
+
+
 /*****************************************************************************
  * ncl_cmd_(un)register_NDEF_agent : BEGIN
  * Handle a record macthing a registered tag type
@@ -1714,6 +1799,10 @@ static NCLCmdInterpretor itFunc[] = {
 	ncl_cmd_list,
 	"List all available commands. 'cmd' --help -h /? for a specific help" },
 
+	{ "perso",
+	ncl_cmd_perso,
+	"Write a CSV/NDJSON file to tags, a row per tag ('--stop' to stop)"},
+
 	{ "push",
 	ncl_cmd_push,
 	"Creates and push a NDEF record to a NFC device"},
@@ -0,0 +1,318 @@
+/*
+ *     NEARDAL (Neard Abstraction Library)
+ *
+ *     Copyright 2014 Intel Corporation. All rights reserved.
+ *
+ *     This program is free software; you can redistribute it and/or modify
+ *     it under the terms of the GNU Lesser General Public License version 2
+ *     as published by the Free Software Foundation.
+ *
+ *     This program is distributed in the hope that it will be useful,
+ *     but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *     MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *     GNU General Public License for more details.
+ *
+ *     You should have received a copy of the GNU General Public License
+ *     along with this program; if not, write to the Free Software Foundation,
+ *     Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+/* test-sim: NEARDAL checks on the in-process simulator (no DBus, no neard),
+ * run by 'make check' */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <glib.h>
+
+#include "neardal.h"
+#include "neardal_sim.h"
+#include "neardal_capture.h"
+#include "neardal_capture_prv.h"
+
+#define TEST_SIM_ADAPTER	"/org/neard/nfc0"
+
+/*****************************************************************************
+ * test_sim_add_tag: new writable tag on the test adapter
+ ****************************************************************************/
+static void test_sim_add_tag(const char *tagName)
+{
+	g_assert_cmpint(neardal_sim_add_tag(tagName, "Type 2", 0), ==,
+			NEARDAL_SUCCESS);
+}
+
+/*****************************************************************************
+ * test_sim_record: properties of the only record of a tag
+ ****************************************************************************/
+static neardal_record *test_sim_record(const char *tagName)
+{
+	neardal_record	*record	= NULL;
+	char		**names	= NULL;
+	int		len	= 0;
+
+	g_assert_cmpint(neardal_get_records((char *) tagName, &names, &len),
+			==, NEARDAL_SUCCESS);
+	g_assert_cmpint(len, ==, 1);
+	g_assert_cmpint(neardal_get_record_properties(names[0], &record), ==,
+			NEARDAL_SUCCESS);
+	neardal_free_array(&names);
+
+	return record;
+}
+
+/* A Smart Poster split in two chunks: its nested records can't be walked */
+static void test_sim_write_raw_chunked_sp(void)
+{
+	static const unsigned char ndef[] = {
+		/* MB, CF, SR, well known "Sp", first 8 payload bytes */
+		0xB1, 0x02, 0x08, 'S', 'p',
+		0xD1, 0x01, 0x0C, 'U', 0x01, 'e', 'x', 'a',
+		/* ME, SR, unchanged, last 8 payload bytes */
+		0x56, 0x00, 0x08,
+		'm', 'p', 'l', 'e', '.', 'c', 'o', 'm'
+	};
+	const char	*tagName = TEST_SIM_ADAPTER "/tag0";
+	neardal_record	*record;
+
+	test_sim_add_tag(tagName);
+
+	g_assert_cmpint(neardal_tag_write_raw(tagName, ndef, sizeof(ndef)),
+			==, NEARDAL_SUCCESS);
+
+	record = test_sim_record(tagName);
+	g_assert_cmpstr(record->type, ==, "SmartPoster");
+	g_assert(record->uri == NULL);
+	neardal_free_record(record);
+
+	neardal_sim_remove_tag(tagName);
+}
+
+/* Raw NDEF read: the bytes written, external type and record id included */
+static void test_sim_raw_ndef_round_trip(void)
+{
+	static const unsigned char ndef[] = {
+		/* MB, ME, SR, IL, external "a.b:c", id "id", payload */
+		0xDC, 0x05, 0x03, 0x02, 'a', '.', 'b', ':', 'c', 'i', 'd',
+		0x01, 0x02, 0x03
+	};
+	const char		*tagName = TEST_SIM_ADAPTER "/tag1";
+	neardal_raw_ndef	*raw	= NULL;
+
+	test_sim_add_tag(tagName);
+
+	g_assert_cmpint(neardal_tag_write_raw(tagName, ndef, sizeof(ndef)),
+			==, NEARDAL_SUCCESS);
+	g_assert_cmpint(neardal_tag_get_raw_ndef(tagName, &raw), ==,
+			NEARDAL_SUCCESS);
+	g_assert_cmpuint(raw->len, ==, sizeof(ndef));
+	g_assert(memcmp(raw->data, ndef, sizeof(ndef)) == 0);
+	neardal_free_raw_ndef(raw);
+
+	neardal_sim_remove_tag(tagName);
+}
+
+/* Verified write outcome */
+typedef struct {
+	gboolean		done;
+	neardal_verify_result	result;
+} TestSimVerify;
+
+static void test_sim_verify_cb(const neardal_verify_result *result,
+			       void *user_data)
+{
+	TestSimVerify	*verify = user_data;
+
+	verify->result = *result;
+	verify->result.tagName = NULL;
+	verify->done = TRUE;
+}
+
+/* Verified write of a MIME record with an id: read back as written */
+static void test_sim_write_verify_mime(void)
+{
+	static const unsigned char ndef[] = {
+		/* MB, ME, SR, IL, MIME "text/plain", id "x1", payload */
+		0xDA, 0x0A, 0x02, 0x02,
+		't', 'e', 'x', 't', '/', 'p', 'l', 'a', 'i', 'n',
+		'x', '1', 'h', 'i'
+	};
+	const char	*tagName = TEST_SIM_ADAPTER "/tag2";
+	TestSimVerify	verify;
+
+	test_sim_add_tag(tagName);
+
+	memset(&verify, 0, sizeof(verify));
+	g_assert_cmpint(neardal_tag_write_verify(tagName, ndef, sizeof(ndef),
+						 100, test_sim_verify_cb,
+						 &verify), ==,
+			NEARDAL_SUCCESS);
+	/* The simulator completes writes from the main loop */
+	while (!verify.done)
+		g_main_context_iteration(NULL, TRUE);
+
+	g_assert_cmpint(verify.result.status, ==, NEARDAL_VERIFY_OK);
+	g_assert_cmpint(verify.result.error, ==, NEARDAL_SUCCESS);
+	g_assert_cmpuint(verify.result.reads, ==, 1);
+
+	neardal_sim_remove_tag(tagName);
+}
+
+/*****************************************************************************
+ * test_sim_capture_event: append an event to a capture being built
+ ****************************************************************************/
+static void test_sim_capture_event(GByteArray *capture, guint8 kind,
+				   const char *path, GVariant *data)
+{
+	guint64		ts	= 0;
+	guint16		pathLen	= GUINT16_TO_LE(strlen(path));
+	guint32		dataLen;
+
+	g_variant_ref_sink(data);
+	dataLen = GUINT32_TO_LE(g_variant_get_size(data));
+
+	g_byte_array_append(capture, &kind, 1);
+	g_byte_array_append(capture, (guint8 *) &ts, sizeof(ts));
+	g_byte_array_append(capture, (guint8 *) &pathLen, sizeof(pathLen));
+	g_byte_array_append(capture, (const guint8 *) path, strlen(path));
+	g_byte_array_append(capture, (guint8 *) &dataLen, sizeof(dataLen));
+	g_byte_array_append(capture, g_variant_get_data(data),
+			    g_variant_get_size(data));
+	g_variant_unref(data);
+}
+
+/*****************************************************************************
+ * test_sim_replay_raw_ndef_replies: replay a capture of 'nb' identical
+ * 'GetRawNDEF' replies for a tag
+ ****************************************************************************/
+static void test_sim_replay_raw_ndef_replies(const char *tagName,
+					     const unsigned char *ndef,
+					     gsize len, guint nb)
+{
+	GByteArray	*capture;
+	gchar		*fileName = NULL;
+	unsigned int	nbEvents = 0;
+	gint		fd;
+	guint		i;
+
+	capture = g_byte_array_new();
+	g_byte_array_append(capture, (const guint8 *) "NDALCAP1", 8);
+	for (i = 0; i < nb; i++)
+		test_sim_capture_event(capture, NEARDAL_CAPTURE_TAG_RAW_NDEF,
+				       tagName,
+				       g_variant_new("(i@ay)", NEARDAL_SUCCESS,
+					g_variant_new_from_data(
+						G_VARIANT_TYPE_BYTESTRING,
+						ndef, len, TRUE, NULL, NULL)));
+	fd = g_file_open_tmp("test-sim-XXXXXX", &fileName, NULL);
+	g_assert(fd >= 0);
+	close(fd);
+	g_assert(g_file_set_contents(fileName, (gchar *) capture->data,
+				     capture->len, NULL));
+	g_byte_array_free(capture, TRUE);
+
+	g_assert_cmpint(neardal_replay(fileName, 0, &nbEvents), ==,
+			NEARDAL_SUCCESS);
+	g_assert_cmpuint(nbEvents, ==, nb);
+	remove(fileName);
+	g_free(fileName);
+}
+
+/* Replayed 'GetRawNDEF' reply: the captured bytes, once, then the
+ * simulator's */
+static void test_sim_replay_raw_ndef(void)
+{
+	static const unsigned char written[] = {
+		/* MB, ME, SR, well known "T", "en" "ok" */
+		0xD1, 0x01, 0x05, 'T', 0x02, 'e', 'n', 'o', 'k'
+	};
+	static const unsigned char captured[] = {
+		/* MB, ME, SR, well known "T", "en" "hi" */
+		0xD1, 0x01, 0x05, 'T', 0x02, 'e', 'n', 'h', 'i'
+	};
+	const char		*tagName = TEST_SIM_ADAPTER "/tag3";
+	neardal_raw_ndef	*raw	= NULL;
+
+	test_sim_add_tag(tagName);
+	g_assert_cmpint(neardal_tag_write_raw(tagName, written,
+					      sizeof(written)), ==,
+			NEARDAL_SUCCESS);
+
+	test_sim_replay_raw_ndef_replies(tagName, captured, sizeof(captured),
+					 1);
+
+	g_assert_cmpint(neardal_tag_get_raw_ndef(tagName, &raw), ==,
+			NEARDAL_SUCCESS);
+	g_assert_cmpuint(raw->len, ==, sizeof(captured));
+	g_assert(memcmp(raw->data, captured, sizeof(captured)) == 0);
+	neardal_free_raw_ndef(raw);
+
+	g_assert_cmpint(neardal_tag_get_raw_ndef(tagName, &raw), ==,
+			NEARDAL_SUCCESS);
+	g_assert_cmpuint(raw->len, ==, sizeof(written));
+	g_assert(memcmp(raw->data, written, sizeof(written)) == 0);
+	neardal_free_raw_ndef(raw);
+
+	neardal_sim_remove_tag(tagName);
+}
+
+/* Verified write read back twice with the same other message: mismatch,
+ * without waiting for the deadline */
+static void test_sim_write_verify_mismatch(void)
+{
+	static const unsigned char ndef[] = {
+		/* MB, ME, SR, well known "T", "en" "ok" */
+		0xD1, 0x01, 0x05, 'T', 0x02, 'e', 'n', 'o', 'k'
+	};
+	static const unsigned char other[] = {
+		/* MB, ME, SR, well known "T", "en" "ko" */
+		0xD1, 0x01, 0x05, 'T', 0x02, 'e', 'n', 'k', 'o'
+	};
+	const char	*tagName = TEST_SIM_ADAPTER "/tag4";
+	TestSimVerify	verify;
+
+	test_sim_add_tag(tagName);
+	test_sim_replay_raw_ndef_replies(tagName, other, sizeof(other), 2);
+
+	memset(&verify, 0, sizeof(verify));
+	g_assert_cmpint(neardal_tag_write_verify(tagName, ndef, sizeof(ndef),
+						 60000, test_sim_verify_cb,
+						 &verify), ==,
+			NEARDAL_SUCCESS);
+	while (!verify.done)
+		g_main_context_iteration(NULL, TRUE);
+
+	g_assert_cmpint(verify.result.status, ==, NEARDAL_VERIFY_MISMATCH);
+	g_assert_cmpuint(verify.result.reads, ==, 2);
+	g_assert_cmpuint(verify.result.verifiedNs - verify.result.doneNs, <,
+			 G_GUINT64_CONSTANT(1000000000));
+
+	neardal_sim_remove_tag(tagName);
+}
+
+int main(int argc, char *argv[])
+{
+	int	ret;
+
+	g_test_init(&argc, &argv, NULL);
+
+	g_assert_cmpint(neardal_sim_enable(1), ==, NEARDAL_SUCCESS);
+	g_assert_cmpint(neardal_sim_add_adapter(TEST_SIM_ADAPTER), ==,
+			NEARDAL_SUCCESS);
+
+	g_test_add_func("/sim/write-raw/chunked-smart-poster",
+			test_sim_write_raw_chunked_sp);
+	g_test_add_func("/sim/raw-ndef/round-trip",
+			test_sim_raw_ndef_round_trip);
+	g_test_add_func("/sim/write-verify/mime-id",
+			test_sim_write_verify_mime);
+	g_test_add_func("/sim/replay/raw-ndef-reply",
+			test_sim_replay_raw_ndef);
+	g_test_add_func("/sim/write-verify/mismatch",
+			test_sim_write_verify_mismatch);
+
+	ret = g_test_run();
+	neardal_destroy();
+
+	return ret;
+}